@@ -33,4 +33,12 @@
 
 @property (nonatomic, readwrite, assign) NSInteger globalSequenceId;
 
+/**
+ * Returns whether an event of the given name should be built, according to the sample rate and rate limit of its policy.
+ *
+ * @param eventName Event name.
+ * @return YES if the event should be built, NO otherwise.
+ */
+- (BOOL) shouldBuildEventWithName:(nonnull NSString *) eventName;
+
 @end
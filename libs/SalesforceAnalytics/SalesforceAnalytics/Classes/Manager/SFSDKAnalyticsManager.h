@@ -28,6 +28,9 @@
  */
 
 #import "SFSDKEventStoreManager.h"
+#import "SFSDKEventSamplingPolicy.h"
+
+static NSString * _Nonnull const kSFSDKEventAggregateKey = @"aggregate";
 
 @interface SFSDKAnalyticsManager : NSObject
 
@@ -47,6 +50,41 @@
  */
 - (nonnull instancetype) initWithStoreDirectory:(nonnull NSString *) storeDirectory dataEncryptorBlock:(nullable DataEncryptorBlock) dataEncryptorBlock dataDecryptorBlock:(nullable DataDecryptorBlock) dataDecryptorBlock deviceAttributes:(nonnull SFSDKDeviceAppAttributes *) deviceAttributes;
 
+/**
+ * Sets how events of the given name get recorded. Events of names without a policy are all built and stored.
+ * Events of the given name aggregated so far get stored right away.
+ *
+ * @param policy Sampling policy, nil to remove it.
+ * @param eventName Event name.
+ */
+- (void) setSamplingPolicy:(nullable SFSDKEventSamplingPolicy *) policy forEventName:(nonnull NSString *) eventName;
+
+/**
+ * Returns how events of the given name get recorded.
+ *
+ * @param eventName Event name.
+ * @return Sampling policy, nil if there is none.
+ */
+- (nullable SFSDKEventSamplingPolicy *) samplingPolicyForEventName:(nonnull NSString *) eventName;
+
+/**
+ * Stores an event, or folds it into the aggregate event of its name if its policy aggregates events.
+ * Sampling and rate limiting happen when events get built, see SFSDKInstrumentationEventBuilder.
+ *
+ * An aggregate event has the name and attributes of the first event folded into it. Under
+ * `kSFSDKEventAggregateKey`, its attributes hold the number of events folded and their window,
+ * along with the total, minimum and maximum durations and the duration histogram of the events
+ * that have an end time.
+ *
+ * @param event Event to be stored.
+ */
+- (void) storeEvent:(nullable SFSDKInstrumentationEvent *) event;
+
+/**
+ * Stores the events aggregated so far, before their interval is over.
+ */
+- (void) flushAggregatedEvents;
+
 /**
  * Resets this instance.
  */
@@ -28,12 +28,36 @@
  */
 
 #import "SFSDKAnalyticsManager+Internal.h"
+#import "SFSDKInstrumentationEvent+Internal.h"
+
+// Rate limiting and aggregation state of the events of one name
+@interface SFSDKEventNameState : NSObject
+
+@property (nonatomic, assign) NSTimeInterval rateLimitWindowStart;
+@property (nonatomic, assign) NSUInteger numBuiltEvents;
+@property (nonatomic, strong) SFSDKInstrumentationEvent *firstAggregatedEvent;
+@property (nonatomic, assign) NSTimeInterval aggregationWindowStart;
+@property (nonatomic, assign) NSUInteger numAggregatedEvents;
+@property (nonatomic, assign) NSInteger lastTime;
+@property (nonatomic, assign) NSUInteger numDurations;
+@property (nonatomic, assign) NSInteger totalDuration;
+@property (nonatomic, assign) NSInteger minDuration;
+@property (nonatomic, assign) NSInteger maxDuration;
+@property (nonatomic, strong) NSArray<NSNumber *> *histogramBounds;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *histogramCounts;
+
+@end
+
+@implementation SFSDKEventNameState
+@end
 
 @interface SFSDKAnalyticsManager ()
 
 @property (nonatomic, readwrite, strong) NSString *storeDirectory;
 @property (nonatomic, readwrite, strong) SFSDKEventStoreManager *storeManager;
 @property (nonatomic, readwrite, strong) SFSDKDeviceAppAttributes *deviceAttributes;
+@property (nonatomic, readwrite, strong) NSMutableDictionary<NSString *, SFSDKEventSamplingPolicy *> *samplingPolicies;
+@property (nonatomic, readwrite, strong) NSMutableDictionary<NSString *, SFSDKEventNameState *> *eventNameStates;
 
 @end
 
@@ -46,12 +70,172 @@
         self.deviceAttributes = deviceAttributes;
         self.globalSequenceId = 0;
         self.storeManager = [[SFSDKEventStoreManager alloc] initWithStoreDirectory:storeDirectory dataEncryptorBlock:dataEncryptorBlock dataDecryptorBlock:dataDecryptorBlock];
+        self.samplingPolicies = [[NSMutableDictionary alloc] init];
+        self.eventNameStates = [[NSMutableDictionary alloc] init];
     }
     return self;
 }
 
+- (void) setSamplingPolicy:(SFSDKEventSamplingPolicy *) policy forEventName:(NSString *) eventName {
+    if (!eventName) {
+        return;
+    }
+    SFSDKInstrumentationEvent *aggregateEvent = nil;
+    @synchronized (self.samplingPolicies) {
+        self.samplingPolicies[eventName] = [policy copy];
+        SFSDKEventNameState *state = self.eventNameStates[eventName];
+        aggregateEvent = [self takeAggregateEventFromState:state];
+        [self.eventNameStates removeObjectForKey:eventName];
+    }
+    [self.storeManager storeEvent:aggregateEvent];
+}
+
+- (SFSDKEventSamplingPolicy *) samplingPolicyForEventName:(NSString *) eventName {
+    if (!eventName) {
+        return nil;
+    }
+    @synchronized (self.samplingPolicies) {
+        return [self.samplingPolicies[eventName] copy];
+    }
+}
+
+- (BOOL) shouldBuildEventWithName:(NSString *) eventName {
+    if (!eventName) {
+        return YES;
+    }
+    @synchronized (self.samplingPolicies) {
+        SFSDKEventSamplingPolicy *policy = self.samplingPolicies[eventName];
+        if (!policy || policy.aggregationInterval > 0) {
+            return YES;
+        }
+        if (policy.sampleRate < 1.0 && (policy.sampleRate <= 0 || arc4random_uniform(UINT32_MAX) >= policy.sampleRate * UINT32_MAX)) {
+            return NO;
+        }
+        if (policy.maxEventsPerInterval == 0) {
+            return YES;
+        }
+        SFSDKEventNameState *state = [self stateForEventName:eventName];
+        NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+        if (now >= state.rateLimitWindowStart + policy.rateLimitInterval) {
+            state.rateLimitWindowStart = now;
+            state.numBuiltEvents = 0;
+        }
+        if (state.numBuiltEvents >= policy.maxEventsPerInterval) {
+            return NO;
+        }
+        state.numBuiltEvents++;
+        return YES;
+    }
+}
+
+- (void) storeEvent:(SFSDKInstrumentationEvent *) event {
+    if (!event) {
+        return;
+    }
+    SFSDKInstrumentationEvent *aggregateEvent = nil;
+    @synchronized (self.samplingPolicies) {
+        SFSDKEventSamplingPolicy *policy = self.samplingPolicies[event.name];
+        if (policy.aggregationInterval > 0) {
+            SFSDKEventNameState *state = [self stateForEventName:event.name];
+            NSTimeInterval now = [[NSDate date] timeIntervalSince1970];
+            if (state.numAggregatedEvents > 0 && now >= state.aggregationWindowStart + policy.aggregationInterval) {
+                aggregateEvent = [self takeAggregateEventFromState:state];
+            }
+            if (state.numAggregatedEvents == 0) {
+                state.aggregationWindowStart = now;
+                state.histogramBounds = policy.durationHistogramBounds;
+            }
+            [self foldEvent:event intoState:state];
+            event = nil;
+        }
+    }
+    [self.storeManager storeEvent:aggregateEvent];
+    [self.storeManager storeEvent:event];
+}
+
+- (void) flushAggregatedEvents {
+    NSMutableArray<SFSDKInstrumentationEvent *> *aggregateEvents = [[NSMutableArray alloc] init];
+    @synchronized (self.samplingPolicies) {
+        for (SFSDKEventNameState *state in self.eventNameStates.allValues) {
+            SFSDKInstrumentationEvent *aggregateEvent = [self takeAggregateEventFromState:state];
+            if (aggregateEvent) {
+                [aggregateEvents addObject:aggregateEvent];
+            }
+        }
+    }
+    [self.storeManager storeEvents:aggregateEvents];
+}
+
 - (void) reset {
+    @synchronized (self.samplingPolicies) {
+        [self.eventNameStates removeAllObjects];
+    }
     [self.storeManager deleteAllEvents];
 }
 
+#pragma mark - Aggregation
+
+- (SFSDKEventNameState *) stateForEventName:(NSString *) eventName {
+    SFSDKEventNameState *state = self.eventNameStates[eventName];
+    if (!state) {
+        state = [[SFSDKEventNameState alloc] init];
+        self.eventNameStates[eventName] = state;
+    }
+    return state;
+}
+
+- (void) foldEvent:(SFSDKInstrumentationEvent *) event intoState:(SFSDKEventNameState *) state {
+    if (state.numAggregatedEvents == 0) {
+        state.firstAggregatedEvent = event;
+        state.numDurations = 0;
+        state.totalDuration = 0;
+        state.histogramCounts = [[NSMutableArray alloc] init];
+        for (NSUInteger i = 0; i <= state.histogramBounds.count; i++) {
+            [state.histogramCounts addObject:@0];
+        }
+    }
+    state.numAggregatedEvents++;
+    state.lastTime = MAX(state.lastTime, MAX(event.startTime, event.endTime));
+    if (event.endTime > 0 && event.endTime >= event.startTime) {
+        NSInteger duration = event.endTime - event.startTime;
+        state.minDuration = (state.numDurations == 0) ? duration : MIN(state.minDuration, duration);
+        state.maxDuration = (state.numDurations == 0) ? duration : MAX(state.maxDuration, duration);
+        state.totalDuration += duration;
+        state.numDurations++;
+        NSUInteger bucket = 0;
+        while (bucket < state.histogramBounds.count && duration > [state.histogramBounds[bucket] integerValue]) {
+            bucket++;
+        }
+        state.histogramCounts[bucket] = @([state.histogramCounts[bucket] unsignedIntegerValue] + 1);
+    }
+}
+
+// Builds the aggregate event of the events folded so far and starts over
+- (SFSDKInstrumentationEvent *) takeAggregateEventFromState:(SFSDKEventNameState *) state {
+    if (state.numAggregatedEvents == 0) {
+        return nil;
+    }
+    SFSDKInstrumentationEvent *first = state.firstAggregatedEvent;
+    NSMutableDictionary *aggregate = [[NSMutableDictionary alloc] init];
+    aggregate[@"count"] = @(state.numAggregatedEvents);
+    aggregate[@"windowStart"] = @(first.startTime);
+    aggregate[@"windowEnd"] = @(state.lastTime);
+    if (state.numDurations > 0) {
+        aggregate[@"durationCount"] = @(state.numDurations);
+        aggregate[@"durationTotal"] = @(state.totalDuration);
+        aggregate[@"durationMin"] = @(state.minDuration);
+        aggregate[@"durationMax"] = @(state.maxDuration);
+        aggregate[@"durationHistogram"] = @{ @"bounds" : state.histogramBounds, @"counts" : [state.histogramCounts copy] };
+    }
+    NSMutableDictionary *attributes = [first.attributes mutableCopy] ?: [[NSMutableDictionary alloc] init];
+    attributes[kSFSDKEventAggregateKey] = aggregate;
+    NSInteger sequenceId = self.globalSequenceId + 1;
+    self.globalSequenceId = sequenceId;
+    SFSDKInstrumentationEvent *aggregateEvent = [[SFSDKInstrumentationEvent alloc] initWithEventId:[[NSUUID UUID] UUIDString] startTime:first.startTime endTime:state.lastTime name:first.name attributes:attributes sessionId:first.sessionId sequenceId:sequenceId senderId:first.senderId senderContext:first.senderContext schemaType:first.schemaType eventType:first.eventType errorType:first.errorType deviceAppAttributes:first.deviceAppAttributes connectionType:first.connectionType senderParentId:first.senderParentId sessionStartTime:first.sessionStartTime page:first.page previousPage:first.previousPage marks:first.marks];
+    state.numAggregatedEvents = 0;
+    state.firstAggregatedEvent = nil;
+    state.lastTime = 0;
+    return aggregateEvent;
+}
+
 @end
@@ -0,0 +1,88 @@
+/*
+ SFSDKEventSamplingPolicy.h
+ SalesforceAnalytics
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * How events of a given name get recorded by the analytics manager: the share of them kept, how
+ * many are kept per interval, or whether they get folded into one aggregate event per interval.
+ */
+@interface SFSDKEventSamplingPolicy : NSObject <NSCopying>
+
+/**
+ * Share of the events that get built, between 0 and 1. 1 by default.
+ */
+@property (nonatomic, assign, readwrite) double sampleRate;
+
+/**
+ * Maximum number of events built per `rateLimitInterval`, 0 for no limit. 0 by default.
+ */
+@property (nonatomic, assign, readwrite) NSUInteger maxEventsPerInterval;
+
+/**
+ * Interval (in seconds) `maxEventsPerInterval` applies to. 60 seconds by default.
+ */
+@property (nonatomic, assign, readwrite) NSTimeInterval rateLimitInterval;
+
+/**
+ * Interval (in seconds) over which events get folded into one aggregate event, 0 to store every
+ * event. 0 by default. Aggregated events are neither sampled nor rate limited.
+ */
+@property (nonatomic, assign, readwrite) NSTimeInterval aggregationInterval;
+
+/**
+ * Upper bounds (in milliseconds) of the buckets of the duration histogram of aggregate events.
+ * Durations above the last bound go into one more bucket.
+ */
+@property (nonatomic, copy, readwrite, nonnull) NSArray<NSNumber *> *durationHistogramBounds;
+
+/**
+ * Returns a policy keeping the given share of the events.
+ *
+ * @param sampleRate Share of the events kept, between 0 and 1.
+ * @return Instance of this class.
+ */
++ (nonnull instancetype) policyWithSampleRate:(double) sampleRate;
+
+/**
+ * Returns a policy keeping at most the given number of events per interval.
+ *
+ * @param maxEvents Maximum number of events kept per interval.
+ * @param interval Interval (in seconds).
+ * @return Instance of this class.
+ */
++ (nonnull instancetype) policyWithMaxEvents:(NSUInteger) maxEvents perInterval:(NSTimeInterval) interval;
+
+/**
+ * Returns a policy folding the events into one aggregate event per interval.
+ *
+ * @param interval Interval (in seconds).
+ * @return Instance of this class.
+ */
++ (nonnull instancetype) aggregationPolicyWithInterval:(NSTimeInterval) interval;
+
+@end
@@ -0,0 +1,73 @@
+/*
+ SFSDKEventSamplingPolicy.m
+ SalesforceAnalytics
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKEventSamplingPolicy.h"
+
+@implementation SFSDKEventSamplingPolicy
+
+- (instancetype) init {
+    self = [super init];
+    if (self) {
+        self.sampleRate = 1.0;
+        self.maxEventsPerInterval = 0;
+        self.rateLimitInterval = 60;
+        self.aggregationInterval = 0;
+        self.durationHistogramBounds = @[ @10, @50, @100, @250, @500, @1000, @2500, @5000, @10000 ];
+    }
+    return self;
+}
+
++ (instancetype) policyWithSampleRate:(double) sampleRate {
+    SFSDKEventSamplingPolicy *policy = [[self alloc] init];
+    policy.sampleRate = sampleRate;
+    return policy;
+}
+
++ (instancetype) policyWithMaxEvents:(NSUInteger) maxEvents perInterval:(NSTimeInterval) interval {
+    SFSDKEventSamplingPolicy *policy = [[self alloc] init];
+    policy.maxEventsPerInterval = maxEvents;
+    policy.rateLimitInterval = interval;
+    return policy;
+}
+
++ (instancetype) aggregationPolicyWithInterval:(NSTimeInterval) interval {
+    SFSDKEventSamplingPolicy *policy = [[self alloc] init];
+    policy.aggregationInterval = interval;
+    return policy;
+}
+
+- (id) copyWithZone:(NSZone *) zone {
+    SFSDKEventSamplingPolicy *policy = [[[self class] allocWithZone:zone] init];
+    policy.sampleRate = self.sampleRate;
+    policy.maxEventsPerInterval = self.maxEventsPerInterval;
+    policy.rateLimitInterval = self.rateLimitInterval;
+    policy.aggregationInterval = self.aggregationInterval;
+    policy.durationHistogramBounds = self.durationHistogramBounds;
+    return policy;
+}
+
+@end
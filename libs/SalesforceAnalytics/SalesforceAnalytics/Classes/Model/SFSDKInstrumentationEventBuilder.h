@@ -50,7 +50,8 @@
 typedef void (^ _Nonnull SFSDKInstrumentationEventBuilderBlock)(SFSDKInstrumentationEventBuilder * _Nonnull eventBuilder);
 
 /**
- * Builds the event. Returns nil if required fields are missing.
+ * Builds the event. Returns nil if required fields are missing, or if the sampling
+ * policy of the event name set on the analytics manager leaves the event out.
  *
  * @return Event instance.
  */
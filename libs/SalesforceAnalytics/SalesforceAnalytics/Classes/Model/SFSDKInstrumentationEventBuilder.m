@@ -72,6 +72,9 @@
         [SFSDKAnalyticsLogger w:[self class] format:@"WARNING: Building event failed! REASON: %@", errorMessage];
         return nil;
     }
+    if (![self.analyticsManager shouldBuildEventWithName:self.name]) {
+        return nil;
+    }
     NSInteger sequenceId = self.analyticsManager.globalSequenceId + 1;
     self.analyticsManager.globalSequenceId = sequenceId;
 
@@ -0,0 +1,110 @@
+/*
+ SFSDKEventLog.h
+ SalesforceAnalytics
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFSDKEventStoreManager.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Append-only log of serialized events, stored as a series of segment files in a directory.
+ *
+ * Each append is one record, encrypted as a whole, holding the length-prefixed id and data of the
+ * appended events. Removals are recorded the same way. The live events are indexed in memory, so
+ * counting them or checking for one doesn't touch the filesystem. Once the oldest segment no longer
+ * holds any live event, the whole file gets deleted.
+ */
+@interface SFSDKEventLog : NSObject
+
+/**
+ * Number of live events in the log.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * Maximum size (in bytes) of a segment before the log moves on to a new one. 256KB by default.
+ */
+@property (nonatomic, assign) NSUInteger maxSegmentSize;
+
+/**
+ * Opens the log stored in the given directory, replaying its segments. Event files left over by
+ * the previous store format are moved into the log.
+ *
+ * @param directory Directory of the log.
+ * @param dataEncryptorBlock Block that encrypts a record.
+ * @param dataDecryptorBlock Block that decrypts a record.
+ * @return Instance of this class.
+ */
+- (instancetype)initWithDirectory:(NSString *)directory dataEncryptorBlock:(DataEncryptorBlock)dataEncryptorBlock dataDecryptorBlock:(DataDecryptorBlock)dataDecryptorBlock NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Appends events to the log as a single record.
+ *
+ * @param eventData Serialized events.
+ * @param eventIds Identifiers of the events, in the same order.
+ * @return YES if the record was written, NO otherwise.
+ */
+- (BOOL)appendEventData:(NSArray<NSData *> *)eventData eventIds:(NSArray<NSString *> *)eventIds;
+
+/**
+ * Returns whether the given event is in the log.
+ *
+ * @param eventId Identifier of the event.
+ */
+- (BOOL)containsEventId:(NSString *)eventId;
+
+/**
+ * Returns the serialized event with the given identifier, nil if it isn't in the log.
+ *
+ * @param eventId Identifier of the event.
+ */
+- (nullable NSData *)dataForEventId:(NSString *)eventId;
+
+/**
+ * Goes through the live events, oldest first, one segment at a time.
+ *
+ * @param block Block called with each event, set `stop` to YES to end the enumeration.
+ */
+- (void)enumerateEventsUsingBlock:(void (^)(NSString *eventId, NSData *data, BOOL *stop))block;
+
+/**
+ * Removes events from the log. Segments left without live events are deleted.
+ *
+ * @param eventIds Identifiers of the events.
+ */
+- (void)removeEventIds:(NSArray<NSString *> *)eventIds;
+
+/**
+ * Removes all the events, deleting all the segments.
+ */
+- (void)removeAllEvents;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,444 @@
+/*
+ SFSDKEventLog.m
+ SalesforceAnalytics
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKEventLog.h"
+
+static NSString * const kSegmentPrefix = @"segment_";
+static NSString * const kSegmentExtension = @"log";
+static NSUInteger const kDefaultMaxSegmentSize = 256 * 1024;
+static NSUInteger const kMaxMigratedEventsPerRecord = 500;
+static uint8_t const kRecordTypeEvents = 'E';
+static uint8_t const kRecordTypeRemovals = 'R';
+
+typedef void (^SFSDKEventLogEntryBlock)(NSString *eventId, NSData *data, BOOL *stop);
+
+#pragma mark - Record encoding
+
+static void SFSDKAppendChunk(NSMutableData *buffer, NSData *chunk) {
+    uint32_t length = CFSwapInt32HostToBig((uint32_t) chunk.length);
+    [buffer appendBytes:&length length:sizeof(length)];
+    [buffer appendData:chunk];
+}
+
+static NSData *SFSDKReadChunk(NSData *buffer, NSUInteger *offset) {
+    uint32_t length = 0;
+    if (*offset + sizeof(length) > buffer.length) {
+        return nil;
+    }
+    [buffer getBytes:&length range:NSMakeRange(*offset, sizeof(length))];
+    length = CFSwapInt32BigToHost(length);
+    if (*offset + sizeof(length) + length > buffer.length) {
+        return nil;
+    }
+    NSData *chunk = [buffer subdataWithRange:NSMakeRange(*offset + sizeof(length), length)];
+    *offset += sizeof(length) + length;
+    return chunk;
+}
+
+// Records of events hold id/data pairs, records of removals hold ids only
+static void SFSDKEnumerateEntries(NSData *payload, BOOL withData, SFSDKEventLogEntryBlock block) {
+    NSUInteger offset = 0;
+    BOOL stop = NO;
+    while (!stop && offset < payload.length) {
+        NSData *idData = SFSDKReadChunk(payload, &offset);
+        NSData *data = withData ? SFSDKReadChunk(payload, &offset) : nil;
+        if (!idData || (withData && !data)) {
+            return;
+        }
+        NSString *eventId = [[NSString alloc] initWithData:idData encoding:NSUTF8StringEncoding];
+        if (eventId) {
+            block(eventId, data, &stop);
+        }
+    }
+}
+
+@interface SFSDKEventLog ()
+
+@property (nonatomic, copy) NSString *directory;
+@property (nonatomic, copy) DataEncryptorBlock dataEncryptorBlock;
+@property (nonatomic, copy) DataDecryptorBlock dataDecryptorBlock;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *segmentForEventId;
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSNumber *> *liveCountForSegment;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *segments;
+@property (nonatomic, strong) NSOutputStream *activeStream;
+@property (nonatomic, assign) NSUInteger activeSegmentSize;
+
+@end
+
+@implementation SFSDKEventLog
+
+- (instancetype)initWithDirectory:(NSString *)directory dataEncryptorBlock:(DataEncryptorBlock)dataEncryptorBlock dataDecryptorBlock:(DataDecryptorBlock)dataDecryptorBlock {
+    self = [super init];
+    if (self) {
+        _directory = [directory copy];
+        _dataEncryptorBlock = dataEncryptorBlock ?: ^NSData*(NSData *data) {
+            return data;
+        };
+        _dataDecryptorBlock = dataDecryptorBlock ?: ^NSData*(NSData *data) {
+            return data;
+        };
+        _maxSegmentSize = kDefaultMaxSegmentSize;
+        _segmentForEventId = [[NSMutableDictionary alloc] init];
+        _liveCountForSegment = [[NSMutableDictionary alloc] init];
+        _segments = [[NSMutableArray alloc] init];
+        [self load];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_activeStream close];
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return self.segmentForEventId.count;
+    }
+}
+
+#pragma mark - Events
+
+- (BOOL)appendEventData:(NSArray<NSData *> *)eventData eventIds:(NSArray<NSString *> *)eventIds {
+    if (eventData.count == 0 || eventData.count != eventIds.count) {
+        return NO;
+    }
+    NSMutableData *payload = [[NSMutableData alloc] init];
+    for (NSUInteger i = 0; i < eventIds.count; i++) {
+        SFSDKAppendChunk(payload, [eventIds[i] dataUsingEncoding:NSUTF8StringEncoding]);
+        SFSDKAppendChunk(payload, eventData[i]);
+    }
+    NSData *record = self.dataEncryptorBlock(payload);
+    @synchronized (self) {
+        NSNumber *segment = [self writeRecordOfType:kRecordTypeEvents record:record];
+        if (!segment) {
+            return NO;
+        }
+        for (NSString *eventId in eventIds) {
+            [self indexEventId:eventId segment:segment];
+        }
+    }
+    return YES;
+}
+
+- (BOOL)containsEventId:(NSString *)eventId {
+    @synchronized (self) {
+        return self.segmentForEventId[eventId] != nil;
+    }
+}
+
+- (NSData *)dataForEventId:(NSString *)eventId {
+    NSNumber *segment = nil;
+    @synchronized (self) {
+        segment = self.segmentForEventId[eventId];
+    }
+    if (!segment) {
+        return nil;
+    }
+    __block NSData *eventData = nil;
+    [self readSegment:segment recordBlock:^(uint8_t type, NSData *payload, BOOL *stop) {
+        if (type == kRecordTypeEvents) {
+            SFSDKEnumerateEntries(payload, YES, ^(NSString *entryId, NSData *data, BOOL *stopEntries) {
+                if ([entryId isEqualToString:eventId]) {
+                    eventData = data;
+                }
+            });
+        }
+    }];
+    return eventData;
+}
+
+- (void)enumerateEventsUsingBlock:(void (^)(NSString *eventId, NSData *data, BOOL *stop))block {
+    NSArray<NSNumber *> *segments = nil;
+    @synchronized (self) {
+        segments = [self.segments copy];
+    }
+    __block BOOL stopped = NO;
+    NSMutableSet<NSString *> *enumerated = [[NSMutableSet alloc] init];
+    for (NSNumber *segment in segments) {
+        [self readSegment:segment recordBlock:^(uint8_t type, NSData *payload, BOOL *stop) {
+            if (type != kRecordTypeEvents) {
+                return;
+            }
+            SFSDKEnumerateEntries(payload, YES, ^(NSString *eventId, NSData *data, BOOL *stopEntries) {
+
+                // Only the latest copy of a live event counts
+                BOOL live = NO;
+                @synchronized (self) {
+                    live = [self.segmentForEventId[eventId] isEqualToNumber:segment];
+                }
+                if (live && ![enumerated containsObject:eventId]) {
+                    [enumerated addObject:eventId];
+                    block(eventId, data, &stopped);
+                    *stopEntries = stopped;
+                }
+            });
+            *stop = stopped;
+        }];
+        if (stopped) {
+            break;
+        }
+    }
+}
+
+- (void)removeEventIds:(NSArray<NSString *> *)eventIds {
+    @synchronized (self) {
+        NSMutableArray<NSString *> *removedIds = [[NSMutableArray alloc] init];
+        for (NSString *eventId in eventIds) {
+            if (self.segmentForEventId[eventId]) {
+                [removedIds addObject:eventId];
+            }
+        }
+        if (removedIds.count == 0) {
+            return;
+        }
+
+        // Removing every live event retires all the segments, nothing needs to be recorded then
+        if (removedIds.count < self.segmentForEventId.count) {
+            NSMutableData *payload = [[NSMutableData alloc] init];
+            for (NSString *eventId in removedIds) {
+                SFSDKAppendChunk(payload, [eventId dataUsingEncoding:NSUTF8StringEncoding]);
+            }
+            if (![self writeRecordOfType:kRecordTypeRemovals record:self.dataEncryptorBlock(payload)]) {
+                [SFSDKAnalyticsLogger w:[self class] format:@"Removal of %lu events could not be recorded", (unsigned long) removedIds.count];
+            }
+        }
+        for (NSString *eventId in removedIds) {
+            [self unindexEventId:eventId];
+        }
+        [self retireEmptySegments];
+    }
+}
+
+- (void)removeAllEvents {
+    @synchronized (self) {
+        [self closeActiveSegment];
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        NSArray<NSString *> *files = [fileManager contentsOfDirectoryAtPath:self.directory error:nil];
+        for (NSString *file in files) {
+            [fileManager removeItemAtPath:[self.directory stringByAppendingPathComponent:file] error:nil];
+        }
+        [self.segmentForEventId removeAllObjects];
+        [self.liveCountForSegment removeAllObjects];
+        [self.segments removeAllObjects];
+    }
+}
+
+#pragma mark - Index
+
+- (void)indexEventId:(NSString *)eventId segment:(NSNumber *)segment {
+    [self unindexEventId:eventId];
+    self.segmentForEventId[eventId] = segment;
+    self.liveCountForSegment[segment] = @(self.liveCountForSegment[segment].unsignedIntegerValue + 1);
+}
+
+- (void)unindexEventId:(NSString *)eventId {
+    NSNumber *segment = self.segmentForEventId[eventId];
+    if (segment) {
+        [self.segmentForEventId removeObjectForKey:eventId];
+        self.liveCountForSegment[segment] = @(self.liveCountForSegment[segment].unsignedIntegerValue - 1);
+    }
+}
+
+/*
+ * Segments are retired oldest first. A removal is always recorded in a segment at least as recent as
+ * the event it removes, so no removal can outlive the event it refers to.
+ */
+- (void)retireEmptySegments {
+    while (self.segments.count > 0 && self.liveCountForSegment[self.segments.firstObject].unsignedIntegerValue == 0) {
+        NSNumber *segment = self.segments.firstObject;
+        if (self.segments.count == 1) {
+            [self closeActiveSegment];
+        }
+        [[NSFileManager defaultManager] removeItemAtPath:[self pathForSegment:segment] error:nil];
+        [self.segments removeObjectAtIndex:0];
+        [self.liveCountForSegment removeObjectForKey:segment];
+    }
+}
+
+#pragma mark - Segments
+
+- (NSString *)pathForSegment:(NSNumber *)segment {
+    NSString *filename = [NSString stringWithFormat:@"%@%08lu.%@", kSegmentPrefix, (unsigned long) segment.unsignedIntegerValue, kSegmentExtension];
+    return [self.directory stringByAppendingPathComponent:filename];
+}
+
+- (NSNumber *)writeRecordOfType:(uint8_t)type record:(NSData *)record {
+    if (!record) {
+        return nil;
+    }
+    if (!self.activeStream || self.activeSegmentSize >= self.maxSegmentSize) {
+        if (![self openNewSegment]) {
+            return nil;
+        }
+    }
+    NSMutableData *bytes = [[NSMutableData alloc] initWithCapacity:record.length + 5];
+    [bytes appendBytes:&type length:sizeof(type)];
+    SFSDKAppendChunk(bytes, record);
+    NSUInteger written = 0;
+    while (written < bytes.length) {
+        NSInteger result = [self.activeStream write:(const uint8_t *) bytes.bytes + written maxLength:bytes.length - written];
+        if (result <= 0) {
+
+            // A partially written record gets dropped when the segment is next replayed
+            [SFSDKAnalyticsLogger w:[self class] format:@"Error occurred while writing to event log: %@", self.activeStream.streamError.localizedDescription];
+            [self closeActiveSegment];
+            return nil;
+        }
+        written += result;
+    }
+    self.activeSegmentSize += bytes.length;
+    return self.segments.lastObject;
+}
+
+- (BOOL)openNewSegment {
+    [self closeActiveSegment];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSDictionary *attributes = @{ NSFileProtectionKey: NSFileProtectionCompleteUntilFirstUserAuthentication };
+    [fileManager createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:attributes error:nil];
+    NSNumber *segment = @(self.segments.lastObject.unsignedIntegerValue + 1);
+    NSString *path = [self pathForSegment:segment];
+    if (![fileManager createFileAtPath:path contents:nil attributes:attributes]) {
+        [SFSDKAnalyticsLogger w:[self class] format:@"Could not create event log segment at %@", path];
+        return NO;
+    }
+    NSOutputStream *stream = [NSOutputStream outputStreamToFileAtPath:path append:YES];
+    [stream open];
+    if (stream.streamStatus != NSStreamStatusOpen) {
+        [SFSDKAnalyticsLogger w:[self class] format:@"Could not open event log segment at %@: %@", path, stream.streamError.localizedDescription];
+        [fileManager removeItemAtPath:path error:nil];
+        return NO;
+    }
+    [self.segments addObject:segment];
+    self.liveCountForSegment[segment] = @0;
+    self.activeStream = stream;
+    self.activeSegmentSize = 0;
+    return YES;
+}
+
+- (void)closeActiveSegment {
+    [self.activeStream close];
+    self.activeStream = nil;
+    self.activeSegmentSize = 0;
+}
+
+// Returns the length of the complete records read
+- (NSUInteger)readSegment:(NSNumber *)segment recordBlock:(void (^)(uint8_t type, NSData *payload, BOOL *stop))recordBlock {
+    NSData *contents = [NSData dataWithContentsOfFile:[self pathForSegment:segment] options:NSDataReadingMappedIfSafe error:nil];
+    NSUInteger offset = 0;
+    BOOL stop = NO;
+    while (!stop && offset < contents.length) {
+        uint8_t type = 0;
+        [contents getBytes:&type range:NSMakeRange(offset, sizeof(type))];
+        NSUInteger recordOffset = offset + sizeof(type);
+        NSData *record = SFSDKReadChunk(contents, &recordOffset);
+        if (!record) {
+            break;
+        }
+        offset = recordOffset;
+        NSData *payload = self.dataDecryptorBlock(record);
+        if (payload) {
+            recordBlock(type, payload, &stop);
+        } else {
+            [SFSDKAnalyticsLogger w:[self class] format:@"Could not decrypt event log record in segment %@", segment];
+        }
+    }
+    return offset;
+}
+
+#pragma mark - Loading
+
+- (void)load {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSArray<NSString *> *files = [fileManager contentsOfDirectoryAtPath:self.directory error:nil];
+    NSMutableArray<NSNumber *> *segments = [[NSMutableArray alloc] init];
+    NSMutableArray<NSString *> *legacyFiles = [[NSMutableArray alloc] init];
+    for (NSString *file in files) {
+        if ([file hasPrefix:kSegmentPrefix] && [file.pathExtension isEqualToString:kSegmentExtension]) {
+            NSString *number = [[file stringByDeletingPathExtension] substringFromIndex:kSegmentPrefix.length];
+            [segments addObject:@(strtoul(number.UTF8String, NULL, 10))];
+        } else {
+            [legacyFiles addObject:file];
+        }
+    }
+    [segments sortUsingSelector:@selector(compare:)];
+    for (NSNumber *segment in segments) {
+        [self.segments addObject:segment];
+        self.liveCountForSegment[segment] = @0;
+        NSUInteger length = [self readSegment:segment recordBlock:^(uint8_t type, NSData *payload, BOOL *stop) {
+            SFSDKEnumerateEntries(payload, type == kRecordTypeEvents, ^(NSString *eventId, NSData *data, BOOL *stopEntries) {
+                if (type == kRecordTypeEvents) {
+                    [self indexEventId:eventId segment:segment];
+                } else if (type == kRecordTypeRemovals) {
+                    [self unindexEventId:eventId];
+                }
+            });
+        }];
+
+        // Drops whatever an interrupted write left at the end of the segment
+        NSString *path = [self pathForSegment:segment];
+        if ([[fileManager attributesOfItemAtPath:path error:nil] fileSize] > length) {
+            [SFSDKAnalyticsLogger w:[self class] format:@"Truncating incomplete record at the end of %@", path.lastPathComponent];
+            NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+            [fileHandle truncateFileAtOffset:length];
+            [fileHandle closeFile];
+        }
+    }
+    [self retireEmptySegments];
+    [self migrateLegacyFiles:legacyFiles];
+}
+
+// Previous versions stored each event in its own file, named after the event
+- (void)migrateLegacyFiles:(NSArray<NSString *> *)files {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSMutableArray<NSData *> *eventData = [[NSMutableArray alloc] init];
+    NSMutableArray<NSString *> *eventIds = [[NSMutableArray alloc] init];
+    NSMutableArray<NSString *> *paths = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < files.count; i++) {
+        NSString *path = [self.directory stringByAppendingPathComponent:files[i]];
+        NSData *data = self.dataDecryptorBlock([NSData dataWithContentsOfFile:path]);
+        if (data) {
+            [eventData addObject:data];
+            [eventIds addObject:files[i]];
+        }
+        [paths addObject:path];
+        if (eventIds.count == kMaxMigratedEventsPerRecord || (i == files.count - 1 && eventIds.count > 0)) {
+            if (![self appendEventData:eventData eventIds:eventIds]) {
+                return;
+            }
+            [eventData removeAllObjects];
+            [eventIds removeAllObjects];
+        }
+        if (eventIds.count == 0) {
+            for (NSString *migratedPath in paths) {
+                [fileManager removeItemAtPath:migratedPath error:nil];
+            }
+            [paths removeAllObjects];
+        }
+    }
+}
+
+@end
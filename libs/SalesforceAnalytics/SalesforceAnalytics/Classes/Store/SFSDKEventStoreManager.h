@@ -29,6 +29,14 @@
 
 #import "SFSDKInstrumentationEvent.h"
 
+/**
+ * What happens to events stored while the write buffer is full.
+ */
+typedef NS_ENUM(NSInteger, SFSDKEventStoreOverflowPolicy) {
+    SFSDKEventStoreOverflowPolicyDropOldest = 0, // Drops the oldest buffered event to make room.
+    SFSDKEventStoreOverflowPolicyDropNewest      // Drops the event being stored.
+};
+
 @interface SFSDKEventStoreManager : NSObject
 
 typedef NSData * _Nullable (^ _Nullable DataEncryptorBlock)(NSData * _Nullable data);
@@ -41,6 +49,21 @@ typedef NSData * _Nullable (^ _Nullable DataDecryptorBlock)(NSData * _Nullable d
 @property (nonatomic, assign, readwrite, getter=isLoggingEnabled) BOOL loggingEnabled;
 @property (nonatomic, assign, readwrite) NSInteger maxEvents;
 
+/**
+ * Maximum number of events waiting to be written. 500 by default.
+ */
+@property (nonatomic, assign, readwrite) NSUInteger maxBufferedEvents;
+
+/**
+ * What happens to events stored while `maxBufferedEvents` are waiting to be written. Drops the oldest by default.
+ */
+@property (nonatomic, assign, readwrite) SFSDKEventStoreOverflowPolicy overflowPolicy;
+
+/**
+ * Number of events dropped because the write buffer was full.
+ */
+@property (nonatomic, assign, readonly) NSUInteger numDroppedEvents;
+
 /**
  * Parameterized initializer.
  *
@@ -52,20 +75,26 @@ typedef NSData * _Nullable (^ _Nullable DataDecryptorBlock)(NSData * _Nullable d
 - (nonnull instancetype) initWithStoreDirectory:(nonnull NSString *) storeDirectory dataEncryptorBlock:(nullable DataEncryptorBlock) dataEncryptorBlock dataDecryptorBlock:(nullable DataDecryptorBlock) dataDecryptorBlock;
 
 /**
- * Stores an event to the filesystem. A combination of event's unique ID and
- * filename suffix is used to generate a unique filename per event.
+ * Stores an event to the filesystem. Events are appended to an encrypted,
+ * segmented log kept in the store directory. This method returns right
+ * away: the event is buffered and written on a background queue.
  *
  * @param event Event to be persisted.
  */
 - (void) storeEvent:(nullable SFSDKInstrumentationEvent *) event;
 
 /**
- * Stores a list of events to the filesystem.
+ * Stores a list of events to the filesystem, as a single record of the log.
  *
  * @param events List of events.
  */
 - (void) storeEvents:(nullable NSArray<SFSDKInstrumentationEvent *> *) events;
 
+/**
+ * Blocks until the buffered events are written. Fetching or deleting events does it first as well.
+ */
+- (void) flush;
+
 /**
  * Returns a specific event stored on the filesystem.
  *
@@ -81,6 +110,16 @@ typedef NSData * _Nullable (^ _Nullable DataDecryptorBlock)(NSData * _Nullable d
  */
 - (nullable NSArray<SFSDKInstrumentationEvent *> *) fetchAllEvents;
 
+/**
+ * Returns the oldest events stored on the filesystem, in the order they were stored.
+ * Used to go through a large number of stored events in chunks of bounded size.
+ *
+ * @param maxCount Maximum number of events returned.
+ * @param maxBytes Maximum size of the serialized events returned, the first event is returned regardless.
+ * @return List of events.
+ */
+- (nonnull NSArray<SFSDKInstrumentationEvent *> *) fetchEventsWithMaxCount:(NSUInteger) maxCount maxBytes:(NSUInteger) maxBytes;
+
 /**
  * Deletes a specific event stored on the filesystem.
  *
@@ -28,13 +28,20 @@
  */
 
 #import "SFSDKEventStoreManager.h"
+#import "SFSDKEventLog.h"
 #import "SFSDKInstrumentationEvent+Internal.h"
 
+static NSUInteger const kDefaultMaxBufferedEvents = 500;
+
 @interface SFSDKEventStoreManager ()
 
 @property (nonatomic, strong, readwrite) NSString *storeDirectory;
 @property (nonatomic, strong, readwrite) DataEncryptorBlock dataEncryptorBlock;
 @property (nonatomic, strong, readwrite) DataDecryptorBlock dataDecryptorBlock;
+@property (nonatomic, strong, readwrite) SFSDKEventLog *eventLog;
+@property (nonatomic, strong, readwrite) dispatch_queue_t ioQueue;
+@property (nonatomic, strong, readwrite) NSMutableArray<SFSDKInstrumentationEvent *> *bufferedEvents;
+@property (nonatomic, assign, readwrite) NSUInteger numDroppedEvents;
 
 @end
 
@@ -45,6 +52,10 @@
     if (self) {
         self.loggingEnabled = YES;
         self.maxEvents = 1000;
+        self.maxBufferedEvents = kDefaultMaxBufferedEvents;
+        self.overflowPolicy = SFSDKEventStoreOverflowPolicyDropOldest;
+        self.bufferedEvents = [[NSMutableArray alloc] init];
+        self.ioQueue = dispatch_queue_create("com.salesforce.analytics.eventStore", DISPATCH_QUEUE_SERIAL);
         self.storeDirectory = storeDirectory;
 
         // If a data encryptor block is passed in, uses it. Otherwise, creates a block that returns data as-is.
@@ -64,6 +75,7 @@
                 return data;
             };
         }
+        self.eventLog = [[SFSDKEventLog alloc] initWithDirectory:storeDirectory dataEncryptorBlock:self.dataEncryptorBlock dataDecryptorBlock:self.dataDecryptorBlock];
     }
     return self;
 }
@@ -72,66 +84,126 @@
     if (!event) {
         return;
     }
+    [self storeEvents:@[event]];
+}
 
-    // Copies event, to isolate data for I/O.
-    SFSDKInstrumentationEvent *eventCopy = [event copy];
-    if (!eventCopy || ![eventCopy jsonRepresentation]) {
+- (void) storeEvents:(NSArray<SFSDKInstrumentationEvent *> *) events {
+    if (!events || [events count] == 0) {
         return;
     }
-    if (![self shouldStoreEvent]) {
+    if (!self.isLoggingEnabled) {
         return;
     }
-    NSData *encryptedData = self.dataEncryptorBlock([eventCopy jsonRepresentation]);
-    NSError *error = nil;
-    if (encryptedData) {
-        NSString *filename = [self filenameForEvent:eventCopy.eventId];
-        NSString *parentDir = [filename stringByDeletingLastPathComponent];
-        [[NSFileManager defaultManager] createDirectoryAtPath:parentDir withIntermediateDirectories:YES attributes: @{ NSFileProtectionKey: NSFileProtectionCompleteUntilFirstUserAuthentication } error:&error];
-        [encryptedData writeToFile:filename options:NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication error:&error];
-        if (error) {
-            [SFSDKAnalyticsLogger w:[self class] format:@"Error occurred while writing to file: %@", error.localizedDescription];
+
+    // Callers only pay for copying the events, encoding, encryption and I/O happen on the I/O queue.
+    BOOL scheduleWrite = NO;
+    NSUInteger numDropped = 0;
+    @synchronized (self.bufferedEvents) {
+        scheduleWrite = (self.bufferedEvents.count == 0);
+        for (SFSDKInstrumentationEvent *event in events) {
+            if (self.bufferedEvents.count >= self.maxBufferedEvents) {
+                numDropped++;
+                if (self.overflowPolicy == SFSDKEventStoreOverflowPolicyDropNewest || self.bufferedEvents.count == 0) {
+                    continue;
+                }
+                [self.bufferedEvents removeObjectAtIndex:0];
+            }
+            [self.bufferedEvents addObject:[event copy]];
         }
+        self.numDroppedEvents += numDropped;
+    }
+    if (numDropped > 0) {
+        [SFSDKAnalyticsLogger w:[self class] format:@"Write buffer full, dropped %lu events", (unsigned long) numDropped];
+    }
+    if (scheduleWrite) {
+        dispatch_async(self.ioQueue, ^{
+            [self writeBufferedEvents];
+        });
     }
 }
 
-- (void) storeEvents:(NSArray<SFSDKInstrumentationEvent *> *) events {
-    if (!events || [events count] == 0) {
-        return;
+- (void) flush {
+    dispatch_sync(self.ioQueue, ^{
+        [self writeBufferedEvents];
+    });
+}
+
+// Runs on the I/O queue
+- (void) writeBufferedEvents {
+    NSArray<SFSDKInstrumentationEvent *> *events = nil;
+    @synchronized (self.bufferedEvents) {
+        events = [self.bufferedEvents copy];
+        [self.bufferedEvents removeAllObjects];
     }
-    if (![self shouldStoreEvent]) {
+    if (events.count == 0 || ![self shouldStoreEvent]) {
         return;
     }
-    for (SFSDKInstrumentationEvent* event in events) {
-        [self storeEvent:event];
+
+    // All the events go into the log as one record, as many as the limit allows.
+    NSInteger capacity = self.maxEvents - (NSInteger) self.eventLog.count;
+    NSMutableArray<NSData *> *eventData = [[NSMutableArray alloc] init];
+    NSMutableArray<NSString *> *eventIds = [[NSMutableArray alloc] init];
+    for (SFSDKInstrumentationEvent *event in events) {
+        if ((NSInteger) eventIds.count >= capacity) {
+            break;
+        }
+
+        NSData *json = [event jsonRepresentation];
+        if (!event.eventId || !json) {
+            continue;
+        }
+        [eventData addObject:json];
+        [eventIds addObject:event.eventId];
+    }
+    if (eventIds.count > 0 && ![self.eventLog appendEventData:eventData eventIds:eventIds]) {
+        [SFSDKAnalyticsLogger w:[self class] format:@"Error occurred while storing %lu events", (unsigned long) eventIds.count];
     }
 }
 
 - (NSInteger) numStoredEvents {
-    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.storeDirectory error:nil];
-    NSInteger fileCount = 0;
-    if (files) {
-        fileCount = files.count;
-    }
-    return fileCount;
+    [self flush];
+    return self.eventLog.count;
 }
 
 - (SFSDKInstrumentationEvent *) fetchEvent:(NSString *) eventId {
     if (!eventId) {
         return nil;
     }
-    NSString *filePath = [self filenameForEvent:eventId];
-    return [self fetchEventFromFile:filePath];
+    [self flush];
+    return [self eventFromData:[self.eventLog dataForEventId:eventId]];
 }
 
 - (NSArray<SFSDKInstrumentationEvent *> *) fetchAllEvents {
-    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.storeDirectory error:nil];
+    [self flush];
     NSMutableArray *events = [[NSMutableArray alloc] init];
-    for (NSString *file in files) {
-        SFSDKInstrumentationEvent *event = [self fetchEventFromFile:[self filenameForEvent:file]];
+    [self.eventLog enumerateEventsUsingBlock:^(NSString *eventId, NSData *data, BOOL *stop) {
+        SFSDKInstrumentationEvent *event = [self eventFromData:data];
         if (event) {
             [events addObject:event];
         }
-    }
+    }];
+    return events;
+}
+
+- (NSArray<SFSDKInstrumentationEvent *> *) fetchEventsWithMaxCount:(NSUInteger) maxCount maxBytes:(NSUInteger) maxBytes {
+    NSMutableArray *events = [[NSMutableArray alloc] init];
+    if (maxCount == 0) {
+        return events;
+    }
+    [self flush];
+    __block NSUInteger numBytes = 0;
+    [self.eventLog enumerateEventsUsingBlock:^(NSString *eventId, NSData *data, BOOL *stop) {
+        if (events.count > 0 && numBytes + data.length > maxBytes) {
+            *stop = YES;
+            return;
+        }
+        SFSDKInstrumentationEvent *event = [self eventFromData:data];
+        if (event) {
+            [events addObject:event];
+            numBytes += data.length;
+        }
+        *stop = (events.count >= maxCount);
+    }];
     return events;
 }
 
@@ -139,52 +211,39 @@
     if (!eventId) {
         return NO;
     }
-    NSFileManager *fileManager = [NSFileManager defaultManager];
-    NSString *filePath = [self filenameForEvent:eventId];
-    if ([fileManager fileExistsAtPath:filePath]) {
-        return [fileManager removeItemAtPath:filePath error:nil];
+    [self flush];
+    if (![self.eventLog containsEventId:eventId]) {
+        return NO;
     }
-    return NO;
+    [self.eventLog removeEventIds:@[eventId]];
+    return YES;
 }
 
 - (void) deleteEvents:(NSArray<NSString *> *) eventIds {
     if (!eventIds || [eventIds count] == 0) {
         return;
     }
-    for (NSString* eventId in eventIds) {
-        [self deleteEvent:eventId];
-    }
+    [self flush];
+    [self.eventLog removeEventIds:eventIds];
 }
 
 - (void) deleteAllEvents {
-    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.storeDirectory error:nil];
-    for (NSString *file in files) {
-        NSFileManager *fileManager = [NSFileManager defaultManager];
-        NSString *filePath = [self filenameForEvent:file];
-        if ([fileManager fileExistsAtPath:filePath]) {
-            [fileManager removeItemAtPath:filePath error:nil];
-        }
+    @synchronized (self.bufferedEvents) {
+        [self.bufferedEvents removeAllObjects];
     }
+    dispatch_sync(self.ioQueue, ^{
+        [self.eventLog removeAllEvents];
+    });
 }
 
 - (BOOL) shouldStoreEvent {
-    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.storeDirectory error:nil];
-    NSInteger fileCount = 0;
-    if (files) {
-        fileCount = files.count;
-    }
-    return (self.isLoggingEnabled && (fileCount < self.maxEvents));
+    return (self.isLoggingEnabled && ((NSInteger) self.eventLog.count < self.maxEvents));
 }
 
-- (SFSDKInstrumentationEvent *) fetchEventFromFile:(NSString *) file {
-    if (!file) {
+- (SFSDKInstrumentationEvent *) eventFromData:(NSData *) data {
+    if (!data) {
         return nil;
     }
-    NSFileManager *fileManager = [NSFileManager defaultManager];
-    if (![fileManager fileExistsAtPath:file]) {
-        return nil;
-    }
-    NSData *data = self.dataDecryptorBlock([NSData dataWithContentsOfFile:file]);
     SFSDKInstrumentationEvent *event = [[SFSDKInstrumentationEvent alloc] initWithJson:data];
     if (event && event.eventId) {
         return [event copy];
@@ -192,8 +251,4 @@
     return nil;
 }
 
-- (NSString *) filenameForEvent:(NSString *) eventId {
-    return [self.storeDirectory stringByAppendingPathComponent:eventId];
-}
-
 @end
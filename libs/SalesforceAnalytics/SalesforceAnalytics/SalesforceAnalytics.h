@@ -34,4 +34,5 @@
 #import <SalesforceAnalytics/SFSDKTransform.h>
 #import <SalesforceAnalytics/SFSDKAILTNTransform.h>
 #import <SalesforceAnalytics/SFSDKAnalyticsManager.h>
+#import <SalesforceAnalytics/SFSDKEventSamplingPolicy.h>
 #import <SalesforceAnalytics/SFSDKInstrumentationEventBuilder.h>
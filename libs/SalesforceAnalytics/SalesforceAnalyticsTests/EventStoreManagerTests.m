@@ -233,6 +233,131 @@ static NSString * const kTestSessionId = @"TEST_SESSION_ID";
     XCTAssertEqualObjects(event, [events firstObject], @"Stored event should be the same as generated event");
 }
 
+/**
+ * Test for events and deletions persisting across store instances.
+ */
+- (void) testEventsPersistAcrossStoreInstances {
+    SFSDKInstrumentationEvent *event1 = [self createTestEvent];
+    SFSDKInstrumentationEvent *event2 = [self createTestEvent];
+    SFSDKInstrumentationEvent *event3 = [self createTestEvent];
+    [self.storeManager storeEvents:@[event1, event2]];
+    [self.storeManager storeEvent:event3];
+    [self.storeManager deleteEvent:event2.eventId];
+    SFSDKEventStoreManager *reopenedStoreManager = [[SFSDKEventStoreManager alloc] initWithStoreDirectory:self.storeDirectory dataEncryptorBlock:nil dataDecryptorBlock:nil];
+    XCTAssertEqual(2, reopenedStoreManager.numStoredEvents, @"Number of events stored should be 2");
+    NSArray<SFSDKInstrumentationEvent *> *events = [reopenedStoreManager fetchAllEvents];
+    XCTAssertEqual(2, events.count, @"Number of events stored should be 2");
+    XCTAssertEqualObjects(event1, events[0], @"Events should be fetched in the order they were stored");
+    XCTAssertEqualObjects(event3, events[1], @"Events should be fetched in the order they were stored");
+    XCTAssertNil([reopenedStoreManager fetchEvent:event2.eventId], @"Deleted event should not be stored");
+    XCTAssertEqualObjects(event3, [reopenedStoreManager fetchEvent:event3.eventId], @"Stored event should be the same as generated event");
+}
+
+/**
+ * Test for segments being deleted once all their events are deleted.
+ */
+- (void) testSegmentsDeletedWithTheirEvents {
+    NSMutableArray<SFSDKInstrumentationEvent *> *genEvents = [[NSMutableArray alloc] init];
+    for (int i = 0; i < 10; i++) {
+        [genEvents addObject:[self createTestEvent]];
+    }
+    [self.storeManager storeEvents:genEvents];
+    [self.storeManager flush];
+    NSArray<NSString *> *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.storeDirectory error:nil];
+    XCTAssertEqual(1, files.count, @"Events stored together should share one segment");
+    [self.storeManager deleteEvents:[genEvents valueForKey:@"eventId"]];
+    XCTAssertEqual(0, self.storeManager.numStoredEvents, @"Number of events stored should be 0");
+    files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.storeDirectory error:nil];
+    XCTAssertEqual(0, files.count, @"Segment should have been deleted with its events");
+}
+
+/**
+ * Test for events stored one file per event by previous versions being moved into the log.
+ */
+- (void) testMigrationOfEventFiles {
+    SFSDKInstrumentationEvent *event = [self createTestEvent];
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.storeDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+    NSString *eventFile = [self.storeDirectory stringByAppendingPathComponent:event.eventId];
+    [[event jsonRepresentation] writeToFile:eventFile atomically:YES];
+    SFSDKEventStoreManager *migratedStoreManager = [[SFSDKEventStoreManager alloc] initWithStoreDirectory:self.storeDirectory dataEncryptorBlock:nil dataDecryptorBlock:nil];
+    XCTAssertEqual(1, migratedStoreManager.numStoredEvents, @"Number of events stored should be 1");
+    XCTAssertEqualObjects(event, [migratedStoreManager fetchEvent:event.eventId], @"Migrated event should be the same as generated event");
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:eventFile], @"Event file should have been removed");
+    [migratedStoreManager deleteAllEvents];
+}
+
+/**
+ * Benchmark for storing 50k events one at a time, then fetching them all.
+ */
+- (void) testStoreManyEventsPerformance {
+    NSInteger numEvents = 50000;
+    NSMutableArray<SFSDKInstrumentationEvent *> *genEvents = [[NSMutableArray alloc] init];
+    for (NSInteger i = 0; i < numEvents; i++) {
+        [genEvents addObject:[self createTestEvent]];
+    }
+    self.storeManager.maxEvents = numEvents;
+    self.storeManager.maxBufferedEvents = numEvents;
+    [self measureMetrics:@[XCTPerformanceMetric_WallClockTime] automaticallyStartMeasuring:NO forBlock:^{
+        [self startMeasuring];
+        for (SFSDKInstrumentationEvent *event in genEvents) {
+            [self.storeManager storeEvent:event];
+        }
+        NSArray<SFSDKInstrumentationEvent *> *events = [self.storeManager fetchAllEvents];
+        [self stopMeasuring];
+        XCTAssertEqual(numEvents, self.storeManager.numStoredEvents, @"All events should be stored");
+        XCTAssertEqual(numEvents, events.count, @"All events should be fetched");
+        [self.storeManager deleteAllEvents];
+    }];
+}
+
+/**
+ * Test for buffered events being written once flushed.
+ */
+- (void) testFlushWritesBufferedEvents {
+    SFSDKInstrumentationEvent *event = [self createTestEvent];
+    [self.storeManager storeEvent:event];
+    [self.storeManager flush];
+    SFSDKEventStoreManager *reopenedStoreManager = [[SFSDKEventStoreManager alloc] initWithStoreDirectory:self.storeDirectory dataEncryptorBlock:nil dataDecryptorBlock:nil];
+    XCTAssertEqual(1, reopenedStoreManager.numStoredEvents, @"Number of events stored should be 1");
+    XCTAssertEqualObjects(event, [reopenedStoreManager fetchEvent:event.eventId], @"Stored event should be the same as generated event");
+}
+
+/**
+ * Test for the oldest buffered events being dropped when the buffer is full.
+ */
+- (void) testBufferOverflowDropsOldestEvents {
+    NSMutableArray<SFSDKInstrumentationEvent *> *genEvents = [[NSMutableArray alloc] init];
+    for (int i = 0; i < 5; i++) {
+        [genEvents addObject:[self createTestEvent]];
+    }
+    self.storeManager.maxBufferedEvents = 2;
+    self.storeManager.overflowPolicy = SFSDKEventStoreOverflowPolicyDropOldest;
+    [self.storeManager storeEvents:genEvents];
+    NSArray<SFSDKInstrumentationEvent *> *events = [self.storeManager fetchAllEvents];
+    XCTAssertEqual(3, self.storeManager.numDroppedEvents, @"Number of events dropped should be 3");
+    XCTAssertEqual(2, events.count, @"Number of events stored should be 2");
+    XCTAssertEqualObjects(genEvents[3], events[0], @"Newest events should be kept");
+    XCTAssertEqualObjects(genEvents[4], events[1], @"Newest events should be kept");
+}
+
+/**
+ * Test for the events being stored getting dropped when the buffer is full.
+ */
+- (void) testBufferOverflowDropsNewestEvents {
+    NSMutableArray<SFSDKInstrumentationEvent *> *genEvents = [[NSMutableArray alloc] init];
+    for (int i = 0; i < 5; i++) {
+        [genEvents addObject:[self createTestEvent]];
+    }
+    self.storeManager.maxBufferedEvents = 2;
+    self.storeManager.overflowPolicy = SFSDKEventStoreOverflowPolicyDropNewest;
+    [self.storeManager storeEvents:genEvents];
+    NSArray<SFSDKInstrumentationEvent *> *events = [self.storeManager fetchAllEvents];
+    XCTAssertEqual(3, self.storeManager.numDroppedEvents, @"Number of events dropped should be 3");
+    XCTAssertEqual(2, events.count, @"Number of events stored should be 2");
+    XCTAssertEqualObjects(genEvents[0], events[0], @"Oldest events should be kept");
+    XCTAssertEqualObjects(genEvents[1], events[1], @"Oldest events should be kept");
+}
+
 - (SFSDKInstrumentationEvent *) createTestEvent {
     SFSDKInstrumentationEvent *event = [SFSDKInstrumentationEventBuilder buildEventWithBuilderBlock:^(SFSDKInstrumentationEventBuilder *builder) {
         double curTime = 1000 * [[NSDate date] timeIntervalSince1970];
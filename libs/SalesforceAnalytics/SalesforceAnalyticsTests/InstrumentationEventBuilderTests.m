@@ -162,8 +162,63 @@ static NSString * const kTestSessionId = @"TEST_SESSION_ID";
     XCTAssertEqual(0, globalSequenceId - sequenceId);
 }
 
+/**
+ * Test for events being left out according to the sample rate of their name.
+ */
+- (void) testSampleRate {
+    [self.analyticsManager setSamplingPolicy:[SFSDKEventSamplingPolicy policyWithSampleRate:0] forEventName:@"sampledEvent"];
+    XCTAssertNil([self testEventWithName:@"sampledEvent" duration:0], @"Event should be left out by sampling");
+    XCTAssertNotNil([self testEventWithName:@"otherEvent" duration:0], @"Events of other names should be built");
+    [self.analyticsManager setSamplingPolicy:[SFSDKEventSamplingPolicy policyWithSampleRate:1] forEventName:@"sampledEvent"];
+    XCTAssertNotNil([self testEventWithName:@"sampledEvent" duration:0], @"Event should be built");
+}
+
+/**
+ * Test for events being left out once their name reaches its rate limit.
+ */
+- (void) testRateLimit {
+    [self.analyticsManager setSamplingPolicy:[SFSDKEventSamplingPolicy policyWithMaxEvents:2 perInterval:60] forEventName:@"limitedEvent"];
+    XCTAssertNotNil([self testEventWithName:@"limitedEvent" duration:0], @"Event should be built");
+    XCTAssertNotNil([self testEventWithName:@"limitedEvent" duration:0], @"Event should be built");
+    XCTAssertNil([self testEventWithName:@"limitedEvent" duration:0], @"Event should be left out by the rate limit");
+}
+
+/**
+ * Test for events being folded into one aggregate event.
+ */
+- (void) testAggregation {
+    [self.analyticsManager setSamplingPolicy:[SFSDKEventSamplingPolicy aggregationPolicyWithInterval:60] forEventName:@"aggregatedEvent"];
+    for (NSNumber *duration in @[ @5, @20, @20, @200, @20000 ]) {
+        [self.analyticsManager storeEvent:[self testEventWithName:@"aggregatedEvent" duration:duration.integerValue]];
+    }
+    XCTAssertEqual(0, self.analyticsManager.storeManager.numStoredEvents, @"Events should not be stored before their interval is over");
+    [self.analyticsManager flushAggregatedEvents];
+    NSArray<SFSDKInstrumentationEvent *> *events = [self.analyticsManager.storeManager fetchAllEvents];
+    XCTAssertEqual(1, events.count, @"Events should be stored as one aggregate event");
+    NSDictionary *aggregate = events[0].attributes[kSFSDKEventAggregateKey];
+    XCTAssertEqualObjects(@"aggregatedEvent", events[0].name, @"Aggregate event should have the name of its events");
+    XCTAssertEqualObjects(@5, aggregate[@"count"], @"Aggregate event should count its events");
+    XCTAssertEqualObjects(@5, aggregate[@"durationMin"], @"Wrong minimum duration");
+    XCTAssertEqualObjects(@20000, aggregate[@"durationMax"], @"Wrong maximum duration");
+    XCTAssertEqualObjects(@20245, aggregate[@"durationTotal"], @"Wrong total duration");
+    NSArray *expectedCounts = @[ @1, @2, @0, @1, @0, @0, @0, @0, @0, @1 ];
+    XCTAssertEqualObjects(expectedCounts, aggregate[@"durationHistogram"][@"counts"], @"Wrong duration histogram");
+}
+
 #pragma mark - Helper methods
 
+- (SFSDKInstrumentationEvent *) testEventWithName:(NSString *) name duration:(NSInteger) duration {
+    return [SFSDKInstrumentationEventBuilder buildEventWithBuilderBlock:^(SFSDKInstrumentationEventBuilder *builder) {
+        NSInteger curTime = 1000 * [[NSDate date] timeIntervalSince1970];
+        builder.name = name;
+        builder.page = [[NSDictionary alloc] init];
+        builder.startTime = curTime;
+        builder.endTime = (duration > 0) ? curTime + duration : 0;
+        builder.schemaType = SchemaTypePerf;
+        builder.eventType = EventTypeSystem;
+    } analyticsManager:self.analyticsManager];
+}
+
 - (SFSDKInstrumentationEvent *)standardTestEvent {
     return [SFSDKInstrumentationEventBuilder buildEventWithBuilderBlock:^(SFSDKInstrumentationEventBuilder *builder) {
         double curTime = 1000 * [[NSDate date] timeIntervalSince1970];
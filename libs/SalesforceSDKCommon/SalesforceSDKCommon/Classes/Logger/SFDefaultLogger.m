@@ -29,9 +29,9 @@
 
 #import "SFDefaultLogger.h"
 #import <OS/log.h>
+#import <objc/runtime.h>
 
 static NSString * const kLogLevelKey = @"log_level";
-static NSString * const kLogIdentifierFormat = @"CLASS: %@";
 
 @interface SFDefaultLogger ()
 
@@ -49,16 +49,24 @@ static NSString * const kLogIdentifierFormat = @"CLASS: %@";
     self = [super init];
     if (self) {
         self.componentName = componentName;
+        self.logLevel = SFLogLevelDebug;
         NSString *appName = [[NSBundle mainBundle] objectForInfoDictionaryKey:@"CFBundleIdentifier"];
         _logger = os_log_create([appName cStringUsingEncoding: NSUTF8StringEncoding], [componentName cStringUsingEncoding: NSUTF8StringEncoding]);
     }
     return self;
 }
 
+- (BOOL)isLevelEnabled:(SFLogLevel)level {
+    return SFLogLevelSeverity(level) >= SFLogLevelSeverity(self.logLevel) && os_log_type_enabled(_logger, (os_log_type_t)level);
+}
+
 - (void)log:(Class)cls level:(SFLogLevel)level message:(NSString *)message {
-    const char *tag = [[NSString stringWithFormat:kLogIdentifierFormat, cls] cStringUsingEncoding:NSUTF8StringEncoding];
-    const char * messageZ = [message cStringUsingEncoding:NSUTF8StringEncoding];
-    os_log_with_type(_logger, level,"%{public}s %{public}s",tag,messageZ);
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
+
+    // The class name kept by the runtime serves as tag, nothing gets built for it.
+    os_log_with_type(_logger, level, "CLASS: %{public}s %{public}@", class_getName(cls), message);
 }
 
 - (void)log:(Class)cls level:(SFLogLevel)level format:(NSString *)format, ... {
@@ -69,6 +77,9 @@ static NSString * const kLogIdentifierFormat = @"CLASS: %@";
 }
 
 - (void)log:(Class)cls level:(SFLogLevel)level format:(NSString *)format args:(va_list)args {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
     NSString *formattedMessage = [[NSString alloc] initWithFormat:format arguments:args];
     [self log:cls level:level message:formattedMessage];
 }
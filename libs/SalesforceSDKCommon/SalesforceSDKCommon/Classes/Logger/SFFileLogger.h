@@ -0,0 +1,136 @@
+/*
+ SFFileLogger.h
+ SalesforceSDKCommon
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFLogger.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Block encrypting or decrypting a chunk of log data.
+ */
+typedef NSData * _Nullable (^SFFileLoggerCryptoBlock)(NSData *data);
+
+/**
+ * SFLogging implementation writing log lines to rotating files, for logs that can be pulled from devices.
+ *
+ * Logging a line only puts it in a fixed-size ring buffer, without taking any lock. A background
+ * queue drains the buffer into the current log file. Once that file reaches `maxFileSize`, it is
+ * rotated and the oldest files beyond `maxFileCount` are deleted. Lines logged while the buffer is
+ * full are dropped and counted, so memory use stays bounded when logging outruns the disk.
+ *
+ * Loggers created through SFLogger (see +[SFLogger setInstanceClass:]) use the class-wide defaults.
+ */
+@interface SFFileLogger : NSObject <SFLogging>
+
+/**
+ * Directory log files are written to, in a subdirectory per component. Library/Logs/Salesforce by default.
+ */
+@property (class, nonatomic, copy) NSString *defaultLogDirectory;
+
+/**
+ * Size (in bytes) log files are rotated at. 1MB by default.
+ */
+@property (class, nonatomic, assign) NSUInteger defaultMaxFileSize;
+
+/**
+ * Number of log files kept per component, current file included. 5 by default.
+ */
+@property (class, nonatomic, assign) NSUInteger defaultMaxFileCount;
+
+/**
+ * Block encrypting log data before it gets written, nil to write plain text. nil by default.
+ */
+@property (class, nonatomic, copy, nullable) SFFileLoggerCryptoBlock defaultEncryptionBlock;
+
+/**
+ * Directory of the log files of this logger.
+ */
+@property (nonatomic, readonly, copy) NSString *directory;
+
+/**
+ * Size (in bytes) log files are rotated at.
+ */
+@property (nonatomic, readonly, assign) NSUInteger maxFileSize;
+
+/**
+ * Number of log files kept, current file included.
+ */
+@property (nonatomic, readonly, assign) NSUInteger maxFileCount;
+
+/**
+ * Number of lines dropped because the ring buffer was full.
+ */
+@property (nonatomic, readonly, assign) NSUInteger numDroppedLines;
+
+/**
+ * Initializes a logger with the class-wide defaults. Lines of the info level and above get logged by default.
+ *
+ * @param componentName Component name.
+ * @return Instance of this class.
+ */
+- (instancetype)initWithComponent:(NSString *)componentName;
+
+/**
+ * Initializes a logger. Lines of the info level and above get logged by default.
+ *
+ * @param componentName Component name.
+ * @param directory Directory of the log files.
+ * @param maxFileSize Size (in bytes) log files are rotated at.
+ * @param maxFileCount Number of log files kept, current file included.
+ * @param bufferCapacity Number of lines the ring buffer holds, rounded up to a power of 2.
+ * @param encryptionBlock Block encrypting log data before it gets written, nil to write plain text.
+ * @return Instance of this class.
+ */
+- (instancetype)initWithComponent:(NSString *)componentName directory:(NSString *)directory maxFileSize:(NSUInteger)maxFileSize maxFileCount:(NSUInteger)maxFileCount bufferCapacity:(NSUInteger)bufferCapacity encryptionBlock:(nullable SFFileLoggerCryptoBlock)encryptionBlock NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Blocks until the lines logged so far are written.
+ */
+- (void)flush;
+
+/**
+ * Returns the paths of the log files, from the oldest to the current one.
+ *
+ * @return Paths of the log files.
+ */
+- (NSArray<NSString *> *)logFilePaths;
+
+/**
+ * Returns the contents of a log file, decrypting them if it was encrypted.
+ *
+ * @param path Path of the log file.
+ * @param decryptionBlock Block decrypting the data encrypted by the encryption block of the logger, nil if it wasn't encrypted.
+ * @return Log lines, nil if the file can't be read or decrypted.
+ */
++ (nullable NSData *)contentsOfLogFileAtPath:(NSString *)path decryptionBlock:(nullable SFFileLoggerCryptoBlock)decryptionBlock;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,435 @@
+/*
+ SFFileLogger.m
+ SalesforceSDKCommon
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFFileLogger.h"
+#import <stdatomic.h>
+#import <objc/runtime.h>
+
+static NSString * const kLogFileExtension = @"log";
+static NSString * const kLogDateFormat = @"yyyy-MM-dd HH:mm:ss.SSS";
+static NSUInteger const kDefaultBufferCapacity = 1024;
+static NSUInteger const kMaxMessageLength = 4096;
+static NSUInteger const kMaxChunkSize = 64 * 1024;
+
+static NSString *DefaultLogDirectory = nil;
+static NSUInteger DefaultMaxFileSize = 1024 * 1024;
+static NSUInteger DefaultMaxFileCount = 5;
+static SFFileLoggerCryptoBlock DefaultEncryptionBlock = nil;
+
+// Log line waiting in the ring buffer
+@interface SFFileLogEntry : NSObject
+
+@property (nonatomic, assign) NSTimeInterval timestamp;
+@property (nonatomic, assign) SFLogLevel level;
+@property (nonatomic, assign) const char *className;
+@property (nonatomic, copy) NSString *message;
+
+@end
+
+@implementation SFFileLogEntry
+@end
+
+// Slot of the ring buffer, its sequence tells producers and the consumer whose turn it is
+typedef struct {
+    atomic_size_t sequence;
+    void *entry;
+} SFFileLogSlot;
+
+@interface SFFileLogger () {
+    SFFileLogSlot *_slots;
+    size_t _mask;
+    atomic_size_t _enqueuePosition;
+    size_t _dequeuePosition;
+    atomic_bool _drainScheduled;
+    atomic_size_t _numDroppedLines;
+}
+
+@property (nonatomic, readwrite, strong) NSString *componentName;
+@property (nonatomic, readwrite, copy) NSString *directory;
+@property (nonatomic, readwrite, assign) NSUInteger maxFileSize;
+@property (nonatomic, readwrite, assign) NSUInteger maxFileCount;
+@property (nonatomic, readwrite, copy) SFFileLoggerCryptoBlock encryptionBlock;
+@property (nonatomic, readwrite, strong) dispatch_queue_t drainQueue;
+@property (nonatomic, readwrite, strong) NSFileHandle *fileHandle;
+@property (nonatomic, readwrite, assign) unsigned long long fileSize;
+@property (nonatomic, readwrite, strong) NSDateFormatter *dateFormatter;
+
+@end
+
+@implementation SFFileLogger
+
+@synthesize componentName;
+@synthesize logLevel;
+
+#pragma mark - Defaults
+
++ (NSString *)defaultLogDirectory {
+    @synchronized ([SFFileLogger class]) {
+        if (!DefaultLogDirectory) {
+            NSString *libraryDirectory = [NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES) firstObject];
+            DefaultLogDirectory = [[libraryDirectory stringByAppendingPathComponent:@"Logs"] stringByAppendingPathComponent:@"Salesforce"];
+        }
+        return DefaultLogDirectory;
+    }
+}
+
++ (void)setDefaultLogDirectory:(NSString *)directory {
+    @synchronized ([SFFileLogger class]) {
+        DefaultLogDirectory = [directory copy];
+    }
+}
+
++ (NSUInteger)defaultMaxFileSize {
+    @synchronized ([SFFileLogger class]) {
+        return DefaultMaxFileSize;
+    }
+}
+
++ (void)setDefaultMaxFileSize:(NSUInteger)maxFileSize {
+    @synchronized ([SFFileLogger class]) {
+        DefaultMaxFileSize = maxFileSize;
+    }
+}
+
++ (NSUInteger)defaultMaxFileCount {
+    @synchronized ([SFFileLogger class]) {
+        return DefaultMaxFileCount;
+    }
+}
+
++ (void)setDefaultMaxFileCount:(NSUInteger)maxFileCount {
+    @synchronized ([SFFileLogger class]) {
+        DefaultMaxFileCount = maxFileCount;
+    }
+}
+
++ (SFFileLoggerCryptoBlock)defaultEncryptionBlock {
+    @synchronized ([SFFileLogger class]) {
+        return DefaultEncryptionBlock;
+    }
+}
+
++ (void)setDefaultEncryptionBlock:(SFFileLoggerCryptoBlock)encryptionBlock {
+    @synchronized ([SFFileLogger class]) {
+        DefaultEncryptionBlock = [encryptionBlock copy];
+    }
+}
+
+#pragma mark - Init
+
+- (instancetype)initWithComponent:(NSString *)componentName {
+    NSString *directory = [[SFFileLogger defaultLogDirectory] stringByAppendingPathComponent:componentName];
+    return [self initWithComponent:componentName directory:directory maxFileSize:[SFFileLogger defaultMaxFileSize] maxFileCount:[SFFileLogger defaultMaxFileCount] bufferCapacity:kDefaultBufferCapacity encryptionBlock:[SFFileLogger defaultEncryptionBlock]];
+}
+
+- (instancetype)initWithComponent:(NSString *)componentName directory:(NSString *)directory maxFileSize:(NSUInteger)maxFileSize maxFileCount:(NSUInteger)maxFileCount bufferCapacity:(NSUInteger)bufferCapacity encryptionBlock:(SFFileLoggerCryptoBlock)encryptionBlock {
+    self = [super init];
+    if (self) {
+        self.componentName = componentName;
+        self.directory = directory;
+        self.maxFileSize = maxFileSize;
+        self.maxFileCount = MAX(maxFileCount, 1);
+        self.encryptionBlock = encryptionBlock;
+        self.logLevel = SFLogLevelInfo;
+        size_t capacity = 2;
+        while (capacity < bufferCapacity) {
+            capacity <<= 1;
+        }
+        _slots = calloc(capacity, sizeof(SFFileLogSlot));
+        for (size_t i = 0; i < capacity; i++) {
+            atomic_init(&_slots[i].sequence, i);
+        }
+        _mask = capacity - 1;
+        atomic_init(&_enqueuePosition, 0);
+        _dequeuePosition = 0;
+        atomic_init(&_drainScheduled, false);
+        atomic_init(&_numDroppedLines, 0);
+        dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        self.drainQueue = dispatch_queue_create("com.salesforce.logger.file", attributes);
+        self.dateFormatter = [[NSDateFormatter alloc] init];
+        self.dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        self.dateFormatter.dateFormat = kLogDateFormat;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (size_t i = 0; i <= _mask; i++) {
+        if (_slots[i].entry) {
+            CFRelease(_slots[i].entry);
+        }
+    }
+    free(_slots);
+    [_fileHandle closeFile];
+}
+
+- (id)logger {
+    return self;
+}
+
+- (NSUInteger)numDroppedLines {
+    return atomic_load_explicit(&_numDroppedLines, memory_order_relaxed);
+}
+
+#pragma mark - SFLogging
+
+- (BOOL)isLevelEnabled:(SFLogLevel)level {
+    return SFLogLevelSeverity(level) >= SFLogLevelSeverity(self.logLevel);
+}
+
+- (void)log:(Class)cls level:(SFLogLevel)level message:(NSString *)message {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
+    if (message.length > kMaxMessageLength) {
+        message = [message substringWithRange:[message rangeOfComposedCharacterSequencesForRange:NSMakeRange(0, kMaxMessageLength)]];
+    }
+    SFFileLogEntry *entry = [[SFFileLogEntry alloc] init];
+    entry.timestamp = [NSDate timeIntervalSinceReferenceDate];
+    entry.level = level;
+    entry.className = class_getName(cls);
+    entry.message = message;
+    if (![self enqueueEntry:entry]) {
+        atomic_fetch_add_explicit(&_numDroppedLines, 1, memory_order_relaxed);
+        return;
+    }
+
+    // Only the first line logged since the last drain schedules the next one.
+    if (!atomic_exchange_explicit(&_drainScheduled, true, memory_order_acq_rel)) {
+        dispatch_async(self.drainQueue, ^{
+            [self drain];
+        });
+    }
+}
+
+- (void)log:(Class)cls level:(SFLogLevel)level format:(NSString *)format, ... {
+    va_list args;
+    va_start(args, format);
+    [self log:cls level:level format:format args:args];
+    va_end(args);
+}
+
+- (void)log:(Class)cls level:(SFLogLevel)level format:(NSString *)format args:(va_list)args {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
+    NSString *formattedMessage = [[NSString alloc] initWithFormat:format arguments:args];
+    [self log:cls level:level message:formattedMessage];
+}
+
+#pragma mark - Ring buffer
+
+// Any thread, bounded multi-producer queue: producers claim a position, fill its slot, then publish it.
+- (BOOL)enqueueEntry:(SFFileLogEntry *)entry {
+    size_t position = atomic_load_explicit(&_enqueuePosition, memory_order_relaxed);
+    SFFileLogSlot *slot = NULL;
+    for (;;) {
+        slot = &_slots[position & _mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&_enqueuePosition, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return NO;
+        } else {
+            position = atomic_load_explicit(&_enqueuePosition, memory_order_relaxed);
+        }
+    }
+    slot->entry = (void *)CFBridgingRetain(entry);
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return YES;
+}
+
+// Drain queue only
+- (SFFileLogEntry *)dequeueEntry {
+    SFFileLogSlot *slot = &_slots[_dequeuePosition & _mask];
+    size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (sequence != _dequeuePosition + 1) {
+        return nil;
+    }
+    SFFileLogEntry *entry = CFBridgingRelease(slot->entry);
+    slot->entry = NULL;
+    atomic_store_explicit(&slot->sequence, _dequeuePosition + _mask + 1, memory_order_release);
+    _dequeuePosition++;
+    return entry;
+}
+
+#pragma mark - Files
+
+- (void)flush {
+    dispatch_sync(self.drainQueue, ^{
+        [self drain];
+        [self.fileHandle synchronizeFile];
+    });
+}
+
+// Drain queue only
+- (void)drain {
+    atomic_exchange_explicit(&_drainScheduled, false, memory_order_acq_rel);
+    NSMutableData *lines = [[NSMutableData alloc] init];
+    NSUInteger numLines = 0;
+    SFFileLogEntry *entry = nil;
+    while ((entry = [self dequeueEntry])) {
+        NSString *date = [self.dateFormatter stringFromDate:[NSDate dateWithTimeIntervalSinceReferenceDate:entry.timestamp]];
+        NSString *line = [NSString stringWithFormat:@"%@ %@ CLASS: %s %@\n", date, [self nameOfLevel:entry.level], entry.className, entry.message];
+        [lines appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+        numLines++;
+        if (lines.length >= kMaxChunkSize) {
+            [self writeLines:lines count:numLines];
+            lines = [[NSMutableData alloc] init];
+            numLines = 0;
+        }
+    }
+    if (numLines > 0) {
+        [self writeLines:lines count:numLines];
+    }
+}
+
+- (void)writeLines:(NSData *)lines count:(NSUInteger)numLines {
+    NSData *chunk = lines;
+
+    // Encrypted chunks are written as records prefixed with their length, so they can be decrypted one by one.
+    if (self.encryptionBlock) {
+        NSData *encryptedLines = self.encryptionBlock(lines);
+        if (!encryptedLines) {
+            atomic_fetch_add_explicit(&_numDroppedLines, numLines, memory_order_relaxed);
+            return;
+        }
+        uint32_t length = CFSwapInt32HostToBig((uint32_t)encryptedLines.length);
+        NSMutableData *record = [[NSMutableData alloc] initWithBytes:&length length:sizeof(length)];
+        [record appendData:encryptedLines];
+        chunk = record;
+    }
+    if (!self.fileHandle && ![self openCurrentFile]) {
+        atomic_fetch_add_explicit(&_numDroppedLines, numLines, memory_order_relaxed);
+        return;
+    }
+    if (self.fileSize > 0 && self.fileSize + chunk.length > self.maxFileSize) {
+        [self rotateFiles];
+        if (![self openCurrentFile]) {
+            atomic_fetch_add_explicit(&_numDroppedLines, numLines, memory_order_relaxed);
+            return;
+        }
+    }
+    @try {
+        [self.fileHandle writeData:chunk];
+        self.fileSize += chunk.length;
+    } @catch (NSException *exception) {
+        atomic_fetch_add_explicit(&_numDroppedLines, numLines, memory_order_relaxed);
+        [self.fileHandle closeFile];
+        self.fileHandle = nil;
+    }
+}
+
+- (BOOL)openCurrentFile {
+    NSFileManager *manager = [NSFileManager defaultManager];
+    NSString *path = [self pathOfLogFileAtIndex:0];
+    if (![manager fileExistsAtPath:path]) {
+        [manager createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+        if (![manager createFileAtPath:path contents:nil attributes:nil]) {
+            return NO;
+        }
+    }
+    self.fileHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+    self.fileSize = [self.fileHandle seekToEndOfFile];
+    return (self.fileHandle != nil);
+}
+
+// The current file becomes file 1, file 1 becomes file 2, and so on, the oldest one gets deleted.
+- (void)rotateFiles {
+    [self.fileHandle closeFile];
+    self.fileHandle = nil;
+    self.fileSize = 0;
+    NSFileManager *manager = [NSFileManager defaultManager];
+    [manager removeItemAtPath:[self pathOfLogFileAtIndex:self.maxFileCount - 1] error:nil];
+    for (NSUInteger i = self.maxFileCount - 1; i > 0; i--) {
+        [manager moveItemAtPath:[self pathOfLogFileAtIndex:i - 1] toPath:[self pathOfLogFileAtIndex:i] error:nil];
+    }
+}
+
+- (NSString *)pathOfLogFileAtIndex:(NSUInteger)index {
+    NSString *name = (index == 0) ? self.componentName : [NSString stringWithFormat:@"%@.%lu", self.componentName, (unsigned long)index];
+    return [self.directory stringByAppendingPathComponent:[name stringByAppendingPathExtension:kLogFileExtension]];
+}
+
+- (NSArray<NSString *> *)logFilePaths {
+    NSMutableArray<NSString *> *paths = [[NSMutableArray alloc] init];
+    for (NSUInteger i = self.maxFileCount; i > 0; i--) {
+        NSString *path = [self pathOfLogFileAtIndex:i - 1];
+        if ([[NSFileManager defaultManager] fileExistsAtPath:path]) {
+            [paths addObject:path];
+        }
+    }
+    return paths;
+}
+
+- (NSString *)nameOfLevel:(SFLogLevel)level {
+    switch (level) {
+        case SFLogLevelDebug:
+            return @"DEBUG";
+        case SFLogLevelInfo:
+            return @"INFO";
+        case SFLogLevelDefault:
+            return @"DEFAULT";
+        case SFLogLevelError:
+            return @"ERROR";
+        case SFLogLevelFault:
+            return @"FAULT";
+    }
+    return @"DEFAULT";
+}
+
++ (NSData *)contentsOfLogFileAtPath:(NSString *)path decryptionBlock:(SFFileLoggerCryptoBlock)decryptionBlock {
+    NSData *contents = [NSData dataWithContentsOfFile:path];
+    if (!contents || !decryptionBlock) {
+        return contents;
+    }
+    NSMutableData *lines = [[NSMutableData alloc] init];
+    NSUInteger offset = 0;
+    while (offset + sizeof(uint32_t) <= contents.length) {
+        uint32_t length = 0;
+        [contents getBytes:&length range:NSMakeRange(offset, sizeof(length))];
+        length = CFSwapInt32BigToHost(length);
+        offset += sizeof(length);
+
+        // A record cut short by the app being killed mid-write ends the file.
+        if (offset + length > contents.length) {
+            break;
+        }
+        NSData *decryptedLines = decryptionBlock([contents subdataWithRange:NSMakeRange(offset, length)]);
+        if (!decryptedLines) {
+            return nil;
+        }
+        [lines appendData:decryptedLines];
+        offset += length;
+    }
+    return lines;
+}
+
+@end
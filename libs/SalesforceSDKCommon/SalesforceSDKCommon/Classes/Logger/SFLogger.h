@@ -36,7 +36,22 @@ typedef NS_ENUM(NSUInteger, SFLogLevel){
     SFLogLevelFault   =  OS_LOG_TYPE_FAULT
 } NS_SWIFT_NAME(SalesforceLogger.Level);
 
+/**
+ * Ranks log levels from the most verbose (debug) to the most severe (fault), since their
+ * os_log values aren't in that order.
+ *
+ * @param level Log level.
+ * @return Rank of the log level.
+ */
+FOUNDATION_EXTERN NSUInteger SFLogLevelSeverity(SFLogLevel level);
+
 NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Block returning a log message, only called if the message gets logged.
+ */
+typedef NSString * _Nonnull (^SFLogMessageBlock)(void);
+
 @protocol SFLogging <NSObject>
 
 /**
@@ -92,6 +107,16 @@ NS_ASSUME_NONNULL_BEGIN
 
 @optional
 + (nonnull instancetype)sharedInstanceWithComponent:(nonnull NSString *)componentName;
+
+/**
+ * Returns whether log lines of the specified level get logged. Log lines of levels for which
+ * this returns NO are dropped before their message is formatted. All levels get logged if
+ * this isn't implemented.
+ *
+ * @param level Log level.
+ * @return YES if log lines of this level get logged, NO otherwise.
+ */
+- (BOOL)isLevelEnabled:(SFLogLevel)level;
 @end
 NS_SWIFT_NAME(SalesforceLogger)
 @interface SFLogger : NSObject
@@ -102,6 +127,23 @@ NS_SWIFT_NAME(SalesforceLogger)
  */
 @property (nonatomic, readwrite, assign) SFLogLevel logLevel NS_SWIFT_NAME(level);
 
+/**
+ * Returns whether log lines of the specified level get logged.
+ *
+ * @param level Log level.
+ * @return YES if log lines of this level get logged, NO otherwise.
+ */
+- (BOOL)isLevelEnabled:(SFLogLevel)level;
+
+/**
+ * Logs a log line of the specified level. The message block is only called if the log line gets logged.
+ *
+ * @param cls Class.
+ * @param level Log level.
+ * @param messageBlock Block returning the log message.
+ */
+- (void)log:(nonnull Class)cls level:(SFLogLevel)level messageBlock:(nonnull SFLogMessageBlock)messageBlock;
+
 /**
  * Logs an error log line.
  *
@@ -344,6 +386,23 @@ NS_SWIFT_NAME(SalesforceLogger)
  */
 + (void)log:(nonnull Class)cls level:(SFLogLevel)level format:(nonnull NSString *)format, ...;
 
+/**
+ * Logs a log line of the specified level. The message block is only called if the log line gets logged.
+ *
+ * @param cls Class.
+ * @param level Log level.
+ * @param messageBlock Block returning the log message.
+ */
++ (void)log:(nonnull Class)cls level:(SFLogLevel)level messageBlock:(nonnull SFLogMessageBlock)messageBlock;
+
+/**
+ * Returns whether log lines of the specified level get logged.
+ *
+ * @param level Log level.
+ * @return YES if log lines of this level get logged, NO otherwise.
+ */
++ (BOOL)isLevelEnabled:(SFLogLevel)level;
+
 /**
  * Returns current log level used by this logger.
  *
@@ -29,16 +29,37 @@
 
 #import "SFLogger.h"
 #import "SFDefaultLogger.h"
-#import "SFSDKSafeMutableDictionary.h"
+#import <stdatomic.h>
 static NSString * const kDefaultComponentName = @"SFSDK";
 
 static Class InstanceClass;
-static SFSDKSafeMutableDictionary *loggerList = nil;
+
+NSUInteger SFLogLevelSeverity(SFLogLevel level) {
+    switch (level) {
+        case SFLogLevelDebug:
+            return 0;
+        case SFLogLevelInfo:
+            return 1;
+        case SFLogLevelDefault:
+            return 2;
+        case SFLogLevelError:
+            return 3;
+        case SFLogLevelFault:
+            return 4;
+    }
+    return 2;
+}
+
+// Immutable dictionary of the component loggers, replaced as a whole when a component gets added.
+// Lookups read it without locking. Replaced dictionaries are never released since readers may
+// still be using them, there are only as many as components ever created.
+static _Atomic(void *) loggerList = NULL;
 
 @interface SFLogger()
 - (instancetype)init:(NSString *)componentName;
 + (void)clearAllComponents;
 @property id<SFLogging> logger;
+@property (nonatomic, assign) BOOL loggerChecksLevel;
 
 @end
 
@@ -54,6 +75,7 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
         } else {
             self.logger = [[InstanceClass alloc] initWithComponent:componentName];
         }
+        self.loggerChecksLevel = [self.logger respondsToSelector:@selector(isLevelEnabled:)];
     }
     return self;
 }
@@ -65,11 +87,19 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 -(void)setLogLevel:(SFLogLevel) logLevel {
     [self.logger setLogLevel:logLevel];
 }
+
+- (BOOL)isLevelEnabled:(SFLogLevel)level {
+    return !self.loggerChecksLevel || [self.logger isLevelEnabled:level];
+}
+
 - (void)log:(nonnull Class)cls message:(nonnull NSString *)message {
-    [self.logger log:cls level:SFLogLevelDefault message:message];
+    [self log:cls level:SFLogLevelDefault message:message];
 }
 
 - (void)log:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    if (![self isLevelEnabled:SFLogLevelDefault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:SFLogLevelDefault format:format args:args];
@@ -77,10 +107,16 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 - (void)log:(Class)cls level:(SFLogLevel)level message:(NSString *)message {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
     [self.logger log:cls level:level message:message];
 }
 
 - (void)log:(Class)cls level:(SFLogLevel)level format:(NSString *)format, ... {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:level format:format args:args];
@@ -88,14 +124,27 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 - (void)log:(Class)cls level:(SFLogLevel)level format:(NSString *)format args:(va_list)args {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
     [self.logger log:cls level:level format:format args:args];
 }
 
+- (void)log:(Class)cls level:(SFLogLevel)level messageBlock:(SFLogMessageBlock)messageBlock {
+    if (![self isLevelEnabled:level]) {
+        return;
+    }
+    [self.logger log:cls level:level message:messageBlock()];
+}
+
 - (void)e:(nonnull Class)cls message:(nonnull NSString *)message {
-    [self.logger log:cls level:SFLogLevelError message:message];
+    [self log:cls level:SFLogLevelError message:message];
 }
 
 - (void)e:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    if (![self isLevelEnabled:SFLogLevelError]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:SFLogLevelError format:format args:args];
@@ -103,10 +152,13 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 - (void)f:(nonnull Class)cls message:(nonnull NSString *)message {
-    [self.logger log:cls level:SFLogLevelFault message:message];
+    [self log:cls level:SFLogLevelFault message:message];
 }
 
 - (void)f:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    if (![self isLevelEnabled:SFLogLevelFault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:SFLogLevelFault format:format args:args];
@@ -114,10 +166,13 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 - (void)i:(nonnull Class)cls message:(nonnull NSString *)message {
-    [self.logger log:cls level:SFLogLevelInfo message:message];
+    [self log:cls level:SFLogLevelInfo message:message];
 }
 
 - (void)i:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    if (![self isLevelEnabled:SFLogLevelInfo]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:SFLogLevelInfo format:format args:args];
@@ -125,10 +180,13 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 - (void)d:(nonnull Class)cls message:(nonnull NSString *)message {
-    [self.logger log:cls level:SFLogLevelDebug message:message];
+    [self log:cls level:SFLogLevelDebug message:message];
 }
 
 - (void)d:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    if (![self isLevelEnabled:SFLogLevelDebug]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:SFLogLevelDebug format:format args:args];
@@ -136,10 +194,13 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 - (void)w:(nonnull Class)cls message:(nonnull NSString *)message {
-    [self.logger log:cls level:SFLogLevelDefault message:message];
+    [self log:cls level:SFLogLevelDefault message:message];
 }
 
 - (void)w:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    if (![self isLevelEnabled:SFLogLevelDefault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
     [self.logger log:cls level:SFLogLevelDefault format:format args:args];
@@ -147,7 +208,9 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 + (void)clearAllComponents {
-    [loggerList removeAllObjects];
+    @synchronized ([SFLogger class]) {
+        atomic_store_explicit(&loggerList, (void *)CFBridgingRetain(@{}), memory_order_release);
+    }
 }
 
 + (SFLogLevel)logLevel {
@@ -158,65 +221,93 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
     [[self defaultLogger] setLogLevel:logLevel];
 }
 
++ (BOOL)isLevelEnabled:(SFLogLevel)level {
+    return [[self defaultLogger] isLevelEnabled:level];
+}
+
 + (void)e:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelError]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelError format:format args:args];
+    [logger log:cls level:SFLogLevelError format:format args:args];
     va_end(args);
 }
 
 + (void)e:(nonnull Class)cls message:(nonnull NSString *)message {
-    [[self defaultLogger] e:cls message:message];
+    [[self defaultLogger] log:cls level:SFLogLevelError message:message];
 }
 
 + (void)d:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelDebug]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelDebug format:format args:args];
+    [logger log:cls level:SFLogLevelDebug format:format args:args];
     va_end(args);
 }
 
 + (void)d:(nonnull Class)cls message:(nonnull NSString *)message {
-    [[self defaultLogger] e:cls message:message];
+    [[self defaultLogger] log:cls level:SFLogLevelDebug message:message];
 }
 
 + (void)w:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelDefault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelDefault format:format args:args];
+    [logger log:cls level:SFLogLevelDefault format:format args:args];
     va_end(args);
 }
 
 + (void)w:(nonnull Class)cls message:(nonnull NSString *)message {
-    [[self defaultLogger] log:cls message:message];
+    [[self defaultLogger] log:cls level:SFLogLevelDefault message:message];
 }
 
 + (void)i:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelInfo]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelInfo format:format args:args];
+    [logger log:cls level:SFLogLevelInfo format:format args:args];
     va_end(args);
 }
 
 + (void)i:(nonnull Class)cls message:(nonnull NSString *)message {
-    [[self defaultLogger] i:cls message:message];
+    [[self defaultLogger] log:cls level:SFLogLevelInfo message:message];
 }
 
 + (void)f:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelFault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelFault format:format args:args];
+    [logger log:cls level:SFLogLevelFault format:format args:args];
     va_end(args);
 }
 
 + (void)f:(nonnull Class)cls message:(nonnull NSString *)message {
-    [[self defaultLogger] f:cls message:message];
+    [[self defaultLogger] log:cls level:SFLogLevelFault message:message];
 }
 
 + (void)v:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelDefault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelDefault format:format args:args];
+    [logger log:cls level:SFLogLevelDefault format:format args:args];
     va_end(args);
 }
 
@@ -229,9 +320,13 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 + (void)log:(nonnull Class)cls format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:SFLogLevelDefault]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelDefault format:format args:args];
+    [logger log:cls level:SFLogLevelDefault format:format args:args];
     va_end(args);
 }
 
@@ -240,12 +335,20 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 + (void)log:(nonnull Class)cls level:(SFLogLevel)level format:(nonnull NSString *)format, ... {
+    SFLogger *logger = [self defaultLogger];
+    if (![logger isLevelEnabled:level]) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    [[self defaultLogger] log:cls level:SFLogLevelDefault format:format args:args];
+    [logger log:cls level:level format:format args:args];
     va_end(args);
 }
 
++ (void)log:(nonnull Class)cls level:(SFLogLevel)level messageBlock:(nonnull SFLogMessageBlock)messageBlock {
+    [[self defaultLogger] log:cls level:level messageBlock:messageBlock];
+}
+
 + (void)initialize {
     if (self == [SFLogger self]) {
         InstanceClass = [SFDefaultLogger class];
@@ -261,19 +364,22 @@ static SFSDKSafeMutableDictionary *loggerList = nil;
 }
 
 + (nonnull instancetype)loggerForComponent:(nonnull NSString *)componentName {
-    
-    static dispatch_once_t pred;
-    dispatch_once(&pred, ^{
-        loggerList = [[SFSDKSafeMutableDictionary alloc] init];
-    });
+    if (!componentName) {
+        return nil;
+    }
+    NSDictionary *loggers = (__bridge NSDictionary *)atomic_load_explicit(&loggerList, memory_order_acquire);
+    id logger = loggers[componentName];
+    if (logger) {
+        return logger;
+    }
     @synchronized ([SFLogger class]) {
-        if (!componentName) {
-            return nil;
-        }
-        id logger = [loggerList objectForKey:componentName];
+        loggers = (__bridge NSDictionary *)atomic_load_explicit(&loggerList, memory_order_relaxed);
+        logger = loggers[componentName];
         if (!logger) {
             logger =  [[self alloc] init:componentName];
-            [loggerList setObject:logger forKey:componentName];
+            NSMutableDictionary *updatedLoggers = [NSMutableDictionary dictionaryWithDictionary:loggers];
+            updatedLoggers[componentName] = logger;
+            atomic_store_explicit(&loggerList, (void *)CFBridgingRetain([updatedLoggers copy]), memory_order_release);
         }
         return logger;
     }
@@ -23,10 +23,13 @@
  */
 
 #import "SFSDKSafeMutableArray.h"
+#import <pthread.h>
 
-@interface SFSDKSafeMutableArray()
+// Guarded by a reader-writer lock: reads run concurrently, writes are exclusive and done when they return.
+@interface SFSDKSafeMutableArray() {
+    pthread_rwlock_t _lock;
+}
 @property (nonatomic,strong) NSMutableArray *backingArray;
-@property (nonatomic,strong) dispatch_queue_t queue;
 @end
 
 @implementation SFSDKSafeMutableArray
@@ -35,7 +38,7 @@
     if ((self = [super init]))
     {
         self.backingArray = [NSMutableArray array];
-        [self initQueue];
+        pthread_rwlock_init(&_lock, NULL);
     }
     return self;
 }
@@ -44,171 +47,167 @@
     if ((self = [super init]))
     {
         self.backingArray = [NSMutableArray arrayWithCapacity:numItems];
-        [self initQueue];
+        pthread_rwlock_init(&_lock, NULL);
     }
     return self;
 }
 
-- (NSUInteger)count {
-    __block NSUInteger size;
-    dispatch_sync(self.queue, ^{
-        size = self.backingArray.count;
-    });
+- (void)dealloc {
+    pthread_rwlock_destroy(&_lock);
+}
 
+- (NSUInteger)count {
+    pthread_rwlock_rdlock(&_lock);
+    NSUInteger size = self.backingArray.count;
+    pthread_rwlock_unlock(&_lock);
     return size;
 }
 
 - (id)mutableCopyWithZone:(NSZone *)zone {
-    __block SFSDKSafeMutableArray *mutableCopy = [[[self class] allocWithZone:zone] init];
-    dispatch_sync(self.queue, ^{
-        mutableCopy.backingArray = [self.backingArray mutableCopy];
-    });
+    SFSDKSafeMutableArray *mutableCopy = [[[self class] allocWithZone:zone] init];
+    pthread_rwlock_rdlock(&_lock);
+    mutableCopy.backingArray = [self.backingArray mutableCopy];
+    pthread_rwlock_unlock(&_lock);
     return mutableCopy;
 }
 
 -(BOOL)containsObject:(id)anObject {
-    __block BOOL exists;
-    dispatch_sync(self.queue, ^{
-        exists = [self.backingArray containsObject:anObject];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    BOOL exists = [self.backingArray containsObject:anObject];
+    pthread_rwlock_unlock(&_lock);
     return exists;
 }
 
 -(id)objectAtIndexedSubscript:(NSUInteger)idx {
-    __block id object;
-    dispatch_sync(self.queue, ^{
-        object = [self.backingArray objectAtIndexedSubscript:idx];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    id object = [self.backingArray objectAtIndexedSubscript:idx];
+    pthread_rwlock_unlock(&_lock);
     return object;
 }
 
 -(id)objectAtIndexed:(NSUInteger)idx {
-    __block id object;
-    dispatch_sync(self.queue, ^{
-        object = [self.backingArray objectAtIndex:idx];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    id object = [self.backingArray objectAtIndex:idx];
+    pthread_rwlock_unlock(&_lock);
     return object;
 }
 
 - (NSArray *)asArray {
-    __block NSArray *array;
-    dispatch_sync(self.queue, ^{
-        array = [NSArray arrayWithArray:self.backingArray];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    NSArray * array = [NSArray arrayWithArray:self.backingArray];
+    pthread_rwlock_unlock(&_lock);
     return array;
 }
 
+// Enumerates a copy, so the block can mutate this array.
 - (void)enumerateObjectsUsingBlock:(void (^)(id obj, NSUInteger idx, BOOL *stop))block {
-    dispatch_sync(self.queue, ^{
-        [self.backingArray enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-            block(obj, idx, stop);
-        }];
-    });
+    [[self asArray] enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        block(obj, idx, stop);
+    }];
 }
 
 #pragma Mark - Mutating Methods
 
 - (void)addObject:(id)obj {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray addObject:obj];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray addObject:obj];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)addObjectsFromArray:(NSArray *)array {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray addObjectsFromArray:array];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray addObjectsFromArray:array];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)insertObject:(id)obj atIndex:(NSUInteger)index {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray insertObject:obj atIndex:index];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray insertObject:obj atIndex:index];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)insertObjects:(id)objects atIndexes:(NSIndexSet *)indexes {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray insertObjects:objects atIndexes:indexes];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray insertObjects:objects atIndexes:indexes];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeAllObjects {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeAllObjects];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeAllObjects];
+    pthread_rwlock_unlock(&_lock);
 }
 
 -(void)removeLastObject {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeLastObject];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeLastObject];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObject:(id)object {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObject:object];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObject:object];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObjectAtIndex:(NSUInteger)index {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObjectAtIndex:index];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObjectAtIndex:index];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObjectsAtIndexes:(NSIndexSet *)indexes {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObjectsAtIndexes:indexes];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObjectsAtIndexes:indexes];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObjectIdenticalTo:(id)object {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObjectIdenticalTo:object];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObjectIdenticalTo:object];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObjectIdenticalTo:(id)object inRange:(NSRange)range {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObjectIdenticalTo:object inRange:range];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObjectIdenticalTo:object inRange:range];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObject:(id)object inRange:(NSRange)range {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObject:object inRange:range];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObject:object inRange:range];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObjectsInArray:(NSArray *)otherArray {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObjectsInArray:otherArray];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObjectsInArray:otherArray];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObjectsInRange:(NSRange)range {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray removeObjectsInRange:range];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray removeObjectsInRange:range];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)setArray:(NSArray *)array {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray setArray:array];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray setArray:array];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)setObject:(id)object atIndexedSubscript:(NSUInteger)index {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray setObject:object atIndexedSubscript:index];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray setObject:object atIndexedSubscript:index];
+    pthread_rwlock_unlock(&_lock);
 }
 
-
 - (void)filterUsingPredicate:(NSPredicate *)predicate {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingArray filterUsingPredicate:predicate];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingArray filterUsingPredicate:predicate];
+    pthread_rwlock_unlock(&_lock);
 }
 
 #pragma mark - Class Level
@@ -223,9 +222,4 @@
     return retVal;
 }
 
-#pragma private methods
-- (void)initQueue {
-    self.queue = dispatch_queue_create([NSString stringWithFormat:@"com.salesforce.mobilesdk.readWriteArrayQ%u", arc4random_uniform(UINT32_MAX)].UTF8String, DISPATCH_QUEUE_CONCURRENT);
-}
-
 @end
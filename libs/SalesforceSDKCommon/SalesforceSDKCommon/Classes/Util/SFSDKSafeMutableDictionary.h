@@ -31,6 +31,14 @@ NS_SWIFT_NAME(SafeMutableDictionary)
 @property (copy, nonatomic, readonly) NSArray *allKeys;
 @property (copy, nonatomic, readonly) NSArray *allValues;
 
+/**
+ Initializes an empty dictionary (Thread Safe)
+ @param useSnapshots YES for read-mostly dictionaries: reads then go to an immutable snapshot,
+ which every write replaces with an updated copy.
+ @return Instance of this class.
+ */
+- (instancetype)initWithCopyOnWriteSnapshots:(BOOL)useSnapshots NS_DESIGNATED_INITIALIZER;
+
 /**
  Retrieves object for the key specified (Thread Safe)
  @return object for specified key
@@ -23,103 +23,162 @@
  */
 
 #import "SFSDKSafeMutableDictionary.h"
-
-@interface SFSDKSafeMutableDictionary()
+#import <pthread.h>
+#import <os/lock.h>
+
+// Guarded by a reader-writer lock: reads run concurrently, writes are exclusive and done when they return.
+// In snapshot mode, reads only hold a lock long enough to grab the current immutable snapshot, while
+// writes copy it, apply the change and publish the copy.
+@interface SFSDKSafeMutableDictionary() {
+    pthread_rwlock_t _lock;
+    os_unfair_lock _snapshotLock;
+    NSDictionary *_snapshot;
+}
 
 @property (strong, nonatomic) NSMutableDictionary *backingDictionary;
-@property (strong, nonatomic) dispatch_queue_t queue;
+@property (assign, nonatomic) BOOL usesSnapshots;
 
 @end
 
 @implementation SFSDKSafeMutableDictionary
 
 - (instancetype)init {
+    return [self initWithCopyOnWriteSnapshots:NO];
+}
+
+- (instancetype)initWithCopyOnWriteSnapshots:(BOOL)useSnapshots {
     self = [super init];
     if (self) {
-        self.backingDictionary = [NSMutableDictionary new];
-        self.queue = dispatch_queue_create([NSString stringWithFormat:@"com.salesforce.mobilesdk.readWriteQueue%u", arc4random_uniform(UINT32_MAX)].UTF8String, DISPATCH_QUEUE_CONCURRENT);
+        self.usesSnapshots = useSnapshots;
+        if (useSnapshots) {
+            _snapshot = @{};
+        } else {
+            self.backingDictionary = [NSMutableDictionary new];
+        }
+        pthread_rwlock_init(&_lock, NULL);
+        _snapshotLock = OS_UNFAIR_LOCK_INIT;
     }
     return self;
 }
 
+- (void)dealloc {
+    pthread_rwlock_destroy(&_lock);
+}
+
+- (NSDictionary *)currentSnapshot {
+    os_unfair_lock_lock(&_snapshotLock);
+    NSDictionary *snapshot = _snapshot;
+    os_unfair_lock_unlock(&_snapshotLock);
+    return snapshot;
+}
+
 - (NSArray *)allKeys {
-    __block NSArray *keys;
-    dispatch_sync(self.queue, ^{
-        keys = self.backingDictionary.allKeys;
-    });
+    if (self.usesSnapshots) {
+        return [self currentSnapshot].allKeys;
+    }
+    pthread_rwlock_rdlock(&_lock);
+    NSArray * keys = self.backingDictionary.allKeys;
+    pthread_rwlock_unlock(&_lock);
     return keys;
 }
 
 - (NSArray *)allValues {
-    __block NSArray *values;
-    dispatch_sync(self.queue, ^{
-        values = self.backingDictionary.allValues;
-    });
+    if (self.usesSnapshots) {
+        return [self currentSnapshot].allValues;
+    }
+    pthread_rwlock_rdlock(&_lock);
+    NSArray * values = self.backingDictionary.allValues;
+    pthread_rwlock_unlock(&_lock);
     return values;
 }
 
 - (id)objectForKey:(id<NSCopying>)aKey {
-    __block id value;
-    dispatch_sync(self.queue, ^{
-        value = self.backingDictionary[aKey];
-    });
+    if (self.usesSnapshots) {
+        return [self currentSnapshot][aKey];
+    }
+    pthread_rwlock_rdlock(&_lock);
+    id value = self.backingDictionary[aKey];
+    pthread_rwlock_unlock(&_lock);
     return value;
 }
 
 - (NSArray *)allKeysForObject:(id)anObject {
-    __block NSArray *keys;
-    dispatch_sync(self.queue, ^{
-        keys = [self.backingDictionary allKeysForObject:anObject];
-    });
+    if (self.usesSnapshots) {
+        return [[self currentSnapshot] allKeysForObject:anObject];
+    }
+    pthread_rwlock_rdlock(&_lock);
+    NSArray * keys = [self.backingDictionary allKeysForObject:anObject];
+    pthread_rwlock_unlock(&_lock);
     return keys;
 }
 
 - (NSDictionary *)dictionary {
-    __block NSDictionary *dict;
-    dispatch_sync(self.queue, ^{
-        dict = [NSDictionary dictionaryWithDictionary:self.backingDictionary];
-    });
+    if (self.usesSnapshots) {
+        return [self currentSnapshot];
+    }
+    pthread_rwlock_rdlock(&_lock);
+    NSDictionary * dict = [NSDictionary dictionaryWithDictionary:self.backingDictionary];
+    pthread_rwlock_unlock(&_lock);
     return dict;
 }
 
 #pragma Mark - Mutating Methods
 
+- (void)mutateUsingBlock:(void (^)(NSMutableDictionary *dictionary))mutation {
+    // The previous snapshot gets released once out of the locks.
+    NSDictionary *previousSnapshot = nil;
+    pthread_rwlock_wrlock(&_lock);
+    if (self.usesSnapshots) {
+
+        // Writers are serialized by the reader-writer lock, readers only by the snapshot lock.
+        NSMutableDictionary *dictionary = [_snapshot mutableCopy];
+        mutation(dictionary);
+        NSDictionary *snapshot = [dictionary copy];
+        os_unfair_lock_lock(&_snapshotLock);
+        previousSnapshot = _snapshot;
+        _snapshot = snapshot;
+        os_unfair_lock_unlock(&_snapshotLock);
+    } else {
+        mutation(self.backingDictionary);
+    }
+    pthread_rwlock_unlock(&_lock);
+    previousSnapshot = nil;
+}
+
 - (void)setObject:(id)object forKey:(id<NSCopying>)aKey {
-    dispatch_barrier_async(self.queue, ^{
-        self.backingDictionary[aKey] = object;
-    });
+    [self mutateUsingBlock:^(NSMutableDictionary *dictionary) {
+        dictionary[aKey] = object;
+    }];
 }
 
 - (void)removeObject:(id<NSCopying>)aKey {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingDictionary removeObjectForKey:aKey];
-    });
+    [self mutateUsingBlock:^(NSMutableDictionary *dictionary) {
+        [dictionary removeObjectForKey:aKey];
+    }];
 }
 
 - (void)removeAllObjects {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingDictionary removeAllObjects];
-    });
+    [self mutateUsingBlock:^(NSMutableDictionary *dictionary) {
+        [dictionary removeAllObjects];
+    }];
 }
 
 - (void)removeObjects:(NSArray<id<NSCopying>> *)keys {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingDictionary removeObjectsForKeys:keys];
-    });
+    [self mutateUsingBlock:^(NSMutableDictionary *dictionary) {
+        [dictionary removeObjectsForKeys:keys];
+    }];
 }
 
 - (void)addEntries:(NSDictionary *)otherDictionary {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingDictionary addEntriesFromDictionary:otherDictionary];
-    });
+    [self mutateUsingBlock:^(NSMutableDictionary *dictionary) {
+        [dictionary addEntriesFromDictionary:otherDictionary];
+    }];
 }
 
 - (void)setDictionary:(NSDictionary *)dictionary {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingDictionary setDictionary:dictionary];
-    });
+    [self mutateUsingBlock:^(NSMutableDictionary *backingDictionary) {
+        [backingDictionary setDictionary:dictionary];
+    }];
 }
 
 @end
-
-
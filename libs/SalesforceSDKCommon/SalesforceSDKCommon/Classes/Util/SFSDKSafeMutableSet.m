@@ -23,10 +23,13 @@
 */
 
 #import "SFSDKSafeMutableSet.h"
+#import <pthread.h>
 
-@interface SFSDKSafeMutableSet()
+// Guarded by a reader-writer lock: reads run concurrently, writes are exclusive and done when they return.
+@interface SFSDKSafeMutableSet() {
+    pthread_rwlock_t _lock;
+}
 @property (nonatomic,strong) NSMutableSet *backingSet;
-@property (nonatomic,strong) dispatch_queue_t queue;
 @end
 
 @implementation SFSDKSafeMutableSet
@@ -35,7 +38,7 @@
     if ((self = [super init]))
     {
         self.backingSet = [NSMutableSet set];
-        [self initQueue];
+        pthread_rwlock_init(&_lock, NULL);
     }
     return self;
 }
@@ -44,49 +47,47 @@
     if ((self = [super init]))
     {
         self.backingSet = [NSMutableSet setWithCapacity:numItems];
-        [self initQueue];
+        pthread_rwlock_init(&_lock, NULL);
     }
     return self;
 }
 
+- (void)dealloc {
+    pthread_rwlock_destroy(&_lock);
+}
+
 - (NSUInteger)count {
-    __block NSUInteger size;
-    dispatch_sync(self.queue, ^{
-        size = self.backingSet.count;
-    });
-    
+    pthread_rwlock_rdlock(&_lock);
+    NSUInteger size = self.backingSet.count;
+    pthread_rwlock_unlock(&_lock);
     return size;
 }
 
 - (id)anyObject {
-    __block id object;
-    dispatch_sync(self.queue, ^{
-        object = [self.backingSet anyObject];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    id object = [self.backingSet anyObject];
+    pthread_rwlock_unlock(&_lock);
     return object;
 }
 
 - (BOOL)containsObject:(id)anObject {
-    __block BOOL exists;
-    dispatch_sync(self.queue, ^{
-        exists = [self.backingSet containsObject:anObject];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    BOOL exists = [self.backingSet containsObject:anObject];
+    pthread_rwlock_unlock(&_lock);
     return exists;
 }
 
 - (NSArray *)allObjects {
-    __block NSArray *array;
-    dispatch_sync(self.queue, ^{
-        array = [self.backingSet allObjects];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    NSArray * array = [self.backingSet allObjects];
+    pthread_rwlock_unlock(&_lock);
     return array;
 }
 
 - (NSSet *)asSet {
-    __block NSSet *set;
-    dispatch_sync(self.queue, ^{
-        set = [NSSet setWithSet:self.backingSet];
-    });
+    pthread_rwlock_rdlock(&_lock);
+    NSSet * set = [NSSet setWithSet:self.backingSet];
+    pthread_rwlock_unlock(&_lock);
     return set;
 }
 
@@ -101,66 +102,64 @@
 }
 
 - (void)addObject:(id)obj {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet addObject:obj];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet addObject:obj];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)addObjectsFromArray:(NSArray *)array {
-    dispatch_barrier_async(self.queue, ^{
-         [self.backingSet addObjectsFromArray:array];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet addObjectsFromArray:array];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeAllObjects {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet removeAllObjects];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet removeAllObjects];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)removeObject:(id)object {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet removeObject:object];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet removeObject:object];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)unionSet:(NSSet *)set {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet unionSet:set];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet unionSet:set];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)minusSet:(NSSet *)set {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet minusSet:set];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet minusSet:set];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)intersectSet:(NSSet *)set {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet intersectSet:set];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet intersectSet:set];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)setSet:(NSSet *)set {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet setSet:set];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet setSet:set];
+    pthread_rwlock_unlock(&_lock);
 }
 
 - (void)filterUsingPredicate:(NSPredicate *)predicate {
-    dispatch_barrier_async(self.queue, ^{
-        [self.backingSet filterUsingPredicate:predicate];
-    });
+    pthread_rwlock_wrlock(&_lock);
+    [self.backingSet filterUsingPredicate:predicate];
+    pthread_rwlock_unlock(&_lock);
 }
 
+// Enumerates a copy, so the block can mutate this set.
 - (void)enumerateObjectsUsingBlock:(void (^)(id obj, BOOL *stop))block {
-    __block NSArray *array = [self allObjects];
-    dispatch_barrier_sync(self.queue, ^{
-        [array enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-            block(obj, stop);
-        }];
-    });
+    [[self allObjects] enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+        block(obj, stop);
+    }];
 }
 
 #pragma mark - Class Level
@@ -175,9 +174,4 @@
     return retVal;
 }
 
-#pragma private methods
-- (void)initQueue {
-     self.queue = dispatch_queue_create([NSString stringWithFormat:@"com.salesforce.mobilesdk.readWriteSetQ%u", arc4random_uniform(UINT32_MAX)].UTF8String, DISPATCH_QUEUE_CONCURRENT);
-}
-
 @end
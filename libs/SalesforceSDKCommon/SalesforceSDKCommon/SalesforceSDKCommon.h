@@ -35,6 +35,7 @@
 #import <SalesforceSDKCommon/SFSDKSafeMutableArray.h>
 #import <SalesforceSDKCommon/SFFileProtectionHelper.h>
 #import <SalesforceSDKCommon/SFDefaultLogger.h>
+#import <SalesforceSDKCommon/SFFileLogger.h>
 #import <SalesforceSDKCommon/SFLogger.h>
 #import <SalesforceSDKCommon/NSUserDefaults+SFAdditions.h>
 #import <SalesforceSDKCommon/SFJsonUtils.h>
@@ -0,0 +1,118 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "SFFileLogger.h"
+
+static NSString * const kTestComponent = @"TestFileComponent";
+
+@interface SFFileLoggerTests : XCTestCase
+@property (nonatomic, strong) NSString *directory;
+@end
+
+@implementation SFFileLoggerTests
+
+- (void)setUp {
+    [super setUp];
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:nil];
+    [super tearDown];
+}
+
+- (void)testLinesWrittenAboveLogLevel {
+    SFFileLogger *logger = [[SFFileLogger alloc] initWithComponent:kTestComponent directory:self.directory maxFileSize:1024 * 1024 maxFileCount:2 bufferCapacity:64 encryptionBlock:nil];
+    [logger log:self.class level:SFLogLevelError format:@"Test error %d", 1];
+    [logger log:self.class level:SFLogLevelDebug format:@"Test debug %d", 2];
+    [logger flush];
+    NSArray<NSString *> *paths = [logger logFilePaths];
+    XCTAssertEqual(paths.count, 1);
+    NSString *contents = [[NSString alloc] initWithData:[SFFileLogger contentsOfLogFileAtPath:paths[0] decryptionBlock:nil] encoding:NSUTF8StringEncoding];
+    XCTAssertTrue([contents containsString:@"ERROR CLASS: SFFileLoggerTests Test error 1\n"]);
+    XCTAssertFalse([contents containsString:@"Test debug 2"], "Lines below the log level should not be written");
+}
+
+- (void)testFilesRotated {
+    SFFileLogger *logger = [[SFFileLogger alloc] initWithComponent:kTestComponent directory:self.directory maxFileSize:256 maxFileCount:3 bufferCapacity:64 encryptionBlock:nil];
+    for (NSUInteger i = 0; i < 50; i++) {
+        [logger log:self.class level:SFLogLevelInfo format:@"Test line %lu", (unsigned long)i];
+        [logger flush];
+    }
+    NSArray<NSString *> *paths = [logger logFilePaths];
+    XCTAssertEqual(paths.count, 3, "Files beyond the maximum count should have been deleted");
+    for (NSString *path in paths) {
+        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil];
+        XCTAssertLessThanOrEqual(attributes.fileSize, 256);
+    }
+    NSString *contents = [[NSString alloc] initWithData:[SFFileLogger contentsOfLogFileAtPath:paths.lastObject decryptionBlock:nil] encoding:NSUTF8StringEncoding];
+    XCTAssertTrue([contents hasSuffix:@"Test line 49\n"], "Current file should end with the last line");
+}
+
+- (void)testEncryptedFiles {
+    SFFileLoggerCryptoBlock xorBlock = ^NSData *(NSData *data) {
+        NSMutableData *result = [data mutableCopy];
+        uint8_t *bytes = result.mutableBytes;
+        for (NSUInteger i = 0; i < result.length; i++) {
+            bytes[i] ^= 0x5A;
+        }
+        return result;
+    };
+    SFFileLogger *logger = [[SFFileLogger alloc] initWithComponent:kTestComponent directory:self.directory maxFileSize:1024 * 1024 maxFileCount:2 bufferCapacity:64 encryptionBlock:xorBlock];
+    [logger log:self.class level:SFLogLevelInfo message:@"Secret line 1"];
+    [logger flush];
+    [logger log:self.class level:SFLogLevelInfo message:@"Secret line 2"];
+    [logger flush];
+    NSString *path = [logger logFilePaths].firstObject;
+    NSString *rawContents = [[NSString alloc] initWithData:[NSData dataWithContentsOfFile:path] encoding:NSISOLatin1StringEncoding];
+    XCTAssertFalse([rawContents containsString:@"Secret line"], "Lines should have been encrypted");
+    NSString *contents = [[NSString alloc] initWithData:[SFFileLogger contentsOfLogFileAtPath:path decryptionBlock:xorBlock] encoding:NSUTF8StringEncoding];
+    XCTAssertTrue([contents containsString:@"Secret line 1\n"]);
+    XCTAssertTrue([contents containsString:@"Secret line 2\n"]);
+}
+
+- (void)testLinesDroppedWhenBufferFull {
+    SFFileLogger *logger = [[SFFileLogger alloc] initWithComponent:kTestComponent directory:self.directory maxFileSize:1024 * 1024 maxFileCount:1 bufferCapacity:4 encryptionBlock:nil];
+    NSUInteger numLines = 10000;
+    dispatch_apply(numLines, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        [logger log:self.class level:SFLogLevelInfo format:@"Test line %zu", i];
+    });
+    [logger flush];
+    NSString *contents = [[NSString alloc] initWithData:[SFFileLogger contentsOfLogFileAtPath:[logger logFilePaths].firstObject decryptionBlock:nil] encoding:NSUTF8StringEncoding];
+    NSUInteger numWrittenLines = [contents componentsSeparatedByString:@"\n"].count - 1;
+    XCTAssertEqual(numWrittenLines + logger.numDroppedLines, numLines, "Every line should have been either written or counted as dropped");
+}
+
+- (void)testLoggingPerformance {
+    SFFileLogger *logger = [[SFFileLogger alloc] initWithComponent:kTestComponent directory:self.directory maxFileSize:1024 * 1024 maxFileCount:2 bufferCapacity:1024 encryptionBlock:nil];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100000; i++) {
+            [logger log:self.class level:SFLogLevelInfo format:@"Test line %lu", (unsigned long)i];
+        }
+        [logger flush];
+    }];
+}
+
+@end
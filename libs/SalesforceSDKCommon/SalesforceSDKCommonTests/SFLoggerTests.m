@@ -266,4 +266,39 @@ static NSString * const kMessageKey = @"message";
     XCTAssertTrue([self isKindOfClass:classUsed],"Log statement should have been logged against  the class");
     XCTAssertTrue(message && message.length > 0 ,"Log statement should not be emtpty");
 }
+
+/**
+ * Test messages of filtered out levels are not built
+ */
+- (void)testMessageBlockOnlyCalledWhenLogged {
+    [TestLogger setInstanceClass:[SFDefaultLogger class]];
+    TestLogger *logger = [TestLogger loggerForComponent:kTestComponent2];
+    logger.logLevel = SFLogLevelError;
+    XCTAssertFalse([logger isLevelEnabled:SFLogLevelDebug], "Debug level should be filtered out");
+    XCTAssertTrue([logger isLevelEnabled:SFLogLevelError], "Error level should be logged");
+    __block NSUInteger numMessagesBuilt = 0;
+    [logger log:self.class level:SFLogLevelDebug messageBlock:^NSString * {
+        numMessagesBuilt++;
+        return kTestLogLine1;
+    }];
+    XCTAssertEqual(numMessagesBuilt, 0, "Message of a filtered out level should not have been built");
+    [logger log:self.class level:SFLogLevelError messageBlock:^NSString * {
+        numMessagesBuilt++;
+        return kTestLogLine2;
+    }];
+    XCTAssertEqual(numMessagesBuilt, 1, "Message of a logged level should have been built");
+}
+
+/**
+ * Benchmark of log lines of a filtered out level
+ */
+- (void)testFilteredOutLogPerformance {
+    [TestLogger setInstanceClass:[SFDefaultLogger class]];
+    TestLogger.logLevel = SFLogLevelError;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 100000; i++) {
+            [TestLogger d:self.class format:@"TestDebugStatement %@ %lu", kTestLogLine1, (unsigned long)i];
+        }
+    }];
+}
 @end
@@ -25,6 +25,41 @@
 #import <XCTest/XCTest.h>
 #import "SFSDKSafeMutableDictionary.h"
 
+// Dictionary guarded the way SFSDKSafeMutableDictionary used to be, to compare the costs of both.
+@interface SFSDKQueueGuardedDictionary : NSObject
+
+@property (strong, nonatomic) NSMutableDictionary *backingDictionary;
+@property (strong, nonatomic) dispatch_queue_t queue;
+
+@end
+
+@implementation SFSDKQueueGuardedDictionary
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.backingDictionary = [NSMutableDictionary new];
+        self.queue = dispatch_queue_create("com.salesforce.mobilesdk.test.readWriteQueue", DISPATCH_QUEUE_CONCURRENT);
+    }
+    return self;
+}
+
+- (id)objectForKey:(id<NSCopying>)aKey {
+    __block id value;
+    dispatch_sync(self.queue, ^{
+        value = self.backingDictionary[aKey];
+    });
+    return value;
+}
+
+- (void)setObject:(id)object forKey:(id<NSCopying>)aKey {
+    dispatch_barrier_async(self.queue, ^{
+        self.backingDictionary[aKey] = object;
+    });
+}
+
+@end
+
 @interface SFSDKSafeMutableDictionaryTests : XCTestCase
 
 @property (strong, nonatomic) SFSDKSafeMutableDictionary *testDictionary;
@@ -67,8 +102,60 @@
     }];
 }
 
+- (void)testSnapshotReadWrites {
+    SFSDKSafeMutableDictionary *dictionary = [[SFSDKSafeMutableDictionary alloc] initWithCopyOnWriteSnapshots:YES];
+    [dictionary setObject:@1 forKey:@"key1"];
+    NSDictionary *snapshot = [dictionary dictionary];
+    [dictionary setObject:@2 forKey:@"key2"];
+    [dictionary removeObject:@"key1"];
+    XCTAssertEqualObjects(snapshot, @{ @"key1" : @1 }, @"Snapshot taken earlier should not change");
+    XCTAssertEqualObjects([dictionary dictionary], @{ @"key2" : @2 });
+    XCTAssertNil([dictionary objectForKey:@"key1"]);
+    XCTAssertEqualObjects([dictionary objectForKey:@"key2"], @2);
+    [dictionary addEntries:@{ @"key3" : @3 }];
+    XCTAssertEqual(dictionary.allKeys.count, 2);
+    [dictionary removeAllObjects];
+    XCTAssertEqual(dictionary.allValues.count, 0);
+}
+
+- (void)testContendedAccessWithQueuePerformance {
+    SFSDKQueueGuardedDictionary *dictionary = [[SFSDKQueueGuardedDictionary alloc] init];
+    [self measureBlock:^{
+        [self performContendedAccess:dictionary];
+    }];
+}
+
+- (void)testContendedAccessWithLockPerformance {
+    SFSDKSafeMutableDictionary *dictionary = [[SFSDKSafeMutableDictionary alloc] init];
+    [self measureBlock:^{
+        [self performContendedAccess:dictionary];
+    }];
+}
+
+- (void)testContendedAccessWithSnapshotsPerformance {
+    SFSDKSafeMutableDictionary *dictionary = [[SFSDKSafeMutableDictionary alloc] initWithCopyOnWriteSnapshots:YES];
+    [self measureBlock:^{
+        [self performContendedAccess:dictionary];
+    }];
+}
+
 #pragma Mark - Helper Methods
 
+// 8 threads each doing 20000 lookups and 20 writes, about the mix of a registry read on every call
+- (void)performContendedAccess:(id)dictionary {
+    NSArray *keys = self.testKeys;
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < 20000; i++) {
+            id key = keys[i % keys.count];
+            if (i % 1000 == 0) {
+                [dictionary setObject:@(i) forKey:key];
+            } else {
+                [dictionary objectForKey:key];
+            }
+        }
+    });
+}
+
 - (NSArray *)generateTestKeys {
     NSMutableArray *keys = [[NSMutableArray alloc] initWithCapacity:1000];
     for (NSUInteger idx = 0; idx < 1000; idx++) {
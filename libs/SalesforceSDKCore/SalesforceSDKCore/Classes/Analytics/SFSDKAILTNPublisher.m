@@ -41,6 +41,49 @@ static NSString* const kLogLines = @"logLines";
 static NSString* const kPayload = @"payload";
 static NSString* const kRestApiSuffix = @"connect/proxy/app-analytics-logging";
 
+/*
+ * Appends a string literal to a JSON document. The payload of a log line is a JSON document itself,
+ * embedded as a string: its escape sequences get escaped once more, except for "\/", which becomes "/".
+ */
+static void SFSDKAppendJSONStringLiteral(NSMutableData *body, NSData *utf8, BOOL isJSONDocument) {
+    const uint8_t *bytes = utf8.bytes;
+    NSUInteger length = utf8.length;
+    NSUInteger start = 0;
+    [body appendBytes:"\"" length:1];
+    for (NSUInteger i = 0; i < length; i++) {
+        uint8_t c = bytes[i];
+        char escape[8] = {0};
+        NSUInteger consumed = 1;
+        if (c == '\\' && isJSONDocument && i + 1 < length) {
+            uint8_t next = bytes[i + 1];
+            consumed = 2;
+            if (next == '/') {
+                strcpy(escape, "/");
+            } else if (next == '"' || next == '\\') {
+                snprintf(escape, sizeof(escape), "\\\\\\%c", next);
+            } else {
+                snprintf(escape, sizeof(escape), "\\\\%c", next);
+            }
+        } else if (c == '"' || c == '\\') {
+            snprintf(escape, sizeof(escape), "\\%c", c);
+        } else if (c < 0x20) {
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+        } else {
+            continue;
+        }
+        [body appendBytes:bytes + start length:i - start];
+        [body appendBytes:escape length:strlen(escape)];
+        i += consumed - 1;
+        start = i + 1;
+    }
+    [body appendBytes:bytes + start length:length - start];
+    [body appendBytes:"\"" length:1];
+}
+
+static void SFSDKAppendString(NSMutableData *body, NSString *string) {
+    [body appendData:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
 @implementation SFSDKAILTNPublisher
 
 - (void) publish:(NSArray *) events publishCompleteBlock:(PublishCompleteBlock) publishCompleteBlock {
@@ -50,17 +93,15 @@ static NSString* const kRestApiSuffix = @"connect/proxy/app-analytics-logging";
     }
 
     // Builds the POST body of the request.
-    NSDictionary *bodyDictionary = [[self class] buildRequestBody:events];
-    [[self class] publishLogLines:bodyDictionary publishCompleteBlock:publishCompleteBlock];
+    NSData *bodyData = [[self class] buildRequestBody:events];
+    [[self class] publishRequestBody:bodyData publishCompleteBlock:publishCompleteBlock];
 }
 
-+ (void) publishLogLines:(NSDictionary *) bodyDictionary publishCompleteBlock:(PublishCompleteBlock) publishCompleteBlock {
++ (void) publishRequestBody:(NSData *) bodyData publishCompleteBlock:(PublishCompleteBlock) publishCompleteBlock {
     NSString *path = [NSString stringWithFormat:@"/%@/%@", kSFRestDefaultAPIVersion, kRestApiSuffix];
     SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:path queryParams:nil];
 
     // Adds GZIP compression.
-    NSString *bodyString = [[self class] dictionaryAsJSONString:bodyDictionary];
-    NSData *bodyData = [bodyString dataUsingEncoding:NSUTF8StringEncoding];
     NSData *postData = [bodyData gzipDeflate];
     [request setCustomRequestBodyData:postData contentType:@"application/json"];
     [request setHeaderValue:@"gzip" forHeaderName:@"Content-Encoding"];
@@ -75,36 +116,48 @@ static NSString* const kRestApiSuffix = @"connect/proxy/app-analytics-logging";
     }];
 }
 
-+ (NSDictionary *) buildRequestBody:(NSArray *) events {
-    NSMutableDictionary *body = [[NSMutableDictionary alloc] init];
-    NSMutableArray *logLines = [[NSMutableArray alloc] init];
-    for (int i = 0; i < events.count; i++) {
-        NSMutableDictionary *event = [events objectAtIndex:i];
-        if (event) {
-            NSMutableDictionary *trackingInfo = [[NSMutableDictionary alloc] init];
-            trackingInfo[kCode] = kAiltn;
-            NSMutableDictionary *data = [[NSMutableDictionary alloc] init];
-            data[kSchemaTypeKey] = event[kSchemaTypeKey];
-            [event removeObjectForKey:kSchemaTypeKey];
-            data[kPayload] = [[self class] dictionaryAsJSONString:event];
-            trackingInfo[kData] = data;
-            [logLines addObject:trackingInfo];
+/*
+ * Writes {"logLines":[{"code":"ailtn","data":{"schemaType":...,"payload":"..."}},...]} directly, each event
+ * being serialized once, instead of serializing the events and then the whole body around them.
+ */
++ (NSData *) buildRequestBody:(NSArray *) events {
+    NSMutableData *body = [[NSMutableData alloc] init];
+    SFSDKAppendString(body, [NSString stringWithFormat:@"{\"%@\":[", kLogLines]);
+    BOOL firstLogLine = YES;
+    for (NSDictionary *event in events) {
+        NSMutableDictionary *payload = [event mutableCopy];
+        [payload removeObjectForKey:kSchemaTypeKey];
+        NSData *payloadData = [[self class] JSONDataForDictionary:payload];
+        if (!payloadData) {
+            continue;
+        }
+        if (!firstLogLine) {
+            SFSDKAppendString(body, @",");
+        }
+        firstLogLine = NO;
+        SFSDKAppendString(body, [NSString stringWithFormat:@"{\"%@\":\"%@\",\"%@\":{", kCode, kAiltn, kData]);
+        id schemaType = event[kSchemaTypeKey];
+        if ([schemaType isKindOfClass:[NSString class]]) {
+            SFSDKAppendString(body, [NSString stringWithFormat:@"\"%@\":", kSchemaTypeKey]);
+            SFSDKAppendJSONStringLiteral(body, [schemaType dataUsingEncoding:NSUTF8StringEncoding], NO);
+            SFSDKAppendString(body, @",");
         }
+        SFSDKAppendString(body, [NSString stringWithFormat:@"\"%@\":", kPayload]);
+        SFSDKAppendJSONStringLiteral(body, payloadData, YES);
+        SFSDKAppendString(body, @"}}");
     }
-    body[kLogLines] = logLines;
+    SFSDKAppendString(body, @"]}");
     return body;
 }
 
-+ (NSString *) dictionaryAsJSONString:(NSDictionary *) dict {
++ (NSData *) JSONDataForDictionary:(NSDictionary *) dict {
     NSError *error = nil;
     if ([NSJSONSerialization isValidJSONObject:dict]) {
         NSData *jsonData = [NSJSONSerialization dataWithJSONObject:dict options:0 error:&error];
         if (error) {
             return nil;
         }
-        NSString *jsonString = [[NSString alloc] initWithBytes:[jsonData bytes] length:[jsonData length] encoding:NSUTF8StringEncoding];
-        jsonString = [jsonString stringByReplacingOccurrencesOfString:@"\\/" withString:@"/"];
-        return jsonString;
+        return jsonData;
     } else {
         [SFSDKCoreLogger e:[self class] format:@"%@ - invalid object passed to JSONDataRepresentation", [self class]];
         return nil;
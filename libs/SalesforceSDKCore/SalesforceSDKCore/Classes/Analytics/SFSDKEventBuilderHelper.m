@@ -61,7 +61,7 @@ NSString * const kSFSDKEventBuilderHelperEndTime   = @"endTime";
         builder.schemaType = SchemaTypeInteraction;
         builder.eventType = EventTypeSystem;
     } analyticsManager:manager.analyticsManager];
-    [manager.analyticsManager.storeManager storeEvent:event];
+    [manager.analyticsManager storeEvent:event];
 }
 
 @end
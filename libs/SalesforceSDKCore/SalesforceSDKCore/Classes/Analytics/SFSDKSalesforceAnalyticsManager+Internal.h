@@ -44,5 +44,26 @@
 @property (nonnull, nonatomic, readwrite, strong) SFSDKEventStoreManager *eventStoreManager;
 @property (nullable, nonatomic, readwrite, strong) SFUserAccount *userAccount;
 @property (nonnull, nonatomic, readwrite, strong) NSMutableArray<SFSDKAnalyticsTransformPublisherPair *> *remotes;
+@property (nonatomic, readwrite, assign) BOOL publishingAllEvents;
+
+/**
+ * Identifiers of the events each publisher acknowledged, kept until every publisher has.
+ */
+@property (nonnull, nonatomic, readwrite, strong) NSMapTable<SFSDKAnalyticsTransformPublisherPair *, NSMutableSet<NSString *> *> *acknowledgedEventIds;
+
+/**
+ * Publishes all stored events, one chunk at a time.
+ *
+ * @param completionBlock Block invoked once publishing stopped, with NO if a chunk could not be published.
+ */
+- (void) publishAllEventsWithCompletion:(nullable void (^)(BOOL success)) completionBlock;
+
+/**
+ * Publishes a list of events, deleting them from the store if publishing was successful for all registered endpoints.
+ *
+ * @param events List of events.
+ * @param completionBlock Block invoked once all registered endpoints are done.
+ */
+- (void) publishEvents:(nonnull NSArray<SFSDKInstrumentationEvent *> *) events completion:(nullable void (^)(BOOL success)) completionBlock;
 
 @end
@@ -46,6 +46,16 @@
  */
 @property (nonatomic, readwrite, assign, getter=isLoggingEnabled) BOOL loggingEnabled;
 
+/**
+ * Maximum number of stored events published at once by `publishAllEvents`. 500 by default.
+ */
+@property (nonatomic, readwrite, assign) NSUInteger publishBatchMaxEvents;
+
+/**
+ * Maximum size (in bytes) of the stored events published at once by `publishAllEvents`. 512KB by default.
+ */
+@property (nonatomic, readwrite, assign) NSUInteger publishBatchMaxBytes;
+
 /**
  * Returns an instance of this class associated with the specified user account.
  *
@@ -77,9 +87,10 @@
 
 /**
  * Publishes all stored events to all registered network endpoints after
- * applying the required event format transforms. Stored events will be
- * deleted if publishing was successful for all registered endpoints.
- * This method should NOT be called from the main thread.
+ * applying the required event format transforms. Events are published in
+ * chunks, oldest first, each chunk being deleted once publishing was
+ * successful for all registered endpoints. Publishing stops at the first
+ * chunk that fails. This method should NOT be called from the main thread.
  */
 - (void) publishAllEvents;
 
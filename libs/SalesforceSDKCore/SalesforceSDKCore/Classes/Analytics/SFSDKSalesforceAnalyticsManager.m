@@ -48,6 +48,8 @@ static NSString * const kEventStoresDirectory = @"event_stores";
 static NSString * const kEventStoreEncryptionKeyLabel = @"com.salesforce.eventStore.encryptionKey";
 static NSString * const kAnalyticsOnOffKey = @"ailtn_enabled";
 static NSString * const kSFAppFeatureAiltnEnabled = @"AI";
+static NSUInteger const kDefaultPublishBatchMaxEvents = 500;
+static NSUInteger const kDefaultPublishBatchMaxBytes = 512 * 1024;
 
 static NSMutableDictionary *analyticsManagerList = nil;
 
@@ -147,6 +149,9 @@ static NSMutableDictionary *analyticsManagerList = nil;
         _analyticsManager = [[SFSDKAnalyticsManager alloc] initWithStoreDirectory:rootStoreDir dataEncryptorBlock:dataEncryptorBlock dataDecryptorBlock:dataDecryptorBlock deviceAttributes:deviceAttributes];
         _eventStoreManager = self.analyticsManager.storeManager;
         _remotes = [[NSMutableArray alloc] init];
+        _acknowledgedEventIds = [NSMapTable strongToStrongObjectsMapTable];
+        _publishBatchMaxEvents = kDefaultPublishBatchMaxEvents;
+        _publishBatchMaxBytes = kDefaultPublishBatchMaxBytes;
         
         // There's no standard for unauthenticated instrumentation publishing, currently.  Consumers
         // should explicitly specify their own.
@@ -191,60 +196,148 @@ static NSMutableDictionary *analyticsManagerList = nil;
 }
 
 - (void) publishAllEvents {
+    [self publishAllEventsWithCompletion:nil];
+}
+
+- (void) publishAllEventsWithCompletion:(void (^)(BOOL)) completionBlock {
     @synchronized (self) {
-        NSArray<SFSDKInstrumentationEvent *> *events = [self.eventStoreManager fetchAllEvents];
-        [self publishEvents:events];
+        if (self.publishingAllEvents) {
+            [SFSDKCoreLogger d:[self class] format:@"%@ Stored events are already being published", NSStringFromSelector(_cmd)];
+            if (completionBlock) {
+                completionBlock(NO);
+            }
+            return;
+        }
+        self.publishingAllEvents = YES;
     }
+    [self.analyticsManager flushAggregatedEvents];
+    [self publishNextEventsWithCompletion:completionBlock];
 }
 
-- (void) publishEvents:(NSArray<SFSDKInstrumentationEvent *> *) events {
-    if (events.count == 0 || self.remotes.count == 0) {
+/*
+ * Publishes the oldest stored events, a chunk bounded in count and size at a time. The next chunk is only
+ * read once the previous one has been published and deleted, so memory use doesn't grow with the backlog.
+ */
+- (void) publishNextEventsWithCompletion:(void (^)(BOOL)) completionBlock {
+    NSArray<SFSDKInstrumentationEvent *> *events = [self.eventStoreManager fetchEventsWithMaxCount:self.publishBatchMaxEvents maxBytes:self.publishBatchMaxBytes];
+    NSUInteger numRemotes = 0;
+    @synchronized (self.remotes) {
+        numRemotes = self.remotes.count;
+    }
+    if (events.count == 0 || numRemotes == 0) {
+        [self finishPublishingAllEvents:YES completion:completionBlock];
         return;
     }
+    __weak typeof(self) weakSelf = self;
+    [self publishEvents:events completion:^(BOOL success) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (success) {
+            [strongSelf publishNextEventsWithCompletion:completionBlock];
+        } else {
+            [strongSelf finishPublishingAllEvents:NO completion:completionBlock];
+        }
+    }];
+}
+
+- (void) finishPublishingAllEvents:(BOOL) success completion:(void (^)(BOOL)) completionBlock {
     @synchronized (self) {
-        NSMutableArray<NSString *> *eventIds = [[NSMutableArray alloc] init];
-        for (SFSDKInstrumentationEvent *event in events) {
-            [eventIds addObject:event.eventId];
+        self.publishingAllEvents = NO;
+    }
+    if (completionBlock) {
+        completionBlock(success);
+    }
+}
+
+- (void) publishEvents:(NSArray<SFSDKInstrumentationEvent *> *) events {
+    [self publishEvents:events completion:nil];
+}
+
+- (void) publishEvents:(NSArray<SFSDKInstrumentationEvent *> *) events completion:(void (^)(BOOL)) completionBlock {
+    NSArray<SFSDKAnalyticsTransformPublisherPair *> *remotes = nil;
+    @synchronized (self.remotes) {
+        remotes = [self.remotes copy];
+    }
+    if (events.count == 0 || remotes.count == 0) {
+        if (completionBlock) {
+            completionBlock(NO);
         }
-        __block BOOL overallSuccess = YES;
-        __block BOOL overallCompletionStatus = NO;
-        NSMutableArray<SFSDKAnalyticsTransformPublisherPair *> *remoteKeySet = [self.remotes mutableCopy];
-        __block SFSDKAnalyticsTransformPublisherPair *currentTpp = remoteKeySet[0];
-        PublishCompleteBlock __block publishCompleteBlock = ^void(BOOL success, NSError *error) {
-
-            /*
-             * Updates the success flag only if all previous requests have been
-             * successful. This ensures that the operation is marked success only
-             * if all publishers are successful.
-             */
-            if (overallSuccess) {
-                overallSuccess = success;
-            }
+        return;
+    }
+    NSMutableArray<NSString *> *eventIds = [[NSMutableArray alloc] init];
+    for (SFSDKInstrumentationEvent *event in events) {
+        [eventIds addObject:event.eventId];
+    }
 
-            // Removes current transform from the list since it's done.
-            if (remoteKeySet) {
-                [remoteKeySet removeObject:currentTpp];
+    /*
+     * Every publisher gets the events it hasn't acknowledged yet, all of them at once: transforms
+     * run in parallel on a background queue and uploads go on concurrently.
+     */
+    dispatch_group_t group = dispatch_group_create();
+    __block BOOL overallSuccess = YES;
+    for (SFSDKAnalyticsTransformPublisherPair *tpp in remotes) {
+        NSArray<SFSDKInstrumentationEvent *> *pendingEvents = [self events:events notAcknowledgedBy:tpp];
+        if (pendingEvents.count == 0) {
+            continue;
+        }
+        dispatch_group_enter(group);
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            [self applyTransformAndPublish:tpp events:pendingEvents publishCompleteBlock:^(BOOL success, NSError *error) {
+                @synchronized (self.acknowledgedEventIds) {
+                    if (success) {
+                        NSMutableSet<NSString *> *acknowledged = [self.acknowledgedEventIds objectForKey:tpp];
+                        if (!acknowledged) {
+                            acknowledged = [[NSMutableSet alloc] init];
+                            [self.acknowledgedEventIds setObject:acknowledged forKey:tpp];
+                        }
+                        for (SFSDKInstrumentationEvent *event in pendingEvents) {
+                            [acknowledged addObject:event.eventId];
+                        }
+                    } else {
+                        [SFSDKCoreLogger w:[self class] format:@"%@ failed to publish %lu events", NSStringFromClass([tpp.publisher class]), (unsigned long)pendingEvents.count];
+                        overallSuccess = NO;
+                    }
+                }
+                dispatch_group_leave(group);
+            }];
+        });
+    }
+    dispatch_group_notify(group, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+
+        /*
+         * Deletes events from the event store once every publisher has acknowledged them. Publishers
+         * that did are skipped when the others get the events again.
+         */
+        BOOL success = NO;
+        @synchronized (self.acknowledgedEventIds) {
+            success = overallSuccess;
+            if (success) {
+                for (SFSDKAnalyticsTransformPublisherPair *tpp in remotes) {
+                    [[self.acknowledgedEventIds objectForKey:tpp] minusSet:[NSSet setWithArray:eventIds]];
+                }
             }
+        }
+        if (success) {
+            [self.eventStoreManager deleteEvents:eventIds];
+        }
+        if (completionBlock) {
+            completionBlock(success);
+        }
+    });
+}
 
-            // If there are no transforms left, we're done here.
-            if (remoteKeySet.count == 0) {
-                overallCompletionStatus = YES;
-            }
-            if (!overallCompletionStatus) {
-                currentTpp = remoteKeySet[0];
-                [self applyTransformAndPublish:currentTpp events:events publishCompleteBlock:publishCompleteBlock];
-            } else {
-
-                /*
-                 * Deletes events from the event store if the network publishing was successful.
-                 */
-                if (overallSuccess) {
-                    [self.eventStoreManager deleteEvents:eventIds];
-                }
-                publishCompleteBlock = nil;
+- (NSArray<SFSDKInstrumentationEvent *> *) events:(NSArray<SFSDKInstrumentationEvent *> *) events notAcknowledgedBy:(SFSDKAnalyticsTransformPublisherPair *) tpp {
+    @synchronized (self.acknowledgedEventIds) {
+        NSSet<NSString *> *acknowledged = [self.acknowledgedEventIds objectForKey:tpp];
+        if (acknowledged.count == 0) {
+            return events;
+        }
+        NSMutableArray<SFSDKInstrumentationEvent *> *pendingEvents = [[NSMutableArray alloc] init];
+        for (SFSDKInstrumentationEvent *event in events) {
+            if (![acknowledged containsObject:event.eventId]) {
+                [pendingEvents addObject:event];
             }
-        };
-        [self applyTransformAndPublish:currentTpp events:events publishCompleteBlock:publishCompleteBlock];
+        }
+        return pendingEvents;
     }
 }
 
@@ -252,11 +345,7 @@ static NSMutableDictionary *analyticsManagerList = nil;
     if (!event) {
         return;
     }
-    @synchronized (self) {
-        NSMutableArray<SFSDKInstrumentationEvent *> *events = [[NSMutableArray alloc] init];
-        [events addObject:event];
-        [self publishEvents:events];
-    }
+    [self publishEvents:@[event]];
 }
 
 - (void) addRemotePublisher:(id<SFSDKTransform>) transformer publisher:(id<SFSDKAnalyticsPublisher>) publisher {
@@ -265,7 +354,9 @@ static NSMutableDictionary *analyticsManagerList = nil;
         return;
     }
     SFSDKAnalyticsTransformPublisherPair *tpp = [[SFSDKAnalyticsTransformPublisherPair alloc] initWithTransform:transformer publisher:publisher];
-    [self.remotes addObject:tpp];
+    @synchronized (self.remotes) {
+        [self.remotes addObject:tpp];
+    }
 }
 
 + (SFSDKDeviceAppAttributes *) getDeviceAppAttributes {
@@ -310,6 +401,21 @@ static NSMutableDictionary *analyticsManagerList = nil;
 
     // Publishing should only happen for the current user, not for all users signed in.
     if (![self.userAccount.accountIdentity isEqual:[SFUserAccountManager sharedInstance].currentUser.accountIdentity]) {
+
+        // Buffered events still get written before the app gets suspended.
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            __block UIBackgroundTaskIdentifier task;
+            task = [[SFApplicationHelper sharedApplication] beginBackgroundTaskWithName:NSStringFromClass([self class]) expirationHandler:^{
+                [[SFApplicationHelper sharedApplication] endBackgroundTask:task];
+                task = UIBackgroundTaskInvalid;
+            }];
+            [self.analyticsManager flushAggregatedEvents];
+            [self.eventStoreManager flush];
+            if (task != UIBackgroundTaskInvalid) {
+                [[SFApplicationHelper sharedApplication] endBackgroundTask:task];
+                task = UIBackgroundTaskInvalid;
+            }
+        });
         return;
     }
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
@@ -318,9 +424,14 @@ static NSMutableDictionary *analyticsManagerList = nil;
             [[SFApplicationHelper sharedApplication] endBackgroundTask:task];
             task = UIBackgroundTaskInvalid;
         }];
-        [self publishAllEvents];
-        [[SFApplicationHelper sharedApplication] endBackgroundTask:task];
-        task = UIBackgroundTaskInvalid;
+
+        // Publishing goes on as long as chunks of events get published, the task ends with it
+        [self publishAllEventsWithCompletion:^(BOOL success) {
+            if (task != UIBackgroundTaskInvalid) {
+                [[SFApplicationHelper sharedApplication] endBackgroundTask:task];
+                task = UIBackgroundTaskInvalid;
+            }
+        }];
     });
 }
 
@@ -336,8 +447,10 @@ static NSMutableDictionary *analyticsManagerList = nil;
         id<SFSDKAnalyticsPublisher> networkPublisher = tpp.publisher;
         if (networkPublisher) {
             [networkPublisher publish:eventsArray publishCompleteBlock:publishCompleteBlock];
+            return;
         }
     }
+    publishCompleteBlock(NO, nil);
 }
 
 #pragma mark - SFUserAccountManagerDelegate
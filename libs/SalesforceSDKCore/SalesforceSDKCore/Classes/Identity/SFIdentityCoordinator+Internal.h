@@ -43,6 +43,11 @@
  */
 @property (nonatomic, strong) NSURLSession *session;
 
+/**
+ * The data task of the ID request.
+ */
+@property (nonatomic, strong) NSURLSessionDataTask *dataTask;
+
 /**
  * The OAuth sesssion refresher to use if the identity request fails with expired credentials.
  */
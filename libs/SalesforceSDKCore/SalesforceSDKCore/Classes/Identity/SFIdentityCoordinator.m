@@ -100,7 +100,8 @@ static NSString * const kSFIdentityDataPropertyKey            = @"com.salesforce
 
 - (void)cancelRetrieval
 {
-    [self.session invalidateAndCancel];
+    // The session is shared: only cancelling our own request
+    [self.dataTask cancel];
     [self cleanupData];
 }
 
@@ -136,9 +137,9 @@ static NSString * const kSFIdentityDataPropertyKey            = @"com.salesforce
     [request setHTTPShouldHandleCookies:NO];
     [SFSDKCoreLogger d:[self class] format:@"SFIdentityCoordinator:Starting identity request at %@", self.credentials.identityUrl.absoluteString];
     __weak __typeof(self) weakSelf = self;
-    SFNetwork *network = [[SFNetwork alloc] initWithEphemeralSession];
+    SFNetwork *network = [SFNetwork sharedEphemeralInstance];
     self.session = network.activeSession;
-    [network sendRequest:request dataResponseBlock:^(NSData *data, NSURLResponse *response, NSError *error) {
+    self.dataTask = [network sendRequest:request dataResponseBlock:^(NSData *data, NSURLResponse *response, NSError *error) {
         __strong typeof(weakSelf) strongSelf = weakSelf;
         if (error) {
             [SFSDKCoreLogger d:[self class] format:@"SFIdentityCoordinator session failed with error: %@", error];
@@ -205,6 +206,7 @@ static NSString * const kSFIdentityDataPropertyKey            = @"com.salesforce
 - (void)cleanupData
 {
     self.session = nil;
+    self.dataTask = nil;
     self.oauthSessionRefresher = nil;
     self.retrievingData = NO;
 }
@@ -263,7 +263,9 @@ static NSString * const kSFECParameter = @"ec";
 
 - (void)stopAuthentication {
     [_view stopLoading];
-    [self.session invalidateAndCancel];
+    // The session is shared: only cancelling our own request
+    [self.dataTask cancel];
+    self.dataTask = nil;
     _session = nil;
     
     self.authenticating = NO;
@@ -531,7 +533,8 @@ static NSString * const kSFECParameter = @"ec";
     [request setHTTPMethod:kHttpMethodPost];
     [request setValue:kHttpPostContentType forHTTPHeaderField:kHttpHeaderContentType];
     
-    [[self.session dataTaskWithRequest:request completionHandler:completionHandler] resume];
+    self.dataTask = [self.session dataTaskWithRequest:request completionHandler:completionHandler];
+    [self.dataTask resume];
 }
 
 // IDP related
@@ -612,7 +615,7 @@ static NSString * const kSFECParameter = @"ec";
     [SFSDKCoreLogger d:[self class] format:@"%@ with %@", NSStringFromSelector(_cmd), logString];
     NSData *encodedBody = [params dataUsingEncoding:NSUTF8StringEncoding];
     [request setHTTPBody:encodedBody];
-    [[self.session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+    self.dataTask = [self.session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
         if (error) {
             NSURL *requestUrl = [request URL];
             NSString *errorUrlString = [NSString stringWithFormat:@"%@://%@%@", [requestUrl scheme], [requestUrl host], [requestUrl relativePath]];
@@ -631,7 +634,8 @@ static NSString * const kSFECParameter = @"ec";
         self.responseData = [NSMutableData dataWithCapacity:kSFOAuthReponseBufferLength];
         [self.responseData appendData:data];
         [self.oauthCoordinatorFlow handleTokenEndpointResponse:self.responseData];
-    }] resume];
+    }];
+    [self.dataTask resume];
 }
 
 /* Handle a 'token' endpoint (e.g. refresh, advanced auth) response.
@@ -883,11 +887,8 @@ static NSString * const kSFECParameter = @"ec";
 }
 
 - (NSURLSession*)session {
-    if (_session == nil) {
-        SFNetwork *network = [[SFNetwork alloc] initWithEphemeralSession];
-        _session = network.activeSession;
-    }
-    return _session;
+    // Not holding on to the shared session: it gets replaced when the session configuration changes
+    return _session ?: [SFNetwork sharedEphemeralInstance].activeSession;
 }
 
 #pragma mark - WKNavigationDelegate (User-Agent Token Flow)
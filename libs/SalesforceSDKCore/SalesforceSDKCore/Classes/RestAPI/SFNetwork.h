@@ -40,6 +40,8 @@ NS_SWIFT_NAME(Network)
 @interface SFNetwork : NSObject
 
 typedef void (^SFDataResponseBlock) (NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) NS_SWIFT_NAME(DataResponseBlock);
+typedef void (^SFDownloadResponseBlock) (NSURL * _Nullable location, NSURLResponse * _Nullable response, NSError * _Nullable error) NS_SWIFT_NAME(DownloadResponseBlock);
+typedef void (^SFTransferProgressBlock) (int64_t bytesTransferred, int64_t totalBytesExpected) NS_SWIFT_NAME(TransferProgressBlock);
 
 @property (nonatomic, readonly, strong, nonnull) NSURLSession *activeSession;
 
@@ -57,6 +59,36 @@ typedef void (^SFDataResponseBlock) (NSData * _Nullable data, NSURLResponse * _N
  */
 - (nonnull instancetype)initWithBackgroundSession;
 
+/**
+ * Returns the shared instance used for requests not tied to a user.
+ *
+ * @return Shared instance of this class.
+ */
++ (nonnull instancetype)sharedEphemeralInstance NS_SWIFT_NAME(sharedEphemeralInstance());
+
+/**
+ * Returns the shared instance for the given identifier (typically a user key), creating it on first use.
+ * Shared instances keep their ephemeral session for as long as they live, so connections and
+ * TLS sessions get reused across requests.
+ *
+ * @param identifier Identifier of the shared instance.
+ * @return Shared instance of this class.
+ */
++ (nonnull instancetype)sharedEphemeralInstanceWithIdentifier:(nonnull NSString *)identifier NS_SWIFT_NAME(sharedEphemeralInstance(identifier:));
+
+/**
+ * Removes the shared instances whose identifier starts with the given identifier.
+ * Their sessions are invalidated once their outstanding tasks complete.
+ *
+ * @param identifier Identifier (or identifier prefix) of the shared instances to remove.
+ */
++ (void)removeSharedInstanceWithIdentifier:(nonnull NSString *)identifier;
+
+/**
+ * Removes all shared instances, invalidating their sessions once their outstanding tasks complete.
+ */
++ (void)removeAllSharedInstances;
+
 /**
  * Sends a REST request and calls the appropriate completion block.
  *
@@ -66,8 +98,31 @@ typedef void (^SFDataResponseBlock) (NSData * _Nullable data, NSURLResponse * _N
  */
 - (nonnull NSURLSessionDataTask *)sendRequest:(nonnull NSURLRequest *)urlRequest dataResponseBlock:(nullable SFDataResponseBlock)dataResponseBlock;
 
+/**
+ * Sends a REST request and calls the appropriate completion block.
+ *
+ * @param urlRequest NSURLRequest instance.
+ * @param progressBlock Called as the request body is sent.
+ * @param dataResponseBlock Network response block.
+ * @return NSURLSessionDataTask instance.
+ */
+- (nonnull NSURLSessionDataTask *)sendRequest:(nonnull NSURLRequest *)urlRequest progressBlock:(nullable SFTransferProgressBlock)progressBlock dataResponseBlock:(nullable SFDataResponseBlock)dataResponseBlock;
+
+/**
+ * Sends a REST request whose response body gets streamed to a temporary file instead of memory.
+ * The file is deleted once the response block returns, so it must be moved or read synchronously.
+ *
+ * @param urlRequest NSURLRequest instance.
+ * @param resumeData Resume data of an interrupted download of the same resource, nil to start from scratch.
+ * @param progressBlock Called as the response body is received.
+ * @param downloadResponseBlock Network response block.
+ * @return NSURLSessionDownloadTask instance.
+ */
+- (nonnull NSURLSessionDownloadTask *)sendDownloadRequest:(nonnull NSURLRequest *)urlRequest resumeData:(nullable NSData *)resumeData progressBlock:(nullable SFTransferProgressBlock)progressBlock downloadResponseBlock:(nullable SFDownloadResponseBlock)downloadResponseBlock;
+
 /**
  * Sets a session configuration to be used for network requests in the Mobile SDK.
+ * Shared instances are removed so that subsequent requests use the new configuration.
  *
  * @param sessionConfig Session configuration to be used.
  */
@@ -75,6 +130,7 @@ typedef void (^SFDataResponseBlock) (NSData * _Nullable data, NSURLResponse * _N
 
 /**
  * Delegates the creation of NSURLSession to an external object.
+ * Shared instances are removed so that subsequent sessions get created by the manager.
  *
  * @param manager object implementing the SFNetworkSessionManaging protocol.
  */
@@ -30,9 +30,67 @@
 #import "SFNetwork.h"
 #import "SalesforceSDKManager.h"
 
+// Reports the progress of a task by observing its byte counts, received for downloads and sent otherwise
+@interface SFSDKTaskProgressObserver : NSObject
+
+@property (nonatomic, strong, readonly) NSURLSessionTask *task;
+@property (nonatomic, copy, readonly) SFTransferProgressBlock progressBlock;
+
+- (instancetype)initWithTask:(NSURLSessionTask *)task progressBlock:(SFTransferProgressBlock)progressBlock;
+- (void)invalidate;
+
+@end
+
+@implementation SFSDKTaskProgressObserver {
+    BOOL _observing;
+    NSString *_keyPath;
+}
+
+static void *kSFTaskProgressContext = &kSFTaskProgressContext;
+
+- (instancetype)initWithTask:(NSURLSessionTask *)task progressBlock:(SFTransferProgressBlock)progressBlock {
+    self = [super init];
+    if (self) {
+        _task = task;
+        _progressBlock = [progressBlock copy];
+        _keyPath = [task isKindOfClass:[NSURLSessionDownloadTask class]] ? NSStringFromSelector(@selector(countOfBytesReceived)) : NSStringFromSelector(@selector(countOfBytesSent));
+        [task addObserver:self forKeyPath:_keyPath options:NSKeyValueObservingOptionNew context:kSFTaskProgressContext];
+        _observing = YES;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self invalidate];
+}
+
+- (void)invalidate {
+    @synchronized (self) {
+        if (_observing) {
+            [self.task removeObserver:self forKeyPath:_keyPath context:kSFTaskProgressContext];
+            _observing = NO;
+        }
+    }
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary<NSKeyValueChangeKey, id> *)change context:(void *)context {
+    if (context != kSFTaskProgressContext) {
+        [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+        return;
+    }
+    if ([self.task isKindOfClass:[NSURLSessionDownloadTask class]]) {
+        self.progressBlock(self.task.countOfBytesReceived, self.task.countOfBytesExpectedToReceive);
+    } else {
+        self.progressBlock(self.task.countOfBytesSent, self.task.countOfBytesExpectedToSend);
+    }
+}
+
+@end
+
 @interface SFNetwork()
 
 @property (nonatomic, readwrite, strong) NSURLSession *activeSession;
+@property (nonatomic, readwrite, assign) BOOL ownsSession;
 
 @end
 
@@ -40,6 +98,8 @@
 
 static NSURLSessionConfiguration *kSFSessionConfig;
 __weak static id<SFNetworkSessionManaging> kSFNetworkManager;
+static NSMutableDictionary<NSString *, SFNetwork *> *kSFSharedInstances;
+static NSString * const kSFDefaultSharedInstanceIdentifier = @"com.salesforce.network.shared";
 
 - (instancetype)initWithEphemeralSession {
     self = [super init];
@@ -52,6 +112,7 @@ __weak static id<SFNetworkSessionManaging> kSFNetworkManager;
             self.activeSession = [kSFNetworkManager ephemeralSession:ephemeralSessionConfig];
         } else {
             self.activeSession = [NSURLSession sessionWithConfiguration:ephemeralSessionConfig];
+            self.ownsSession = YES;
         }
     }
     return self;
@@ -74,27 +135,108 @@ __weak static id<SFNetworkSessionManaging> kSFNetworkManager;
     return self;
 }
 
++ (instancetype)sharedEphemeralInstance {
+    return [self sharedEphemeralInstanceWithIdentifier:kSFDefaultSharedInstanceIdentifier];
+}
+
++ (instancetype)sharedEphemeralInstanceWithIdentifier:(NSString *)identifier {
+    @synchronized ([SFNetwork class]) {
+        if (!kSFSharedInstances) {
+            kSFSharedInstances = [[NSMutableDictionary alloc] init];
+        }
+        SFNetwork *network = kSFSharedInstances[identifier];
+        if (!network) {
+            network = [[SFNetwork alloc] initWithEphemeralSession];
+            kSFSharedInstances[identifier] = network;
+        }
+        return network;
+    }
+}
+
++ (void)removeSharedInstanceWithIdentifier:(NSString *)identifier {
+    @synchronized ([SFNetwork class]) {
+        for (NSString *key in kSFSharedInstances.allKeys) {
+            if ([key hasPrefix:identifier]) {
+                [kSFSharedInstances[key] invalidateSession];
+                [kSFSharedInstances removeObjectForKey:key];
+            }
+        }
+    }
+}
+
++ (void)removeAllSharedInstances {
+    @synchronized ([SFNetwork class]) {
+        for (SFNetwork *network in kSFSharedInstances.allValues) {
+            [network invalidateSession];
+        }
+        [kSFSharedInstances removeAllObjects];
+    }
+}
+
+// Sessions handed out by a session manager belong to that manager
+- (void)invalidateSession {
+    if (self.ownsSession) {
+        [self.activeSession finishTasksAndInvalidate];
+    }
+}
+
 - (NSURLSessionDataTask *)sendRequest:(NSMutableURLRequest *)urlRequest dataResponseBlock:(SFDataResponseBlock)dataResponseBlock {
+    return [self sendRequest:urlRequest progressBlock:nil dataResponseBlock:dataResponseBlock];
+}
+
+- (NSURLSessionDataTask *)sendRequest:(NSMutableURLRequest *)urlRequest progressBlock:(SFTransferProgressBlock)progressBlock dataResponseBlock:(SFDataResponseBlock)dataResponseBlock {
 
     // Sets Mobile SDK user agent if it hasn't been set already elsewhere.
     if (![urlRequest.allHTTPHeaderFields.allKeys containsObject:@"User-Agent"]) {
         [urlRequest setValue:[SalesforceSDKManager sharedManager].userAgentString(@"") forHTTPHeaderField:@"User-Agent"];
     }
+    __block SFSDKTaskProgressObserver *progressObserver = nil;
     NSURLSessionDataTask *dataTask = [self.activeSession dataTaskWithRequest:urlRequest completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        [progressObserver invalidate];
+        progressObserver = nil;
         if (dataResponseBlock) {
             dataResponseBlock(data, response, error);
         }
     }];
+    if (progressBlock) {
+        progressObserver = [[SFSDKTaskProgressObserver alloc] initWithTask:dataTask progressBlock:progressBlock];
+    }
     [dataTask resume];
     return dataTask;
 }
 
+- (NSURLSessionDownloadTask *)sendDownloadRequest:(NSMutableURLRequest *)urlRequest resumeData:(NSData *)resumeData progressBlock:(SFTransferProgressBlock)progressBlock downloadResponseBlock:(SFDownloadResponseBlock)downloadResponseBlock {
+    if (![urlRequest.allHTTPHeaderFields.allKeys containsObject:@"User-Agent"]) {
+        [urlRequest setValue:[SalesforceSDKManager sharedManager].userAgentString(@"") forHTTPHeaderField:@"User-Agent"];
+    }
+    __block SFSDKTaskProgressObserver *progressObserver = nil;
+    void (^completionHandler)(NSURL *, NSURLResponse *, NSError *) = ^(NSURL *location, NSURLResponse *response, NSError *error) {
+        [progressObserver invalidate];
+        progressObserver = nil;
+        if (downloadResponseBlock) {
+            downloadResponseBlock(location, response, error);
+        }
+    };
+    NSURLSessionDownloadTask *downloadTask = resumeData ? [self.activeSession downloadTaskWithResumeData:resumeData completionHandler:completionHandler] : [self.activeSession downloadTaskWithRequest:urlRequest completionHandler:completionHandler];
+    if (progressBlock) {
+        progressObserver = [[SFSDKTaskProgressObserver alloc] initWithTask:downloadTask progressBlock:progressBlock];
+    }
+    [downloadTask resume];
+    return downloadTask;
+}
+
 + (void)setSessionConfiguration:(NSURLSessionConfiguration *)sessionConfig {
-    kSFSessionConfig = sessionConfig;
+    @synchronized ([SFNetwork class]) {
+        kSFSessionConfig = sessionConfig;
+        [self removeAllSharedInstances];
+    }
 }
 
 + (void)setSessionManager:(id<SFNetworkSessionManaging>)manager {
-    kSFNetworkManager = manager;
+    @synchronized ([SFNetwork class]) {
+        kSFNetworkManager = manager;
+        [self removeAllSharedInstances];
+    }
 }
 
 @end
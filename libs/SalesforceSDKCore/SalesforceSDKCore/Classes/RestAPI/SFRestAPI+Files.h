@@ -102,6 +102,29 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (SFRestRequest *) requestForFileContents:(NSString *) sfdcId version:(nullable NSString*) version;
 
+/**
+ * Builds a request that streams the binary file contents of this particular file
+ * to a file, instead of loading them in memory.
+ *
+ * @param sfdcId The Id of the file
+ * @param version The version of the file
+ * @param destinationURL File URL the contents get written to, handed to the delegate once the download completes.
+ * @return A new SFRestRequest that can be used to fetch this data
+ */
+- (SFRestRequest *) requestForFileContents:(NSString *) sfdcId version:(nullable NSString*) version destinationURL:(NSURL *)destinationURL;
+
+/**
+ * Builds a request that streams the contents of a blob field (e.g. the VersionData of a ContentVersion)
+ * to a file, instead of loading them in memory.
+ *
+ * @param objectType Object type (e.g. ContentVersion)
+ * @param objectId Id of the record
+ * @param fieldName Name of the blob field (e.g. VersionData)
+ * @param destinationURL File URL the contents get written to, handed to the delegate once the download completes.
+ * @return A new SFRestRequest that can be used to fetch this data
+ */
+- (SFRestRequest *) requestForBlobWithObjectType:(NSString *)objectType objectId:(NSString *)objectId fieldName:(NSString *)fieldName destinationURL:(NSURL *)destinationURL;
+
 /**
  * Build a request that can fetch a page from the list of entities that this
  * file is shared to.
@@ -143,6 +166,20 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (SFRestRequest *) requestForUploadFile:(NSData *)data name:(NSString *)name description:(NSString *)description mimeType:(NSString *)mimeType;
 
+/**
+ * Build a request that can upload a new file to the server, this will
+ * create a new file at version 1. The file gets streamed from disk as it is sent,
+ * rather than loaded in memory.
+ *
+ * @param fileURL URL of the file to upload.
+ * @param name The name/title of this file.
+ * @param description A description of the file.
+ * @param mimeType The mime-type of the file, if known.
+ * @param decryptionKey Key the file was encrypted with (see SFEncryptStream), nil if it isn't encrypted.
+ * @return A SFRestRequest that can perform this upload.
+ */
+- (SFRestRequest *) requestForUploadFileAtURL:(NSURL *)fileURL name:(NSString *)name description:(NSString *)description mimeType:(nullable NSString *)mimeType decryptionKey:(nullable SFEncryptionKey *)decryptionKey;
+
 /**
  * Build a request that can upload a new profile photo to the server
  *
@@ -92,6 +92,21 @@
     return request;
 }
 
+- (SFRestRequest *) requestForFileContents:(NSString *) sfdcId version:(NSString*) version destinationURL:(NSURL *)destinationURL {
+    SFRestRequest *request = [self requestForFileContents:sfdcId version:version];
+    request.parseResponse = NO;
+    request.downloadDestinationURL = destinationURL;
+    return request;
+}
+
+- (SFRestRequest *) requestForBlobWithObjectType:(NSString *)objectType objectId:(NSString *)objectId fieldName:(NSString *)fieldName destinationURL:(NSURL *)destinationURL {
+    NSString *path = [NSString stringWithFormat:@"/%@/sobjects/%@/%@/%@", self.apiVersion, objectType, objectId, fieldName];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    request.parseResponse = NO;
+    request.downloadDestinationURL = destinationURL;
+    return request;
+}
+
 - (SFRestRequest *) requestForFileShares:(NSString *)sfdcId page:(NSUInteger)page {
     NSString *path = [NSString stringWithFormat:@"/%@/connect%@/files/%@/file-shares", self.apiVersion,[self communitiesUrlPathIfRequired], sfdcId];
     NSMutableDictionary *params = [NSMutableDictionary dictionary];
@@ -127,6 +142,15 @@
     return request;
 }
 
+- (SFRestRequest *) requestForUploadFileAtURL:(NSURL *)fileURL name:(NSString *)name description:(NSString *)description mimeType:(NSString *)mimeType decryptionKey:(SFEncryptionKey *)decryptionKey {
+    NSString *path = [NSString stringWithFormat:@"/%@/connect%@/files/users/me", self.apiVersion,[self communitiesUrlPathIfRequired]];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:path queryParams:nil];
+
+    NSDictionary *params = @{@"title" : name, @"desc" : description};
+    [request addPostFileURL:fileURL paramName:FILE_DATA fileName:name mimeType:mimeType params:params decryptionKey:decryptionKey];
+    return request;
+}
+
 - (SFRestRequest *)requestForProfilePhotoUpload:(NSData *)data fileName:(NSString *)fileName mimeType:(NSString *)mimeType userId:(NSString *)userId {
     NSString *path = [NSString stringWithFormat:@"/%@/connect%@/user-profiles/%@/photo", self.apiVersion, [self communitiesUrlPathIfRequired], userId];
     SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:path queryParams:nil];
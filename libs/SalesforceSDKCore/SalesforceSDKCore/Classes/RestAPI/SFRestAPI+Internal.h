@@ -25,6 +25,11 @@
 #import "SFRestAPI.h"
 #import "SFUserAccountManager.h"
 #import <SalesforceSDKCommon/SFSDKSafeMutableSet.h>
+
+@class SFSDKRequestScheduler;
+@class SFSDKRequestBatcher;
+@class SFSDKRequestCoalescer;
+
 /**
  We declare here a set of interfaces that are meant to be used by code running internally
  to SFRestAPI or close "friend" classes such as unit test helpers. You SHOULD NOT access these interfaces
@@ -42,6 +47,21 @@
 
 @property (nullable, nonatomic, strong) id<SFRestDelegate>instrDelegateInternal;
 
+/**
+ * Scheduler ordering and throttling the requests sent by this instance (shared by all instances by default).
+ */
+@property (nonatomic, strong, nonnull) SFSDKRequestScheduler *requestScheduler;
+
+/**
+ * Batcher gathering requests into composite requests when auto batching is enabled.
+ */
+@property (nonatomic, readonly, strong, nonnull) SFSDKRequestBatcher *requestBatcher;
+
+/**
+ * Coalescer sharing the response of requests in flight with identical requests.
+ */
+@property (nonatomic, readonly, strong, nonnull) SFSDKRequestCoalescer *requestCoalescer;
+
 - (void)removeActiveRequestObject:(nonnull SFRestRequest *)request;
 
 /**
@@ -54,6 +74,23 @@
 
 - (void)send:(nonnull SFRestRequest *)request delegate:(nullable id<SFRestDelegate>)delegate shouldRetry:(BOOL)shouldRetry;
 
+/**
+ * Resends the active requests once the access token got refreshed, leaving out the ones still queued in the scheduler.
+ */
+- (void)resendActiveRequestsRequiringAuthentication;
+
+/**
+ * Fails the active requests after the access token could not be refreshed, leaving out the ones still queued in the scheduler.
+ */
+- (void)flushPendingRequestQueue:(nullable NSError *)error rawResponse:(nullable NSURLResponse *)rawResponse;
+
+- (void)notifyDelegateOfResponse:(nullable id<SFRestDelegate>)delegate request:(nonnull SFRestRequest *)request data:(nullable id)data rawResponse:(nullable NSURLResponse *)rawResponse;
+- (void)notifyDelegateOfFailure:(nullable id<SFRestDelegate>)delegate request:(nonnull SFRestRequest *)request error:(nullable NSError *)error rawResponse:(nullable NSURLResponse *)rawResponse;
+- (void)notifyDelegateOfCancel:(nullable id<SFRestDelegate>)delegate request:(nonnull SFRestRequest *)request;
+- (void)notifyDelegateOfTimeout:(nullable id<SFRestDelegate>)delegate request:(nonnull SFRestRequest *)request;
++ (nonnull NSOperationQueue *)responseParsingQueue;
++ (nonnull dispatch_queue_t)defaultDeliveryQueue;
+
 + (void)removeSharedInstanceWithUser:(nonnull SFUserAccount *)user;
 
 @end
@@ -26,6 +26,7 @@
 #import "SFRestRequest.h"
 #import "SFSObjectTree.h"
 #import "SFUserAccount.h"
+#import "SFSDKResponseCache.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -147,6 +148,49 @@ NS_SWIFT_NAME(RestClient)
  */
 @property (nonatomic, strong, readonly) SFUserAccount *user NS_SWIFT_NAME(userAccount);
 
+/**
+ * Whether requests sent with `send:delegate:` get gathered into composite requests. NO by default.
+ * Requests sent within `autoBatchingWindow` of each other are sent together (up to 25 at a time),
+ * each delegate still gets its own response. Requests not supported by the composite API are sent as usual.
+ */
+@property (nonatomic, assign) BOOL autoBatchingEnabled;
+
+/**
+ * Time (in seconds) during which requests are gathered into a single composite request. 0.05 by default.
+ */
+@property (nonatomic, assign) NSTimeInterval autoBatchingWindow;
+
+/**
+ * Whether GET requests identical to a request already in flight (same URL, headers and parsing options) share
+ * its response instead of going out again. YES by default. Cancelling one of them leaves the others running.
+ */
+@property (nonatomic, assign) BOOL coalescesIdenticalRequests;
+
+/**
+ * Lifetime (in seconds) of an access token used when the org's session timeout is not known. The session timeout
+ * comes from the token response's `expires_in` value if any, then from the `SESSION_TIMEOUT` custom attribute
+ * (in minutes) of the connected app in the user's identity data. 2 hours (Salesforce's default) by default.
+ * Set to 0 to only refresh the token once a request gets a 401.
+ */
+@property (nonatomic, assign) NSTimeInterval sessionTimeout;
+
+/**
+ * How long (in seconds) before the access token expires it gets refreshed in the background. 5 minutes by default.
+ * Authenticated requests sent while the token is being refreshed past its expiry wait for the new token.
+ */
+@property (nonatomic, assign) NSTimeInterval tokenRefreshLeadTime;
+
+/**
+ * Date at which the current access token is expected to expire, nil when unknown.
+ */
+@property (nullable, nonatomic, readonly) NSDate *accessTokenExpirationDate;
+
+/**
+ * Cache of the responses of requests with `cacheResponse` set (shared by all instances of a given user),
+ * or nil for instances without a user. Exposes its size budget and hit/miss statistics.
+ */
+@property (nonatomic, readonly, nullable) SFSDKResponseCache *responseCache;
+
 /**
  * Returns the singleton instance of `SFRestAPI` associated with the current user.
  */
@@ -393,6 +437,39 @@ NS_SWIFT_NAME(RestClient)
  */
 - (SFRestRequest*) requestForSObjectTree:(NSString*)objectType objectTrees:(NSArray<SFSObjectTree*>*)objectTrees;
 
+/**
+ * Returns an `SFRestRequest` which creates up to 200 records in one call using sObject Collections.
+ * @param allOrNone Indicates whether to roll back the entire request when the creation of any object fails.
+ * @param records Array of records to create. Each record must have an "attributes" entry with its "type".
+ * @see https://developer.salesforce.com/docs/atlas.en-us.api_rest.meta/api_rest/resources_composite_sobjects_collections_create.htm
+ */
+- (SFRestRequest *)requestForCollectionCreate:(BOOL)allOrNone records:(NSArray<NSDictionary*>*)records NS_SWIFT_NAME(requestForCollectionCreate(allOrNone:records:));
+
+/**
+ * Returns an `SFRestRequest` which updates up to 200 records in one call using sObject Collections.
+ * @param allOrNone Indicates whether to roll back the entire request when the update of any object fails.
+ * @param records Array of records to update. Each record must have an "attributes" entry with its "type" and an "id".
+ * @see https://developer.salesforce.com/docs/atlas.en-us.api_rest.meta/api_rest/resources_composite_sobjects_collections_update.htm
+ */
+- (SFRestRequest *)requestForCollectionUpdate:(BOOL)allOrNone records:(NSArray<NSDictionary*>*)records NS_SWIFT_NAME(requestForCollectionUpdate(allOrNone:records:));
+
+/**
+ * Returns an `SFRestRequest` which deletes up to 200 records in one call using sObject Collections.
+ * @param allOrNone Indicates whether to roll back the entire request when the deletion of any object fails.
+ * @param objectIds Array of ids of the records to delete.
+ * @see https://developer.salesforce.com/docs/atlas.en-us.api_rest.meta/api_rest/resources_composite_sobjects_collections_delete.htm
+ */
+- (SFRestRequest *)requestForCollectionDelete:(BOOL)allOrNone objectIds:(NSArray<NSString*>*)objectIds NS_SWIFT_NAME(requestForCollectionDelete(allOrNone:objectIds:));
+
+/**
+ * Returns an `SFRestRequest` which retrieves up to 2000 records of the same type in one call using sObject Collections.
+ * @param objectType object type; for example, "Account"
+ * @param objectIds Array of ids of the records to retrieve.
+ * @param fieldList Array of fields to return for each record.
+ * @see https://developer.salesforce.com/docs/atlas.en-us.api_rest.meta/api_rest/resources_composite_sobjects_collections_retrieve.htm
+ */
+- (SFRestRequest *)requestForCollectionRetrieve:(NSString *)objectType objectIds:(NSArray<NSString*>*)objectIds fieldList:(NSArray<NSString*>*)fieldList NS_SWIFT_NAME(requestForCollectionRetrieve(objectType:objectIds:fieldList:));
+
 ///---------------------------------------------------------------------------------------
 /// @name Other utility methods
 ///---------------------------------------------------------------------------------------
@@ -30,6 +30,14 @@
 #import "SalesforceSDKManager.h"
 #import "SFSDKEventBuilderHelper.h"
 #import "SFNetwork.h"
+#import "SFSDKRequestScheduler.h"
+#import "SFSDKRequestBatcher.h"
+#import "SFSDKRequestCoalescer.h"
+#import "SFSDKResponseCache.h"
+#import "SFSDKRetryPolicy.h"
+#import "SFSDKCircuitBreaker.h"
+#import "SFEncryptStream.h"
+#import "SFSDKLazyJSONResponse.h"
 #import "SFOAuthSessionRefresher.h"
 #import "NSString+SFAdditions.h"
 
@@ -41,11 +49,21 @@ NSInteger const kSFRestErrorCode = 999;
 
 static BOOL kIsTestRun;
 static SFSDKSafeMutableDictionary *sfRestApiList = nil;
+static NSUInteger const kSFDownloadBufferSize = 64 * 1024;
+static NSInteger const kSFMaxConcurrentResponseParsing = 2;
+static NSTimeInterval const kSFDefaultSessionTimeout = 2 * 60 * 60;
+static NSTimeInterval const kSFDefaultTokenRefreshLeadTime = 5 * 60;
+static NSTimeInterval const kSFProactiveRefreshRetryInterval = 60;
+static NSString * const kSFOAuthExpiresIn = @"expires_in";
+static NSString * const kSFSessionTimeoutAttribute = @"SESSION_TIMEOUT";
 
 @interface SFRestAPI ()
 
 @property (readwrite, assign) BOOL sessionRefreshInProgress;
 @property (readwrite, assign) BOOL pendingRequestsBeingProcessed;
+@property (readwrite, assign) BOOL proactiveRefreshInProgress;
+@property (nonatomic, strong) NSDate *proactiveRefreshRetryDate;
+@property (nonatomic, strong) NSMutableArray<SFRestRequest *> *requestsAwaitingRefresh;
 @property (nonatomic, strong) SFOAuthSessionRefresher *oauthSessionRefresher;
 @property (nonatomic, strong, readwrite) SFUserAccount *user;
 
@@ -55,6 +73,8 @@ static SFSDKSafeMutableDictionary *sfRestApiList = nil;
 
 @synthesize apiVersion = _apiVersion;
 @synthesize activeRequests = _activeRequests;
+@synthesize requestBatcher = _requestBatcher;
+@synthesize requestCoalescer = _requestCoalescer;
 
 __strong static NSDateFormatter *httpDateFormatter = nil;
 
@@ -72,6 +92,13 @@ __strong static NSDateFormatter *httpDateFormatter = nil;
     if (self) {
         self.user = user;
         _activeRequests = [SFSDKSafeMutableSet setWithCapacity:10];
+        _requestScheduler = [SFSDKRequestScheduler sharedInstance];
+        _requestBatcher = [[SFSDKRequestBatcher alloc] initWithRestAPI:self];
+        _requestCoalescer = [[SFSDKRequestCoalescer alloc] initWithRestAPI:self];
+        _coalescesIdenticalRequests = YES;
+        _sessionTimeout = kSFDefaultSessionTimeout;
+        _tokenRefreshLeadTime = kSFDefaultTokenRefreshLeadTime;
+        _requestsAwaitingRefresh = [NSMutableArray array];
         self.apiVersion = kSFRestDefaultAPIVersion;
         self.sessionRefreshInProgress = NO;
         self.pendingRequestsBeingProcessed = NO;
@@ -93,10 +120,20 @@ __strong static NSDateFormatter *httpDateFormatter = nil;
 
 - (void)cancelAllRequests {
     
-    [self.activeRequests enumerateObjectsUsingBlock:^(id obj, BOOL *stop) {
-        SFRestRequest *request = obj;
+    // Works off a snapshot since requests still queued in the scheduler notify their delegate right away
+    for (SFRestRequest *request in [self.activeRequests asSet]) {
         [request cancel];
-    }];
+    }
+    [self.requestCoalescer cancelAllRequests];
+    NSArray<SFRestRequest *> *waitingRequests = nil;
+    @synchronized (self) {
+        waitingRequests = [self.requestsAwaitingRefresh copy];
+        [self.requestsAwaitingRefresh removeAllObjects];
+    }
+    for (SFRestRequest *request in waitingRequests) {
+        [self notifyDelegateOfCancel:request.delegate request:request];
+    }
+    [self.requestBatcher cancelPendingRequests];
     [self.activeRequests removeAllObjects];
     
 }
@@ -106,7 +143,7 @@ static dispatch_once_t pred;
 
 + (SFRestAPI *)sharedGlobalInstance {
     dispatch_once(&pred, ^{
-        sfRestApiList = [[SFSDKSafeMutableDictionary alloc] init];
+        sfRestApiList = [[SFSDKSafeMutableDictionary alloc] initWithCopyOnWriteSnapshots:YES];
     });
     
     @synchronized ([SFRestAPI class]) {
@@ -127,7 +164,7 @@ static dispatch_once_t pred;
 + (SFRestAPI *)sharedInstanceWithUser:(SFUserAccount *)user {
     
     dispatch_once(&pred, ^{
-        sfRestApiList = [[SFSDKSafeMutableDictionary alloc] init];
+        sfRestApiList = [[SFSDKSafeMutableDictionary alloc] initWithCopyOnWriteSnapshots:YES];
     });
     @synchronized ([SFRestAPI class]) {
         if (!user) {
@@ -171,6 +208,9 @@ static dispatch_once_t pred;
                     [sfRestApiList removeObject:key];
                 }
             }
+
+            // Invalidates the network sessions of this user (and its community users)
+            [SFNetwork removeSharedInstanceWithIdentifier:userKey];
         }
     }
 }
@@ -216,9 +256,63 @@ static dispatch_once_t pred;
     return [SalesforceSDKManager sharedManager].userAgentString(qualifier);
 }
 
+- (SFSDKResponseCache *)responseCache {
+    return self.user ? [SFSDKResponseCache sharedCacheForUser:self.user] : nil;
+}
+
+- (NSDate *)accessTokenExpirationDate {
+    SFOAuthCredentials *credentials = self.user.credentials;
+    if (self.sessionTimeout <= 0 || credentials.accessToken == nil || credentials.issuedAt == nil) {
+        return nil;
+    }
+    return [credentials.issuedAt dateByAddingTimeInterval:[self accessTokenLifetime]];
+}
+
+/*
+ * Lifetime of the access token, from the token response (expires_in) if it has one, then from the identity
+ * data (session timeout in minutes, handed out by the connected app as its SESSION_TIMEOUT custom attribute),
+ * sessionTimeout being the fallback.
+ */
+- (NSTimeInterval)accessTokenLifetime {
+    id expiresIn = self.user.credentials.additionalOAuthFields[kSFOAuthExpiresIn];
+    if ([expiresIn respondsToSelector:@selector(doubleValue)] && [expiresIn doubleValue] > 0) {
+        return [expiresIn doubleValue];
+    }
+    id timeoutMinutes = self.user.idData.customAttributes[kSFSessionTimeoutAttribute];
+    if ([timeoutMinutes respondsToSelector:@selector(doubleValue)] && [timeoutMinutes doubleValue] > 0) {
+        return [timeoutMinutes doubleValue] * 60;
+    }
+    return self.sessionTimeout;
+}
+
+- (NSTimeInterval)autoBatchingWindow {
+    return self.requestBatcher.batchingWindow;
+}
+
+- (void)setAutoBatchingWindow:(NSTimeInterval)autoBatchingWindow {
+    self.requestBatcher.batchingWindow = autoBatchingWindow;
+}
+
 #pragma mark - send method
 
 - (void)send:(SFRestRequest *)request delegate:(id<SFRestDelegate>)delegate {
+    request.retryCount = 0;
+    request.cancelRequested = NO;
+    request.skipsConditionalHeaders = NO;
+
+    // Identical requests in flight share one response, the first one's copy is what actually goes out
+    if (self.coalescesIdenticalRequests && self.user && [SFSDKRequestCoalescer canCoalesceRequest:request]) {
+        SFRestRequest *carrier = [self.requestCoalescer addRequest:request delegate:delegate];
+        if (!carrier) {
+            return;
+        }
+        request = carrier;
+        delegate = self.requestCoalescer;
+    }
+    if (self.autoBatchingEnabled && self.requiresAuthentication && [SFSDKRequestBatcher canBatchRequest:request]) {
+        [self.requestBatcher addRequest:request delegate:delegate];
+        return;
+    }
     [self send:request delegate:delegate shouldRetry:self.requiresAuthentication && request.requiresAuthentication];
 }
 
@@ -239,7 +333,7 @@ static dispatch_once_t pred;
             __strong typeof(weakSelf) strongSelf = weakSelf;
             [SFUserAccountManager sharedInstance].currentUser = userAccount;
             strongSelf.user = userAccount;
-            [strongSelf enqueueRequest:request delegate:delegate shouldRetry:shouldRetry];
+            [strongSelf scheduleRequest:request delegate:delegate shouldRetry:shouldRetry];
         } failure:^(SFOAuthInfo *authInfo, NSError *error) {
             __strong typeof(weakSelf) strongSelf = weakSelf;
             [SFSDKCoreLogger e:[strongSelf class] format:@"Authentication failed in SFRestAPI: %@. Logging out.", error];
@@ -249,8 +343,65 @@ static dispatch_once_t pred;
             [SFSDKEventBuilderHelper createAndStoreEvent:@"userLogout" userAccount:nil className:NSStringFromClass([strongSelf class]) attributes:attributes];
             [[SFUserAccountManager sharedInstance] logout];
         }];
+    } else if (shouldRetry && [self holdRequestForTokenRefresh:request]) {
+        [SFSDKCoreLogger d:[self class] format:@"Request waiting for the access token to be refreshed: %@", request.path];
     } else {
-        [self enqueueRequest:request delegate:delegate shouldRetry:shouldRetry];
+        [self scheduleRequest:request delegate:delegate shouldRetry:shouldRetry];
+    }
+}
+
+/*
+ * Refreshes the access token in the background once it's about to expire. Requests keep going out with the
+ * current token until it actually expires, from then on they wait for the new one (as they do during a refresh
+ * triggered by a 401).
+ */
+- (BOOL)holdRequestForTokenRefresh:(SFRestRequest *)request {
+    NSDate *expirationDate = self.accessTokenExpirationDate;
+    NSTimeInterval timeLeft = expirationDate ? [expirationDate timeIntervalSinceNow] : DBL_MAX;
+    @synchronized (self) {
+        if (!self.sessionRefreshInProgress && timeLeft <= self.tokenRefreshLeadTime && self.user.credentials.refreshToken
+            && (!self.proactiveRefreshRetryDate || [self.proactiveRefreshRetryDate timeIntervalSinceNow] <= 0)) {
+            [self refreshSessionBeforeExpiry];
+        }
+        if (self.sessionRefreshInProgress && (!self.proactiveRefreshInProgress || timeLeft <= 0)) {
+            [self.requestsAwaitingRefresh addObject:request];
+            return YES;
+        }
+    }
+    return NO;
+}
+
+- (void)refreshSessionBeforeExpiry {
+    [SFSDKCoreLogger i:[self class] format:@"%@: Access token about to expire, refreshing it in the background.", NSStringFromSelector(_cmd)];
+    self.sessionRefreshInProgress = YES;
+    self.proactiveRefreshInProgress = YES;
+    SFOAuthSessionRefresher *sessionRefresher = [self sessionRefresherForUser:self.user];
+    __weak __typeof(self) weakSelf = self;
+    [sessionRefresher refreshSessionWithCompletion:^(SFOAuthCredentials *updatedCredentials) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        strongSelf.proactiveRefreshRetryDate = nil;
+        [strongSelf finishRefreshBeforeExpiry];
+    } error:^(NSError *refreshError) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+
+        // The current token may still be good, a request getting a 401 goes through the usual refresh
+        [SFSDKCoreLogger w:[strongSelf class] format:@"Background refresh of the access token failed. Error: %@", refreshError];
+        strongSelf.proactiveRefreshRetryDate = [NSDate dateWithTimeIntervalSinceNow:kSFProactiveRefreshRetryInterval];
+        [strongSelf finishRefreshBeforeExpiry];
+    }];
+}
+
+- (void)finishRefreshBeforeExpiry {
+    NSArray<SFRestRequest *> *waitingRequests = nil;
+    @synchronized (self) {
+        self.sessionRefreshInProgress = NO;
+        self.proactiveRefreshInProgress = NO;
+        self.oauthSessionRefresher = nil;
+        waitingRequests = [self.requestsAwaitingRefresh copy];
+        [self.requestsAwaitingRefresh removeAllObjects];
+    }
+    for (SFRestRequest *request in waitingRequests) {
+        [self send:request delegate:request.delegate shouldRetry:YES];
     }
 }
 
@@ -268,64 +419,249 @@ static dispatch_once_t pred;
     return self.oauthSessionRefresher;
 }
 
-- (void)enqueueRequest:(SFRestRequest *)request delegate:(id<SFRestDelegate>)delegate shouldRetry:(BOOL)shouldRetry {
+// Requests of a given user (and community) share one long lived network session
+- (NSString *)networkIdentifier {
+    NSString *key = self.user ? SFKeyForUserAndScope(self.user, SFUserAccountScopeCommunity) : nil;
+    return key ?: SFKeyForGlobalScope();
+}
+
+// Host used by the scheduler for its per host cap
+- (NSString *)hostForRequest:(SFRestRequest *)request {
+    NSString *url = [[request.path lowercaseString] hasPrefix:@"https://"] ? request.path : [SFRestRequest restUrlForBaseUrl:request.baseURL serviceHostType:request.serviceHostType credentials:self.user.credentials];
+    NSString *host = url ? [NSURL URLWithString:url].host : nil;
+    return host ?: @"";
+}
+
+- (void)scheduleRequest:(SFRestRequest *)request delegate:(id<SFRestDelegate>)delegate shouldRetry:(BOOL)shouldRetry {
     __weak __typeof(self) weakSelf = self;
-    NSURLRequest *finalRequest = [request prepareRequestForSend:self.user];
-    if (finalRequest) {
-        SFNetwork *network = [[SFNetwork alloc] initWithEphemeralSession];
-        NSURLSessionDataTask *dataTask = [network sendRequest:finalRequest dataResponseBlock:^(NSData *data, NSURLResponse *response, NSError *error) {
-            __strong typeof(weakSelf) strongSelf = weakSelf;
-            // Network error
-            if (error) {
-                [SFSDKCoreLogger d:[strongSelf class] format:@"REST request failed with error: Error Code: %ld, Description: %@, URL: %@", (long) error.code, error.localizedDescription, finalRequest.URL];
+    request.sessionDataTask = nil;
+    request.sessionDownloadTask = nil;
+    [self.requestScheduler scheduleRequest:request host:[self hostForRequest:request] dispatchBlock:^(dispatch_block_t finishBlock) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (strongSelf) {
+            [strongSelf enqueueRequest:request delegate:delegate shouldRetry:shouldRetry finishBlock:finishBlock];
+        } else {
+            finishBlock();
+        }
+    } cancelBlock:^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        [strongSelf notifyDelegateOfCancel:delegate request:request];
+    }];
+}
 
-                // Checks if the request was canceled.
-                if (error.code == -999) {
-                    [strongSelf notifyDelegateOfCancel:delegate request:request];
+- (void)enqueueRequest:(SFRestRequest *)request delegate:(id<SFRestDelegate>)delegate shouldRetry:(BOOL)shouldRetry finishBlock:(dispatch_block_t)finishBlock {
+    __weak __typeof(self) weakSelf = self;
+    NSURLRequest *finalRequest = [request prepareRequestForSend:self.user];
+    SFSDKResponseCache *responseCache = (request.cacheResponse && request.method == SFRestMethodGET && !request.downloadDestinationURL) ? self.responseCache : nil;
+    SFSDKCircuitBreaker *circuitBreaker = finalRequest ? [SFSDKCircuitBreaker circuitBreakerForHost:finalRequest.URL.host ?: @""] : nil;
+    if (!finalRequest) {
+        finishBlock();
+    } else if (request.cancelRequested) {
+        finishBlock();
+        [self notifyDelegateOfCancel:delegate request:request];
+    } else if (![circuitBreaker allowRequest]) {
+        finishBlock();
+        NSString *description = [NSString stringWithFormat:@"Request not sent, %@ keeps failing", circuitBreaker.host];
+        NSError *circuitError = [NSError errorWithDomain:kSFRestErrorDomain code:kSFRestCircuitOpenErrorCode userInfo:@{NSLocalizedDescriptionKey: description}];
+        [self notifyDelegateOfFailure:delegate request:request error:circuitError rawResponse:nil];
+    } else {
+        if (request.skipsConditionalHeaders) {
+            [request.request setValue:nil forHTTPHeaderField:@"If-None-Match"];
+            [request.request setValue:nil forHTTPHeaderField:@"If-Modified-Since"];
+        } else {
+            [responseCache addValidatorsToRequest:request.request];
+        }
+        SFNetwork *network = [SFNetwork sharedEphemeralInstanceWithIdentifier:[self networkIdentifier]];
+        if (request.downloadDestinationURL) {
+            request.sessionDownloadTask = [network sendDownloadRequest:finalRequest resumeData:request.downloadResumeData progressBlock:request.progressBlock downloadResponseBlock:^(NSURL *location, NSURLResponse *response, NSError *error) {
+                __strong typeof(weakSelf) strongSelf = weakSelf;
+                finishBlock();
+
+                // Interrupted downloads keep their resume data, so that retries pick up where they left off
+                NSData *data = nil;
+                NSInteger statusCode = [(NSHTTPURLResponse *)response statusCode];
+                if (error) {
+                    NSData *resumeData = error.userInfo[NSURLSessionDownloadTaskResumeData];
+                    if (resumeData) {
+                        request.downloadResumeData = resumeData;
+                    }
+                } else if ([SFRestAPI isStatusCodeSuccess:statusCode]) {
+                    request.downloadResumeData = nil;
+                    [strongSelf storeDownloadAtURL:location forRequest:request error:&error];
                 } else {
-                    [strongSelf notifyDelegateOfFailure:delegate request:request error:error rawResponse:response];
+                    // Error responses are small, they get loaded and parsed as usual
+                    request.downloadResumeData = nil;
+                    data = location ? [NSData dataWithContentsOfURL:location] : nil;
                 }
-                return;
-            }
+                [strongSelf handleResponse:response data:data error:error request:request finalRequest:finalRequest delegate:delegate shouldRetry:shouldRetry circuitBreaker:circuitBreaker responseCache:responseCache];
+            }];
+        } else {
+            request.sessionDataTask = [network sendRequest:finalRequest progressBlock:request.progressBlock dataResponseBlock:^(NSData *data, NSURLResponse *response, NSError *error) {
+                __strong typeof(weakSelf) strongSelf = weakSelf;
 
-            // Timeout
-            if (!response) {
-                [strongSelf notifyDelegateOfTimeout:delegate request:request];
-                
+                // Frees the request's slot before anything else, since replays get scheduled again
+                finishBlock();
+                [strongSelf handleResponse:response data:data error:error request:request finalRequest:finalRequest delegate:delegate shouldRetry:shouldRetry circuitBreaker:circuitBreaker responseCache:responseCache];
+            }];
+        }
+    }
+}
+
+// Processes the outcome of a data or download task
+- (void)handleResponse:(NSURLResponse *)response data:(NSData *)data error:(NSError *)error request:(SFRestRequest *)request finalRequest:(NSURLRequest *)finalRequest delegate:(id<SFRestDelegate>)delegate shouldRetry:(BOOL)shouldRetry circuitBreaker:(SFSDKCircuitBreaker *)circuitBreaker responseCache:(SFSDKResponseCache *)responseCache {
+    // Transient failures count against the host and get retried as per the request's retry policy.
+    if (!(error.code == NSURLErrorCancelled && [error.domain isEqualToString:NSURLErrorDomain])) {
+        SFSDKRetryPolicy *retryPolicy = request.retryPolicy ?: [SFSDKRetryPolicy noRetryPolicy];
+        if ([retryPolicy isTransientFailure:response error:error]) {
+            [circuitBreaker recordFailure];
+            NSTimeInterval delay = [retryPolicy retryDelayForRequest:request response:response error:error retryCount:request.retryCount];
+            if (delay >= 0) {
+                request.retryCount++;
+                [SFSDKCoreLogger i:[self class] format:@"REST request failed with a transient error, retry %lu in %.2fs, URL: %@", (unsigned long)request.retryCount, delay, finalRequest.URL];
+                dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                    [self send:request delegate:delegate shouldRetry:shouldRetry];
+                });
                 return;
             }
-            
-            NSInteger statusCode = [(NSHTTPURLResponse *)response statusCode];
-            // 2xx indicates success.
-            if ([SFRestAPI isStatusCodeSuccess:statusCode]) {
-                id dataForDelegate = [strongSelf prepareDataForDelegate:data request:request response:response];
-                [strongSelf notifyDelegateOfResponse:delegate request:request data:dataForDelegate rawResponse:response];
-            }
-            // 401 (and sometimes 403) indicates refresh is required.
-            else if (request.shouldRefreshOn403 ? (statusCode == 401 || statusCode == 403) : (statusCode == 401)) {
-                if (shouldRetry) {
-                    [strongSelf replayRequest:request response:response delegate:delegate];
-                } else {
-                    NSError *retryError = [[NSError alloc] initWithDomain:response.URL.absoluteString code:statusCode userInfo:nil];
-                    [strongSelf notifyDelegateOfFailure:delegate request:request error:retryError rawResponse:response];
-                }
-            }
-            // Other status codes indicate failure.
-            else {
-                NSError* errorForDelegate = [strongSelf prepareErrorForDelegate:data response:response];
-                [strongSelf notifyDelegateOfFailure:delegate request:request error:errorForDelegate rawResponse:response];
+        } else {
+            [circuitBreaker recordSuccess];
+        }
+    }
+
+    // Network error
+    if (error) {
+        [SFSDKCoreLogger d:[self class] format:@"REST request failed with error: Error Code: %ld, Description: %@, URL: %@", (long) error.code, error.localizedDescription, finalRequest.URL];
+
+        // Goes through the parse queue like every other outcome, to be delivered in the same order
+        __weak typeof(self) weakSelf = self;
+        [[SFRestAPI responseParsingQueue] addOperationWithBlock:^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+
+            // Checks if the request was canceled.
+            if (error.code == -999) {
+                [strongSelf notifyDelegateOfCancel:delegate request:request];
+            } else {
+                [strongSelf notifyDelegateOfFailure:delegate request:request error:error rawResponse:response];
             }
-            
         }];
-        request.sessionDataTask = dataTask;
+        return;
+    }
+
+    // Timeout
+    if (!response) {
+        __weak typeof(self) weakSelf = self;
+        [[SFRestAPI responseParsingQueue] addOperationWithBlock:^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            [strongSelf notifyDelegateOfTimeout:delegate request:request];
+        }];
+
+        return;
+    }
+    
+    NSInteger statusCode = [(NSHTTPURLResponse *)response statusCode];
+
+    // 304 means the cached response is still good, any other 2xx replaces it.
+    if (responseCache && statusCode == 304) {
+        NSHTTPURLResponse *cachedResponse = nil;
+        NSData *cachedData = [responseCache cachedDataForRequest:finalRequest response:&cachedResponse];
+        if (cachedData) {
+            data = cachedData;
+            response = cachedResponse;
+            statusCode = cachedResponse.statusCode;
+        } else if (!request.skipsConditionalHeaders) {
+
+            // Cached body evicted or unreadable, asks for the full response once
+            [SFSDKCoreLogger i:[self class] format:@"No cached response to go with 304, sending request again without validators, URL: %@", finalRequest.URL];
+            request.skipsConditionalHeaders = YES;
+            [self send:request delegate:delegate shouldRetry:shouldRetry];
+            return;
+        }
+    } else if (responseCache && [SFRestAPI isStatusCodeSuccess:statusCode]) {
+        [responseCache storeData:data response:(NSHTTPURLResponse *)response forRequest:finalRequest];
+    }
+
+    // 2xx indicates success, parsing happens on the parse queue to keep the session's queue responsive.
+    if ([SFRestAPI isStatusCodeSuccess:statusCode]) {
+        __weak typeof(self) weakSelf = self;
+        [[SFRestAPI responseParsingQueue] addOperationWithBlock:^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            id dataForDelegate = [strongSelf prepareDataForDelegate:data request:request response:response];
+            [strongSelf notifyDelegateOfResponse:delegate request:request data:dataForDelegate rawResponse:response];
+        }];
+    }
+    // 401 (and sometimes 403) indicates refresh is required.
+    else if (request.shouldRefreshOn403 ? (statusCode == 401 || statusCode == 403) : (statusCode == 401)) {
+        if (shouldRetry) {
+            [self replayRequest:request response:response delegate:delegate];
+        } else {
+            NSError *retryError = [[NSError alloc] initWithDomain:response.URL.absoluteString code:statusCode userInfo:nil];
+            __weak typeof(self) weakSelf = self;
+            [[SFRestAPI responseParsingQueue] addOperationWithBlock:^{
+                __strong typeof(weakSelf) strongSelf = weakSelf;
+                [strongSelf notifyDelegateOfFailure:delegate request:request error:retryError rawResponse:response];
+            }];
+        }
+    }
+    // Other status codes indicate failure.
+    else {
+        __weak typeof(self) weakSelf = self;
+        [[SFRestAPI responseParsingQueue] addOperationWithBlock:^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            NSError* errorForDelegate = [strongSelf prepareErrorForDelegate:data response:response];
+            [strongSelf notifyDelegateOfFailure:delegate request:request error:errorForDelegate rawResponse:response];
+        }];
     }
 }
 
+// Moves (or encrypts) a completed download to its destination, before the temporary file goes away
+- (BOOL)storeDownloadAtURL:(NSURL *)location forRequest:(SFRestRequest *)request error:(NSError **)error {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSURL *destinationURL = request.downloadDestinationURL;
+    [fileManager removeItemAtURL:destinationURL error:nil];
+    [fileManager createDirectoryAtURL:[destinationURL URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+    if (!request.downloadEncryptionKey) {
+        return [fileManager moveItemAtURL:location toURL:destinationURL error:error];
+    }
+    NSInputStream *inStream = [NSInputStream inputStreamWithURL:location];
+    SFEncryptStream *outStream = [[SFEncryptStream alloc] initToFileAtPath:destinationURL.path append:NO];
+    [outStream setupWithEncryptionKey:request.downloadEncryptionKey];
+    // Reading the next chunk of the download overlaps with encrypting the previous one
+    outStream.encryptsInBackground = YES;
+    [inStream open];
+    [outStream open];
+    NSMutableData *buffer = [NSMutableData dataWithLength:kSFDownloadBufferSize];
+    NSInteger bytesRead = 0;
+    while ((bytesRead = [inStream read:buffer.mutableBytes maxLength:buffer.length]) > 0) {
+        if ([outStream write:buffer.bytes maxLength:bytesRead] < 0) {
+            break;
+        }
+    }
+    [outStream close];
+    [inStream close];
+    NSError *streamError = inStream.streamError ?: outStream.streamError;
+    if (streamError) {
+        [fileManager removeItemAtURL:destinationURL error:nil];
+        if (error) {
+            *error = streamError;
+        }
+        return NO;
+    }
+    return YES;
+}
+
 - (id) prepareDataForDelegate:(NSData*)data request:(SFRestRequest*)request response:(NSURLResponse*)response {
+    // Downloaded to a file
+    if (request.downloadDestinationURL) {
+        return request.downloadDestinationURL;
+    }
     // No parsing
-    if (!request.parseResponse) {
+    else if (!request.parseResponse) {
         return data;
     }
+    // Parsing left to the delegate
+    else if (request.lazyParseResponse) {
+        return data.length == 0 ? nil : [[SFSDKLazyJSONResponse alloc] initWithData:data rawResponse:response];
+    }
     // Parsing
     else {
         NSDictionary *jsonDict = [SFJsonUtils objectFromJSONData:data];
@@ -372,7 +708,11 @@ static dispatch_once_t pred;
      * Otherwise, wait for the current session refresh call to complete before sending.
      */
     @synchronized (self) {
-        if (!self.sessionRefreshInProgress) {
+
+        // A background refresh only resends the requests waiting for it
+        if (self.proactiveRefreshInProgress) {
+            [self.requestsAwaitingRefresh addObject:request];
+        } else if (!self.sessionRefreshInProgress) {
             self.sessionRefreshInProgress = YES;
             SFOAuthSessionRefresher *sessionRefresher = [self sessionRefresherForUser:self.user];
             __weak __typeof(self) weakSelf = self;
@@ -413,8 +753,14 @@ static dispatch_once_t pred;
     @synchronized (self) {
         NSSet *pendingRequests = [self.activeRequests asSet];
         for (SFRestRequest *request in pendingRequests) {
+
+            // Requests still queued in the scheduler get their own outcome once dispatched
+            if ([self.requestScheduler isRequestQueued:request]) {
+                continue;
+            }
             [self notifyDelegateOfFailure:request.delegate request:request error:error rawResponse:rawResponse];
         }
+        [self.requestsAwaitingRefresh removeAllObjects];
         self.pendingRequestsBeingProcessed = NO;
     }
 }
@@ -422,43 +768,97 @@ static dispatch_once_t pred;
 - (void)resendActiveRequestsRequiringAuthentication {
     @synchronized (self) {
         NSSet *pendingRequests = [self.activeRequests asSet];
+
+        // Requests waiting for the new token are active requests as well
+        [self.requestsAwaitingRefresh removeAllObjects];
         for (SFRestRequest *request in pendingRequests) {
-           [self send:request delegate:request.delegate shouldRetry:NO];
+
+            // Requests still queued in the scheduler pick up the new token once dispatched
+            if ([self.requestScheduler isRequestQueued:request]) {
+                continue;
+            }
+            [self send:request delegate:request.delegate shouldRetry:NO];
         }
         self.pendingRequestsBeingProcessed = NO;
     }
 }
 
 - (void)notifyDelegateOfResponse:(id<SFRestDelegate>)delegate request:(SFRestRequest *)request data:(id)data rawResponse:(NSURLResponse *)rawResponse {
-    if ([delegate respondsToSelector:@selector(request:didLoadResponse:rawResponse:)]) {
-        [delegate request:request didLoadResponse:data rawResponse:rawResponse];
-    } else if ([delegate respondsToSelector:@selector(request:didLoadResponse:)]) {
-        [delegate request:request didLoadResponse:data];
-    }
-    [self removeActiveRequestObject:request];
+    [self deliverForRequest:request block:^{
+        if ([delegate respondsToSelector:@selector(request:didLoadResponse:rawResponse:)]) {
+            [delegate request:request didLoadResponse:data rawResponse:rawResponse];
+        } else if ([delegate respondsToSelector:@selector(request:didLoadResponse:)]) {
+            [delegate request:request didLoadResponse:data];
+        }
+        [self removeActiveRequestObject:request];
+    }];
 }
 
 - (void)notifyDelegateOfFailure:(id<SFRestDelegate>)delegate request:(SFRestRequest *)request error:(NSError *)error rawResponse:(NSURLResponse *)rawResponse {
-    if ([delegate respondsToSelector:@selector(request:didFailLoadWithError:rawResponse:)]) {
-        [delegate request:request didFailLoadWithError:error rawResponse:rawResponse];
-    } else if ([delegate respondsToSelector:@selector(request:didFailLoadWithError:)]) {
-        [delegate request:request didFailLoadWithError:error];
-    }
-    [self removeActiveRequestObject:request];
+    [self deliverForRequest:request block:^{
+        if ([delegate respondsToSelector:@selector(request:didFailLoadWithError:rawResponse:)]) {
+            [delegate request:request didFailLoadWithError:error rawResponse:rawResponse];
+        } else if ([delegate respondsToSelector:@selector(request:didFailLoadWithError:)]) {
+            [delegate request:request didFailLoadWithError:error];
+        }
+        [self removeActiveRequestObject:request];
+    }];
 }
 
 - (void)notifyDelegateOfCancel:(id<SFRestDelegate>)delegate request:(SFRestRequest *)request {
-    if ([delegate respondsToSelector:@selector(requestDidCancelLoad:)]) {
-        [delegate requestDidCancelLoad:request];
-    }
-    [self removeActiveRequestObject:request];
+    [self deliverForRequest:request block:^{
+        if ([delegate respondsToSelector:@selector(requestDidCancelLoad:)]) {
+            [delegate requestDidCancelLoad:request];
+        }
+        [self removeActiveRequestObject:request];
+    }];
 }
 
 - (void)notifyDelegateOfTimeout:(id<SFRestDelegate>)delegate request:(SFRestRequest *)request {
-    if ([delegate respondsToSelector:@selector(requestDidTimeout:)]) {
-        [delegate requestDidTimeout:request];
+    [self deliverForRequest:request block:^{
+        if ([delegate respondsToSelector:@selector(requestDidTimeout:)]) {
+            [delegate requestDidTimeout:request];
+        }
+        [self removeActiveRequestObject:request];
+    }];
+}
+
+/*
+ * Runs the block on the request's delivery queue if it has one, right away otherwise. Outcomes coming off
+ * the parse queue go to the serial default delivery queue instead, so that slow (or blocking) delegates don't
+ * hold up parsing while still being notified one at a time.
+ */
+- (void)deliverForRequest:(SFRestRequest *)request block:(dispatch_block_t)block {
+    dispatch_queue_t deliveryQueue = request.deliveryQueue;
+    if (!deliveryQueue && [NSOperationQueue currentQueue] == [SFRestAPI responseParsingQueue]) {
+        deliveryQueue = [SFRestAPI defaultDeliveryQueue];
+    }
+    if (deliveryQueue) {
+        dispatch_async(deliveryQueue, block);
+    } else {
+        block();
     }
-    [self removeActiveRequestObject:request];
+}
+
++ (dispatch_queue_t)defaultDeliveryQueue {
+    static dispatch_queue_t deliveryQueue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        deliveryQueue = dispatch_queue_create("com.salesforce.restapi.delivery", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+    });
+    return deliveryQueue;
+}
+
++ (NSOperationQueue *)responseParsingQueue {
+    static NSOperationQueue *parsingQueue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        parsingQueue = [[NSOperationQueue alloc] init];
+        parsingQueue.name = @"com.salesforce.restapi.responseParsing";
+        parsingQueue.maxConcurrentOperationCount = kSFMaxConcurrentResponseParsing;
+        parsingQueue.qualityOfService = NSQualityOfServiceUtility;
+    });
+    return parsingQueue;
 }
 
 - (void)createAndStoreLogoutEvent:(NSError *)error user:(SFUserAccount*)user {
@@ -491,17 +891,23 @@ static dispatch_once_t pred;
 
 - (SFRestRequest *)requestForDescribeGlobal {
     NSString *path = [NSString stringWithFormat:@"/%@/sobjects", self.apiVersion];
-    return [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    request.cacheResponse = YES;
+    return request;
 }
 
 - (SFRestRequest *)requestForMetadataWithObjectType:(NSString *)objectType {
     NSString *path = [NSString stringWithFormat:@"/%@/sobjects/%@", self.apiVersion, objectType];
-    return [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    request.cacheResponse = YES;
+    return request;
 }
 
 - (SFRestRequest *)requestForDescribeWithObjectType:(NSString *)objectType {
     NSString *path = [NSString stringWithFormat:@"/%@/sobjects/%@/describe", self.apiVersion, objectType];
-    return [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    request.cacheResponse = YES;
+    return request;
 }
 
 - (SFRestRequest *)requestForLayoutWithObjectType:(NSString *)objectType layoutType:(NSString *)layoutType {
@@ -509,7 +915,9 @@ static dispatch_once_t pred;
                                  @{@"layoutType": layoutType}
                                  : nil);
     NSString *path = [NSString stringWithFormat:@"/%@/ui-api/layout/%@", self.apiVersion, objectType];
-    return [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:queryParams];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:queryParams];
+    request.cacheResponse = YES;
+    return request;
 }
 
 - (SFRestRequest *)requestForRetrieveWithObjectType:(NSString *)objectType
@@ -519,7 +927,9 @@ static dispatch_once_t pred;
                                  @{@"fields": fieldList}
                                  : nil);
     NSString *path = [NSString stringWithFormat:@"/%@/sobjects/%@/%@", self.apiVersion, objectType, objectId];
-    return [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:queryParams];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:queryParams];
+    request.cacheResponse = YES;
+    return request;
 }
 
 - (SFRestRequest *)requestForCreateWithObjectType:(NSString *)objectType
@@ -673,6 +1083,35 @@ static dispatch_once_t pred;
     return [self addBodyForPostRequest:requestJson request:request];
 }
 
+- (SFRestRequest *)requestForCollectionCreate:(BOOL)allOrNone records:(NSArray<NSDictionary*>*)records {
+    NSDictionary<NSString *, id> *requestJson = @{@"allOrNone": [NSNumber numberWithBool:allOrNone], @"records": records};
+    NSString *path = [NSString stringWithFormat:@"/%@/composite/sobjects", self.apiVersion];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:path queryParams:nil];
+    return [self addBodyForPostRequest:requestJson request:request];
+}
+
+- (SFRestRequest *)requestForCollectionUpdate:(BOOL)allOrNone records:(NSArray<NSDictionary*>*)records {
+    NSDictionary<NSString *, id> *requestJson = @{@"allOrNone": [NSNumber numberWithBool:allOrNone], @"records": records};
+    NSString *path = [NSString stringWithFormat:@"/%@/composite/sobjects", self.apiVersion];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPATCH path:path queryParams:nil];
+    return [self addBodyForPostRequest:requestJson request:request];
+}
+
+- (SFRestRequest *)requestForCollectionDelete:(BOOL)allOrNone objectIds:(NSArray<NSString*>*)objectIds {
+    NSDictionary *queryParams = @{@"ids": [objectIds componentsJoinedByString:@","],
+                                  @"allOrNone": allOrNone ? @"true" : @"false"};
+    NSString *path = [NSString stringWithFormat:@"/%@/composite/sobjects", self.apiVersion];
+    return [SFRestRequest requestWithMethod:SFRestMethodDELETE path:path queryParams:queryParams];
+}
+
+- (SFRestRequest *)requestForCollectionRetrieve:(NSString *)objectType objectIds:(NSArray<NSString*>*)objectIds fieldList:(NSArray<NSString*>*)fieldList {
+    // Using POST so that the ids don't end up in the url (which would limit how many we can fetch)
+    NSDictionary<NSString *, id> *requestJson = @{@"ids": objectIds, @"fields": fieldList};
+    NSString *path = [NSString stringWithFormat:@"/%@/composite/sobjects/%@", self.apiVersion, objectType];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:path queryParams:nil];
+    return [self addBodyForPostRequest:requestJson request:request];
+}
+
 - (NSString *)toQueryString:(NSDictionary *)components {
     NSMutableString *params = [NSMutableString new];
     if (components) {
@@ -718,6 +1157,11 @@ static dispatch_once_t pred;
         [sfRestApi cleanup];
     }
     [[self class] removeSharedInstanceWithUser:user];
+
+    // Cached responses of this user should not outlive it
+    if (user) {
+        [SFSDKResponseCache removeSharedCacheForUser:user];
+    }
 }
 @end
 
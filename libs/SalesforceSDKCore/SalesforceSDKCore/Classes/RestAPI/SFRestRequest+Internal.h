@@ -24,6 +24,10 @@
 
 #import "SFRestRequest.h"
 
+@class SFSDKRequestScheduler;
+@class SFSDKRequestCoalescer;
+@class SFSDKRequestBatcher;
+
 @interface SFRestRequest ()
 
 @property (nonnull, nonatomic, strong, readwrite) NSMutableURLRequest *request;
@@ -31,6 +35,13 @@
 @property (nullable, nonatomic, copy) NSDictionary *requestBodyAsDictionary;
 @property (nullable, nonatomic, copy) NSString *requestContentType;
 @property (nullable, nonatomic, strong) id<SFRestDelegate>instrDelegateInternal;
+@property (nullable, nonatomic, weak) SFSDKRequestScheduler *scheduler;
+@property (nullable, atomic, weak) SFSDKRequestCoalescer *coalescer;
+@property (nullable, atomic, weak) SFSDKRequestBatcher *batcher;
+@property (nonatomic, assign) NSUInteger retryCount;
+@property (atomic, assign) BOOL cancelRequested;
+@property (nonatomic, assign) BOOL skipsConditionalHeaders;
+@property (nullable, nonatomic, strong) NSURLSessionDownloadTask *sessionDownloadTask;
 
 + (nonnull NSString *)restUrlForBaseUrl:(nullable NSString *)baseUrl serviceHostType:(SFSDKRestServiceHostType)hostType credentials:(nonnull SFOAuthCredentials *)credentials;
 
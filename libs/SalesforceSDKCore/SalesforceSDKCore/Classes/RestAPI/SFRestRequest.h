@@ -25,6 +25,7 @@
 #import <Foundation/Foundation.h>
 #import "SalesforceSDKConstants.h"
 #import "SFUserAccount.h"
+#import "SFNetwork.h"
 
 /**
  * HTTP methods for requests.
@@ -48,6 +49,15 @@ typedef NS_ENUM(NSInteger, SFSDKNetworkServiceType) {
    
 } NS_SWIFT_NAME(RestRequest.NetWorkServiceType);
 
+/**
+ * Scheduling priority of requests. When requests have to wait for a free connection,
+ * higher priority requests are sent first.
+ */
+typedef NS_ENUM(NSInteger, SFRestRequestPriority) {
+    SFRestRequestPriorityLow = 0,
+    SFRestRequestPriorityNormal,
+    SFRestRequestPriorityHigh
+} NS_SWIFT_NAME(RestRequest.Priority);
 
 /**
  * The type of service host to use for Rest requests.
@@ -79,6 +89,8 @@ extern NSString * const kSFDefaultRestEndpoint;
 
 // Forward declaration.
 @class SFRestRequest;
+@class SFSDKRetryPolicy;
+@class SFEncryptionKey;
 
 /**
  * Lifecycle events for SFRestRequests.
@@ -163,6 +175,19 @@ NS_SWIFT_NAME(RestRequest)
  */
 @property (nonatomic, assign, readwrite) SFSDKNetworkServiceType networkServiceType;
 
+/**
+ * The scheduling priority of the request. SFRestRequestPriorityNormal by default.
+ */
+@property (nonatomic, assign, readwrite) SFRestRequestPriority priority;
+
+/**
+ * The policy used to retry the request after transient failures (429, 5xx, timeouts, dropped connections).
+ * Requests are retried by default: new requests get `SFSDKRetryPolicy.defaultPolicy`, which retries up to 3 times.
+ * Set it to nil (or `SFSDKRetryPolicy.noRetryPolicy`) for this request to never be retried, or set
+ * `SFSDKRetryPolicy.defaultPolicy` to nil to turn retries off for all the requests created afterwards.
+ */
+@property (nullable, nonatomic, copy, readwrite) SFSDKRetryPolicy *retryPolicy;
+
 /**
  * The type of service host for the request (e.g. login or instance).
  */
@@ -194,6 +219,50 @@ NS_SWIFT_NAME(RestRequest)
  */
 @property (nonatomic, assign) BOOL parseResponse;
 
+/**
+ * Used to specify if parsing should be left to the delegate. When YES (and `parseResponse` is YES), the delegate
+ * receives a SFSDKLazyJSONResponse that only parses the body when asked for it. NO by default.
+ */
+@property (nonatomic, assign) BOOL lazyParseResponse;
+
+/**
+ * Queue the delegate gets notified on. When nil (the default), the delegate is notified on a serial background queue
+ * shared with the notifications of other requests, one at a time.
+ */
+@property (nullable, nonatomic, strong) dispatch_queue_t deliveryQueue;
+
+/**
+ * Used to specify if the response should be cached (encrypted, on disk) and revalidated with conditional
+ * requests (`If-None-Match` / `If-Modified-Since`). Only applies to GET requests.
+ * NO by default, YES for the describe, metadata, layout and retrieve requests built by SFRestAPI.
+ */
+@property (nonatomic, assign) BOOL cacheResponse;
+
+/**
+ * File URL the response body gets streamed to, instead of being loaded in memory. When set, the request is sent
+ * as a download task and, once the download completes, the delegate receives this URL instead of the response data.
+ * Any existing file at this URL gets replaced.
+ */
+@property (nullable, nonatomic, strong) NSURL *downloadDestinationURL;
+
+/**
+ * Key used to encrypt the downloaded file (see SFEncryptStream) as it gets written to `downloadDestinationURL`.
+ * Nil to write the file unencrypted.
+ */
+@property (nullable, nonatomic, strong) SFEncryptionKey *downloadEncryptionKey;
+
+/**
+ * Resume data of an interrupted download. Set when a download fails or gets cancelled after part of the
+ * response was received, in which case sending the request again resumes the download where it left off.
+ */
+@property (nullable, nonatomic, strong) NSData *downloadResumeData;
+
+/**
+ * Called (on a background queue) as the response body of a download gets received,
+ * or as the request body of an upload gets sent.
+ */
+@property (nullable, nonatomic, copy) SFTransferProgressBlock progressBlock;
+
 /**
  * The query parameters of the request (could be nil).
  * Note that URL encoding of the parameters will automatically happen when the request is sent.
@@ -270,6 +339,18 @@ NS_SWIFT_NAME(RestRequest)
  */
 - (void)addPostFileData:(NSData *)fileData paramName:(NSString*)paramName description:(nullable NSString *)description fileName:(NSString *)fileName mimeType:(NSString *)mimeType;
 
+/**
+ * Add file to upload, streamed from disk rather than loaded in memory.
+ * @param fileURL URL of the file to upload
+ * @param paramName Name of the POST parameter
+ * @param fileName Name of the file
+ * @param mimeType MIME type of the file
+ * @param params File properties (e.g. title, desc, contentSize)
+ * @param decryptionKey Key the file was encrypted with (see SFEncryptStream), nil if it isn't encrypted.
+ * The file gets decrypted as it is sent.
+ */
+- (void)addPostFileURL:(NSURL *)fileURL paramName:(NSString *)paramName fileName:(NSString *)fileName mimeType:(nullable NSString *)mimeType params:(nullable NSDictionary *)params decryptionKey:(nullable SFEncryptionKey *)decryptionKey;
+
 /**
  * Sets a custom request body based on an NSString representation.
  * @param bodyString The NSString object representing the request body.
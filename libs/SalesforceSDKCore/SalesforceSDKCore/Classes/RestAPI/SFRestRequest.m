@@ -26,8 +26,14 @@
 #import "SFRestRequest+Internal.h"
 #import "SFRestAPI+Internal.h"
 #import "NSString+SFAdditions.h"
+#import "SFSDKRequestScheduler.h"
+#import "SFSDKRequestCoalescer.h"
+#import "SFSDKRequestBatcher.h"
+#import "SFSDKRetryPolicy.h"
+#import "SFDecryptStream.h"
 
 NSString * const kSFDefaultRestEndpoint = @"/services/data";
+static NSUInteger const kSFUploadBufferSize = 64 * 1024;
 
 @implementation SFRestRequest
 
@@ -43,6 +49,8 @@ NSString * const kSFDefaultRestEndpoint = @"/services/data";
         self.endpoint = (hostType == SFSDKRestServiceHostTypeCustom)?@"":kSFDefaultRestEndpoint;
         self.parseResponse = YES;
         self.shouldRefreshOn403 = YES;
+        self.priority = SFRestRequestPriorityNormal;
+        self.retryPolicy = [SFSDKRetryPolicy defaultPolicy];
         self.request = [[NSMutableURLRequest alloc] init];
     }
     return self;
@@ -224,8 +232,26 @@ NSString * const kSFDefaultRestEndpoint = @"/services/data";
 }
 
 - (void)cancel {
-    if (self.sessionDataTask) {
+    self.cancelRequested = YES;
+
+    // Requests sharing the response of an identical request only detach from it, same for batched requests
+    SFSDKRequestCoalescer *coalescer = self.coalescer;
+    SFSDKRequestBatcher *batcher = self.batcher;
+    if (coalescer) {
+        [coalescer cancelRequest:self];
+    } else if (batcher) {
+        [batcher cancelRequest:self];
+    } else if (self.sessionDataTask) {
         [self.sessionDataTask cancel];
+    } else if (self.sessionDownloadTask) {
+        __weak typeof(self) weakSelf = self;
+        [self.sessionDownloadTask cancelByProducingResumeData:^(NSData *resumeData) {
+            if (resumeData) {
+                weakSelf.downloadResumeData = resumeData;
+            }
+        }];
+    } else {
+        [self.scheduler cancelRequest:self];
     }
 }
 
@@ -252,40 +278,87 @@ NSString * const kSFDefaultRestEndpoint = @"/services/data";
 
 #pragma mark - Upload
 - (void)addPostFileData:(NSData *)fileData paramName:(NSString *)paramName fileName:(NSString *)fileName mimeType:(NSString *)mimeType params:(nullable NSDictionary *)params {
-
     NSString *mpeBoundary = [[NSUUID UUID] UUIDString];
-    NSString *mpeSeparator = @"--";
-    NSString *newline = @"\r\n";
     NSMutableData *body = [NSMutableData data];
+    [body appendData:[self multiPartRequestBodyHeaderForBoundary:mpeBoundary params:params]];
 
-    // PART 1
-    if (params) {
-        NSError *parsingError;
-        NSData *jsonData = [NSJSONSerialization dataWithJSONObject:params
-                                                           options:NSJSONWritingPrettyPrinted
-                                                             error:&parsingError];
+    //PART 2
+    if (fileData) {
+        [body appendData:[self multiPartRequestBodyForKey:paramName mimeType:(mimeType ?: @"application/octet-stream") fileName:fileName file:fileData]];
+        [body appendData:[self multiPartRequestBodyTrailerForBoundary:mpeBoundary]];
+    }
+    [self setCustomRequestBodyData:body contentType:[NSString stringWithFormat:@"multipart/form-data; boundary=%@", mpeBoundary]];
+    [self setMultiPartRequestHeadersForBoundary:mpeBoundary];
+}
 
-        if (jsonData) {
-            [body appendData:[[NSString stringWithFormat:@"%@%@%@", mpeSeparator, mpeBoundary, newline] dataUsingEncoding:NSUTF8StringEncoding]];
-            [body appendData:[self multiPartRequestBodyForKey:@"json" mimeType:@"application/json" fileName:nil file:jsonData]];
+- (void)addPostFileURL:(NSURL *)fileURL paramName:(NSString *)paramName fileName:(NSString *)fileName mimeType:(NSString *)mimeType params:(NSDictionary *)params decryptionKey:(SFEncryptionKey *)decryptionKey {
+    NSString *mpeBoundary = [[NSUUID UUID] UUIDString];
+    NSMutableData *head = [NSMutableData data];
+    [head appendData:[self multiPartRequestBodyHeaderForBoundary:mpeBoundary params:params]];
+    [head appendData:[self multiPartRequestPartHeaderForKey:paramName mimeType:(mimeType ?: @"application/octet-stream") fileName:fileName]];
+    NSMutableData *tail = [[@"\r\n" dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+    [tail appendData:[self multiPartRequestBodyTrailerForBoundary:mpeBoundary]];
+
+    // Each send gets a fresh stream, the file is only read as the body gets sent
+    NSInputStream *(^bodyStreamBlock)(void) = ^{
+        NSInputStream *fileStream = nil;
+        if (decryptionKey) {
+            SFDecryptStream *decryptStream = [[SFDecryptStream alloc] initWithFileAtPath:fileURL.path];
+            [decryptStream setupWithDecryptionKey:decryptionKey];
+            fileStream = decryptStream;
+        } else {
+            fileStream = [NSInputStream inputStreamWithURL:fileURL];
         }
+        return [SFRestRequest boundInputStreamWithHead:head fileStream:fileStream tail:tail];
+    };
+    [self setCustomRequestBodyStream:bodyStreamBlock contentType:[NSString stringWithFormat:@"multipart/form-data; boundary=%@", mpeBoundary]];
+
+    // The size of decrypted files isn't known upfront, those get sent chunked
+    NSNumber *fileSize = decryptionKey ? nil : [[NSFileManager defaultManager] attributesOfItemAtPath:fileURL.path error:nil][NSFileSize];
+    if (fileSize) {
+        [self setHeaderValue:[NSString stringWithFormat:@"%llu", head.length + fileSize.unsignedLongLongValue + tail.length] forHeaderName:@"Content-Length"];
+    } else {
+        [self.customHeaders removeObjectForKey:@"Content-Length"];
     }
+    [self setMultiPartRequestHeadersForBoundary:mpeBoundary];
+}
 
-    [body appendData:[[NSString stringWithFormat:@"%@%@%@", mpeSeparator, mpeBoundary, newline] dataUsingEncoding:NSUTF8StringEncoding]];
+// Returns the read end of a bound stream pair, the write end being fed on a background queue
++ (NSInputStream *)boundInputStreamWithHead:(NSData *)head fileStream:(NSInputStream *)fileStream tail:(NSData *)tail {
+    NSInputStream *inputStream = nil;
+    NSOutputStream *outputStream = nil;
+    [NSStream getBoundStreamsWithBufferSize:kSFUploadBufferSize inputStream:&inputStream outputStream:&outputStream];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [outputStream open];
+        [fileStream open];
+        BOOL written = [self writeData:head toStream:outputStream];
+        NSMutableData *buffer = [NSMutableData dataWithLength:kSFUploadBufferSize];
+        NSInteger bytesRead = 0;
+        while (written && (bytesRead = [fileStream read:buffer.mutableBytes maxLength:buffer.length]) > 0) {
+            written = [self writeData:[NSData dataWithBytesNoCopy:buffer.mutableBytes length:bytesRead freeWhenDone:NO] toStream:outputStream];
+        }
+        if (written && bytesRead == 0) {
+            [self writeData:tail toStream:outputStream];
+        } else if (bytesRead < 0) {
+            [SFSDKCoreLogger e:[self class] format:@"Failed to read file to upload: %@", fileStream.streamError];
+        }
+        [fileStream close];
+        [outputStream close];
+    });
+    return inputStream;
+}
 
-    //PART 2
-    if (fileData) {
-        if (!mimeType) {
-            mimeType = @"application/octet-stream";
+// Blocks until all the data got written, or the stream got closed by its reader
++ (BOOL)writeData:(NSData *)data toStream:(NSOutputStream *)outputStream {
+    NSUInteger offset = 0;
+    while (offset < data.length) {
+        NSInteger written = [outputStream write:(const uint8_t *)data.bytes + offset maxLength:data.length - offset];
+        if (written <= 0) {
+            return NO;
         }
-        [body appendData:[self multiPartRequestBodyForKey:paramName mimeType:mimeType fileName:fileName file:fileData]];
-        [body appendData:[[NSString stringWithFormat:@"%@%@%@%@", mpeSeparator, mpeBoundary, mpeSeparator, newline] dataUsingEncoding:NSUTF8StringEncoding]];
+        offset += written;
     }
-    [self setCustomRequestBodyData:body contentType:[NSString stringWithFormat:@"multipart/form-data; boundary=%@", mpeBoundary]];
-    [self.request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
-    [self.request setHTTPShouldHandleCookies:NO];
-    [self setHeaderValue:@"Keep-Alive" forHeaderName:@"Connection"];
-    [self setHeaderValue:[NSString stringWithFormat:@"multipart/form-data; boundary=%@", mpeBoundary] forHeaderName:@"Content-Type"];
+    return YES;
 }
 
 - (void)addPostFileData:(NSData *)fileData paramName:(NSString*)paramName description:(NSString *)description fileName:(NSString *)fileName mimeType:(NSString *)mimeType {
@@ -302,6 +375,15 @@ NSString * const kSFDefaultRestEndpoint = @"/services/data";
 }
 
 - (NSData *)multiPartRequestBodyForKey:(NSString *)key mimeType:(NSString*)mimeType fileName:(NSString*)fileName file:(NSData *)fileData {
+    NSMutableData *body = [NSMutableData data];
+    NSString *newline = @"\r\n";
+    [body appendData:[self multiPartRequestPartHeaderForKey:key mimeType:mimeType fileName:fileName]];
+    [body appendData:fileData];
+    [body appendData:[newline dataUsingEncoding:NSUTF8StringEncoding]];
+    return body;
+}
+
+- (NSData *)multiPartRequestPartHeaderForKey:(NSString *)key mimeType:(NSString*)mimeType fileName:(NSString*)fileName {
     NSMutableData *body = [NSMutableData data];
     NSString *newline = @"\r\n";
     NSString *bodyContentDisposition = [NSString stringWithFormat:@"Content-Disposition: form-data; name=\"%@\";", key];
@@ -312,11 +394,42 @@ NSString * const kSFDefaultRestEndpoint = @"/services/data";
     [body appendData:[newline dataUsingEncoding:NSUTF8StringEncoding]];
     [body appendData:[[NSString stringWithFormat:@"Content-Type: %@; charset=UTF-8%@",mimeType, newline] dataUsingEncoding:NSUTF8StringEncoding]];
     [body appendData:[newline dataUsingEncoding:NSUTF8StringEncoding]];
-    [body appendData:fileData];
-    [body appendData:[newline dataUsingEncoding:NSUTF8StringEncoding]];
     return body;
 }
 
+// JSON part (if any) and the boundary opening the file part
+- (NSData *)multiPartRequestBodyHeaderForBoundary:(NSString *)mpeBoundary params:(NSDictionary *)params {
+    NSString *mpeSeparator = @"--";
+    NSString *newline = @"\r\n";
+    NSMutableData *body = [NSMutableData data];
+
+    // PART 1
+    if (params) {
+        NSError *parsingError;
+        NSData *jsonData = [NSJSONSerialization dataWithJSONObject:params
+                                                           options:NSJSONWritingPrettyPrinted
+                                                             error:&parsingError];
+
+        if (jsonData) {
+            [body appendData:[[NSString stringWithFormat:@"%@%@%@", mpeSeparator, mpeBoundary, newline] dataUsingEncoding:NSUTF8StringEncoding]];
+            [body appendData:[self multiPartRequestBodyForKey:@"json" mimeType:@"application/json" fileName:nil file:jsonData]];
+        }
+    }
+    [body appendData:[[NSString stringWithFormat:@"%@%@%@", mpeSeparator, mpeBoundary, newline] dataUsingEncoding:NSUTF8StringEncoding]];
+    return body;
+}
+
+- (NSData *)multiPartRequestBodyTrailerForBoundary:(NSString *)mpeBoundary {
+    return [[NSString stringWithFormat:@"--%@--\r\n", mpeBoundary] dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)setMultiPartRequestHeadersForBoundary:(NSString *)mpeBoundary {
+    [self.request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
+    [self.request setHTTPShouldHandleCookies:NO];
+    [self setHeaderValue:@"Keep-Alive" forHeaderName:@"Connection"];
+    [self setHeaderValue:[NSString stringWithFormat:@"multipart/form-data; boundary=%@", mpeBoundary] forHeaderName:@"Content-Type"];
+}
+
 + (BOOL)isNetworkError:(NSError *)error {
     switch (error.code) {
         case kCFURLErrorNotConnectedToInternet:
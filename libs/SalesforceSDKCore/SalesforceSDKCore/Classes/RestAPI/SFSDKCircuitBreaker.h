@@ -0,0 +1,104 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Error code (in kSFRestErrorDomain) of requests failed right away because the circuit breaker of their host is open.
+ */
+extern NSInteger const kSFRestCircuitOpenErrorCode NS_SWIFT_NAME(SFRestCircuitOpenErrorCode);
+
+/**
+ * Sheds load from a host that keeps failing. After `failureThreshold` consecutive transient failures the circuit opens
+ * and requests to the host fail right away. Once `openInterval` has elapsed a single probe request goes through:
+ * if it succeeds the circuit closes, otherwise it stays open for another `openInterval`.
+ */
+NS_SWIFT_NAME(CircuitBreaker)
+@interface SFSDKCircuitBreaker : NSObject
+
+/**
+ * Number of consecutive transient failures opening the circuit. 5 by default.
+ */
+@property (atomic, assign) NSUInteger failureThreshold;
+
+/**
+ * Time (in seconds) the circuit stays open before a probe request is let through. 30 by default.
+ */
+@property (atomic, assign) NSTimeInterval openInterval;
+
+/**
+ * Whether the circuit is open, i.e. requests are being shed.
+ */
+@property (atomic, readonly, getter=isOpen) BOOL open;
+
+/**
+ * Host of this circuit breaker.
+ */
+@property (nonatomic, readonly, copy) NSString *host;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Initializes a circuit breaker for the given host.
+ *
+ * @param host Host.
+ * @return Instance of this class.
+ */
+- (instancetype)initWithHost:(NSString *)host NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Returns the shared circuit breaker of the given host, creating it on first use.
+ *
+ * @param host Host.
+ * @return Circuit breaker of the host.
+ */
++ (instancetype)circuitBreakerForHost:(NSString *)host NS_SWIFT_NAME(circuitBreaker(for:));
+
+/**
+ * Removes all shared circuit breakers (e.g. to close all circuits).
+ */
++ (void)removeAllCircuitBreakers;
+
+/**
+ * Returns whether a request can be sent to the host now.
+ *
+ * @return NO if the request should be failed right away.
+ */
+- (BOOL)allowRequest;
+
+/**
+ * Records a response that is not a transient failure.
+ */
+- (void)recordSuccess;
+
+/**
+ * Records a transient failure.
+ */
+- (void)recordFailure;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,122 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKCircuitBreaker.h"
+
+NSInteger const kSFRestCircuitOpenErrorCode = 998;
+
+static NSUInteger const kSFCircuitBreakerDefaultFailureThreshold = 5;
+static NSTimeInterval const kSFCircuitBreakerDefaultOpenInterval = 30.0;
+
+static NSMutableDictionary<NSString *, SFSDKCircuitBreaker *> *circuitBreakers = nil;
+
+@interface SFSDKCircuitBreaker ()
+
+@property (nonatomic, assign) NSUInteger consecutiveFailures;
+
+// Uptime at which the circuit opened (or the last probe was let through), 0 when closed
+@property (nonatomic, assign) NSTimeInterval openedAt;
+@property (nonatomic, assign) BOOL probeInFlight;
+
+@end
+
+@implementation SFSDKCircuitBreaker
+
+- (instancetype)initWithHost:(NSString *)host {
+    self = [super init];
+    if (self) {
+        _host = [host copy];
+        _failureThreshold = kSFCircuitBreakerDefaultFailureThreshold;
+        _openInterval = kSFCircuitBreakerDefaultOpenInterval;
+    }
+    return self;
+}
+
++ (instancetype)circuitBreakerForHost:(NSString *)host {
+    @synchronized ([SFSDKCircuitBreaker class]) {
+        if (!circuitBreakers) {
+            circuitBreakers = [NSMutableDictionary dictionary];
+        }
+        SFSDKCircuitBreaker *circuitBreaker = circuitBreakers[host];
+        if (!circuitBreaker) {
+            circuitBreaker = [[SFSDKCircuitBreaker alloc] initWithHost:host];
+            circuitBreakers[host] = circuitBreaker;
+        }
+        return circuitBreaker;
+    }
+}
+
++ (void)removeAllCircuitBreakers {
+    @synchronized ([SFSDKCircuitBreaker class]) {
+        [circuitBreakers removeAllObjects];
+    }
+}
+
+- (BOOL)isOpen {
+    @synchronized (self) {
+        return self.openedAt > 0;
+    }
+}
+
+- (BOOL)allowRequest {
+    @synchronized (self) {
+        if (self.openedAt == 0) {
+            return YES;
+        }
+
+        // Lets a single probe through per open interval (a probe that never reported back doesn't block the next one)
+        NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+        if (now - self.openedAt >= self.openInterval) {
+            self.openedAt = now;
+            self.probeInFlight = YES;
+            [SFSDKCoreLogger i:[self class] format:@"Circuit of %@ half open, letting a probe request through", self.host];
+            return YES;
+        }
+        return NO;
+    }
+}
+
+- (void)recordSuccess {
+    @synchronized (self) {
+        if (self.openedAt > 0) {
+            [SFSDKCoreLogger i:[self class] format:@"Circuit of %@ closed", self.host];
+        }
+        self.consecutiveFailures = 0;
+        self.openedAt = 0;
+        self.probeInFlight = NO;
+    }
+}
+
+- (void)recordFailure {
+    @synchronized (self) {
+        self.consecutiveFailures++;
+        if (self.probeInFlight || (self.openedAt == 0 && self.consecutiveFailures >= self.failureThreshold)) {
+            [SFSDKCoreLogger w:[self class] format:@"Circuit of %@ open after %lu consecutive failures", self.host, (unsigned long)self.consecutiveFailures];
+            self.openedAt = [NSProcessInfo processInfo].systemUptime;
+            self.probeInFlight = NO;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,70 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Response handed to the delegate of requests with `lazyParseResponse` set.
+ * The JSON body only gets parsed the first time it is asked for, on the calling thread.
+ */
+NS_SWIFT_NAME(LazyJSONResponse)
+@interface SFSDKLazyJSONResponse : NSObject
+
+/**
+ * Raw body of the response.
+ */
+@property (nonatomic, strong, readonly) NSData *data;
+
+/**
+ * Raw response.
+ */
+@property (nullable, nonatomic, strong, readonly) NSURLResponse *rawResponse;
+
+/**
+ * Body parsed as JSON, nil if the body isn't JSON.
+ * Parsed on first access, then cached. Safe to call from any thread.
+ */
+@property (nullable, nonatomic, strong, readonly) id jsonObject;
+
+/**
+ * Body parsed as JSON, or the raw body if it isn't JSON (nil if empty).
+ * This is what SFRestAPI hands to the delegate of requests parsed eagerly.
+ */
+@property (nullable, nonatomic, strong, readonly) id object;
+
+/**
+ * Initializes a response.
+ * @param data Raw body of the response.
+ * @param rawResponse Raw response.
+ * @return The response.
+ */
+- (instancetype)initWithData:(NSData *)data rawResponse:(nullable NSURLResponse *)rawResponse NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
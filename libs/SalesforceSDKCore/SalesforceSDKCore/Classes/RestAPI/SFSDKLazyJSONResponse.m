@@ -0,0 +1,68 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKLazyJSONResponse.h"
+#import <SalesforceSDKCommon/SFJsonUtils.h>
+
+@interface SFSDKLazyJSONResponse ()
+
+@property (nonatomic, assign) BOOL parsed;
+@property (nullable, nonatomic, strong) id parsedObject;
+
+@end
+
+@implementation SFSDKLazyJSONResponse
+
+- (instancetype)initWithData:(NSData *)data rawResponse:(NSURLResponse *)rawResponse {
+    self = [super init];
+    if (self) {
+        _data = data ?: [NSData data];
+        _rawResponse = rawResponse;
+    }
+    return self;
+}
+
+- (id)jsonObject {
+    @synchronized (self) {
+        if (!self.parsed) {
+            self.parsedObject = self.data.length > 0 ? [SFJsonUtils objectFromJSONData:self.data] : nil;
+            self.parsed = YES;
+        }
+        return self.parsedObject;
+    }
+}
+
+- (id)object {
+    id jsonObject = self.jsonObject;
+    if (jsonObject) {
+        return jsonObject;
+    }
+    return self.data.length == 0 ? nil : self.data;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p, %lu bytes>", NSStringFromClass([self class]), self, (unsigned long)self.data.length];
+}
+
+@end
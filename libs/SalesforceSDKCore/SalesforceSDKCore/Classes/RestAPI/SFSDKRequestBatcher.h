@@ -0,0 +1,96 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFRestAPI.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Gathers requests sent through an SFRestAPI instance within a short window and sends them as a single
+ * composite request, then hands every subresponse back to the delegate of the original request.
+ */
+@interface SFSDKRequestBatcher : NSObject <SFRestDelegate>
+
+/**
+ * Maximum number of subrequests per composite request. Defaults (and is capped) to 25.
+ * A batch also goes out once it holds 5 queries, the most the composite API takes.
+ */
+@property (atomic, assign) NSUInteger maxBatchSize;
+
+/**
+ * Time (in seconds) the batcher waits for more requests after the first one of a batch. Defaults to 0.05.
+ */
+@property (atomic, assign) NSTimeInterval batchingWindow;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Initializes a batcher sending its composite requests through the given SFRestAPI instance.
+ *
+ * @param restAPI SFRestAPI instance (not retained).
+ * @return Instance of this class.
+ */
+- (instancetype)initWithRestAPI:(SFRestAPI *)restAPI NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Returns whether the given request can be sent as part of a composite request: authenticated
+ * requests against the instance's REST endpoint, for resources supported by the composite API,
+ * with a JSON body (if any) and a JSON response.
+ *
+ * @param request Request to check.
+ * @return YES if the request can be batched.
+ */
++ (BOOL)canBatchRequest:(SFRestRequest *)request;
+
+/**
+ * Adds a request to the current batch, starting a new batch if needed.
+ *
+ * @param request Request to send.
+ * @param delegate Delegate of the request.
+ */
+- (void)addRequest:(SFRestRequest *)request delegate:(nullable id<SFRestDelegate>)delegate;
+
+/**
+ * Sends the current batch right away.
+ */
+- (void)flush;
+
+/**
+ * Drops the requests of the current batch, notifying their delegates of the cancellation.
+ */
+- (void)cancelPendingRequests;
+
+/**
+ * Cancels a request added to this batcher: the request is dropped from the current batch, or its
+ * subresponse is ignored if its composite request is already in flight. The composite request gets
+ * cancelled once none of its requests is left.
+ *
+ * @param request Request to cancel.
+ */
+- (void)cancelRequest:(SFRestRequest *)request;
+
+@end
+
+NS_ASSUME_NONNULL_END
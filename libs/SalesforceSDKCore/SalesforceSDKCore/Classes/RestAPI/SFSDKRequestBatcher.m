@@ -0,0 +1,370 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKRequestBatcher.h"
+#import "SFRestAPI+Internal.h"
+#import "SFRestRequest+Internal.h"
+
+static NSUInteger const kSFRequestBatcherMaxBatchSize = 25;
+static NSUInteger const kSFRequestBatcherMaxQueriesPerBatch = 5;
+static NSTimeInterval const kSFRequestBatcherDefaultBatchingWindow = 0.05;
+static NSString * const kSFRequestBatcherRefIdPrefix = @"refBatch";
+static NSString * const kSFRequestBatcherUserAgentHeader = @"User-Agent";
+static NSString * const kSFRequestBatcherCompositeResponse = @"compositeResponse";
+
+@interface SFSDKBatchedRequest : NSObject
+
+@property (nonatomic, strong) SFRestRequest *request;
+@property (nonatomic, strong) id<SFRestDelegate> delegate;
+@property (nonatomic, assign) BOOL cancelled;
+
+@end
+
+@implementation SFSDKBatchedRequest
+@end
+
+@interface SFSDKRequestBatcher ()
+
+@property (nonatomic, weak) SFRestAPI *restAPI;
+@property (nonatomic, strong) NSMutableArray<SFSDKBatchedRequest *> *pendingRequests;
+@property (nonatomic, assign) NSUInteger batchGeneration;
+@property (nonatomic, strong) dispatch_queue_t timerQueue;
+
+// Original requests of the composite requests in flight, keyed by composite request (cancelled ones included)
+@property (nonatomic, strong) NSMapTable<SFRestRequest *, NSArray<SFSDKBatchedRequest *> *> *inFlightBatches;
+
+@end
+
+@implementation SFSDKRequestBatcher
+
+- (instancetype)initWithRestAPI:(SFRestAPI *)restAPI {
+    self = [super init];
+    if (self) {
+        _restAPI = restAPI;
+        _pendingRequests = [NSMutableArray array];
+        _timerQueue = dispatch_queue_create("com.salesforce.restapi.requestBatcher", DISPATCH_QUEUE_SERIAL);
+        _inFlightBatches = [NSMapTable strongToStrongObjectsMapTable];
+        _maxBatchSize = kSFRequestBatcherMaxBatchSize;
+        _batchingWindow = kSFRequestBatcherDefaultBatchingWindow;
+    }
+    return self;
+}
+
++ (BOOL)canBatchRequest:(SFRestRequest *)request {
+    if (!request.requiresAuthentication || !request.parseResponse || request.lazyParseResponse || request.cacheResponse || request.downloadDestinationURL
+        || request.serviceHostType != SFSDKRestServiceHostTypeInstance || request.baseURL != nil
+        || ![request.endpoint isEqualToString:kSFDefaultRestEndpoint]) {
+        return NO;
+    }
+
+    // Subrequests can't carry custom headers, the user agent of the composite request is good enough though
+    for (NSString *header in request.customHeaders) {
+        if (![header isEqualToString:kSFRequestBatcherUserAgentHeader]) {
+            return NO;
+        }
+    }
+
+    // Subrequests only carry JSON bodies
+    if (request.requestBodyStreamBlock != nil
+        && (request.requestBodyAsDictionary == nil || ![request.requestContentType hasPrefix:@"application/json"])) {
+        return NO;
+    }
+
+    // Resources supported by the composite API, with a path relative to the REST endpoint
+    static NSRegularExpression *supportedPathRegex = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        supportedPathRegex = [NSRegularExpression regularExpressionWithPattern:@"^/v[0-9]+\\.[0-9]+/(sobjects|query|queryAll)(/|$)" options:0 error:nil];
+    });
+    return request.path != nil && [supportedPathRegex firstMatchInString:request.path options:0 range:NSMakeRange(0, request.path.length)] != nil;
+}
+
+// The composite API takes at most 5 query subrequests, a batch with more fails as a whole
++ (BOOL)isQueryRequest:(SFRestRequest *)request {
+    static NSRegularExpression *queryPathRegex = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queryPathRegex = [NSRegularExpression regularExpressionWithPattern:@"^/v[0-9]+\\.[0-9]+/(query|queryAll)(/|$)" options:0 error:nil];
+    });
+    return request.path != nil && [queryPathRegex firstMatchInString:request.path options:0 range:NSMakeRange(0, request.path.length)] != nil;
+}
+
+#pragma mark - Batching
+
+- (void)addRequest:(SFRestRequest *)request delegate:(id<SFRestDelegate>)delegate {
+    if (nil != delegate) {
+        request.delegate = delegate;
+    }
+    SFSDKBatchedRequest *entry = [[SFSDKBatchedRequest alloc] init];
+    entry.request = request;
+    entry.delegate = delegate ?: request.delegate;
+
+    BOOL batchFull = NO;
+    BOOL batchStarted = NO;
+    NSUInteger generation = 0;
+    @synchronized (self) {
+        request.batcher = self;
+        [self.pendingRequests addObject:entry];
+        NSUInteger queryCount = 0;
+        for (SFSDKBatchedRequest *pendingEntry in self.pendingRequests) {
+            queryCount += [SFSDKRequestBatcher isQueryRequest:pendingEntry.request] ? 1 : 0;
+        }
+        batchFull = self.pendingRequests.count >= MAX(1, MIN(self.maxBatchSize, kSFRequestBatcherMaxBatchSize))
+                    || queryCount >= kSFRequestBatcherMaxQueriesPerBatch;
+        batchStarted = self.pendingRequests.count == 1;
+        generation = self.batchGeneration;
+    }
+    if (batchFull) {
+        [self flush];
+    } else if (batchStarted) {
+        __weak typeof(self) weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.batchingWindow * NSEC_PER_SEC)), self.timerQueue, ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            [strongSelf sendBatch:[strongSelf takePendingRequestsForGeneration:@(generation)]];
+        });
+    }
+}
+
+- (void)flush {
+    [self sendBatch:[self takePendingRequestsForGeneration:nil]];
+}
+
+- (void)cancelPendingRequests {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKBatchedRequest *entry in [self takePendingRequestsForGeneration:nil]) {
+        entry.request.batcher = nil;
+        [restAPI notifyDelegateOfCancel:entry.delegate request:entry.request];
+    }
+}
+
+- (void)cancelRequest:(SFRestRequest *)request {
+    SFSDKBatchedRequest *cancelledEntry = nil;
+    SFRestRequest *compositeToCancel = nil;
+    @synchronized (self) {
+        for (SFSDKBatchedRequest *entry in self.pendingRequests) {
+            if (entry.request == request) {
+                cancelledEntry = entry;
+                break;
+            }
+        }
+        if (cancelledEntry) {
+            [self.pendingRequests removeObjectIdenticalTo:cancelledEntry];
+        } else {
+            for (SFRestRequest *compositeRequest in self.inFlightBatches.keyEnumerator.allObjects) {
+                NSArray<SFSDKBatchedRequest *> *batch = [self.inFlightBatches objectForKey:compositeRequest];
+                for (SFSDKBatchedRequest *entry in batch) {
+                    if (entry.request == request && !entry.cancelled) {
+                        cancelledEntry = entry;
+                        break;
+                    }
+                }
+                if (cancelledEntry) {
+                    cancelledEntry.cancelled = YES;
+                    if ([self isBatchCancelled:batch]) {
+                        compositeToCancel = compositeRequest;
+                    }
+                    break;
+                }
+            }
+        }
+        request.batcher = nil;
+    }
+    if (cancelledEntry) {
+        [self.restAPI notifyDelegateOfCancel:cancelledEntry.delegate request:cancelledEntry.request];
+    }
+    [compositeToCancel cancel];
+}
+
+- (BOOL)isBatchCancelled:(NSArray<SFSDKBatchedRequest *> *)batch {
+    for (SFSDKBatchedRequest *entry in batch) {
+        if (!entry.cancelled) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+// Takes the pending requests, unless they were already taken by a flush since the batch identified by generation started
+- (NSArray<SFSDKBatchedRequest *> *)takePendingRequestsForGeneration:(NSNumber *)generation {
+    @synchronized (self) {
+        if (generation != nil && generation.unsignedIntegerValue != self.batchGeneration) {
+            return nil;
+        }
+        NSArray<SFSDKBatchedRequest *> *batch = [self.pendingRequests copy];
+        [self.pendingRequests removeAllObjects];
+        self.batchGeneration++;
+        return batch;
+    }
+}
+
+- (void)sendBatch:(NSArray<SFSDKBatchedRequest *> *)batch {
+    SFRestAPI *restAPI = self.restAPI;
+    if (batch.count == 0 || restAPI == nil) {
+        return;
+    }
+
+    // Nothing to gain from a composite request for a single request, which then gets cancelled as usual
+    if (batch.count == 1) {
+        SFRestRequest *request = batch[0].request;
+        request.batcher = nil;
+        [restAPI send:request delegate:batch[0].delegate shouldRetry:restAPI.requiresAuthentication && request.requiresAuthentication];
+        return;
+    }
+    NSMutableArray<SFRestRequest *> *requests = [NSMutableArray arrayWithCapacity:batch.count];
+    NSMutableArray<NSString *> *refIds = [NSMutableArray arrayWithCapacity:batch.count];
+    SFRestRequestPriority priority = SFRestRequestPriorityLow;
+    for (NSUInteger i = 0; i < batch.count; i++) {
+        [requests addObject:batch[i].request];
+        [refIds addObject:[self refIdAtIndex:i]];
+        priority = MAX(priority, batch[i].request.priority);
+    }
+    SFRestRequest *compositeRequest = [restAPI compositeRequest:requests refIds:refIds allOrNone:NO];
+    compositeRequest.priority = priority;
+    NSMutableArray<SFSDKBatchedRequest *> *cancelledEntries = [NSMutableArray array];
+    @synchronized (self) {
+        [self.inFlightBatches setObject:batch forKey:compositeRequest];
+
+        // Requests cancelled while their batch was being put together
+        for (SFSDKBatchedRequest *entry in batch) {
+            if (!entry.cancelled && entry.request.cancelRequested && entry.request.batcher == nil) {
+                entry.cancelled = YES;
+                [cancelledEntries addObject:entry];
+            }
+        }
+    }
+    for (SFSDKBatchedRequest *entry in cancelledEntries) {
+        [restAPI notifyDelegateOfCancel:entry.delegate request:entry.request];
+    }
+    if ([self isBatchCancelled:batch]) {
+        [self takeInFlightBatch:compositeRequest];
+        return;
+    }
+    [SFSDKCoreLogger d:[self class] format:@"Sending %lu requests in a single composite request", (unsigned long)batch.count];
+    [restAPI send:compositeRequest delegate:self shouldRetry:restAPI.requiresAuthentication];
+}
+
+- (NSArray<SFSDKBatchedRequest *> *)takeInFlightBatch:(SFRestRequest *)compositeRequest {
+    @synchronized (self) {
+        NSArray<SFSDKBatchedRequest *> *batch = [self.inFlightBatches objectForKey:compositeRequest];
+        [self.inFlightBatches removeObjectForKey:compositeRequest];
+        for (SFSDKBatchedRequest *entry in batch) {
+            entry.request.batcher = nil;
+        }
+        return batch;
+    }
+}
+
+- (NSString *)refIdAtIndex:(NSUInteger)index {
+    return [NSString stringWithFormat:@"%@%lu", kSFRequestBatcherRefIdPrefix, (unsigned long)index];
+}
+
+#pragma mark - SFRestDelegate
+
+- (void)request:(SFRestRequest *)request didLoadResponse:(id)dataResponse rawResponse:(NSURLResponse *)rawResponse {
+    NSArray<SFSDKBatchedRequest *> *batch = [self takeInFlightBatch:request];
+    SFRestAPI *restAPI = self.restAPI;
+    NSMutableDictionary<NSString *, NSDictionary *> *subresponses = [NSMutableDictionary dictionary];
+    id compositeResponse = [dataResponse isKindOfClass:[NSDictionary class]] ? dataResponse[kSFRequestBatcherCompositeResponse] : nil;
+    if ([compositeResponse isKindOfClass:[NSArray class]]) {
+        for (id subresponse in compositeResponse) {
+            if ([subresponse isKindOfClass:[NSDictionary class]] && [subresponse[@"referenceId"] isKindOfClass:[NSString class]]) {
+                subresponses[subresponse[@"referenceId"]] = subresponse;
+            }
+        }
+    }
+    [batch enumerateObjectsUsingBlock:^(SFSDKBatchedRequest *entry, NSUInteger idx, BOOL *stop) {
+        if (entry.cancelled) {
+            return;
+        }
+        NSDictionary *subresponse = subresponses[[self refIdAtIndex:idx]];
+        if (subresponse == nil) {
+            NSError *error = [NSError errorWithDomain:kSFRestErrorDomain code:kSFRestErrorCode userInfo:@{NSLocalizedDescriptionKey: @"No response for request in composite response"}];
+            [restAPI notifyDelegateOfFailure:entry.delegate request:entry.request error:error rawResponse:rawResponse];
+            return;
+        }
+        NSInteger statusCode = [subresponse[@"httpStatusCode"] integerValue];
+        id body = subresponse[@"body"] == [NSNull null] ? nil : subresponse[@"body"];
+        NSHTTPURLResponse *subRawResponse = [self rawResponseForRequest:entry.request statusCode:statusCode headers:subresponse[@"httpHeaders"] compositeResponse:rawResponse];
+        if ([SFRestAPI isStatusCodeSuccess:statusCode]) {
+            [restAPI notifyDelegateOfResponse:entry.delegate request:entry.request data:body rawResponse:subRawResponse];
+        } else {
+
+            // Same shape of error as for a standalone request
+            NSDictionary *errorDict = nil;
+            if ([body isKindOfClass:[NSDictionary class]]) {
+                errorDict = body;
+            } else if (body != nil) {
+                errorDict = @{@"error": body};
+            }
+            NSError *error = [[NSError alloc] initWithDomain:subRawResponse.URL.absoluteString code:statusCode userInfo:errorDict];
+            [restAPI notifyDelegateOfFailure:entry.delegate request:entry.request error:error rawResponse:subRawResponse];
+        }
+    }];
+}
+
+- (void)request:(SFRestRequest *)request didFailLoadWithError:(NSError *)error rawResponse:(NSURLResponse *)rawResponse {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKBatchedRequest *entry in [self takeInFlightBatch:request]) {
+        if (entry.cancelled) {
+            continue;
+        }
+        [restAPI notifyDelegateOfFailure:entry.delegate request:entry.request error:error rawResponse:rawResponse];
+    }
+}
+
+- (void)requestDidCancelLoad:(SFRestRequest *)request {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKBatchedRequest *entry in [self takeInFlightBatch:request]) {
+        if (entry.cancelled) {
+            continue;
+        }
+        [restAPI notifyDelegateOfCancel:entry.delegate request:entry.request];
+    }
+}
+
+- (void)requestDidTimeout:(SFRestRequest *)request {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKBatchedRequest *entry in [self takeInFlightBatch:request]) {
+        if (entry.cancelled) {
+            continue;
+        }
+        [restAPI notifyDelegateOfTimeout:entry.delegate request:entry.request];
+    }
+}
+
+- (NSHTTPURLResponse *)rawResponseForRequest:(SFRestRequest *)request statusCode:(NSInteger)statusCode headers:(id)headers compositeResponse:(NSURLResponse *)compositeResponse {
+    NSMutableDictionary<NSString *, NSString *> *headerFields = [NSMutableDictionary dictionary];
+    if ([headers isKindOfClass:[NSDictionary class]]) {
+        [headers enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            if ([key isKindOfClass:[NSString class]]) {
+                headerFields[key] = [value isKindOfClass:[NSString class]] ? value : [value description];
+            }
+        }];
+    }
+    NSString *relativeUrl = [NSString stringWithFormat:@"%@%@", request.endpoint, request.path];
+    NSURL *url = [NSURL URLWithString:relativeUrl relativeToURL:compositeResponse.URL].absoluteURL ?: compositeResponse.URL;
+    return [[NSHTTPURLResponse alloc] initWithURL:url statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:headerFields];
+}
+
+@end
@@ -0,0 +1,89 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFRestAPI.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Gives single-flight semantics to idempotent requests sent through an SFRestAPI instance: a request identical
+ * to one already in flight (same method, URL, headers and parsing options) doesn't go out again, it gets
+ * the response of the one in flight instead.
+ *
+ * Every group of identical requests is carried by a copy of the first one, which is what actually gets sent.
+ * Cancelling one of the requests of a group only detaches it, the copy gets cancelled along with the last one.
+ */
+@interface SFSDKRequestCoalescer : NSObject <SFRestDelegate>
+
+/**
+ * Number of requests actually in flight on behalf of coalesced requests.
+ */
+@property (nonatomic, readonly) NSUInteger inFlightCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Initializes a coalescer for the given SFRestAPI instance.
+ *
+ * @param restAPI SFRestAPI instance (not retained).
+ * @return Instance of this class.
+ */
+- (instancetype)initWithRestAPI:(SFRestAPI *)restAPI NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Returns whether the given request can share its response with identical requests: GET requests
+ * without a body that aren't downloaded to a file.
+ *
+ * @param request Request to check.
+ * @return YES if the request can be coalesced.
+ */
++ (BOOL)canCoalesceRequest:(SFRestRequest *)request;
+
+/**
+ * Attaches a request to the identical request in flight, if any.
+ *
+ * @param request Request to send.
+ * @param delegate Delegate of the request.
+ * @return nil if the request got attached to an identical request in flight. Otherwise, the request that
+ * carries it and must be sent with this coalescer as delegate.
+ */
+- (nullable SFRestRequest *)addRequest:(SFRestRequest *)request delegate:(nullable id<SFRestDelegate>)delegate;
+
+/**
+ * Detaches a request from its group, notifying its delegate of the cancellation.
+ * The request actually in flight gets cancelled once all the requests of its group are.
+ *
+ * @param request Request to cancel.
+ */
+- (void)cancelRequest:(SFRestRequest *)request;
+
+/**
+ * Cancels all the requests in flight, notifying the delegates of all coalesced requests.
+ */
+- (void)cancelAllRequests;
+
+@end
+
+NS_ASSUME_NONNULL_END
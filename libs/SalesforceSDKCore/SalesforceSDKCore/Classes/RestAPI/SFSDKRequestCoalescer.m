@@ -0,0 +1,224 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKRequestCoalescer.h"
+#import "SFRestAPI+Internal.h"
+#import "SFRestRequest+Internal.h"
+
+@interface SFSDKCoalescedRequest : NSObject
+
+@property (nonatomic, strong) SFRestRequest *request;
+@property (nonatomic, strong) id<SFRestDelegate> delegate;
+
+@end
+
+@implementation SFSDKCoalescedRequest
+@end
+
+// Identical requests sharing one request in flight
+@interface SFSDKCoalescedGroup : NSObject
+
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, strong) SFRestRequest *carrier;
+@property (nonatomic, strong) NSMutableArray<SFSDKCoalescedRequest *> *members;
+
+@end
+
+@implementation SFSDKCoalescedGroup
+@end
+
+@interface SFSDKRequestCoalescer ()
+
+@property (nonatomic, weak) SFRestAPI *restAPI;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, SFSDKCoalescedGroup *> *groupsByKey;
+@property (nonatomic, strong) NSMapTable<SFRestRequest *, SFSDKCoalescedGroup *> *groupsByCarrier;
+
+@end
+
+@implementation SFSDKRequestCoalescer
+
+- (instancetype)initWithRestAPI:(SFRestAPI *)restAPI {
+    self = [super init];
+    if (self) {
+        _restAPI = restAPI;
+        _groupsByKey = [NSMutableDictionary dictionary];
+        _groupsByCarrier = [NSMapTable strongToStrongObjectsMapTable];
+    }
+    return self;
+}
+
++ (BOOL)canCoalesceRequest:(SFRestRequest *)request {
+    return request.method == SFRestMethodGET && request.requestBodyStreamBlock == nil
+        && request.downloadDestinationURL == nil && request.progressBlock == nil;
+}
+
+- (NSUInteger)inFlightCount {
+    @synchronized (self) {
+        return self.groupsByKey.count;
+    }
+}
+
+#pragma mark - Coalescing
+
+- (SFRestRequest *)addRequest:(SFRestRequest *)request delegate:(id<SFRestDelegate>)delegate {
+    if (nil != delegate) {
+        request.delegate = delegate;
+    }
+    SFSDKCoalescedRequest *member = [[SFSDKCoalescedRequest alloc] init];
+    member.request = request;
+    member.delegate = delegate ?: request.delegate;
+    SFRestRequest *carrier = [self carrierForRequest:request];
+    NSString *key = [self keyForCarrier:carrier];
+    @synchronized (self) {
+        request.coalescer = self;
+        SFSDKCoalescedGroup *group = self.groupsByKey[key];
+        if (group) {
+            [group.members addObject:member];
+            [SFSDKCoreLogger d:[self class] format:@"Request attached to identical request in flight (%lu requests): %@", (unsigned long)group.members.count, request.path];
+            return nil;
+        }
+        group = [[SFSDKCoalescedGroup alloc] init];
+        group.key = key;
+        group.carrier = carrier;
+        group.members = [NSMutableArray arrayWithObject:member];
+        self.groupsByKey[key] = group;
+        [self.groupsByCarrier setObject:group forKey:group.carrier];
+        return group.carrier;
+    }
+}
+
+- (void)cancelRequest:(SFRestRequest *)request {
+    SFSDKCoalescedRequest *cancelledMember = nil;
+    SFRestRequest *carrierToCancel = nil;
+    @synchronized (self) {
+        for (SFSDKCoalescedGroup *group in self.groupsByKey.allValues) {
+            for (SFSDKCoalescedRequest *member in group.members) {
+                if (member.request == request) {
+                    cancelledMember = member;
+                    break;
+                }
+            }
+            if (cancelledMember) {
+                [group.members removeObject:cancelledMember];
+                if (group.members.count == 0) {
+                    [self.groupsByKey removeObjectForKey:group.key];
+                    [self.groupsByCarrier removeObjectForKey:group.carrier];
+                    carrierToCancel = group.carrier;
+                }
+                break;
+            }
+        }
+        request.coalescer = nil;
+    }
+    if (cancelledMember) {
+        [self.restAPI notifyDelegateOfCancel:cancelledMember.delegate request:cancelledMember.request];
+    }
+    [carrierToCancel cancel];
+}
+
+- (void)cancelAllRequests {
+    NSArray<SFRestRequest *> *carriers = nil;
+    @synchronized (self) {
+        carriers = [self.groupsByCarrier.keyEnumerator allObjects];
+    }
+    for (SFRestRequest *carrier in carriers) {
+        [carrier cancel];
+    }
+}
+
+/*
+ * Method, URL, headers and parsing options, which is what the response depends on. Computed from the carrier,
+ * a copy of the request, since preparing a request for sending changes it (e.g. its path and URL request).
+ */
+- (NSString *)keyForCarrier:(SFRestRequest *)carrier {
+    NSURLRequest *urlRequest = [carrier prepareRequestForSend:self.restAPI.user];
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%@ %@ %d%d%d", urlRequest.HTTPMethod, urlRequest.URL.absoluteString, carrier.parseResponse, carrier.lazyParseResponse, carrier.cacheResponse];
+    for (NSString *header in [carrier.customHeaders.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        [key appendFormat:@"\n%@: %@", header, carrier.customHeaders[header]];
+    }
+    return key;
+}
+
+- (SFRestRequest *)carrierForRequest:(SFRestRequest *)request {
+    SFRestRequest *carrier = [SFRestRequest requestWithMethod:request.method serviceHostType:request.serviceHostType path:request.path queryParams:request.queryParams];
+    carrier.baseURL = request.baseURL;
+    carrier.endpoint = request.endpoint;
+    carrier.requiresAuthentication = request.requiresAuthentication;
+    carrier.shouldRefreshOn403 = request.shouldRefreshOn403;
+    carrier.parseResponse = request.parseResponse;
+    carrier.lazyParseResponse = request.lazyParseResponse;
+    carrier.cacheResponse = request.cacheResponse;
+    carrier.customHeaders = [request.customHeaders mutableCopy];
+    carrier.networkServiceType = request.networkServiceType;
+    carrier.priority = request.priority;
+    carrier.retryPolicy = request.retryPolicy;
+    return carrier;
+}
+
+- (NSArray<SFSDKCoalescedRequest *> *)takeMembersForCarrier:(SFRestRequest *)carrier {
+    @synchronized (self) {
+        SFSDKCoalescedGroup *group = [self.groupsByCarrier objectForKey:carrier];
+        if (!group) {
+            return @[];
+        }
+        [self.groupsByCarrier removeObjectForKey:carrier];
+        [self.groupsByKey removeObjectForKey:group.key];
+        for (SFSDKCoalescedRequest *member in group.members) {
+            member.request.coalescer = nil;
+        }
+        return group.members;
+    }
+}
+
+#pragma mark - SFRestDelegate
+
+- (void)request:(SFRestRequest *)request didLoadResponse:(id)dataResponse rawResponse:(NSURLResponse *)rawResponse {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKCoalescedRequest *member in [self takeMembersForCarrier:request]) {
+        [restAPI notifyDelegateOfResponse:member.delegate request:member.request data:dataResponse rawResponse:rawResponse];
+    }
+}
+
+- (void)request:(SFRestRequest *)request didFailLoadWithError:(NSError *)error rawResponse:(NSURLResponse *)rawResponse {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKCoalescedRequest *member in [self takeMembersForCarrier:request]) {
+        [restAPI notifyDelegateOfFailure:member.delegate request:member.request error:error rawResponse:rawResponse];
+    }
+}
+
+- (void)requestDidCancelLoad:(SFRestRequest *)request {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKCoalescedRequest *member in [self takeMembersForCarrier:request]) {
+        [restAPI notifyDelegateOfCancel:member.delegate request:member.request];
+    }
+}
+
+- (void)requestDidTimeout:(SFRestRequest *)request {
+    SFRestAPI *restAPI = self.restAPI;
+    for (SFSDKCoalescedRequest *member in [self takeMembersForCarrier:request]) {
+        [restAPI notifyDelegateOfTimeout:member.delegate request:member.request];
+    }
+}
+
+@end
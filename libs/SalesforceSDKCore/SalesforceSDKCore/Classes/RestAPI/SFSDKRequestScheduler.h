@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFRestRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Block run by the scheduler when a request gets its turn. The request must call `finishBlock` exactly once
+ * when it no longer uses the network, so that its slot can go to the next queued request.
+ */
+typedef void (^SFSDKRequestSchedulerDispatchBlock) (dispatch_block_t finishBlock) NS_SWIFT_NAME(RequestSchedulerDispatchBlock);
+
+/**
+ * Orders outgoing REST requests by priority and caps how many of them run at once, globally and per host.
+ * Queued requests age while they wait: every `agingInterval` seconds spent in the queue raises a request
+ * by one priority level, so low priority work (e.g. sync) keeps making progress under a steady stream of
+ * interactive requests.
+ */
+NS_SWIFT_NAME(RequestScheduler)
+@interface SFSDKRequestScheduler : NSObject
+
+/**
+ * Maximum number of requests running at once, across all hosts. Defaults to 10.
+ */
+@property (atomic, assign) NSUInteger maxConcurrentRequests;
+
+/**
+ * Maximum number of requests running at once against a single host. Defaults to 6.
+ */
+@property (atomic, assign) NSUInteger maxConcurrentRequestsPerHost;
+
+/**
+ * Time (in seconds) a queued request needs to wait to be promoted by one priority level. Defaults to 2.
+ */
+@property (atomic, assign) NSTimeInterval agingInterval;
+
+/**
+ * Number of requests waiting for a slot.
+ */
+@property (atomic, readonly) NSUInteger queuedCount;
+
+/**
+ * Number of requests currently holding a slot.
+ */
+@property (atomic, readonly) NSUInteger runningCount;
+
+/**
+ * Returns the scheduler shared by all SFRestAPI instances.
+ *
+ * @return Shared instance of this class.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ * Runs `dispatchBlock` right away if a slot is free for `host`, or queues it otherwise.
+ *
+ * @param request Request being scheduled, its `priority` decides its place in the queue.
+ * @param host Host the request goes to.
+ * @param dispatchBlock Block sending the request.
+ * @param cancelBlock Block run if the request gets cancelled while still queued.
+ */
+- (void)scheduleRequest:(SFRestRequest *)request
+                   host:(NSString *)host
+          dispatchBlock:(SFSDKRequestSchedulerDispatchBlock)dispatchBlock
+            cancelBlock:(nullable dispatch_block_t)cancelBlock;
+
+/**
+ * Removes the given request from the queue and runs its cancel block.
+ *
+ * @param request Request to cancel.
+ * @return YES if the request was still queued, NO if it was already dispatched (or never scheduled).
+ */
+- (BOOL)cancelRequest:(SFRestRequest *)request;
+
+/**
+ * Whether the given request is waiting for a slot.
+ *
+ * @param request Request to look for.
+ * @return YES if the request is queued, NO if it was already dispatched (or never scheduled).
+ */
+- (BOOL)isRequestQueued:(SFRestRequest *)request;
+
+/**
+ * Number of requests of the given priority dispatched since the last reset of the statistics.
+ */
+- (NSUInteger)dispatchedCountForPriority:(SFRestRequestPriority)priority;
+
+/**
+ * Average time (in seconds) requests of the given priority waited in the queue before being dispatched.
+ */
+- (NSTimeInterval)averageWaitTimeForPriority:(SFRestRequestPriority)priority;
+
+/**
+ * Longest time (in seconds) a request of the given priority waited in the queue before being dispatched.
+ */
+- (NSTimeInterval)maxWaitTimeForPriority:(SFRestRequestPriority)priority;
+
+/**
+ * Resets the wait time statistics.
+ */
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,266 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKRequestScheduler.h"
+#import "SFRestRequest+Internal.h"
+
+static NSUInteger const kSFRequestSchedulerDefaultMaxConcurrentRequests = 10;
+static NSUInteger const kSFRequestSchedulerDefaultMaxConcurrentRequestsPerHost = 6;
+static NSTimeInterval const kSFRequestSchedulerDefaultAgingInterval = 2.0;
+#define kSFRequestPriorityLevels (SFRestRequestPriorityHigh + 1)
+
+@interface SFSDKScheduledRequest : NSObject
+
+@property (nonatomic, strong) SFRestRequest *request;
+@property (nonatomic, copy) NSString *host;
+@property (nonatomic, assign) SFRestRequestPriority priority;
+@property (nonatomic, assign) NSTimeInterval enqueueTime;
+@property (nonatomic, copy) SFSDKRequestSchedulerDispatchBlock dispatchBlock;
+@property (nonatomic, copy) dispatch_block_t cancelBlock;
+@property (nonatomic, assign) BOOL finished;
+
+@end
+
+@implementation SFSDKScheduledRequest
+@end
+
+@interface SFSDKRequestScheduler () {
+    NSUInteger _dispatchedCounts[kSFRequestPriorityLevels];
+    NSTimeInterval _totalWaitTimes[kSFRequestPriorityLevels];
+    NSTimeInterval _maxWaitTimes[kSFRequestPriorityLevels];
+}
+
+// One FIFO queue per priority level, indexed by priority
+@property (nonatomic, strong) NSArray<NSMutableArray<SFSDKScheduledRequest *> *> *queues;
+@property (nonatomic, strong) NSCountedSet<NSString *> *runningHosts;
+@property (nonatomic, assign) NSUInteger running;
+
+@end
+
+@implementation SFSDKRequestScheduler
+
++ (instancetype)sharedInstance {
+    static SFSDKRequestScheduler *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] init];
+    });
+    return sharedInstance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        NSMutableArray *queues = [NSMutableArray arrayWithCapacity:kSFRequestPriorityLevels];
+        for (NSInteger level = 0; level < kSFRequestPriorityLevels; level++) {
+            [queues addObject:[NSMutableArray array]];
+        }
+        _queues = queues;
+        _runningHosts = [NSCountedSet set];
+        _maxConcurrentRequests = kSFRequestSchedulerDefaultMaxConcurrentRequests;
+        _maxConcurrentRequestsPerHost = kSFRequestSchedulerDefaultMaxConcurrentRequestsPerHost;
+        _agingInterval = kSFRequestSchedulerDefaultAgingInterval;
+    }
+    return self;
+}
+
+#pragma mark - Scheduling
+
+- (void)scheduleRequest:(SFRestRequest *)request
+                   host:(NSString *)host
+          dispatchBlock:(SFSDKRequestSchedulerDispatchBlock)dispatchBlock
+            cancelBlock:(dispatch_block_t)cancelBlock {
+    SFSDKScheduledRequest *entry = [[SFSDKScheduledRequest alloc] init];
+    entry.request = request;
+    entry.host = host;
+    entry.priority = MAX(SFRestRequestPriorityLow, MIN(SFRestRequestPriorityHigh, request.priority));
+    entry.enqueueTime = [NSProcessInfo processInfo].systemUptime;
+    entry.dispatchBlock = dispatchBlock;
+    entry.cancelBlock = cancelBlock;
+    request.scheduler = self;
+    @synchronized (self) {
+        [self.queues[entry.priority] addObject:entry];
+    }
+    [self dispatchReadyRequests];
+}
+
+- (BOOL)cancelRequest:(SFRestRequest *)request {
+    SFSDKScheduledRequest *cancelled = nil;
+    @synchronized (self) {
+        for (NSMutableArray<SFSDKScheduledRequest *> *queue in self.queues) {
+            NSUInteger index = [queue indexOfObjectPassingTest:^BOOL(SFSDKScheduledRequest *entry, NSUInteger idx, BOOL *stop) {
+                return entry.request == request;
+            }];
+            if (index != NSNotFound) {
+                cancelled = queue[index];
+                [queue removeObjectAtIndex:index];
+                break;
+            }
+        }
+    }
+    if (cancelled && cancelled.cancelBlock) {
+        cancelled.cancelBlock();
+    }
+    return cancelled != nil;
+}
+
+- (BOOL)isRequestQueued:(SFRestRequest *)request {
+    @synchronized (self) {
+        for (NSArray<SFSDKScheduledRequest *> *queue in self.queues) {
+            for (SFSDKScheduledRequest *entry in queue) {
+                if (entry.request == request) {
+                    return YES;
+                }
+            }
+        }
+        return NO;
+    }
+}
+
+- (void)dispatchReadyRequests {
+    NSMutableArray<SFSDKScheduledRequest *> *ready = [NSMutableArray array];
+    @synchronized (self) {
+        NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+        SFSDKScheduledRequest *next = nil;
+        while (self.running < self.maxConcurrentRequests && (next = [self nextDispatchableRequest:now])) {
+            [self.queues[next.priority] removeObjectIdenticalTo:next];
+            [self.runningHosts addObject:next.host];
+            self.running++;
+            [self recordWaitTime:now - next.enqueueTime priority:next.priority];
+            [ready addObject:next];
+        }
+    }
+
+    // Dispatch blocks are run outside of the lock since they may finish (and so reenter) synchronously
+    for (SFSDKScheduledRequest *entry in ready) {
+        __weak typeof(self) weakSelf = self;
+        SFSDKRequestSchedulerDispatchBlock dispatchBlock = entry.dispatchBlock;
+        entry.dispatchBlock = nil;
+        entry.cancelBlock = nil;
+        dispatchBlock(^{
+            [weakSelf finishScheduledRequest:entry];
+        });
+    }
+}
+
+/*
+ * Picks the queued request with the highest effective priority, i.e. its priority plus one level per
+ * aging interval spent in the queue, skipping requests whose host is at capacity. Within a priority level
+ * the oldest eligible request always wins, so only the first eligible request of each level is considered.
+ */
+- (SFSDKScheduledRequest *)nextDispatchableRequest:(NSTimeInterval)now {
+    SFSDKScheduledRequest *best = nil;
+    double bestScore = 0;
+    for (NSInteger level = 0; level < kSFRequestPriorityLevels; level++) {
+        for (SFSDKScheduledRequest *entry in self.queues[level]) {
+            if ([self.runningHosts countForObject:entry.host] >= self.maxConcurrentRequestsPerHost) {
+                continue;
+            }
+            double score = level + (self.agingInterval > 0 ? (now - entry.enqueueTime) / self.agingInterval : 0);
+            if (!best || score > bestScore || (score == bestScore && entry.enqueueTime < best.enqueueTime)) {
+                best = entry;
+                bestScore = score;
+            }
+            break;
+        }
+    }
+    return best;
+}
+
+- (void)finishScheduledRequest:(SFSDKScheduledRequest *)entry {
+    @synchronized (self) {
+        if (entry.finished) {
+            return;
+        }
+        entry.finished = YES;
+        [self.runningHosts removeObject:entry.host];
+        self.running--;
+    }
+    [self dispatchReadyRequests];
+}
+
+#pragma mark - Counts
+
+- (NSUInteger)queuedCount {
+    @synchronized (self) {
+        NSUInteger count = 0;
+        for (NSArray *queue in self.queues) {
+            count += queue.count;
+        }
+        return count;
+    }
+}
+
+- (NSUInteger)runningCount {
+    @synchronized (self) {
+        return self.running;
+    }
+}
+
+#pragma mark - Statistics
+
+- (void)recordWaitTime:(NSTimeInterval)waitTime priority:(SFRestRequestPriority)priority {
+    _dispatchedCounts[priority]++;
+    _totalWaitTimes[priority] += waitTime;
+    _maxWaitTimes[priority] = MAX(_maxWaitTimes[priority], waitTime);
+}
+
+- (NSUInteger)dispatchedCountForPriority:(SFRestRequestPriority)priority {
+    if (priority < SFRestRequestPriorityLow || priority > SFRestRequestPriorityHigh) {
+        return 0;
+    }
+    @synchronized (self) {
+        return _dispatchedCounts[priority];
+    }
+}
+
+- (NSTimeInterval)averageWaitTimeForPriority:(SFRestRequestPriority)priority {
+    if (priority < SFRestRequestPriorityLow || priority > SFRestRequestPriorityHigh) {
+        return 0;
+    }
+    @synchronized (self) {
+        return _dispatchedCounts[priority] == 0 ? 0 : _totalWaitTimes[priority] / _dispatchedCounts[priority];
+    }
+}
+
+- (NSTimeInterval)maxWaitTimeForPriority:(SFRestRequestPriority)priority {
+    if (priority < SFRestRequestPriorityLow || priority > SFRestRequestPriorityHigh) {
+        return 0;
+    }
+    @synchronized (self) {
+        return _maxWaitTimes[priority];
+    }
+}
+
+- (void)resetStatistics {
+    @synchronized (self) {
+        for (NSInteger level = 0; level < kSFRequestPriorityLevels; level++) {
+            _dispatchedCounts[level] = 0;
+            _totalWaitTimes[level] = 0;
+            _maxWaitTimes[level] = 0;
+        }
+    }
+}
+
+@end
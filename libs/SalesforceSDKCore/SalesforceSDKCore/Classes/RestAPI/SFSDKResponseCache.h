@@ -0,0 +1,141 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFUserAccount.h"
+
+@class SFEncryptionKey;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Encrypted on-disk cache of REST responses, revalidated with conditional requests.
+ * Requests for cached responses are sent with `If-None-Match` / `If-Modified-Since` and a `304 Not Modified`
+ * answer is served from the cache. Entries are evicted least recently used first once the cache goes over `maxSize`.
+ * Only responses carrying an `ETag` or a `Last-Modified` header get cached.
+ */
+NS_SWIFT_NAME(ResponseCache)
+@interface SFSDKResponseCache : NSObject
+
+/**
+ * Size budget (in bytes) of the cache. 10 MB by default.
+ */
+@property (atomic, assign) NSUInteger maxSize;
+
+/**
+ * Total size (in bytes) of the cached responses.
+ */
+@property (atomic, readonly) NSUInteger currentSize;
+
+/**
+ * Number of cached responses.
+ */
+@property (atomic, readonly) NSUInteger entryCount;
+
+/**
+ * Number of responses served from the cache (i.e. `304 Not Modified` answers) since the last reset of the statistics.
+ */
+@property (atomic, readonly) NSUInteger hitCount;
+
+/**
+ * Number of responses that had to be downloaded since the last reset of the statistics.
+ */
+@property (atomic, readonly) NSUInteger missCount;
+
+/**
+ * Number of responses evicted to stay within `maxSize` since the last reset of the statistics.
+ */
+@property (atomic, readonly) NSUInteger evictionCount;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Initializes a cache stored in the given directory.
+ *
+ * @param directory Directory of the cache, created if needed.
+ * @param encryptionKey Key used to encrypt the cache on disk.
+ * @param maxSize Size budget (in bytes) of the cache.
+ * @return Instance of this class.
+ */
+- (instancetype)initWithDirectory:(NSString *)directory encryptionKey:(SFEncryptionKey *)encryptionKey maxSize:(NSUInteger)maxSize NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Returns the cache of the given user, creating it on first use.
+ *
+ * @param user User account.
+ * @return Cache of the user.
+ */
++ (instancetype)sharedCacheForUser:(SFUserAccount *)user NS_SWIFT_NAME(sharedCache(for:));
+
+/**
+ * Removes the cache of the given user, including its files.
+ *
+ * @param user User account.
+ */
++ (void)removeSharedCacheForUser:(SFUserAccount *)user;
+
+/**
+ * Adds validators (`If-None-Match` / `If-Modified-Since`) to the given request if its response is cached.
+ *
+ * @param request Request about to be sent.
+ */
+- (void)addValidatorsToRequest:(NSMutableURLRequest *)request;
+
+/**
+ * Returns the cached response body for the given request, to be used when the server answered `304 Not Modified`.
+ *
+ * @param request Request that was sent.
+ * @param response Set to the cached response.
+ * @return Cached response body, or nil if the response is not cached (anymore).
+ */
+- (nullable NSData *)cachedDataForRequest:(NSURLRequest *)request response:(NSHTTPURLResponse * _Nullable * _Nullable)response;
+
+/**
+ * Caches the response of the given request, if it carries an `ETag` or a `Last-Modified` header.
+ *
+ * @param data Response body.
+ * @param response Response.
+ * @param request Request that was sent.
+ */
+- (void)storeData:(nullable NSData *)data response:(NSHTTPURLResponse *)response forRequest:(NSURLRequest *)request;
+
+/**
+ * Saves the index of the cache right away if it changed. The index is otherwise saved shortly after
+ * it changes, and when the app goes to the background.
+ */
+- (void)flush;
+
+/**
+ * Removes all the cached responses.
+ */
+- (void)removeAllEntries;
+
+/**
+ * Resets the hit, miss and eviction counts.
+ */
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
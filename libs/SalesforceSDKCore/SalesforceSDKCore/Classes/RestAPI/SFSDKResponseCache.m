@@ -0,0 +1,329 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <UIKit/UIKit.h>
+#import <SalesforceSDKCommon/SFJsonUtils.h>
+#import "SFSDKResponseCache.h"
+#import "SFEncryptionKey.h"
+#import "SFKeyStoreManager.h"
+#import "SFDirectoryManager.h"
+#import "SFUserAccountManager.h"
+#import "NSString+SFAdditions.h"
+
+static NSString * const kSFResponseCacheDirectory = @"com.salesforce.restapi.responseCache";
+static NSString * const kSFResponseCacheEncryptionKeyLabel = @"com.salesforce.restapi.responseCache.encryptionKey";
+static NSString * const kSFResponseCacheIndexFile = @"index";
+static NSUInteger const kSFResponseCacheDefaultMaxSize = 10 * 1024 * 1024;
+static NSTimeInterval const kSFResponseCacheIndexSaveDelay = 2.0;
+
+// Index entry keys
+static NSString * const kSFResponseCacheETag = @"etag";
+static NSString * const kSFResponseCacheLastModified = @"lastModified";
+static NSString * const kSFResponseCacheHeaders = @"headers";
+static NSString * const kSFResponseCacheSize = @"size";
+static NSString * const kSFResponseCacheLastAccess = @"lastAccess";
+
+// Request headers the response may depend on, other than method and URL
+static NSString * const kSFResponseCacheKeyHeaders[] = { @"Accept", @"Accept-Language" };
+
+static NSMutableDictionary<NSString *, SFSDKResponseCache *> *sharedCaches = nil;
+
+@interface SFSDKResponseCache ()
+
+@property (nonatomic, copy) NSString *directory;
+@property (nonatomic, strong) SFEncryptionKey *encryptionKey;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableDictionary *> *index;
+@property (nonatomic, assign) BOOL indexChanged;
+@property (nonatomic, strong) dispatch_queue_t indexQueue;
+@property (atomic, readwrite) NSUInteger currentSize;
+@property (atomic, readwrite) NSUInteger hitCount;
+@property (atomic, readwrite) NSUInteger missCount;
+@property (atomic, readwrite) NSUInteger evictionCount;
+
+@end
+
+@implementation SFSDKResponseCache
+
+- (instancetype)initWithDirectory:(NSString *)directory encryptionKey:(SFEncryptionKey *)encryptionKey maxSize:(NSUInteger)maxSize {
+    self = [super init];
+    if (self) {
+        _directory = [directory copy];
+        _encryptionKey = encryptionKey;
+        _maxSize = maxSize;
+        NSError *error = nil;
+        if (![SFDirectoryManager ensureDirectoryExists:directory error:&error]) {
+            [SFSDKCoreLogger e:[self class] format:@"Could not create response cache directory: %@", error];
+        }
+        _indexQueue = dispatch_queue_create("com.salesforce.restapi.responseCache.index", DISPATCH_QUEUE_SERIAL);
+        [self loadIndex];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flush) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flush) name:UIApplicationWillTerminateNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Shared caches
+
++ (NSString *)directoryForUser:(SFUserAccount *)user {
+    return [[SFDirectoryManager sharedManager] directoryForUser:user scope:SFUserAccountScopeUser type:NSCachesDirectory components:@[ kSFResponseCacheDirectory ]];
+}
+
++ (instancetype)sharedCacheForUser:(SFUserAccount *)user {
+    NSString *key = SFKeyForUserAndScope(user, SFUserAccountScopeUser);
+    @synchronized ([SFSDKResponseCache class]) {
+        if (!sharedCaches) {
+            sharedCaches = [NSMutableDictionary dictionary];
+        }
+        SFSDKResponseCache *cache = sharedCaches[key];
+        if (!cache) {
+            SFEncryptionKey *encryptionKey = [[SFKeyStoreManager sharedInstance] retrieveKeyWithLabel:kSFResponseCacheEncryptionKeyLabel autoCreate:YES];
+            cache = [[SFSDKResponseCache alloc] initWithDirectory:[self directoryForUser:user] encryptionKey:encryptionKey maxSize:kSFResponseCacheDefaultMaxSize];
+            sharedCaches[key] = cache;
+        }
+        return cache;
+    }
+}
+
++ (void)removeSharedCacheForUser:(SFUserAccount *)user {
+    NSString *key = SFKeyForUserAndScope(user, SFUserAccountScopeUser);
+    @synchronized ([SFSDKResponseCache class]) {
+        [sharedCaches[key] removeAllEntries];
+        [sharedCaches removeObjectForKey:key];
+        NSString *directory = [self directoryForUser:user];
+        if (directory) {
+            [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+        }
+    }
+}
+
+#pragma mark - Conditional requests
+
+- (NSString *)keyForRequest:(NSURLRequest *)request {
+    NSMutableString *keyString = [NSMutableString stringWithFormat:@"%@ %@", request.HTTPMethod ?: @"GET", request.URL.absoluteString];
+    for (NSUInteger i = 0; i < sizeof(kSFResponseCacheKeyHeaders) / sizeof(kSFResponseCacheKeyHeaders[0]); i++) {
+        [keyString appendFormat:@"\n%@", [request valueForHTTPHeaderField:kSFResponseCacheKeyHeaders[i]] ?: @""];
+    }
+    return [NSString stringWithHexData:[keyString sha256]];
+}
+
+- (void)addValidatorsToRequest:(NSMutableURLRequest *)request {
+    NSString *key = [self keyForRequest:request];
+    @synchronized (self) {
+        NSDictionary *entry = self.index[key];
+        if (!entry) {
+            return;
+        }
+        if (entry[kSFResponseCacheETag] && ![request valueForHTTPHeaderField:@"If-None-Match"]) {
+            [request setValue:entry[kSFResponseCacheETag] forHTTPHeaderField:@"If-None-Match"];
+        }
+        if (entry[kSFResponseCacheLastModified] && ![request valueForHTTPHeaderField:@"If-Modified-Since"]) {
+            [request setValue:entry[kSFResponseCacheLastModified] forHTTPHeaderField:@"If-Modified-Since"];
+        }
+    }
+}
+
+- (NSData *)cachedDataForRequest:(NSURLRequest *)request response:(NSHTTPURLResponse **)response {
+    NSString *key = [self keyForRequest:request];
+    @synchronized (self) {
+        NSMutableDictionary *entry = self.index[key];
+        if (!entry) {
+            return nil;
+        }
+        NSData *encryptedData = [NSData dataWithContentsOfFile:[self.directory stringByAppendingPathComponent:key]];
+        NSData *data = encryptedData ? [self.encryptionKey decryptData:encryptedData] : nil;
+        if (!data) {
+            [self removeEntryWithKey:key];
+            [self setNeedsSaveIndex];
+            return nil;
+        }
+        entry[kSFResponseCacheLastAccess] = @([NSDate date].timeIntervalSince1970);
+        [self setNeedsSaveIndex];
+        self.hitCount++;
+        if (response) {
+            *response = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:entry[kSFResponseCacheHeaders]];
+        }
+        return data;
+    }
+}
+
+- (void)storeData:(NSData *)data response:(NSHTTPURLResponse *)response forRequest:(NSURLRequest *)request {
+    NSString *key = [self keyForRequest:request];
+    NSDictionary<NSString *, NSString *> *headers = response.allHeaderFields;
+    NSString *etag = [self valueForHeader:@"ETag" headers:headers];
+    NSString *lastModified = [self valueForHeader:@"Last-Modified" headers:headers];
+    NSString *cacheControl = [self valueForHeader:@"Cache-Control" headers:headers];
+    BOOL cacheable = (etag || lastModified) && data != nil && data.length <= self.maxSize && ![cacheControl.lowercaseString containsString:@"no-store"];
+    @synchronized (self) {
+        self.missCount++;
+        [self removeEntryWithKey:key];
+        if (cacheable) {
+            NSData *encryptedData = [self.encryptionKey encryptData:data];
+            if ([encryptedData writeToFile:[self.directory stringByAppendingPathComponent:key] atomically:YES]) {
+                NSMutableDictionary *entry = [NSMutableDictionary dictionary];
+                entry[kSFResponseCacheETag] = etag;
+                entry[kSFResponseCacheLastModified] = lastModified;
+                entry[kSFResponseCacheHeaders] = headers;
+                entry[kSFResponseCacheSize] = @(data.length);
+                entry[kSFResponseCacheLastAccess] = @([NSDate date].timeIntervalSince1970);
+                self.index[key] = entry;
+                self.currentSize += data.length;
+                [self evictIfNeeded];
+            }
+        }
+        [self setNeedsSaveIndex];
+    }
+}
+
+- (NSString *)valueForHeader:(NSString *)header headers:(NSDictionary<NSString *, NSString *> *)headers {
+    for (NSString *name in headers) {
+        if ([name caseInsensitiveCompare:header] == NSOrderedSame) {
+            return headers[name];
+        }
+    }
+    return nil;
+}
+
+#pragma mark - Entries
+
+- (NSUInteger)entryCount {
+    @synchronized (self) {
+        return self.index.count;
+    }
+}
+
+- (void)removeAllEntries {
+    @synchronized (self) {
+        for (NSString *key in self.index.allKeys) {
+            [self removeEntryWithKey:key];
+        }
+        [self setNeedsSaveIndex];
+    }
+    [self flush];
+}
+
+- (void)resetStatistics {
+    self.hitCount = 0;
+    self.missCount = 0;
+    self.evictionCount = 0;
+}
+
+// Must be called while holding the lock
+- (void)removeEntryWithKey:(NSString *)key {
+    NSDictionary *entry = self.index[key];
+    if (entry) {
+        self.currentSize -= MIN(self.currentSize, [entry[kSFResponseCacheSize] unsignedIntegerValue]);
+        [self.index removeObjectForKey:key];
+        [[NSFileManager defaultManager] removeItemAtPath:[self.directory stringByAppendingPathComponent:key] error:nil];
+    }
+}
+
+// Must be called while holding the lock
+- (void)evictIfNeeded {
+    if (self.currentSize <= self.maxSize) {
+        return;
+    }
+    NSArray<NSString *> *keysByLastAccess = [self.index keysSortedByValueUsingComparator:^NSComparisonResult(NSDictionary *entry1, NSDictionary *entry2) {
+        return [entry1[kSFResponseCacheLastAccess] compare:entry2[kSFResponseCacheLastAccess]];
+    }];
+    for (NSString *key in keysByLastAccess) {
+        if (self.currentSize <= self.maxSize) {
+            break;
+        }
+        [self removeEntryWithKey:key];
+        self.evictionCount++;
+    }
+}
+
+#pragma mark - Index
+
+- (NSString *)indexPath {
+    return [self.directory stringByAppendingPathComponent:kSFResponseCacheIndexFile];
+}
+
+- (void)loadIndex {
+    self.index = [NSMutableDictionary dictionary];
+    self.currentSize = 0;
+    NSData *encryptedIndex = [NSData dataWithContentsOfFile:[self indexPath]];
+    NSData *indexData = encryptedIndex ? [self.encryptionKey decryptData:encryptedIndex] : nil;
+    id savedIndex = indexData ? [SFJsonUtils objectFromJSONData:indexData] : nil;
+    if ([savedIndex isKindOfClass:[NSDictionary class]]) {
+        for (NSString *key in savedIndex) {
+            NSMutableDictionary *entry = [savedIndex[key] mutableCopy];
+            if ([[NSFileManager defaultManager] fileExistsAtPath:[self.directory stringByAppendingPathComponent:key]]) {
+                self.index[key] = entry;
+                self.currentSize += [entry[kSFResponseCacheSize] unsignedIntegerValue];
+            }
+        }
+    }
+
+    // Bodies stored after the index was last saved are unknown, they go away
+    for (NSString *file in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directory error:nil]) {
+        if (![file isEqualToString:kSFResponseCacheIndexFile] && !self.index[file]) {
+            [[NSFileManager defaultManager] removeItemAtPath:[self.directory stringByAppendingPathComponent:file] error:nil];
+        }
+    }
+}
+
+/*
+ * The index changes on every hit, it is saved a little while after it changed (and when the app goes to the
+ * background) rather than encrypted and written on each access. Must be called while holding the lock.
+ */
+- (void)setNeedsSaveIndex {
+    if (self.indexChanged) {
+        return;
+    }
+    self.indexChanged = YES;
+    __weak typeof(self) weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kSFResponseCacheIndexSaveDelay * NSEC_PER_SEC)), self.indexQueue, ^{
+        [weakSelf saveIndexIfChanged];
+    });
+}
+
+- (void)flush {
+    dispatch_sync(self.indexQueue, ^{
+        [self saveIndexIfChanged];
+    });
+}
+
+// Must be called on the index queue
+- (void)saveIndexIfChanged {
+    NSData *indexData = nil;
+    @synchronized (self) {
+        if (!self.indexChanged) {
+            return;
+        }
+        self.indexChanged = NO;
+        indexData = [SFJsonUtils JSONDataRepresentation:self.index options:0];
+    }
+    NSData *encryptedIndex = indexData ? [self.encryptionKey encryptData:indexData] : nil;
+    if (![encryptedIndex writeToFile:[self indexPath] atomically:YES]) {
+        [SFSDKCoreLogger e:[self class] format:@"Could not save response cache index"];
+    }
+}
+
+@end
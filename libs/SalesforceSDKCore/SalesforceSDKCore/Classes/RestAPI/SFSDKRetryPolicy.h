@@ -0,0 +1,115 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFRestRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Decides whether (and when) a request that failed with a transient error gets sent again.
+ * Transient errors are 429 (e.g. REQUEST_LIMIT_EXCEEDED), 5xx gateway/availability errors, timeouts and dropped connections.
+ * Requests are retried with exponential backoff and full jitter, or after the delay asked by a `Retry-After` header.
+ * Non idempotent (POST) requests are only retried when the server rejected them outright (429 and 503).
+ */
+NS_SWIFT_NAME(RetryPolicy)
+@interface SFSDKRetryPolicy : NSObject <NSCopying>
+
+/**
+ * Maximum number of retries of a request. 3 by default.
+ */
+@property (nonatomic, assign) NSUInteger maxRetries;
+
+/**
+ * Delay (in seconds) before the first retry, doubled for each subsequent retry. 0.5 by default.
+ */
+@property (nonatomic, assign) NSTimeInterval baseDelay;
+
+/**
+ * Maximum delay (in seconds) between two attempts, when the server does not ask for a specific one. 30 by default.
+ */
+@property (nonatomic, assign) NSTimeInterval maxDelay;
+
+/**
+ * Longest `Retry-After` (in seconds) honored, requests asked to wait longer are not retried. 120 by default.
+ */
+@property (nonatomic, assign) NSTimeInterval maxRetryAfter;
+
+/**
+ * Whether delays are randomized (full jitter) to avoid clients retrying in lockstep. YES by default.
+ */
+@property (nonatomic, assign) BOOL jitter;
+
+/**
+ * HTTP status codes considered transient. 429, 500, 502, 503 and 504 by default.
+ */
+@property (nonatomic, copy) NSSet<NSNumber *> *retryableStatusCodes;
+
+/**
+ * NSURLErrorDomain error codes considered transient. Timeouts, dropped connections and failed connections by default.
+ */
+@property (nonatomic, copy) NSSet<NSNumber *> *retryableErrorCodes;
+
+/**
+ * Policy given to new requests, an instance with the default settings (i.e. up to 3 retries) unless changed.
+ * Set it to nil to not retry requests by default.
+ */
+@property (class, nonatomic, copy, nullable) SFSDKRetryPolicy *defaultPolicy;
+
+/**
+ * Returns a policy that never retries.
+ */
++ (instancetype)noRetryPolicy;
+
+/**
+ * Returns whether the outcome of a request is a transient failure.
+ *
+ * @param response Response received, if any.
+ * @param error Network error, if any.
+ * @return YES for transient failures.
+ */
+- (BOOL)isTransientFailure:(nullable NSURLResponse *)response error:(nullable NSError *)error;
+
+/**
+ * Returns the delay before the next attempt of a request, or a negative value if the request should not be retried.
+ *
+ * @param request Request that failed.
+ * @param response Response received, if any.
+ * @param error Network error, if any.
+ * @param retryCount Number of retries already done for this request.
+ * @return Delay (in seconds) before the next attempt, or a negative value.
+ */
+- (NSTimeInterval)retryDelayForRequest:(SFRestRequest *)request response:(nullable NSURLResponse *)response error:(nullable NSError *)error retryCount:(NSUInteger)retryCount;
+
+/**
+ * Parses a `Retry-After` header value (delay in seconds or HTTP date).
+ *
+ * @param value Header value.
+ * @return Delay (in seconds), or a negative value if the header could not be parsed.
+ */
++ (NSTimeInterval)delayFromRetryAfter:(nullable NSString *)value;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,156 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKRetryPolicy.h"
+
+static NSUInteger const kSFRetryPolicyDefaultMaxRetries = 3;
+static NSTimeInterval const kSFRetryPolicyDefaultBaseDelay = 0.5;
+static NSTimeInterval const kSFRetryPolicyDefaultMaxDelay = 30.0;
+static NSTimeInterval const kSFRetryPolicyDefaultMaxRetryAfter = 120.0;
+static NSString * const kSFRetryPolicyRetryAfterHeader = @"Retry-After";
+
+static SFSDKRetryPolicy *defaultPolicy = nil;
+
+@implementation SFSDKRetryPolicy
+
++ (void)initialize {
+    if (self == [SFSDKRetryPolicy class]) {
+        defaultPolicy = [[SFSDKRetryPolicy alloc] init];
+    }
+}
+
++ (SFSDKRetryPolicy *)defaultPolicy {
+    @synchronized ([SFSDKRetryPolicy class]) {
+        return defaultPolicy;
+    }
+}
+
++ (void)setDefaultPolicy:(SFSDKRetryPolicy *)policy {
+    @synchronized ([SFSDKRetryPolicy class]) {
+        defaultPolicy = [policy copy];
+    }
+}
+
++ (instancetype)noRetryPolicy {
+    SFSDKRetryPolicy *policy = [[self alloc] init];
+    policy.maxRetries = 0;
+    return policy;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _maxRetries = kSFRetryPolicyDefaultMaxRetries;
+        _baseDelay = kSFRetryPolicyDefaultBaseDelay;
+        _maxDelay = kSFRetryPolicyDefaultMaxDelay;
+        _maxRetryAfter = kSFRetryPolicyDefaultMaxRetryAfter;
+        _jitter = YES;
+        _retryableStatusCodes = [NSSet setWithArray:@[@429, @500, @502, @503, @504]];
+        _retryableErrorCodes = [NSSet setWithArray:@[@(NSURLErrorTimedOut), @(NSURLErrorNetworkConnectionLost), @(NSURLErrorCannotConnectToHost)]];
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    SFSDKRetryPolicy *policy = [[[self class] allocWithZone:zone] init];
+    policy.maxRetries = self.maxRetries;
+    policy.baseDelay = self.baseDelay;
+    policy.maxDelay = self.maxDelay;
+    policy.maxRetryAfter = self.maxRetryAfter;
+    policy.jitter = self.jitter;
+    policy.retryableStatusCodes = self.retryableStatusCodes;
+    policy.retryableErrorCodes = self.retryableErrorCodes;
+    return policy;
+}
+
+#pragma mark - Retry decision
+
+- (BOOL)isTransientFailure:(NSURLResponse *)response error:(NSError *)error {
+    if (error) {
+        return [error.domain isEqualToString:NSURLErrorDomain] && [self.retryableErrorCodes containsObject:@(error.code)];
+    }
+    if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
+        return [self.retryableStatusCodes containsObject:@(((NSHTTPURLResponse *)response).statusCode)];
+    }
+    return NO;
+}
+
+- (NSTimeInterval)retryDelayForRequest:(SFRestRequest *)request response:(NSURLResponse *)response error:(NSError *)error retryCount:(NSUInteger)retryCount {
+    if (retryCount >= self.maxRetries || ![self isTransientFailure:response error:error]) {
+        return -1;
+    }
+    NSHTTPURLResponse *httpResponse = [response isKindOfClass:[NSHTTPURLResponse class]] ? (NSHTTPURLResponse *)response : nil;
+
+    // A POST may have been (partially) processed, unless the server turned it away
+    if (request.method == SFRestMethodPOST && !(httpResponse.statusCode == 429 || httpResponse.statusCode == 503)) {
+        return -1;
+    }
+
+    // Server knows best
+    NSTimeInterval retryAfter = [[self class] delayFromRetryAfter:[self valueForHeader:kSFRetryPolicyRetryAfterHeader response:httpResponse]];
+    if (retryAfter >= 0) {
+        return retryAfter <= self.maxRetryAfter ? retryAfter : -1;
+    }
+    NSTimeInterval delay = MIN(self.maxDelay, self.baseDelay * pow(2, retryCount));
+    if (self.jitter) {
+        delay = delay * arc4random_uniform(UINT32_MAX) / UINT32_MAX;
+    }
+    return delay;
+}
+
++ (NSTimeInterval)delayFromRetryAfter:(NSString *)value {
+    NSString *trimmedValue = [value stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    if (trimmedValue.length == 0) {
+        return -1;
+    }
+    NSScanner *scanner = [NSScanner scannerWithString:trimmedValue];
+    NSInteger seconds = 0;
+    if ([scanner scanInteger:&seconds] && scanner.isAtEnd) {
+        return MAX(0, seconds);
+    }
+    static NSDateFormatter *httpDateFormatter = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        httpDateFormatter = [[NSDateFormatter alloc] init];
+        httpDateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        httpDateFormatter.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"GMT"];
+        httpDateFormatter.dateFormat = @"EEE',' dd MMM yyyy HH':'mm':'ss zzz";
+    });
+    NSDate *date = nil;
+    @synchronized (httpDateFormatter) {
+        date = [httpDateFormatter dateFromString:trimmedValue];
+    }
+    return date ? MAX(0, [date timeIntervalSinceNow]) : -1;
+}
+
+- (NSString *)valueForHeader:(NSString *)header response:(NSHTTPURLResponse *)response {
+    for (NSString *name in response.allHeaderFields) {
+        if ([name caseInsensitiveCompare:header] == NSOrderedSame) {
+            return response.allHeaderFields[name];
+        }
+    }
+    return nil;
+}
+
+@end
@@ -35,6 +35,8 @@ extern uint32_t const SFCryptChunksCipherAlgorithm;
 extern size_t const SFCryptChunksCipherKeySize;
 // The cipher options used in the cipher algorithm used by SFCryptChunks.
 extern uint32_t const SFCryptChunksCipherOptions;
+// The default buffer size of SFEncryptStream and SFDecryptStream.
+extern size_t const SFCryptChunksDefaultStreamBufferSize;
 
 /**
  *  SFCryptChunksDelegate
@@ -53,9 +55,9 @@ extern uint32_t const SFCryptChunksCipherOptions;
 @end
 
 /**
- *  SFCryptChunks performs encryption / decryption in chunks, using a fixed size buffer in the stack.
- *  It does not allocate any memory to perform the encryption / decryption,
- *  the size of memory used (by SFCryptChunks) is O(1) regardless of the input / output data size.
+ *  SFCryptChunks performs encryption / decryption in chunks, using a fixed size buffer.
+ *  By default the buffer is in the stack and holds a single cipher block, larger chunks use a reusable heap buffer (see `chunkSize`).
+ *  Either way the size of memory used (by SFCryptChunks) is O(1) regardless of the input / output data size.
  *  
  *  Basic usage is:
  *      1. Create an instance giving it a key and setting a delegate to consume results;
@@ -90,17 +92,32 @@ extern uint32_t const SFCryptChunksCipherOptions;
  */
 @property (nonatomic, weak) id<SFCryptChunksDelegate> delegate;
 
+/**
+ *  The number of input bytes passed to the cipher at a time, rounded up to a multiple of `SFCryptChunksCipherBlockSize`.
+ *  The default, 0, crypts one cipher block at a time without allocating memory. Larger chunks allocate an aligned buffer
+ *  of `chunkSize` plus one cipher block once, and call the cipher and the delegate once per chunk, which is much faster
+ *  for large data. Set before passing data in.
+ */
+@property (nonatomic, assign) size_t chunkSize;
+
 /**
  *  A data buffer to be encrypted / decrypted. You may pass a buffer of any size here,
  *  the delegate will then be called with results as many times as needed:
  *      - the delegate may be called multiple times with chunk results; or
  *      - the delegate may not be called at all, if there isn't enough data to produce a result.
- *  This method utilizes a stack memory buffer the size of 2 cipher blocks.
+ *  This method utilizes a stack memory buffer the size of 2 cipher blocks, or the `chunkSize` buffer if set.
  *  @param buffer the buffer data to be encrypted or decrypted.
  *  @param len    the buffer size.
  */
 - (void)cryptBuffer:(const uint8_t *)buffer bufferLen:(size_t)len;
 
+/**
+ *  The error of the first cipher call that failed, nil while all of them succeeded. Its domain is `NSOSStatusErrorDomain`
+ *  and its code the `CCCryptorStatus`, e.g. `kCCDecodeError` when decrypting data encrypted with another key.
+ *  Once set, data passed in is ignored and the delegate is not called anymore.
+ */
+@property (nullable, nonatomic, strong, readonly) NSError *cryptError;
+
 /**
  *  Whether or not the crypt operation completed. 
  *  Once complete, this object must be disposed.
@@ -29,11 +29,14 @@ size_t const SFCryptChunksCipherBlockSize = kCCBlockSizeAES128;
 uint32_t const SFCryptChunksCipherAlgorithm = kCCAlgorithmAES;
 size_t const SFCryptChunksCipherKeySize = kCCKeySizeAES256;
 uint32_t const SFCryptChunksCipherOptions = kCCOptionPKCS7Padding;
+size_t const SFCryptChunksDefaultStreamBufferSize = 128 * 1024;
 
 @interface SFCryptChunks()
 
 @property (nonatomic, assign) CCCryptorRef cryptor;
 @property (nonatomic, assign, readwrite) BOOL cryptFinalized;
+@property (nonatomic, strong, readwrite) NSError *cryptError;
+@property (nonatomic, assign) uint8_t *chunkBuffer;
 
 @end
 
@@ -82,34 +85,53 @@ uint32_t const SFCryptChunksCipherOptions = kCCOptionPKCS7Padding;
 - (void)dealloc {
     CCCryptorRelease(_cryptor);
     _cryptor = NULL;
+    free(_chunkBuffer);
 }
 
 
 #pragma mark - Public
 
+- (void)setChunkSize:(size_t)chunkSize {
+    size_t alignedChunkSize = (chunkSize + SFCryptChunksCipherBlockSize - 1) / SFCryptChunksCipherBlockSize * SFCryptChunksCipherBlockSize;
+    if (alignedChunkSize != _chunkSize) {
+        _chunkSize = alignedChunkSize;
+        free(_chunkBuffer);
+        _chunkBuffer = NULL;
+    }
+}
+
 - (void)cryptBuffer:(const uint8_t *)buffer bufferLen:(size_t)len {
     /*
      From CommonCryptor.h: "For block ciphers, the output size will
      always be less than or equal to the input size plus the size
      of one block.", SFCryptChunks uses AES which is a block cipher algorithm.
      */
-    const size_t kMaxOutLen = SFCryptChunksCipherBlockSize * 2;
-    uint8_t outBuffer[kMaxOutLen];
-    const size_t kMaxInLen = kMaxOutLen - SFCryptChunksCipherBlockSize;
+    const size_t kMaxInLen = self.chunkSize > 0 ? self.chunkSize : SFCryptChunksCipherBlockSize;
+    const size_t kMaxOutLen = kMaxInLen + SFCryptChunksCipherBlockSize;
+    uint8_t stackBuffer[SFCryptChunksCipherBlockSize * 2];
+    uint8_t *outBuffer = stackBuffer;
+    if (self.chunkSize > 0) {
+        if (!_chunkBuffer && posix_memalign((void **)&_chunkBuffer, getpagesize(), kMaxOutLen) != 0) {
+            _chunkBuffer = NULL;
+        }
+        NSAssert(_chunkBuffer, @"SFCryptChunks - failed to allocate chunk buffer.");
+        outBuffer = _chunkBuffer;
+    }
     NSRange inBufferWindow;
     inBufferWindow.location = 0;
     inBufferWindow.length = MIN(kMaxInLen, len);
-    while (inBufferWindow.location < len) {
+    while (inBufferWindow.location < len && !self.cryptError) {
         const uint8_t *inBuffer = &(buffer[inBufferWindow.location]);
         size_t cryptedCount = 0;
-        __unused CCStatus result = CCCryptorUpdate(self.cryptor,
-                                          inBuffer,
-                                          inBufferWindow.length,
-                                          outBuffer,
-                                          kMaxOutLen,
-                                          &cryptedCount);
-        NSAssert(result == kCCSuccess, @"SFCryptChunks - error on CCCryptorUpdate call.");
-        if (cryptedCount > 0) {
+        CCCryptorStatus result = CCCryptorUpdate(self.cryptor,
+                                                 inBuffer,
+                                                 inBufferWindow.length,
+                                                 outBuffer,
+                                                 kMaxOutLen,
+                                                 &cryptedCount);
+        if (result != kCCSuccess) {
+            [self recordFailedCall:@"CCCryptorUpdate" status:result];
+        } else if (cryptedCount > 0) {
             [self.delegate cryptChunk:self chunkResult:outBuffer bufferLen:cryptedCount];
         }
         // Move window
@@ -123,15 +145,27 @@ uint32_t const SFCryptChunksCipherOptions = kCCOptionPKCS7Padding;
         self.cryptFinalized = YES;
         uint8_t outBuffer[SFCryptChunksCipherBlockSize]; // the max output size of CCCryptorFinal is 1 cipher block size.
         size_t cryptedCount = 0;
-        __unused CCStatus result = CCCryptorFinal(self.cryptor,
-                                         outBuffer,
-                                         SFCryptChunksCipherBlockSize,
-                                         &cryptedCount);
-        NSAssert(result == kCCSuccess, @"SFCryptChunks - error on CCCryptorFinal call.");
-        if (cryptedCount > 0) {
+        if (self.cryptError) {
+            return;
+        }
+        CCCryptorStatus result = CCCryptorFinal(self.cryptor,
+                                                outBuffer,
+                                                SFCryptChunksCipherBlockSize,
+                                                &cryptedCount);
+        if (result != kCCSuccess) {
+            [self recordFailedCall:@"CCCryptorFinal" status:result];
+        } else if (cryptedCount > 0) {
             [self.delegate cryptChunk:self chunkResult:outBuffer bufferLen:cryptedCount];
         }
     }
 }
 
+
+#pragma mark - Private
+
+- (void)recordFailedCall:(NSString *)call status:(CCCryptorStatus)status {
+    [SFSDKCoreLogger e:[self class] format:@"SFCryptChunks - error on %@ call, CCCryptorStatus: %i.", call, status];
+    self.cryptError = [NSError errorWithDomain:NSOSStatusErrorDomain code:status userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"%@ failed.", call]}];
+}
+
 @end
@@ -30,7 +30,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  * SFDecryptStream is an input stream that decrypts data right after it is read.
- * SFCryptChunks is used to perform the decryption.
+ * SFCryptChunks is used to perform the decryption. A failed decryption (e.g. with the wrong key, which usually
+ * only shows once the end of the data is reached) makes reads return -1 and is reported by `streamError`.
  */
 @interface SFDecryptStream : NSInputStream <SFCryptChunksDelegate>
 
@@ -47,6 +48,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)setupWithKey:(NSData *)key andInitializationVector:(nullable NSData *)iv;
 
+/**
+ *  Number of bytes read from the underlying stream and decrypted at a time, `SFCryptChunksDefaultStreamBufferSize` by default.
+ *  Decrypted bytes are kept in a reusable buffer and handed out by later reads, so small reads don't mean small decrypts.
+ *  Set before opening the stream.
+ */
+@property (nonatomic, assign) NSUInteger bufferSize;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -30,18 +30,22 @@
 @property (nonatomic, strong) SFCryptChunks *cryptChunks;
 @property (nonatomic, strong) NSInputStream *inStream;
 
-@property (nonatomic, assign) uint8_t *remainders;
-@property (nonatomic, assign) size_t remaindersLen;
+// Ciphertext read from the underlying stream
+@property (nonatomic, assign) uint8_t *inBuffer;
 
-@property (nonatomic, assign) uint8_t *readingBuffer;
-@property (nonatomic, assign) size_t readingBufferLen;
-@property (nonatomic, assign) size_t readingBufferFill;
+// Decrypted bytes not handed out yet
+@property (nonatomic, assign) uint8_t *outBuffer;
+@property (nonatomic, assign) size_t outBufferCapacity;
+@property (nonatomic, assign) size_t outBufferOffset;
+@property (nonatomic, assign) size_t outBufferLen;
 
 @end
 
 
 @implementation SFDecryptStream
 
+@synthesize bufferSize = _bufferSize;
+
 #pragma mark - Lifecycle
 
 /**
@@ -73,9 +77,23 @@
     return self;
 }
 
+- (void)dealloc {
+    free(_inBuffer);
+    free(_outBuffer);
+}
+
 
 #pragma mark - Public Methods
 
+- (NSUInteger)bufferSize {
+    return _bufferSize > 0 ? _bufferSize : SFCryptChunksDefaultStreamBufferSize;
+}
+
+- (void)setBufferSize:(NSUInteger)bufferSize {
+    NSAssert(!_inBuffer, @"SFDecryptStream - the buffer size must be set before opening the stream.");
+    _bufferSize = (bufferSize + SFCryptChunksCipherBlockSize - 1) / SFCryptChunksCipherBlockSize * SFCryptChunksCipherBlockSize;
+}
+
 - (void)setupWithDecryptionKey:(SFEncryptionKey *)decKey {
     NSAssert(!_cryptChunks, @"SFDecryptStream - setup is only allowed once.");
     if (!_cryptChunks) {
@@ -92,25 +110,19 @@
 
 #pragma mark - Private
 
-- (uint8_t *)remainders {
-    if (!_remainders) {
-        _remainders = malloc(sizeof(uint8_t) * SFCryptChunksCipherBlockSize);
-    }
-    return _remainders;
-}
-
-- (void)fillReadingBuffer:(uint8_t *)buffer bufferLen:(size_t)len {
-    size_t fillLen = MIN(self.readingBufferLen - self.readingBufferFill, len);
-    uint8_t *fillWindow = &(self.readingBuffer[self.readingBufferFill]);
-    memcpy(fillWindow, buffer, fillLen);
-    self.readingBufferFill += fillLen;
-    
-    // Left overs?
-    self.remaindersLen = len - fillLen;
-    if (self.remaindersLen > 0) {
-        NSAssert(self.remaindersLen < SFCryptChunksCipherBlockSize, @"SFDecryptStream - there should never be more remainders than the size of the cipher block!");
-        memcpy(self.remainders, &buffer[fillLen], self.remaindersLen);
+- (BOOL)allocateBuffers {
+    if (!_inBuffer) {
+        // Decrypting a full input buffer outputs at most one more cipher block, finalizing outputs at most one block.
+        _outBufferCapacity = self.bufferSize + SFCryptChunksCipherBlockSize;
+        if (posix_memalign((void **)&_inBuffer, getpagesize(), self.bufferSize) != 0) {
+            _inBuffer = NULL;
+        }
+        if (posix_memalign((void **)&_outBuffer, getpagesize(), _outBufferCapacity) != 0) {
+            _outBuffer = NULL;
+        }
+        self.cryptChunks.chunkSize = self.bufferSize;
     }
+    return _inBuffer && _outBuffer;
 }
 
 
@@ -118,7 +130,10 @@
 
 - (void)cryptChunk:(SFCryptChunks *)cryptChunks chunkResult:(uint8_t *)buffer bufferLen:(size_t)len {
     if (cryptChunks == self.cryptChunks) {
-        [self fillReadingBuffer:buffer bufferLen:len];
+        size_t fillOffset = self.outBufferOffset + self.outBufferLen;
+        NSAssert(fillOffset + len <= self.outBufferCapacity, @"SFDecryptStream - decrypted more than the output buffer holds!");
+        memcpy(&self.outBuffer[fillOffset], buffer, len);
+        self.outBufferLen += len;
     }
 }
 
@@ -126,29 +141,36 @@
 #pragma mark - NSInputStream
 
 - (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
-    self.readingBuffer = buffer;
-    self.readingBufferLen = len;
-    self.readingBufferFill = 0;
-    
-    // Consume remainders first
-    if (self.remaindersLen > 0) {
-        [self fillReadingBuffer:self.remainders bufferLen:self.remaindersLen];
-    }
-    // Consume new bytes
-    else {
-        NSInteger bytesRead = [self.inStream read:buffer maxLength:len];
+    // Decrypt the next input buffer once all decrypted bytes were read
+    if (self.outBufferLen == 0 && !self.cryptChunks.cryptFinalized) {
+        if (![self allocateBuffers]) {
+            [SFSDKCoreLogger e:[self class] format:@"SFDecryptStream - failed to allocate buffers."];
+            return -1;
+        }
+        self.outBufferOffset = 0;
+        NSInteger bytesRead = [self.inStream read:self.inBuffer maxLength:self.bufferSize];
         if (bytesRead > 0) {
-            [self.cryptChunks cryptBuffer:buffer bufferLen:bytesRead];
+            [self.cryptChunks cryptBuffer:self.inBuffer bufferLen:bytesRead];
         }
         else if (bytesRead == 0) {
             [self.cryptChunks finalizeCrypt];
         }
         else {
             [SFSDKCoreLogger d:[self class] format:@"SFDecryptStream - error on reading stream: %@.", self.streamError];
+            return -1;
         }
     }
-    
-    return self.readingBufferFill;
+
+    // Wrong key or corrupted data, nothing decrypted can be trusted
+    if (self.cryptChunks.cryptError) {
+        return -1;
+    }
+
+    size_t readLen = MIN(len, self.outBufferLen);
+    memcpy(buffer, &self.outBuffer[self.outBufferOffset], readLen);
+    self.outBufferOffset += readLen;
+    self.outBufferLen -= readLen;
+    return readLen;
 }
 
 - (BOOL)getBuffer:(uint8_t **)buffer length:(NSUInteger *)len {
@@ -156,7 +178,10 @@
 }
 
 - (BOOL)hasBytesAvailable {
-    return [self.inStream hasBytesAvailable] || ![self.cryptChunks cryptFinalized] || (self.remaindersLen > 0);
+    if (self.cryptChunks.cryptError) {
+        return NO;
+    }
+    return [self.inStream hasBytesAvailable] || ![self.cryptChunks cryptFinalized] || (self.outBufferLen > 0);
 }
 
 - (void)open {
@@ -193,6 +218,9 @@
 }
 
 - (NSStreamStatus)streamStatus {
+    if (self.cryptChunks.cryptError) {
+        return NSStreamStatusError;
+    }
     NSStreamStatus status = self.inStream.streamStatus;
     // Reading stream is at end, but still have bytes to available?
     if (status == NSStreamStatusAtEnd && [self hasBytesAvailable]) {
@@ -202,7 +230,7 @@
 }
 
 - (NSError *)streamError {
-    return self.inStream.streamError;
+    return self.cryptChunks.cryptError ?: self.inStream.streamError;
 }
 
 @end
@@ -47,6 +47,22 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)setupWithKey:(NSData *)key andInitializationVector:(nullable NSData *)iv;
 
+/**
+ *  Number of bytes encrypted and written out at a time, `SFCryptChunksDefaultStreamBufferSize` by default.
+ *  Writes are gathered in a reusable buffer of this size, so the cipher and the underlying stream see large chunks
+ *  however small the writes are. Data only reaches the underlying stream once a buffer fills up, or on close.
+ *  Set before opening the stream.
+ */
+@property (nonatomic, assign) NSUInteger bufferSize;
+
+/**
+ *  Whether to encrypt and write out on a background serial queue, NO by default.
+ *  Writes then only copy data into one of a few buffers, and encrypting a full buffer overlaps with filling the next one.
+ *  Writes wait while every buffer is queued. Errors of the underlying stream are reported by later writes and by `streamError`.
+ *  Set before opening the stream.
+ */
+@property (nonatomic, assign) BOOL encryptsInBackground;
+
 @end
 
 NS_ASSUME_NONNULL_END
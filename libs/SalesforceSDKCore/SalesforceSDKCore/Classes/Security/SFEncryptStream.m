@@ -24,17 +24,31 @@
 
 #import "SFEncryptStream.h"
 
+// Number of buffers when encrypting in background: one being filled, one being encrypted and one queued.
+static NSUInteger const kSFEncryptStreamPipelineDepth = 3;
 
 @interface SFEncryptStream()
 
 @property (nonatomic, strong) SFCryptChunks *cryptChunks;
 @property (nonatomic, strong) NSOutputStream *outStream;
 
+@property (nonatomic, assign) uint8_t *inBuffers;
+@property (nonatomic, assign) uint8_t *inBuffer;
+@property (nonatomic, assign) size_t inBufferFill;
+@property (nonatomic, assign) NSUInteger inBuffersTaken;
+
+@property (nonatomic, strong) dispatch_queue_t cryptQueue;
+@property (nonatomic, strong) dispatch_semaphore_t freeInBuffers;
+@property (atomic, strong) NSError *writeError;
+@property (nonatomic, assign) BOOL closed;
+
 @end
 
 
 @implementation SFEncryptStream
 
+@synthesize bufferSize = _bufferSize;
+
 #pragma mark - Lifecycle
 
 /**
@@ -74,9 +88,22 @@
     return self;
 }
 
+- (void)dealloc {
+    free(_inBuffers);
+}
+
 
 #pragma mark - Public Methods
 
+- (NSUInteger)bufferSize {
+    return _bufferSize > 0 ? _bufferSize : SFCryptChunksDefaultStreamBufferSize;
+}
+
+- (void)setBufferSize:(NSUInteger)bufferSize {
+    NSAssert(!_inBuffers, @"SFEncryptStream - the buffer size must be set before opening the stream.");
+    _bufferSize = (bufferSize + SFCryptChunksCipherBlockSize - 1) / SFCryptChunksCipherBlockSize * SFCryptChunksCipherBlockSize;
+}
+
 - (void)setupWithEncryptionKey:(SFEncryptionKey* )encKey {
     NSAssert(!_cryptChunks, @"SFEncryptStream - setup is only allowed once.");
     if (!_cryptChunks) {
@@ -91,11 +118,50 @@
 }
 
 
+#pragma mark - Private
+
+- (void)takeInBuffer {
+    if (self.cryptQueue) {
+        // Buffers are encrypted in order, so the oldest one is the next to be free.
+        dispatch_semaphore_wait(self.freeInBuffers, DISPATCH_TIME_FOREVER);
+    }
+    NSUInteger depth = self.cryptQueue ? kSFEncryptStreamPipelineDepth : 1;
+    self.inBuffer = &self.inBuffers[(self.inBuffersTaken++ % depth) * self.bufferSize];
+    self.inBufferFill = 0;
+}
+
+- (void)cryptInBuffer {
+    const uint8_t *buffer = self.inBuffer;
+    size_t len = self.inBufferFill;
+    self.inBuffer = NULL;
+    self.inBufferFill = 0;
+    if (self.cryptQueue) {
+        dispatch_async(self.cryptQueue, ^{
+            if (!self.writeError) {
+                [self.cryptChunks cryptBuffer:buffer bufferLen:len];
+            }
+            dispatch_semaphore_signal(self.freeInBuffers);
+        });
+    } else {
+        [self.cryptChunks cryptBuffer:buffer bufferLen:len];
+    }
+}
+
+
 #pragma mark - SFCryptChunks Delegate
 
 - (void)cryptChunk:(SFCryptChunks *)cryptChunks chunkResult:(uint8_t *)buffer bufferLen:(size_t)len {
-    if (cryptChunks == self.cryptChunks) {
-        [self.outStream write:buffer maxLength:len];
+    if (cryptChunks == self.cryptChunks && !self.writeError) {
+        size_t written = 0;
+        while (written < len) {
+            NSInteger count = [self.outStream write:&buffer[written] maxLength:len - written];
+            if (count <= 0) {
+                self.writeError = self.outStream.streamError ?: [NSError errorWithDomain:NSPOSIXErrorDomain code:EIO userInfo:nil];
+                [SFSDKCoreLogger d:[self class] format:@"SFEncryptStream - error on writing stream: %@.", self.writeError];
+                return;
+            }
+            written += count;
+        }
     }
 }
 
@@ -103,22 +169,69 @@
 #pragma mark - NSOutputStream
 
 - (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)len {
-    [self.cryptChunks cryptBuffer:buffer bufferLen:len];    
+    if (self.writeError || !self.inBuffers || self.closed) {
+        return -1;
+    }
+    const NSUInteger bufferSize = self.bufferSize;
+    NSUInteger consumed = 0;
+    while (consumed < len) {
+        // Whole buffers are encrypted in place when encrypting on the calling thread.
+        if (!self.cryptQueue && self.inBufferFill == 0 && len - consumed >= bufferSize) {
+            size_t directLen = (len - consumed) / bufferSize * bufferSize;
+            [self.cryptChunks cryptBuffer:&buffer[consumed] bufferLen:directLen];
+            consumed += directLen;
+            continue;
+        }
+        if (!self.inBuffer) {
+            [self takeInBuffer];
+        }
+        size_t fillLen = MIN(bufferSize - self.inBufferFill, len - consumed);
+        memcpy(&self.inBuffer[self.inBufferFill], &buffer[consumed], fillLen);
+        self.inBufferFill += fillLen;
+        consumed += fillLen;
+        if (self.inBufferFill == bufferSize) {
+            [self cryptInBuffer];
+        }
+    }
     // return full len, signalizing whole buffer was consumed.
     return len;
 }
 
 - (BOOL)hasSpaceAvailable {
-    return [self.outStream hasSpaceAvailable];
+    return !self.writeError && [self.outStream hasSpaceAvailable];
 }
 
 - (void)open {
     NSAssert(_cryptChunks, @"SFEncryptStream - you must setup first. Call -setupWithKey:andInitializationVector: before opening stream.");
+    if (!_inBuffers) {
+        NSUInteger depth = self.encryptsInBackground ? kSFEncryptStreamPipelineDepth : 1;
+        if (posix_memalign((void **)&_inBuffers, getpagesize(), depth * self.bufferSize) != 0) {
+            _inBuffers = NULL;
+        }
+        NSAssert(_inBuffers, @"SFEncryptStream - failed to allocate buffers.");
+        self.cryptChunks.chunkSize = self.bufferSize;
+        if (self.encryptsInBackground) {
+            self.cryptQueue = dispatch_queue_create("com.salesforce.mobilesdk.encryptStream", DISPATCH_QUEUE_SERIAL);
+            self.freeInBuffers = dispatch_semaphore_create(depth);
+        }
+    }
     [self.outStream open];
 }
 
 - (void)close {
-    [self.cryptChunks finalizeCrypt];
+    if (!self.closed) {
+        self.closed = YES;
+        if (self.inBufferFill > 0) {
+            [self cryptInBuffer];
+        }
+        if (self.cryptQueue) {
+            dispatch_sync(self.cryptQueue, ^{
+                [self.cryptChunks finalizeCrypt];
+            });
+        } else {
+            [self.cryptChunks finalizeCrypt];
+        }
+    }
     [self.outStream close];
 }
 
@@ -147,11 +260,11 @@
 }
 
 - (NSStreamStatus)streamStatus {
-    return self.outStream.streamStatus;
+    return self.writeError ? NSStreamStatusError : self.outStream.streamStatus;
 }
 
 - (NSError *)streamError {
-    return self.outStream.streamError;
+    return self.writeError ?: self.cryptChunks.cryptError ?: self.outStream.streamError;
 }
 
 @end
@@ -0,0 +1,107 @@
+/*
+ SFEncryptedBlobFormat+Internal.h
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFEncryptedBlobFormat.h"
+#import "SFEncryptionKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Layout of an encrypted blob, integers are little endian:
+   header : magic "SFEB" (4) | version (2) | flags (2) | block size (4) | reserved (4) | salt (16) | header MAC (32)
+   blocks : IV (16) | AES-256-CBC ciphertext of up to `block size` payload bytes, PKCS7 padded
+   index  : block count (8) | payload length (8) | block MACs (32 each) | index MAC (32)
+   footer : index offset (8) | magic "SFEI" (4) | reserved (4)
+ Every block but the last holds exactly `block size` payload bytes, so a block offset follows from its position.
+ The encryption and MAC keys are derived from the caller's key and the per-blob salt with HMAC-SHA256.
+ A block MAC covers the block position, IV and ciphertext. The index MAC covers the header MAC, the counts and every block MAC.
+ */
+extern size_t const SFEncryptedBlobHeaderLength;
+extern size_t const SFEncryptedBlobFooterLength;
+extern size_t const SFEncryptedBlobMACLength;
+
+@interface SFEncryptedBlobFormat ()
+
+@property (nonatomic, assign, readonly) NSUInteger blockSize;
+@property (nonatomic, copy, readonly) NSData *headerData;
+
+/**
+ * Format for a new blob, with a random salt.
+ */
+- (nullable instancetype)initForWritingWithKey:(SFEncryptionKey *)key blockSize:(NSUInteger)blockSize;
+
+/**
+ * Format of an existing blob, after authenticating its header.
+ */
+- (nullable instancetype)initWithHeaderData:(NSData *)headerData key:(SFEncryptionKey *)key error:(NSError **)error;
+
++ (NSError *)errorWithCode:(SFEncryptedBlobErrorCode)code description:(NSString *)description;
+
+- (uint64_t)blockCountForLength:(unsigned long long)length;
+- (size_t)storedLengthOfBlockWithLength:(size_t)length;
+- (unsigned long long)offsetOfBlockAtIndex:(uint64_t)index;
+
+/**
+ * Encrypts one block into `stored` (IV followed by ciphertext) and writes its MAC into `mac`.
+ */
+- (BOOL)encryptBlockAtIndex:(uint64_t)index
+                      bytes:(const uint8_t *)bytes
+                     length:(size_t)length
+                       into:(NSMutableData *)stored
+                        mac:(uint8_t *)mac;
+
+/**
+ * Authenticates one stored block against its MAC from the index, then decrypts it into `payload`.
+ */
+- (BOOL)decryptBlockAtIndex:(uint64_t)index
+                     stored:(const uint8_t *)stored
+                     length:(size_t)storedLength
+                expectedMAC:(const uint8_t *)mac
+                       into:(NSMutableData *)payload
+                      error:(NSError **)error;
+
+/**
+ * Index and footer closing a blob.
+ */
+- (NSData *)trailerDataWithBlockMACs:(NSData *)blockMACs payloadLength:(unsigned long long)length;
+
+/**
+ * Offset of the index, read from the footer at the end of a blob.
+ */
++ (BOOL)getIndexOffset:(unsigned long long *)indexOffset fromFooterData:(NSData *)footerData error:(NSError **)error;
+
+/**
+ * Authenticates the index found between `indexOffset` and the footer, and returns its block MACs.
+ */
+- (nullable NSData *)blockMACsFromIndexData:(NSData *)indexData
+                                indexOffset:(unsigned long long)indexOffset
+                              payloadLength:(unsigned long long *)length
+                                      error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
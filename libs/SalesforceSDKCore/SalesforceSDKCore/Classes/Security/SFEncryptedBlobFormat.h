@@ -0,0 +1,91 @@
+/*
+ SFEncryptedBlobFormat.h
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Error domain of errors reported by the encrypted blob readers and writers.
+ */
+extern NSString * const kSFEncryptedBlobErrorDomain;
+
+/**
+ * Error codes in `kSFEncryptedBlobErrorDomain`.
+ */
+typedef NS_ENUM(NSInteger, SFEncryptedBlobErrorCode) {
+    /** The data is not an encrypted blob, is truncated or uses an unsupported version. */
+    SFEncryptedBlobErrorInvalidFormat = 1,
+    /** The key is wrong or the data was tampered with. */
+    SFEncryptedBlobErrorAuthenticationFailed,
+    /** Reading or writing the underlying file or stream failed. */
+    SFEncryptedBlobErrorIO,
+    /** The cipher failed to encrypt or decrypt a block. */
+    SFEncryptedBlobErrorCryptFailed,
+    /** The requested range is past the end of the blob. */
+    SFEncryptedBlobErrorOutOfRange
+} NS_SWIFT_NAME(EncryptedBlobError);
+
+/**
+ * The default number of plaintext bytes per block (64 KB).
+ */
+extern NSUInteger const kSFEncryptedBlobDefaultBlockSize;
+
+/**
+ * The smallest and largest block sizes accepted by the writer. Block sizes must be a multiple of `SFCryptChunksCipherBlockSize`.
+ */
+extern NSUInteger const kSFEncryptedBlobMinBlockSize;
+extern NSUInteger const kSFEncryptedBlobMaxBlockSize;
+
+/**
+ * SFEncryptedBlobFormat describes the seekable encrypted container written by `SFEncryptedBlobWriter`.
+ *
+ * Unlike `SFEncryptStream`, which encrypts the whole payload as one CBC chain, the payload is cut into
+ * fixed-size blocks that are encrypted independently with their own random initialization vector, so any
+ * byte range can be decrypted by reading only the blocks it covers. A header authenticates the format
+ * parameters, and a block index at the end of the file authenticates every block, its position and the
+ * payload length, so tampered, reordered or truncated blocks are detected.
+ */
+@interface SFEncryptedBlobFormat : NSObject
+
+/**
+ * Whether the file at the given path starts with an encrypted blob header. The header is not authenticated.
+ * @param path The file path.
+ * @return YES if the file looks like an encrypted blob, NO for legacy `SFEncryptStream` files and other files.
+ */
++ (BOOL)isEncryptedBlobAtPath:(NSString *)path;
+
+/**
+ * Whether the data starts with an encrypted blob header. The header is not authenticated.
+ * @param data The data.
+ * @return YES if the data looks like an encrypted blob.
+ */
++ (BOOL)isEncryptedBlobData:(NSData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
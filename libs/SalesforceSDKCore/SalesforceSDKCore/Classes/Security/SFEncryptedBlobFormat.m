@@ -0,0 +1,314 @@
+/*
+ SFEncryptedBlobFormat.m
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFEncryptedBlobFormat+Internal.h"
+#import "SFCryptChunks.h"
+#import <CommonCrypto/CommonCrypto.h>
+#import <Security/Security.h>
+#import <libkern/OSByteOrder.h>
+
+NSString * const kSFEncryptedBlobErrorDomain = @"com.salesforce.mobilesdk.EncryptedBlobErrorDomain";
+
+NSUInteger const kSFEncryptedBlobDefaultBlockSize = 64 * 1024;
+NSUInteger const kSFEncryptedBlobMinBlockSize = 1024;
+NSUInteger const kSFEncryptedBlobMaxBlockSize = 16 * 1024 * 1024;
+
+size_t const SFEncryptedBlobHeaderLength = 64;
+size_t const SFEncryptedBlobFooterLength = 16;
+size_t const SFEncryptedBlobMACLength = CC_SHA256_DIGEST_LENGTH;
+
+static const uint8_t kSFEncryptedBlobHeaderMagic[4] = {'S', 'F', 'E', 'B'};
+static const uint8_t kSFEncryptedBlobFooterMagic[4] = {'S', 'F', 'E', 'I'};
+static const uint16_t kSFEncryptedBlobVersion = 1;
+static const size_t kSFEncryptedBlobSaltLength = 16;
+static const size_t kSFEncryptedBlobHeaderMACOffset = 32;
+
+@interface SFEncryptedBlobFormat ()
+
+@property (nonatomic, assign, readwrite) NSUInteger blockSize;
+@property (nonatomic, copy, readwrite) NSData *headerData;
+@property (nonatomic, copy) NSData *encryptionKey;
+@property (nonatomic, copy) NSData *macKey;
+
+@end
+
+@implementation SFEncryptedBlobFormat
+
+#pragma mark - Lifecycle
+
+- (instancetype)initForWritingWithKey:(SFEncryptionKey *)key blockSize:(NSUInteger)blockSize {
+    if (![[self class] isValidBlockSize:blockSize] || key.key.length == 0) {
+        [SFSDKCoreLogger e:[self class] format:@"SFEncryptedBlobFormat - invalid key or block size %lu.", (unsigned long)blockSize];
+        return nil;
+    }
+    if ((self = [super init])) {
+        uint8_t salt[kSFEncryptedBlobSaltLength];
+        if (SecRandomCopyBytes(kSecRandomDefault, sizeof(salt), salt) != errSecSuccess) {
+            [SFSDKCoreLogger e:[self class] format:@"SFEncryptedBlobFormat - failed to generate salt."];
+            return nil;
+        }
+        _blockSize = blockSize;
+        [self deriveKeysFromKey:key salt:salt];
+        NSMutableData *header = [NSMutableData dataWithLength:SFEncryptedBlobHeaderLength];
+        uint8_t *bytes = header.mutableBytes;
+        memcpy(bytes, kSFEncryptedBlobHeaderMagic, sizeof(kSFEncryptedBlobHeaderMagic));
+        OSWriteLittleInt16(bytes, 4, kSFEncryptedBlobVersion);
+        OSWriteLittleInt32(bytes, 8, (uint32_t)blockSize);
+        memcpy(&bytes[16], salt, kSFEncryptedBlobSaltLength);
+        [self mac:&bytes[kSFEncryptedBlobHeaderMACOffset] ofParts:(const void *[]){bytes} lengths:(size_t[]){kSFEncryptedBlobHeaderMACOffset} count:1];
+        _headerData = header;
+    }
+    return self;
+}
+
+- (instancetype)initWithHeaderData:(NSData *)headerData key:(SFEncryptionKey *)key error:(NSError **)error {
+    if (![[self class] isEncryptedBlobData:headerData] || headerData.length < SFEncryptedBlobHeaderLength) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Not an encrypted blob."];
+        return nil;
+    }
+    const uint8_t *bytes = headerData.bytes;
+    uint16_t version = OSReadLittleInt16(bytes, 4);
+    NSUInteger blockSize = OSReadLittleInt32(bytes, 8);
+    if (version != kSFEncryptedBlobVersion || ![[self class] isValidBlockSize:blockSize]) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorInvalidFormat description:[NSString stringWithFormat:@"Unsupported encrypted blob version %u or block size %lu.", version, (unsigned long)blockSize]];
+        return nil;
+    }
+    if (key.key.length == 0) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorAuthenticationFailed description:@"Missing encryption key."];
+        return nil;
+    }
+    if ((self = [super init])) {
+        _blockSize = blockSize;
+        [self deriveKeysFromKey:key salt:&bytes[16]];
+        uint8_t mac[CC_SHA256_DIGEST_LENGTH];
+        [self mac:mac ofParts:(const void *[]){bytes} lengths:(size_t[]){kSFEncryptedBlobHeaderMACOffset} count:1];
+        if (timingsafe_bcmp(mac, &bytes[kSFEncryptedBlobHeaderMACOffset], SFEncryptedBlobMACLength) != 0) {
+            if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorAuthenticationFailed description:@"Wrong key or tampered encrypted blob header."];
+            return nil;
+        }
+        _headerData = [headerData subdataWithRange:NSMakeRange(0, SFEncryptedBlobHeaderLength)];
+    }
+    return self;
+}
+
+#pragma mark - Public
+
++ (BOOL)isEncryptedBlobAtPath:(NSString *)path {
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForReadingAtPath:path];
+    NSData *magic = [fileHandle readDataOfLength:sizeof(kSFEncryptedBlobHeaderMagic)];
+    [fileHandle closeFile];
+    return [self isEncryptedBlobData:magic];
+}
+
++ (BOOL)isEncryptedBlobData:(NSData *)data {
+    return data.length >= sizeof(kSFEncryptedBlobHeaderMagic)
+        && memcmp(data.bytes, kSFEncryptedBlobHeaderMagic, sizeof(kSFEncryptedBlobHeaderMagic)) == 0;
+}
+
+#pragma mark - Internal
+
++ (NSError *)errorWithCode:(SFEncryptedBlobErrorCode)code description:(NSString *)description {
+    return [NSError errorWithDomain:kSFEncryptedBlobErrorDomain code:code userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+- (uint64_t)blockCountForLength:(unsigned long long)length {
+    return (length + self.blockSize - 1) / self.blockSize;
+}
+
+- (size_t)storedLengthOfBlockWithLength:(size_t)length {
+    // PKCS7 always pads, adding a full cipher block to block aligned payloads.
+    return SFCryptChunksCipherBlockSize + (length / SFCryptChunksCipherBlockSize + 1) * SFCryptChunksCipherBlockSize;
+}
+
+- (unsigned long long)offsetOfBlockAtIndex:(uint64_t)index {
+    return SFEncryptedBlobHeaderLength + index * [self storedLengthOfBlockWithLength:self.blockSize];
+}
+
+- (BOOL)encryptBlockAtIndex:(uint64_t)index
+                      bytes:(const uint8_t *)bytes
+                     length:(size_t)length
+                       into:(NSMutableData *)stored
+                        mac:(uint8_t *)mac {
+    NSAssert(length <= self.blockSize, @"SFEncryptedBlobFormat - block larger than the block size.");
+    size_t storedLength = [self storedLengthOfBlockWithLength:length];
+    stored.length = storedLength;
+    uint8_t *iv = stored.mutableBytes;
+    if (SecRandomCopyBytes(kSecRandomDefault, SFCryptChunksCipherBlockSize, iv) != errSecSuccess) {
+        [SFSDKCoreLogger e:[self class] format:@"SFEncryptedBlobFormat - failed to generate initialization vector."];
+        return NO;
+    }
+    size_t cryptedCount = 0;
+    CCCryptorStatus status = CCCrypt(kCCEncrypt, SFCryptChunksCipherAlgorithm, SFCryptChunksCipherOptions,
+                                     self.encryptionKey.bytes, SFCryptChunksCipherKeySize, iv,
+                                     bytes, length,
+                                     &iv[SFCryptChunksCipherBlockSize], storedLength - SFCryptChunksCipherBlockSize, &cryptedCount);
+    if (status != kCCSuccess || cryptedCount != storedLength - SFCryptChunksCipherBlockSize) {
+        [SFSDKCoreLogger e:[self class] format:@"SFEncryptedBlobFormat - failed to encrypt block %llu, CCCryptorStatus: %i.", index, status];
+        return NO;
+    }
+    [self mac:mac ofBlockAtIndex:index stored:iv length:storedLength];
+    return YES;
+}
+
+- (BOOL)decryptBlockAtIndex:(uint64_t)index
+                     stored:(const uint8_t *)stored
+                     length:(size_t)storedLength
+                expectedMAC:(const uint8_t *)expectedMAC
+                       into:(NSMutableData *)payload
+                      error:(NSError **)error {
+    uint8_t mac[CC_SHA256_DIGEST_LENGTH];
+    [self mac:mac ofBlockAtIndex:index stored:stored length:storedLength];
+    if (storedLength < 2 * SFCryptChunksCipherBlockSize || timingsafe_bcmp(mac, expectedMAC, SFEncryptedBlobMACLength) != 0) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorAuthenticationFailed description:[NSString stringWithFormat:@"Encrypted blob block %llu failed authentication.", index]];
+        return NO;
+    }
+    size_t cipherLength = storedLength - SFCryptChunksCipherBlockSize;
+    payload.length = cipherLength;
+    size_t cryptedCount = 0;
+    CCCryptorStatus status = CCCrypt(kCCDecrypt, SFCryptChunksCipherAlgorithm, SFCryptChunksCipherOptions,
+                                     self.encryptionKey.bytes, SFCryptChunksCipherKeySize, stored,
+                                     &stored[SFCryptChunksCipherBlockSize], cipherLength,
+                                     payload.mutableBytes, cipherLength, &cryptedCount);
+    if (status != kCCSuccess) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorCryptFailed description:[NSString stringWithFormat:@"Failed to decrypt encrypted blob block %llu, CCCryptorStatus: %i.", index, status]];
+        return NO;
+    }
+    payload.length = cryptedCount;
+    return YES;
+}
+
+- (NSData *)trailerDataWithBlockMACs:(NSData *)blockMACs payloadLength:(unsigned long long)length {
+    uint64_t blockCount = blockMACs.length / SFEncryptedBlobMACLength;
+    NSAssert(blockCount == [self blockCountForLength:length], @"SFEncryptedBlobFormat - block count does not match payload length.");
+    uint8_t counts[16];
+    OSWriteLittleInt64(counts, 0, blockCount);
+    OSWriteLittleInt64(counts, 8, length);
+    NSMutableData *trailer = [NSMutableData dataWithCapacity:sizeof(counts) + blockMACs.length + SFEncryptedBlobMACLength + SFEncryptedBlobFooterLength];
+    [trailer appendBytes:counts length:sizeof(counts)];
+    [trailer appendData:blockMACs];
+    uint8_t indexMAC[CC_SHA256_DIGEST_LENGTH];
+    [self mac:indexMAC ofIndexCounts:counts blockMACs:blockMACs];
+    [trailer appendBytes:indexMAC length:sizeof(indexMAC)];
+    uint8_t footer[SFEncryptedBlobFooterLength] = {0};
+    OSWriteLittleInt64(footer, 0, [self dataEndForLength:length]);
+    memcpy(&footer[8], kSFEncryptedBlobFooterMagic, sizeof(kSFEncryptedBlobFooterMagic));
+    [trailer appendBytes:footer length:sizeof(footer)];
+    return trailer;
+}
+
++ (BOOL)getIndexOffset:(unsigned long long *)indexOffset fromFooterData:(NSData *)footerData error:(NSError **)error {
+    if (footerData.length != SFEncryptedBlobFooterLength || memcmp(&((const uint8_t *)footerData.bytes)[8], kSFEncryptedBlobFooterMagic, sizeof(kSFEncryptedBlobFooterMagic)) != 0) {
+        if (error) *error = [self errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob is truncated or was not closed."];
+        return NO;
+    }
+    *indexOffset = OSReadLittleInt64(footerData.bytes, 0);
+    return YES;
+}
+
+- (NSData *)blockMACsFromIndexData:(NSData *)indexData
+                       indexOffset:(unsigned long long)indexOffset
+                     payloadLength:(unsigned long long *)length
+                             error:(NSError **)error {
+    const size_t countsLength = 16;
+    if (indexData.length < countsLength + SFEncryptedBlobMACLength) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob index is truncated."];
+        return nil;
+    }
+    const uint8_t *bytes = indexData.bytes;
+    uint64_t blockCount = OSReadLittleInt64(bytes, 0);
+    unsigned long long payloadLength = OSReadLittleInt64(bytes, 8);
+    size_t macsLength = indexData.length - countsLength - SFEncryptedBlobMACLength;
+    if (blockCount != macsLength / SFEncryptedBlobMACLength || macsLength % SFEncryptedBlobMACLength != 0) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob index is truncated."];
+        return nil;
+    }
+    NSData *blockMACs = [indexData subdataWithRange:NSMakeRange(countsLength, macsLength)];
+    uint8_t indexMAC[CC_SHA256_DIGEST_LENGTH];
+    [self mac:indexMAC ofIndexCounts:bytes blockMACs:blockMACs];
+    if (timingsafe_bcmp(indexMAC, &bytes[countsLength + macsLength], SFEncryptedBlobMACLength) != 0) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorAuthenticationFailed description:@"Encrypted blob index failed authentication."];
+        return nil;
+    }
+    // The MAC vouches for the counts, the layout must agree with them.
+    if (blockCount != [self blockCountForLength:payloadLength] || indexOffset != [self dataEndForLength:payloadLength]) {
+        if (error) *error = [[self class] errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob index does not match its blocks."];
+        return nil;
+    }
+    *length = payloadLength;
+    return blockMACs;
+}
+
+#pragma mark - Private
+
++ (BOOL)isValidBlockSize:(NSUInteger)blockSize {
+    return blockSize >= kSFEncryptedBlobMinBlockSize && blockSize <= kSFEncryptedBlobMaxBlockSize
+        && blockSize % SFCryptChunksCipherBlockSize == 0;
+}
+
+- (unsigned long long)dataEndForLength:(unsigned long long)length {
+    uint64_t blockCount = [self blockCountForLength:length];
+    if (blockCount == 0) {
+        return SFEncryptedBlobHeaderLength;
+    }
+    size_t lastBlockLength = (size_t)(length - (blockCount - 1) * self.blockSize);
+    return [self offsetOfBlockAtIndex:blockCount - 1] + [self storedLengthOfBlockWithLength:lastBlockLength];
+}
+
+- (void)deriveKeysFromKey:(SFEncryptionKey *)key salt:(const uint8_t *)salt {
+    uint8_t derived[CC_SHA256_DIGEST_LENGTH];
+    uint8_t label[kSFEncryptedBlobSaltLength + 1];
+    memcpy(label, salt, kSFEncryptedBlobSaltLength);
+    label[kSFEncryptedBlobSaltLength] = 1;
+    CCHmac(kCCHmacAlgSHA256, key.key.bytes, key.key.length, label, sizeof(label), derived);
+    _encryptionKey = [NSData dataWithBytes:derived length:SFCryptChunksCipherKeySize];
+    label[kSFEncryptedBlobSaltLength] = 2;
+    CCHmac(kCCHmacAlgSHA256, key.key.bytes, key.key.length, label, sizeof(label), derived);
+    _macKey = [NSData dataWithBytes:derived length:sizeof(derived)];
+    memset_s(derived, sizeof(derived), 0, sizeof(derived));
+}
+
+- (void)mac:(uint8_t *)mac ofParts:(const void * const *)parts lengths:(const size_t *)lengths count:(NSUInteger)count {
+    CCHmacContext context;
+    CCHmacInit(&context, kCCHmacAlgSHA256, self.macKey.bytes, self.macKey.length);
+    for (NSUInteger i = 0; i < count; i++) {
+        CCHmacUpdate(&context, parts[i], lengths[i]);
+    }
+    CCHmacFinal(&context, mac);
+}
+
+- (void)mac:(uint8_t *)mac ofBlockAtIndex:(uint64_t)index stored:(const uint8_t *)stored length:(size_t)storedLength {
+    uint8_t position[8];
+    OSWriteLittleInt64(position, 0, index);
+    [self mac:mac ofParts:(const void *[]){position, stored} lengths:(size_t[]){sizeof(position), storedLength} count:2];
+}
+
+- (void)mac:(uint8_t *)mac ofIndexCounts:(const uint8_t *)counts blockMACs:(NSData *)blockMACs {
+    const uint8_t *headerMAC = &((const uint8_t *)self.headerData.bytes)[kSFEncryptedBlobHeaderMACOffset];
+    [self mac:mac ofParts:(const void *[]){headerMAC, counts, blockMACs.bytes} lengths:(size_t[]){SFEncryptedBlobMACLength, 16, blockMACs.length} count:3];
+}
+
+@end
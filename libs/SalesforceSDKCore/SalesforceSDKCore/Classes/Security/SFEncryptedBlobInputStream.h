@@ -0,0 +1,53 @@
+/*
+ SFEncryptedBlobInputStream.h
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFEncryptedBlobReader.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * SFEncryptedBlobInputStream is an input stream that decrypts an encrypted blob written by `SFEncryptedBlobWriter`.
+ * The stream is seekable: setting `NSStreamFileCurrentOffsetKey` moves to any payload offset without decrypting the
+ * blocks before it, which allows resuming uploads and serving ranged reads.
+ */
+@interface SFEncryptedBlobInputStream : NSInputStream
+
+/**
+ *  Setup for decryption. You must call this method before opening the stream.
+ *  @param decKey the key the blob was written with
+ */
+- (void)setupWithDecryptionKey:(SFEncryptionKey *)decKey;
+
+/**
+ * The reader used by the stream, available once the stream is open.
+ */
+@property (nonatomic, strong, readonly, nullable) SFEncryptedBlobReader *reader;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,185 @@
+/*
+ SFEncryptedBlobInputStream.m
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFEncryptedBlobInputStream.h"
+
+@interface SFEncryptedBlobInputStream()
+
+@property (nonatomic, copy, nullable) NSString *path;
+@property (nonatomic, copy, nullable) NSData *data;
+@property (nonatomic, strong, nullable) SFEncryptionKey *key;
+@property (nonatomic, strong, readwrite, nullable) SFEncryptedBlobReader *reader;
+@property (nonatomic, assign) unsigned long long offset;
+@property (nonatomic, assign) NSStreamStatus status;
+@property (nonatomic, strong, nullable) NSError *error;
+@property (nonatomic, weak, nullable) id<NSStreamDelegate> streamDelegate;
+
+@end
+
+
+@implementation SFEncryptedBlobInputStream
+
+#pragma mark - Lifecycle
+
+/**
+ Same as SFDecryptStream, only init is called on NSObject since this class does not use any functionality of NSInputStream.
+ */
+#pragma clang diagnostic ignored "-Wobjc-designated-initializers"
+
+- (instancetype)initWithData:(NSData *)data {
+    self = [super init];
+    if (self) {
+        _data = [data copy];
+    }
+    return self;
+}
+
+- (nullable instancetype)initWithURL:(NSURL *)url {
+    if (!url.isFileURL) {
+        return nil;
+    }
+    return [self initWithFileAtPath:url.path];
+}
+
+- (nullable instancetype)initWithFileAtPath:(NSString *)path {
+    self = [super init];
+    if (self){
+        _path = [path copy];
+    }
+    return self;
+}
+
+
+#pragma mark - Public Methods
+
+- (void)setupWithDecryptionKey:(SFEncryptionKey *)decKey {
+    NSAssert(!_key, @"SFEncryptedBlobInputStream - setup is only allowed once.");
+    if (!_key) {
+        _key = decKey;
+    }
+}
+
+
+#pragma mark - NSInputStream
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    if (self.status != NSStreamStatusOpen) {
+        return self.status == NSStreamStatusAtEnd ? 0 : -1;
+    }
+    NSError *error = nil;
+    NSInteger bytesRead = [self.reader readBytes:buffer maxLength:len atOffset:self.offset error:&error];
+    if (bytesRead < 0) {
+        self.error = error;
+        self.status = NSStreamStatusError;
+        [SFSDKCoreLogger d:[self class] format:@"SFEncryptedBlobInputStream - error on reading stream: %@.", error];
+        return -1;
+    }
+    self.offset += bytesRead;
+    if (self.offset >= self.reader.length) {
+        self.status = NSStreamStatusAtEnd;
+    }
+    return bytesRead;
+}
+
+- (BOOL)getBuffer:(uint8_t **)buffer length:(NSUInteger *)len {
+    return NO;
+}
+
+- (BOOL)hasBytesAvailable {
+    return self.status == NSStreamStatusOpen;
+}
+
+- (void)open {
+    NSAssert(_key, @"SFEncryptedBlobInputStream - you must setup first. Call -setupWithDecryptionKey: before opening stream.");
+    if (self.status != NSStreamStatusNotOpen) {
+        return;
+    }
+    NSError *error = nil;
+    if (self.path) {
+        self.reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:self.path key:self.key error:&error];
+    } else {
+        self.reader = [[SFEncryptedBlobReader alloc] initWithData:self.data key:self.key error:&error];
+    }
+    if (!self.reader) {
+        self.error = error;
+        self.status = NSStreamStatusError;
+        [SFSDKCoreLogger d:[self class] format:@"SFEncryptedBlobInputStream - failed to open stream: %@.", error];
+        return;
+    }
+    self.status = self.reader.length > 0 ? NSStreamStatusOpen : NSStreamStatusAtEnd;
+}
+
+- (void)close {
+    [self.reader close];
+    self.status = NSStreamStatusClosed;
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate {
+    self.streamDelegate = delegate;
+}
+
+- (id<NSStreamDelegate>)delegate {
+    return self.streamDelegate;
+}
+
+- (id)propertyForKey:(NSString *)key {
+    if ([key isEqualToString:NSStreamFileCurrentOffsetKey]) {
+        return @(self.offset);
+    }
+    return nil;
+}
+
+- (BOOL)setProperty:(id)property forKey:(NSString *)key {
+    if (![key isEqualToString:NSStreamFileCurrentOffsetKey] || ![property isKindOfClass:[NSNumber class]]) {
+        return NO;
+    }
+    unsigned long long offset = [property unsignedLongLongValue];
+    if (!self.reader || offset > self.reader.length
+        || (self.status != NSStreamStatusOpen && self.status != NSStreamStatusAtEnd)) {
+        return NO;
+    }
+    self.offset = offset;
+    self.status = offset < self.reader.length ? NSStreamStatusOpen : NSStreamStatusAtEnd;
+    return YES;
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)aRunLoop forMode:(NSString *)mode {
+    // Reads are synchronous, like file streams there is nothing to schedule.
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)aRunLoop forMode:(NSString *)mode {
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.status;
+}
+
+- (NSError *)streamError {
+    return self.error;
+}
+
+@end
@@ -0,0 +1,125 @@
+/*
+ SFEncryptedBlobReader.h
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFEncryptedBlobFormat.h"
+#import "SFEncryptionKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * SFEncryptedBlobReader gives random access to the payload of an encrypted blob written by `SFEncryptedBlobWriter`.
+ * Reading a range only reads and decrypts the blocks it covers, and every block is authenticated before it is decrypted.
+ * The most recently decrypted block is kept, so sequential small reads decrypt each block once.
+ * Instances are safe to use from multiple threads.
+ */
+@interface SFEncryptedBlobReader : NSObject
+
+/**
+ * Opens an encrypted blob file, authenticating its header and block index.
+ * @param path  the file path
+ * @param key   the encryption key the blob was written with
+ * @param error set if the file is not a complete encrypted blob, or the key is wrong
+ * @return the reader, or nil on error
+ */
+- (nullable instancetype)initWithFileAtPath:(NSString *)path key:(SFEncryptionKey *)key error:(NSError **)error;
+
+/**
+ * Opens an encrypted blob held in memory, authenticating its header and block index.
+ * @param data  the encrypted blob
+ * @param key   the encryption key the blob was written with
+ * @param error set if the data is not a complete encrypted blob, or the key is wrong
+ * @return the reader, or nil on error
+ */
+- (nullable instancetype)initWithData:(NSData *)data key:(SFEncryptionKey *)key error:(NSError **)error;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * Length of the decrypted payload.
+ */
+@property (nonatomic, assign, readonly) unsigned long long length;
+
+/**
+ * Number of payload bytes per block.
+ */
+@property (nonatomic, assign, readonly) NSUInteger blockSize;
+
+/**
+ * Reads and decrypts a range of the payload.
+ * @param range the payload range, which must lie within `length`
+ * @param error set if the range is out of bounds, a block fails authentication or reading fails
+ * @return the decrypted bytes, or nil on error
+ */
+- (nullable NSData *)readDataInRange:(NSRange)range error:(NSError **)error;
+
+/**
+ * Reads and decrypts up to `len` payload bytes starting at `offset`.
+ * @param buffer the destination buffer
+ * @param len    the buffer size
+ * @param offset the payload offset
+ * @param error  set if a block fails authentication or reading fails
+ * @return the number of bytes read, 0 at the end of the payload, or -1 on error
+ */
+- (NSInteger)readBytes:(uint8_t *)buffer maxLength:(NSUInteger)len atOffset:(unsigned long long)offset error:(NSError **)error;
+
+/**
+ * Closes the underlying file. Reads fail afterwards.
+ */
+- (void)close;
+
+/**
+ * Opens a file written either as an encrypted blob or in the legacy `SFEncryptStream` format.
+ * Use this while files are migrated: encrypted blobs are read with `SFEncryptedBlobInputStream`,
+ * other files with `SFDecryptStream`. The stream is set up but not opened.
+ * @param path      the file path
+ * @param key       the encryption key of encrypted blobs
+ * @param legacyKey the key and initialization vector of legacy files, `key` if nil
+ * @return the input stream
+ */
++ (nullable NSInputStream *)inputStreamForFileAtPath:(NSString *)path
+                                                 key:(SFEncryptionKey *)key
+                                           legacyKey:(nullable SFEncryptionKey *)legacyKey;
+
+/**
+ * Rewrites a legacy `SFEncryptStream` file as an encrypted blob, in place.
+ * The new file is written next to the old one and then replaces it, so a failed migration leaves the old file untouched.
+ * Files that already are encrypted blobs are left as is.
+ * @param path      the file path
+ * @param legacyKey the key and initialization vector the legacy file was written with
+ * @param key       the encryption key for the encrypted blob
+ * @param error     set if the migration failed
+ * @return YES if the file is an encrypted blob when this method returns
+ */
++ (BOOL)migrateLegacyFileAtPath:(NSString *)path
+                      legacyKey:(SFEncryptionKey *)legacyKey
+                            key:(SFEncryptionKey *)key
+                          error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
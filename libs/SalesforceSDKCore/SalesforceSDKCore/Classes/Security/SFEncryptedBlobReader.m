@@ -0,0 +1,305 @@
+/*
+ SFEncryptedBlobReader.m
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFEncryptedBlobReader.h"
+#import "SFEncryptedBlobFormat+Internal.h"
+#import "SFEncryptedBlobInputStream.h"
+#import "SFEncryptedBlobWriter.h"
+#import "SFDecryptStream.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static NSUInteger const kSFEncryptedBlobMigrationBufferSize = 64 * 1024;
+
+@interface SFEncryptedBlobReader ()
+
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, strong, nullable) NSData *data;
+@property (nonatomic, strong) SFEncryptedBlobFormat *format;
+@property (nonatomic, copy) NSData *blockMACs;
+@property (nonatomic, assign, readwrite) unsigned long long length;
+
+// Last decrypted block, guarded by @synchronized(self)
+@property (nonatomic, strong) NSMutableData *storedBlock;
+@property (nonatomic, strong) NSMutableData *cachedBlock;
+@property (nonatomic, assign) uint64_t cachedBlockIndex;
+
+@end
+
+@implementation SFEncryptedBlobReader
+
+#pragma mark - Lifecycle
+
+- (instancetype)initWithFileAtPath:(NSString *)path key:(SFEncryptionKey *)key error:(NSError **)error {
+    int fileDescriptor = open(path.fileSystemRepresentation, O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        if (error) *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+        return nil;
+    }
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        if (error) *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+        close(fileDescriptor);
+        return nil;
+    }
+    return [self initWithFileDescriptor:fileDescriptor data:nil rawLength:fileStat.st_size key:key error:error];
+}
+
+- (instancetype)initWithData:(NSData *)data key:(SFEncryptionKey *)key error:(NSError **)error {
+    return [self initWithFileDescriptor:-1 data:[data copy] rawLength:data.length key:key error:error];
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor
+                                  data:(NSData *)data
+                             rawLength:(unsigned long long)rawLength
+                                   key:(SFEncryptionKey *)key
+                                 error:(NSError **)error {
+    if ((self = [super init])) {
+        _fileDescriptor = fileDescriptor;
+        _data = data;
+        _cachedBlockIndex = UINT64_MAX;
+        if (![self openWithRawLength:rawLength key:key error:error]) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+    }
+}
+
+- (BOOL)openWithRawLength:(unsigned long long)rawLength key:(SFEncryptionKey *)key error:(NSError **)error {
+    if (rawLength < SFEncryptedBlobHeaderLength + SFEncryptedBlobFooterLength) {
+        if (error) *error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob is truncated."];
+        return NO;
+    }
+    NSMutableData *header = [NSMutableData dataWithLength:SFEncryptedBlobHeaderLength];
+    if (![self readRawBytes:header.mutableBytes length:header.length atOffset:0 error:error]) {
+        return NO;
+    }
+    self.format = [[SFEncryptedBlobFormat alloc] initWithHeaderData:header key:key error:error];
+    if (!self.format) {
+        return NO;
+    }
+    unsigned long long footerOffset = rawLength - SFEncryptedBlobFooterLength;
+    NSMutableData *footer = [NSMutableData dataWithLength:SFEncryptedBlobFooterLength];
+    unsigned long long indexOffset = 0;
+    if (![self readRawBytes:footer.mutableBytes length:footer.length atOffset:footerOffset error:error]
+        || ![SFEncryptedBlobFormat getIndexOffset:&indexOffset fromFooterData:footer error:error]) {
+        return NO;
+    }
+    if (indexOffset < SFEncryptedBlobHeaderLength || indexOffset > footerOffset) {
+        if (error) *error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob index offset is out of bounds."];
+        return NO;
+    }
+    NSMutableData *index = [NSMutableData dataWithLength:(NSUInteger)(footerOffset - indexOffset)];
+    unsigned long long length = 0;
+    if (![self readRawBytes:index.mutableBytes length:index.length atOffset:indexOffset error:error]) {
+        return NO;
+    }
+    self.blockMACs = [self.format blockMACsFromIndexData:index indexOffset:indexOffset payloadLength:&length error:error];
+    if (!self.blockMACs) {
+        return NO;
+    }
+    self.length = length;
+    self.storedBlock = [NSMutableData dataWithCapacity:[self.format storedLengthOfBlockWithLength:self.format.blockSize]];
+    self.cachedBlock = [NSMutableData dataWithCapacity:[self.format storedLengthOfBlockWithLength:self.format.blockSize]];
+    return YES;
+}
+
+#pragma mark - Public
+
+- (NSUInteger)blockSize {
+    return self.format.blockSize;
+}
+
+- (NSData *)readDataInRange:(NSRange)range error:(NSError **)error {
+    if (NSMaxRange(range) > self.length || NSMaxRange(range) < range.location) {
+        if (error) *error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorOutOfRange description:[NSString stringWithFormat:@"Range %@ is past the end of the %llu bytes payload.", NSStringFromRange(range), self.length]];
+        return nil;
+    }
+    NSMutableData *result = [NSMutableData dataWithLength:range.length];
+    NSUInteger filled = 0;
+    while (filled < range.length) {
+        NSInteger count = [self readBytes:&((uint8_t *)result.mutableBytes)[filled] maxLength:range.length - filled atOffset:range.location + filled error:error];
+        if (count <= 0) {
+            return nil;
+        }
+        filled += count;
+    }
+    return result;
+}
+
+- (NSInteger)readBytes:(uint8_t *)buffer maxLength:(NSUInteger)len atOffset:(unsigned long long)offset error:(NSError **)error {
+    if (offset >= self.length || len == 0) {
+        return 0;
+    }
+    unsigned long long end = MIN(offset + len, self.length);
+    NSUInteger blockSize = self.format.blockSize;
+    NSUInteger filled = 0;
+    @synchronized (self) {
+        while (offset < end) {
+            uint64_t blockIndex = offset / blockSize;
+            if (![self decryptBlockAtIndex:blockIndex error:error]) {
+                return -1;
+            }
+            size_t blockOffset = (size_t)(offset - blockIndex * blockSize);
+            size_t count = (size_t)MIN(self.cachedBlock.length - blockOffset, end - offset);
+            memcpy(&buffer[filled], &((const uint8_t *)self.cachedBlock.bytes)[blockOffset], count);
+            filled += count;
+            offset += count;
+        }
+    }
+    return filled;
+}
+
+- (void)close {
+    @synchronized (self) {
+        if (self.fileDescriptor >= 0) {
+            close(self.fileDescriptor);
+            self.fileDescriptor = -1;
+        }
+        self.data = nil;
+        self.cachedBlockIndex = UINT64_MAX;
+    }
+}
+
+#pragma mark - Legacy format
+
++ (NSInputStream *)inputStreamForFileAtPath:(NSString *)path key:(SFEncryptionKey *)key legacyKey:(SFEncryptionKey *)legacyKey {
+    if ([SFEncryptedBlobFormat isEncryptedBlobAtPath:path]) {
+        SFEncryptedBlobInputStream *stream = [[SFEncryptedBlobInputStream alloc] initWithFileAtPath:path];
+        [stream setupWithDecryptionKey:key];
+        return stream;
+    }
+    SFDecryptStream *stream = [[SFDecryptStream alloc] initWithFileAtPath:path];
+    [stream setupWithDecryptionKey:legacyKey ?: key];
+    return stream;
+}
+
++ (BOOL)migrateLegacyFileAtPath:(NSString *)path legacyKey:(SFEncryptionKey *)legacyKey key:(SFEncryptionKey *)key error:(NSError **)error {
+    if ([SFEncryptedBlobFormat isEncryptedBlobAtPath:path]) {
+        return YES;
+    }
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (![fileManager fileExistsAtPath:path]) {
+        if (error) *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileNoSuchFileError userInfo:@{NSFilePathErrorKey: path}];
+        return NO;
+    }
+    NSString *migratedPath = [path stringByAppendingPathExtension:@"migrating"];
+    SFDecryptStream *inStream = [[SFDecryptStream alloc] initWithFileAtPath:path];
+    [inStream setupWithDecryptionKey:legacyKey];
+    SFEncryptedBlobWriter *outStream = [[SFEncryptedBlobWriter alloc] initToFileAtPath:migratedPath append:NO];
+    [outStream setupWithEncryptionKey:key];
+    [inStream open];
+    [outStream open];
+    NSMutableData *buffer = [NSMutableData dataWithLength:kSFEncryptedBlobMigrationBufferSize];
+    NSError *migrationError = nil;
+    while (!migrationError && [inStream hasBytesAvailable]) {
+        NSInteger count = [inStream read:buffer.mutableBytes maxLength:buffer.length];
+        if (count < 0) {
+            migrationError = inStream.streamError ?: [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorIO description:@"Failed to read legacy encrypted file."];
+        } else if (count > 0 && [outStream write:buffer.bytes maxLength:count] < 0) {
+            migrationError = outStream.streamError;
+        }
+    }
+    [inStream close];
+    [outStream close];
+
+    // A wrong legacy key only shows when finalizing, the file must then stay as it is
+    migrationError = migrationError ?: inStream.streamError ?: outStream.streamError;
+    if (!migrationError) {
+        [fileManager replaceItemAtURL:[NSURL fileURLWithPath:path] withItemAtURL:[NSURL fileURLWithPath:migratedPath] backupItemName:nil options:0 resultingItemURL:nil error:&migrationError];
+    }
+    if (migrationError) {
+        [SFSDKCoreLogger e:[self class] format:@"Failed to migrate legacy encrypted file %@: %@", path.lastPathComponent, migrationError];
+        [fileManager removeItemAtPath:migratedPath error:nil];
+        if (error) *error = migrationError;
+        return NO;
+    }
+    return YES;
+}
+
+#pragma mark - Private
+
+- (BOOL)decryptBlockAtIndex:(uint64_t)blockIndex error:(NSError **)error {
+    if (blockIndex == self.cachedBlockIndex) {
+        return YES;
+    }
+    NSUInteger blockSize = self.format.blockSize;
+    size_t payloadLength = (size_t)MIN((unsigned long long)blockSize, self.length - blockIndex * blockSize);
+    self.storedBlock.length = [self.format storedLengthOfBlockWithLength:payloadLength];
+    if (![self readRawBytes:self.storedBlock.mutableBytes length:self.storedBlock.length atOffset:[self.format offsetOfBlockAtIndex:blockIndex] error:error]) {
+        return NO;
+    }
+    self.cachedBlockIndex = UINT64_MAX;
+    const uint8_t *mac = &((const uint8_t *)self.blockMACs.bytes)[blockIndex * SFEncryptedBlobMACLength];
+    if (![self.format decryptBlockAtIndex:blockIndex stored:self.storedBlock.bytes length:self.storedBlock.length expectedMAC:mac into:self.cachedBlock error:error]) {
+        return NO;
+    }
+    if (self.cachedBlock.length != payloadLength) {
+        if (error) *error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorInvalidFormat description:[NSString stringWithFormat:@"Encrypted blob block %llu has the wrong length.", blockIndex]];
+        return NO;
+    }
+    self.cachedBlockIndex = blockIndex;
+    return YES;
+}
+
+- (BOOL)readRawBytes:(uint8_t *)bytes length:(size_t)length atOffset:(unsigned long long)offset error:(NSError **)error {
+    if (self.data) {
+        if (offset + length > self.data.length) {
+            if (error) *error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob is truncated."];
+            return NO;
+        }
+        memcpy(bytes, &((const uint8_t *)self.data.bytes)[offset], length);
+        return YES;
+    }
+    if (self.fileDescriptor < 0) {
+        if (error) *error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorIO description:@"Encrypted blob reader is closed."];
+        return NO;
+    }
+    size_t done = 0;
+    while (done < length) {
+        ssize_t count = pread(self.fileDescriptor, &bytes[done], length - done, (off_t)(offset + done));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            if (error) *error = count == 0 ? [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorInvalidFormat description:@"Encrypted blob is truncated."]
+                                           : [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorIO description:[NSString stringWithFormat:@"Failed to read encrypted blob (errno = %d).", errno]];
+            return NO;
+        }
+        done += count;
+    }
+    return YES;
+}
+
+@end
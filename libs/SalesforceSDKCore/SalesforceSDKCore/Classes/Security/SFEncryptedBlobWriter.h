@@ -0,0 +1,75 @@
+/*
+ SFEncryptedBlobWriter.h
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "SFEncryptedBlobFormat.h"
+#import "SFEncryptionKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * SFEncryptedBlobWriter is an output stream that writes its data as an encrypted blob (see `SFEncryptedBlobFormat`),
+ * which `SFEncryptedBlobReader` and `SFEncryptedBlobInputStream` can then read from any offset.
+ * Data is buffered until a block is full, so memory use is one block regardless of the payload size.
+ * The blob is only complete, and readable, once the stream is closed. Appending to an existing blob is not supported.
+ */
+@interface SFEncryptedBlobWriter : NSOutputStream
+
+/**
+ * Setup for encryption with the default block size. You must call this method before using the stream.
+ * Only the key component is used, every block gets its own random initialization vector.
+ * @param encKey the encryption key
+ */
+- (void)setupWithEncryptionKey:(SFEncryptionKey *)encKey;
+
+/**
+ * Setup for encryption. You must call this method before using the stream.
+ * @param encKey    the encryption key
+ * @param blockSize the number of payload bytes per block, a multiple of `SFCryptChunksCipherBlockSize`
+ *                  between `kSFEncryptedBlobMinBlockSize` and `kSFEncryptedBlobMaxBlockSize`.
+ *                  Smaller blocks make small ranged reads cheaper, larger blocks lower the size overhead.
+ */
+- (void)setupWithEncryptionKey:(SFEncryptionKey *)encKey blockSize:(NSUInteger)blockSize;
+
+/**
+ * Number of payload bytes written so far.
+ */
+@property (nonatomic, assign, readonly) unsigned long long payloadLength;
+
+/**
+ * Writes data as an encrypted blob file, replacing any existing file.
+ * @param data  the payload
+ * @param path  the file path
+ * @param key   the encryption key
+ * @param error set if the file could not be written
+ * @return YES on success
+ */
++ (BOOL)writeData:(NSData *)data toFileAtPath:(NSString *)path key:(SFEncryptionKey *)key error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
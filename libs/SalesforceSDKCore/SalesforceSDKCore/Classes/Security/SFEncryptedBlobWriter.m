@@ -0,0 +1,237 @@
+/*
+ SFEncryptedBlobWriter.m
+ SalesforceSDKCore
+ 
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFEncryptedBlobWriter.h"
+#import "SFEncryptedBlobFormat+Internal.h"
+
+@interface SFEncryptedBlobWriter()
+
+@property (nonatomic, strong) NSOutputStream *outStream;
+@property (nonatomic, strong) SFEncryptedBlobFormat *format;
+@property (nonatomic, strong) NSMutableData *blockBuffer;
+@property (nonatomic, assign) size_t blockFill;
+@property (nonatomic, strong) NSMutableData *storedBlock;
+@property (nonatomic, strong) NSMutableData *blockMACs;
+@property (nonatomic, assign, readwrite) unsigned long long payloadLength;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) BOOL closed;
+
+@end
+
+
+@implementation SFEncryptedBlobWriter
+
+#pragma mark - Lifecycle
+
+/**
+ Same as SFEncryptStream, only init is called on NSObject since this class just wraps an NSOutputStream.
+ */
+#pragma clang diagnostic ignored "-Wobjc-designated-initializers"
+
+- (instancetype)initToMemory {
+    self = [super init];
+    if (self) {
+        _outStream = [[NSOutputStream alloc] initToMemory];
+    }
+    return self;
+}
+
+- (instancetype)initToBuffer:(uint8_t *)buffer capacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        _outStream = [[NSOutputStream alloc] initToBuffer:buffer capacity:capacity];
+    }
+    return self;
+}
+
+- (nullable instancetype)initWithURL:(NSURL *)url append:(BOOL)shouldAppend {
+    NSAssert(!shouldAppend, @"SFEncryptedBlobWriter - appending to an encrypted blob is not supported.");
+    self = [super init];
+    if (self) {
+        _outStream = [[NSOutputStream alloc] initWithURL:url append:NO];
+    }
+    return self;
+}
+
+- (nullable instancetype)initToFileAtPath:(NSString *)path append:(BOOL)shouldAppend {
+    NSAssert(!shouldAppend, @"SFEncryptedBlobWriter - appending to an encrypted blob is not supported.");
+    self = [super init];
+    if (self) {
+        _outStream = [[NSOutputStream alloc] initToFileAtPath:path append:NO];
+    }
+    return self;
+}
+
+
+#pragma mark - Public Methods
+
+- (void)setupWithEncryptionKey:(SFEncryptionKey *)encKey {
+    [self setupWithEncryptionKey:encKey blockSize:kSFEncryptedBlobDefaultBlockSize];
+}
+
+- (void)setupWithEncryptionKey:(SFEncryptionKey *)encKey blockSize:(NSUInteger)blockSize {
+    NSAssert(!_format, @"SFEncryptedBlobWriter - setup is only allowed once.");
+    if (!_format) {
+        _format = [[SFEncryptedBlobFormat alloc] initForWritingWithKey:encKey blockSize:blockSize];
+        if (!_format) {
+            _error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorCryptFailed description:@"Invalid encryption key or block size."];
+            return;
+        }
+        _blockBuffer = [NSMutableData dataWithLength:blockSize];
+        _storedBlock = [NSMutableData dataWithCapacity:[_format storedLengthOfBlockWithLength:blockSize]];
+        _blockMACs = [NSMutableData data];
+    }
+}
+
++ (BOOL)writeData:(NSData *)data toFileAtPath:(NSString *)path key:(SFEncryptionKey *)key error:(NSError **)error {
+    SFEncryptedBlobWriter *writer = [[SFEncryptedBlobWriter alloc] initToFileAtPath:path append:NO];
+    [writer setupWithEncryptionKey:key];
+    [writer open];
+    if (data.length > 0) {
+        [writer write:data.bytes maxLength:data.length];
+    }
+    [writer close];
+    if (writer.streamError) {
+        if (error) *error = writer.streamError;
+        return NO;
+    }
+    return YES;
+}
+
+
+#pragma mark - Private
+
+- (BOOL)writeFully:(const uint8_t *)bytes length:(size_t)len {
+    size_t written = 0;
+    while (written < len) {
+        NSInteger count = [self.outStream write:&bytes[written] maxLength:len - written];
+        if (count <= 0) {
+            self.error = self.outStream.streamError ?: [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorIO description:@"Failed to write encrypted blob."];
+            [SFSDKCoreLogger e:[self class] format:@"SFEncryptedBlobWriter - error on writing stream: %@.", self.error];
+            return NO;
+        }
+        written += count;
+    }
+    return YES;
+}
+
+- (BOOL)writeBlock {
+    uint64_t index = self.blockMACs.length / SFEncryptedBlobMACLength;
+    uint8_t mac[SFEncryptedBlobMACLength];
+    if (![self.format encryptBlockAtIndex:index bytes:self.blockBuffer.bytes length:self.blockFill into:self.storedBlock mac:mac]) {
+        self.error = [SFEncryptedBlobFormat errorWithCode:SFEncryptedBlobErrorCryptFailed description:@"Failed to encrypt encrypted blob block."];
+        return NO;
+    }
+    [self.blockMACs appendBytes:mac length:sizeof(mac)];
+    self.blockFill = 0;
+    return [self writeFully:self.storedBlock.bytes length:self.storedBlock.length];
+}
+
+
+#pragma mark - NSOutputStream
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)len {
+    if (self.error || self.closed) {
+        return -1;
+    }
+    uint8_t *block = self.blockBuffer.mutableBytes;
+    NSUInteger consumed = 0;
+    while (consumed < len) {
+        size_t fillLen = MIN(self.format.blockSize - self.blockFill, len - consumed);
+        memcpy(&block[self.blockFill], &buffer[consumed], fillLen);
+        self.blockFill += fillLen;
+        consumed += fillLen;
+        if (self.blockFill == self.format.blockSize && ![self writeBlock]) {
+            return -1;
+        }
+    }
+    self.payloadLength += len;
+    // return full len, signalizing whole buffer was consumed.
+    return len;
+}
+
+- (BOOL)hasSpaceAvailable {
+    return !self.error && [self.outStream hasSpaceAvailable];
+}
+
+- (void)open {
+    NSAssert(_format || _error, @"SFEncryptedBlobWriter - you must setup first. Call -setupWithEncryptionKey: before opening stream.");
+    [self.outStream open];
+    if (self.format) {
+        [self writeFully:self.format.headerData.bytes length:self.format.headerData.length];
+    }
+}
+
+- (void)close {
+    if (!self.closed) {
+        self.closed = YES;
+        if (!self.error && self.format) {
+            if (self.blockFill > 0) {
+                [self writeBlock];
+            }
+            if (!self.error) {
+                NSData *trailer = [self.format trailerDataWithBlockMACs:self.blockMACs payloadLength:self.payloadLength];
+                [self writeFully:trailer.bytes length:trailer.length];
+            }
+        }
+    }
+    [self.outStream close];
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate {
+    self.outStream.delegate = delegate;
+}
+
+- (id<NSStreamDelegate>)delegate {
+    return self.outStream.delegate;
+}
+
+- (id)propertyForKey:(NSString *)key {
+    return [self.outStream propertyForKey:key];
+}
+
+- (BOOL)setProperty:(id)property forKey:(NSString *)key {
+    return [self.outStream setProperty:property forKey:key];
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)aRunLoop forMode:(NSString *)mode {
+    [self.outStream scheduleInRunLoop:aRunLoop forMode:mode];
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)aRunLoop forMode:(NSString *)mode {
+    [self.outStream removeFromRunLoop:aRunLoop forMode:mode];
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.error ? NSStreamStatusError : self.outStream.streamStatus;
+}
+
+- (NSError *)streamError {
+    return self.error ?: self.outStream.streamError;
+}
+
+@end
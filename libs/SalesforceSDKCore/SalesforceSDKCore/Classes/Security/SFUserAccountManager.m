@@ -1440,7 +1440,8 @@ static NSString *const  kOptionsClientKey          = @"clientIdentifier";
         NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:account.idData.pictureUrl];
         [request setHTTPMethod:@"GET"];
         [request setValue:[NSString stringWithFormat:kHttpAuthHeaderFormatString, account.credentials.accessToken] forHTTPHeaderField:kHttpHeaderAuthorization];
-        SFNetwork *network = [[SFNetwork alloc] initWithEphemeralSession];
+        NSString *userKey = SFKeyForUserAndScope(account, SFUserAccountScopeUser);
+        SFNetwork *network = userKey ? [SFNetwork sharedEphemeralInstanceWithIdentifier:userKey] : [SFNetwork sharedEphemeralInstance];
         [network sendRequest:request  dataResponseBlock:^(NSData *data, NSURLResponse *response, NSError *error){
             if (error) {
                 [SFSDKCoreLogger w:[self class] format:@"Error while trying to retrieve user photo: %ld %@", (long) error.code, error.localizedDescription];
@@ -0,0 +1,93 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Canned response returned by the stand-in server.
+ */
+@interface SFSDKStandInResponse : NSObject
+
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, copy) NSDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, copy, nullable) NSData *data;
+
+/// When set, the request fails with that error instead of returning a response
+@property (nonatomic, strong, nullable) NSError *error;
+
+/// Seconds to wait before answering
+@property (nonatomic, assign) NSTimeInterval delay;
+
++ (instancetype)responseWithStatusCode:(NSInteger)statusCode jsonObject:(nullable id)jsonObject;
++ (instancetype)responseWithStatusCode:(NSInteger)statusCode headers:(nullable NSDictionary<NSString *, NSString *> *)headers data:(nullable NSData *)data;
++ (instancetype)responseWithError:(NSError *)error;
+
+@end
+
+/**
+ * Block answering a request, or returning nil to let the next handler answer it.
+ */
+typedef SFSDKStandInResponse * _Nullable (^SFSDKStandInHandler)(NSURLRequest *request, NSData * _Nullable body);
+
+/**
+ * In-process stand-in for the Salesforce REST endpoints, used by tests that should not go to a real server.
+ * Once started, every request sent through SFNetwork is answered by the registered handlers (404 if none answers).
+ */
+@interface SFSDKTestStandInServer : NSURLProtocol
+
+/**
+ * Routes SFNetwork sessions to the stand-in server and clears handlers and recorded requests.
+ */
++ (void)start;
+
+/**
+ * Restores the default SFNetwork session configuration.
+ */
++ (void)stop;
+
+/**
+ * Registers a handler; handlers are consulted in registration order.
+ */
++ (void)addHandler:(SFSDKStandInHandler)handler;
+
+/**
+ * Requests received since the server was started, in arrival order.
+ */
++ (NSArray<NSURLRequest *> *)receivedRequests;
+
+/**
+ * Bodies of the requests received since the server was started (empty data for requests without body).
+ */
++ (NSArray<NSData *> *)receivedBodies;
+
+/**
+ * Highest number of requests being answered at the same time since the server was started.
+ */
++ (NSUInteger)maxConcurrentRequests;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,199 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKTestStandInServer.h"
+#import "SFNetwork.h"
+
+@implementation SFSDKStandInResponse
+
++ (instancetype)responseWithStatusCode:(NSInteger)statusCode jsonObject:(id)jsonObject {
+    NSData *data = jsonObject ? [NSJSONSerialization dataWithJSONObject:jsonObject options:0 error:nil] : nil;
+    return [self responseWithStatusCode:statusCode headers:@{@"Content-Type": @"application/json"} data:data];
+}
+
++ (instancetype)responseWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> *)headers data:(NSData *)data {
+    SFSDKStandInResponse *response = [[SFSDKStandInResponse alloc] init];
+    response.statusCode = statusCode;
+    response.headers = headers ? headers : @{};
+    response.data = data;
+    return response;
+}
+
++ (instancetype)responseWithError:(NSError *)error {
+    SFSDKStandInResponse *response = [[SFSDKStandInResponse alloc] init];
+    response.error = error;
+    return response;
+}
+
+@end
+
+static NSMutableArray<SFSDKStandInHandler> *standInHandlers;
+static NSMutableArray<NSURLRequest *> *standInRequests;
+static NSMutableArray<NSData *> *standInBodies;
+static NSUInteger standInActiveRequests;
+static NSUInteger standInMaxConcurrentRequests;
+static NSObject *standInLock;
+
+@interface SFSDKTestStandInServer ()
+
+@property (nonatomic, assign) BOOL stopped;
+
+@end
+
+@implementation SFSDKTestStandInServer
+
++ (void)initialize {
+    if (self == [SFSDKTestStandInServer class]) {
+        standInLock = [[NSObject alloc] init];
+        standInHandlers = [NSMutableArray new];
+        standInRequests = [NSMutableArray new];
+        standInBodies = [NSMutableArray new];
+    }
+}
+
++ (void)start {
+    @synchronized (standInLock) {
+        [standInHandlers removeAllObjects];
+        [standInRequests removeAllObjects];
+        [standInBodies removeAllObjects];
+        standInActiveRequests = 0;
+        standInMaxConcurrentRequests = 0;
+    }
+    NSURLSessionConfiguration *config = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    config.protocolClasses = @[[SFSDKTestStandInServer class]];
+    [SFNetwork setSessionConfiguration:config];
+}
+
++ (void)stop {
+    [SFNetwork setSessionConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    @synchronized (standInLock) {
+        [standInHandlers removeAllObjects];
+    }
+}
+
++ (void)addHandler:(SFSDKStandInHandler)handler {
+    @synchronized (standInLock) {
+        [standInHandlers addObject:[handler copy]];
+    }
+}
+
++ (NSArray<NSURLRequest *> *)receivedRequests {
+    @synchronized (standInLock) {
+        return [standInRequests copy];
+    }
+}
+
++ (NSArray<NSData *> *)receivedBodies {
+    @synchronized (standInLock) {
+        return [standInBodies copy];
+    }
+}
+
++ (NSUInteger)maxConcurrentRequests {
+    @synchronized (standInLock) {
+        return standInMaxConcurrentRequests;
+    }
+}
+
+#pragma mark - NSURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return YES;
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    NSURLRequest *request = self.request;
+    NSData *body = [SFSDKTestStandInServer bodyOfRequest:request];
+    NSArray<SFSDKStandInHandler> *handlers;
+    @synchronized (standInLock) {
+        [standInRequests addObject:request];
+        [standInBodies addObject:body];
+        standInActiveRequests++;
+        standInMaxConcurrentRequests = MAX(standInMaxConcurrentRequests, standInActiveRequests);
+        handlers = [standInHandlers copy];
+    }
+    
+    SFSDKStandInResponse *response = nil;
+    for (SFSDKStandInHandler handler in handlers) {
+        response = handler(request, body.length > 0 ? body : nil);
+        if (response) {
+            break;
+        }
+    }
+    if (!response) {
+        response = [SFSDKStandInResponse responseWithStatusCode:404 jsonObject:@[@{@"errorCode": @"NOT_FOUND", @"message": @"No stand-in handler"}]];
+    }
+    
+    dispatch_time_t when = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(response.delay * NSEC_PER_SEC));
+    dispatch_after(when, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        @synchronized (standInLock) {
+            standInActiveRequests--;
+        }
+        @synchronized (self) {
+            if (self.stopped) {
+                return;
+            }
+        }
+        if (response.error) {
+            [self.client URLProtocol:self didFailWithError:response.error];
+            return;
+        }
+        NSHTTPURLResponse *httpResponse = [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:response.statusCode HTTPVersion:@"HTTP/1.1" headerFields:response.headers];
+        [self.client URLProtocol:self didReceiveResponse:httpResponse cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+        if (response.data) {
+            [self.client URLProtocol:self didLoadData:response.data];
+        }
+        [self.client URLProtocolDidFinishLoading:self];
+    });
+}
+
+- (void)stopLoading {
+    @synchronized (self) {
+        self.stopped = YES;
+    }
+}
+
++ (NSData *)bodyOfRequest:(NSURLRequest *)request {
+    if (request.HTTPBody) {
+        return request.HTTPBody;
+    }
+    NSMutableData *body = [NSMutableData data];
+    NSInputStream *stream = request.HTTPBodyStream;
+    if (stream) {
+        uint8_t buffer[4096];
+        [stream open];
+        NSInteger read;
+        while ((read = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+            [body appendBytes:buffer length:read];
+        }
+        [stream close];
+    }
+    return body;
+}
+
+@end
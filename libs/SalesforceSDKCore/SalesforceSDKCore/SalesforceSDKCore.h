@@ -48,6 +48,7 @@
 #import <SalesforceSDKCore/SFSDKInstrumentationHelper.h>
 #import <SalesforceSDKCore/SFSDKAsyncProcessListener.h>
 #import <SalesforceSDKCore/SFSDKTestRequestListener.h>
+#import <SalesforceSDKCore/SFSDKTestStandInServer.h>
 #import <SalesforceSDKCore/UIColor+SFColors.h>
 #import <SalesforceSDKCore/SFSDKLoginHostDelegate.h>
 #import <SalesforceSDKCore/SFPasscodeProviderManager.h>
@@ -93,6 +94,10 @@
 #import <SalesforceSDKCore/UIScreen+SFAdditions.h>
 #import <SalesforceSDKCore/SFRestAPI+QueryBuilder.h>
 #import <SalesforceSDKCore/SFEncryptStream.h>
+#import <SalesforceSDKCore/SFEncryptedBlobFormat.h>
+#import <SalesforceSDKCore/SFEncryptedBlobWriter.h>
+#import <SalesforceSDKCore/SFEncryptedBlobReader.h>
+#import <SalesforceSDKCore/SFEncryptedBlobInputStream.h>
 #import <SalesforceSDKCore/SFSDKAppDelegate.h>
 #import <SalesforceSDKCore/SFRestAPI+Blocks.h>
 #import <SalesforceSDKCore/SFSDKAuthConfigUtil.h>
@@ -124,6 +129,11 @@
 #import <SalesforceSDKCore/SFSDKViewController.h>
 #import <SalesforceSDKCore/NSObject+SFBlocks.h>
 #import <SalesforceSDKCore/SFNetwork.h>
+#import <SalesforceSDKCore/SFSDKRequestScheduler.h>
+#import <SalesforceSDKCore/SFSDKResponseCache.h>
+#import <SalesforceSDKCore/SFSDKRetryPolicy.h>
+#import <SalesforceSDKCore/SFSDKCircuitBreaker.h>
+#import <SalesforceSDKCore/SFSDKLazyJSONResponse.h>
 #import <SalesforceSDKCore/SFIdentityData.h>
 #import <SalesforceSDKCore/SFPreferences.h>
 #import <SalesforceSDKCore/SFSDKWebUtils.h>
@@ -31,6 +31,10 @@
 
 @interface SFEncryptDecryptStreamTests : XCTestCase
 
+// Stream settings used by performTestWithDataLen:, 0 / NO for the defaults.
+@property (nonatomic, assign) NSUInteger streamBufferSize;
+@property (nonatomic, assign) BOOL encryptsInBackground;
+
 @end
 
 
@@ -90,8 +94,98 @@
     [self performTestWithDataLen:(SFCryptChunksCipherBlockSize * 100000) + 13];
 }
 
+- (void)testEncryptsInBackground {
+    self.encryptsInBackground = YES;
+    [self performTestWithDataLen:0];
+    [self performTestWithDataLen:SFCryptChunksCipherBlockSize + 7];
+    [self performTestWithDataLen:SFCryptChunksDefaultStreamBufferSize * 3 + 13];
+}
+
+- (void)testEncryptsWithSmallAndOddBufferSizes {
+    for (NSNumber *bufferSize in @[@(SFCryptChunksCipherBlockSize), @1000, @(SFCryptChunksCipherBlockSize * 3)]) {
+        self.streamBufferSize = bufferSize.unsignedIntegerValue;
+        [self performTestWithDataLen:SFCryptChunksCipherBlockSize * 42];
+        [self performTestWithDataLen:(SFCryptChunksCipherBlockSize * 100) + 7];
+    }
+}
+
+- (void)testPerformanceEncryptDecrypt {
+    [self measureBlock:^{
+        [self encryptDecryptPayloadWithSize:16 << 20 bufferSize:SFCryptChunksDefaultStreamBufferSize inBackground:YES encryptTime:NULL decryptTime:NULL];
+    }];
+}
+
+- (void)testEncryptDecryptThroughput {
+    // Reports MB/s, from one cipher block at a time (how the streams used to work) to large buffers on a background queue.
+    // Takes minutes with its 1 GB payloads, so only runs when SF_CRYPTO_THROUGHPUT is set in the scheme's environment.
+    if (![NSProcessInfo processInfo].environment[@"SF_CRYPTO_THROUGHPUT"]) {
+        return;
+    }
+    NSArray<NSNumber *> *payloadSizes = @[@(1 << 20), @(16 << 20), @(128 << 20), @(1 << 30)];
+    for (NSNumber *payloadSize in payloadSizes) {
+        unsigned long long size = payloadSize.unsignedLongLongValue;
+        if (size <= (16 << 20)) {
+            [self measureThroughputWithPayloadSize:size bufferSize:SFCryptChunksCipherBlockSize inBackground:NO];
+        }
+        [self measureThroughputWithPayloadSize:size bufferSize:SFCryptChunksDefaultStreamBufferSize inBackground:NO];
+        [self measureThroughputWithPayloadSize:size bufferSize:SFCryptChunksDefaultStreamBufferSize inBackground:YES];
+        [self measureThroughputWithPayloadSize:size bufferSize:1 << 20 inBackground:YES];
+    }
+}
+
 #pragma mark - The actual test code
 
+- (void)measureThroughputWithPayloadSize:(unsigned long long)payloadSize bufferSize:(NSUInteger)bufferSize inBackground:(BOOL)inBackground {
+    CFAbsoluteTime encryptTime = 0;
+    CFAbsoluteTime decryptTime = 0;
+    [self encryptDecryptPayloadWithSize:payloadSize bufferSize:bufferSize inBackground:inBackground encryptTime:&encryptTime decryptTime:&decryptTime];
+    double megabytes = payloadSize / (1024.0 * 1024.0);
+    NSLog(@"%@: %.0f MB, buffer %lu%@: encrypt %.1f MB/s, decrypt %.1f MB/s", NSStringFromClass([self class]), megabytes,
+          (unsigned long)bufferSize, inBackground ? @" (background)" : @"", megabytes / encryptTime, megabytes / decryptTime);
+}
+
+- (void)encryptDecryptPayloadWithSize:(unsigned long long)payloadSize bufferSize:(NSUInteger)bufferSize inBackground:(BOOL)inBackground encryptTime:(CFAbsoluteTime *)encryptTime decryptTime:(CFAbsoluteTime *)decryptTime {
+    NSData *key = [SFCryptoStreamTestUtils defaultKeyWithSize:kCCKeySizeAES256];
+    NSData *iv = [SFCryptoStreamTestUtils defaultInitializationVectorWithBlockSize:SFCryptChunksCipherBlockSize];
+    NSString *filePath = [SFCryptoStreamTestUtils filePathForFileName:[[NSUUID UUID] UUIDString]];
+    // Written the way callers usually write, in small pieces.
+    NSData *chunk = [SFCryptoStreamTestUtils defaultTestDataWithSize:16 * 1024];
+
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    SFEncryptStream *encryptStream = [[SFEncryptStream alloc] initToFileAtPath:filePath append:NO];
+    [encryptStream setupWithKey:key andInitializationVector:iv];
+    encryptStream.bufferSize = bufferSize;
+    encryptStream.encryptsInBackground = inBackground;
+    [encryptStream open];
+    for (unsigned long long written = 0; written < payloadSize; written += chunk.length) {
+        [encryptStream write:chunk.bytes maxLength:(NSUInteger)MIN(chunk.length, payloadSize - written)];
+    }
+    [encryptStream close];
+    if (encryptTime) {
+        *encryptTime = CFAbsoluteTimeGetCurrent() - start;
+    }
+    XCTAssertNil(encryptStream.streamError);
+
+    start = CFAbsoluteTimeGetCurrent();
+    SFDecryptStream *decryptStream = [[SFDecryptStream alloc] initWithFileAtPath:filePath];
+    [decryptStream setupWithKey:key andInitializationVector:iv];
+    decryptStream.bufferSize = bufferSize;
+    [decryptStream open];
+    NSMutableData *readBuffer = [NSMutableData dataWithLength:chunk.length];
+    unsigned long long decryptedSize = 0;
+    NSInteger bytesRead = 0;
+    while ([decryptStream hasBytesAvailable] && (bytesRead = [decryptStream read:readBuffer.mutableBytes maxLength:readBuffer.length]) >= 0) {
+        decryptedSize += bytesRead;
+    }
+    [decryptStream close];
+    if (decryptTime) {
+        *decryptTime = CFAbsoluteTimeGetCurrent() - start;
+    }
+    XCTAssertEqual(decryptedSize, payloadSize);
+    XCTAssertNil(decryptStream.streamError);
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+}
+
 - (void)performTestWithDataLen:(NSUInteger)testLen {
     NSArray *dataChunksToTest = @[@(SFCryptChunksCipherBlockSize/2),
                                   @(SFCryptChunksCipherBlockSize-1),
@@ -125,6 +219,10 @@
     };
     void (^performEncryption)(SFEncryptStream *) = ^(SFEncryptStream *encryptStream) {
         [encryptStream setupWithKey:key andInitializationVector:iv];
+        if (self.streamBufferSize > 0) {
+            encryptStream.bufferSize = self.streamBufferSize;
+        }
+        encryptStream.encryptsInBackground = self.encryptsInBackground;
         [encryptStream open];
         NSRange encryptChunkRange = {0};
         while (encryptChunkRange.location < testData.length) {
@@ -145,6 +243,9 @@
     };
     NSData *(^performDecryption)(SFDecryptStream *) = ^(SFDecryptStream *decryptStream) {
         [decryptStream setupWithKey:key andInitializationVector:iv];
+        if (self.streamBufferSize > 0) {
+            decryptStream.bufferSize = self.streamBufferSize;
+        }
         [decryptStream open];
         NSMutableData *decryptedData = [[NSMutableData alloc] init];
         while ([decryptStream hasBytesAvailable]) {
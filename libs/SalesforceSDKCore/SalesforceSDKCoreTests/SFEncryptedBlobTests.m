@@ -0,0 +1,260 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "SFEncryptedBlobFormat.h"
+#import "SFEncryptedBlobWriter.h"
+#import "SFEncryptedBlobReader.h"
+#import "SFEncryptedBlobInputStream.h"
+#import "SFEncryptStream.h"
+#import "SFCryptoStreamTestUtils.h"
+
+static NSUInteger const kTestBlockSize = 4096;
+
+@interface SFEncryptedBlobTests : XCTestCase
+
+@property (nonatomic, strong) SFEncryptionKey *key;
+@property (nonatomic, strong) NSMutableArray<NSString *> *filePaths;
+
+@end
+
+@implementation SFEncryptedBlobTests
+
+- (void)setUp {
+    [super setUp];
+    self.key = [[SFEncryptionKey alloc] initWithData:[SFCryptoStreamTestUtils defaultKeyWithSize:SFCryptChunksCipherKeySize]
+                                initializationVector:[SFCryptoStreamTestUtils defaultInitializationVectorWithBlockSize:SFCryptChunksCipherBlockSize]];
+    self.filePaths = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    for (NSString *filePath in self.filePaths) {
+        [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    }
+    [super tearDown];
+}
+
+- (void)testRoundTripsPayloadSizes {
+    NSArray<NSNumber *> *lengths = @[@0, @1, @(SFCryptChunksCipherBlockSize), @(kTestBlockSize - 1), @(kTestBlockSize), @(kTestBlockSize + 1), @(kTestBlockSize * 10 + 333)];
+    for (NSNumber *length in lengths) {
+        NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:length.unsignedIntegerValue];
+        NSString *filePath = [self writeBlobWithPayload:payload];
+        NSError *error = nil;
+        SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:self.key error:&error];
+        XCTAssertNotNil(reader, @"Blob of %@ bytes should open: %@", length, error);
+        XCTAssertEqual(reader.length, payload.length);
+        XCTAssertEqualObjects([reader readDataInRange:NSMakeRange(0, payload.length) error:&error], payload, @"Payload of %@ bytes should round trip", length);
+    }
+}
+
+- (void)testReadsArbitraryRanges {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 7 + 100];
+    SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:[self writeBlobWithPayload:payload] key:self.key error:nil];
+    NSArray<NSValue *> *ranges = @[[NSValue valueWithRange:NSMakeRange(payload.length - 1024, 1024)],
+                                   [NSValue valueWithRange:NSMakeRange(0, 1)],
+                                   [NSValue valueWithRange:NSMakeRange(kTestBlockSize - 10, 20)],
+                                   [NSValue valueWithRange:NSMakeRange(kTestBlockSize * 2, kTestBlockSize * 3 + 5)],
+                                   [NSValue valueWithRange:NSMakeRange(kTestBlockSize * 5 + 17, 0)]];
+    for (NSValue *range in ranges) {
+        NSError *error = nil;
+        XCTAssertEqualObjects([reader readDataInRange:range.rangeValue error:&error], [payload subdataWithRange:range.rangeValue], @"Range %@ should match: %@", NSStringFromRange(range.rangeValue), error);
+    }
+    NSError *error = nil;
+    XCTAssertNil([reader readDataInRange:NSMakeRange(payload.length - 10, 11) error:&error]);
+    XCTAssertEqual(error.code, SFEncryptedBlobErrorOutOfRange);
+}
+
+- (void)testReadsFromMemory {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 2 + 1];
+    SFEncryptedBlobWriter *writer = [[SFEncryptedBlobWriter alloc] initToMemory];
+    [writer setupWithEncryptionKey:self.key blockSize:kTestBlockSize];
+    [writer open];
+    [writer write:payload.bytes maxLength:payload.length];
+    [writer close];
+    NSData *blob = [writer propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    XCTAssertTrue([SFEncryptedBlobFormat isEncryptedBlobData:blob]);
+    NSError *error = nil;
+    SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithData:blob key:self.key error:&error];
+    XCTAssertEqualObjects([reader readDataInRange:NSMakeRange(kTestBlockSize, kTestBlockSize + 1) error:&error], [payload subdataWithRange:NSMakeRange(kTestBlockSize, kTestBlockSize + 1)]);
+}
+
+- (void)testRejectsWrongKey {
+    NSString *filePath = [self writeBlobWithPayload:[SFCryptoStreamTestUtils defaultTestDataWithSize:1000]];
+    SFEncryptionKey *otherKey = [SFEncryptionKey createKey];
+    NSError *error = nil;
+    XCTAssertNil([[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:otherKey error:&error]);
+    XCTAssertEqualObjects(error.domain, kSFEncryptedBlobErrorDomain);
+    XCTAssertEqual(error.code, SFEncryptedBlobErrorAuthenticationFailed);
+}
+
+- (void)testDetectsTamperedBlock {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 3];
+    NSString *filePath = [self writeBlobWithPayload:payload];
+    NSMutableData *blob = [NSMutableData dataWithContentsOfFile:filePath];
+    // Flip a byte in the second block, past the 64 bytes header.
+    ((uint8_t *)blob.mutableBytes)[64 + kTestBlockSize + 100] ^= 0x01;
+    [blob writeToFile:filePath atomically:YES];
+
+    NSError *error = nil;
+    SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:self.key error:&error];
+    XCTAssertNotNil(reader, @"Index is intact, the blob should open: %@", error);
+    XCTAssertEqualObjects([reader readDataInRange:NSMakeRange(0, kTestBlockSize) error:&error], [payload subdataWithRange:NSMakeRange(0, kTestBlockSize)], @"Untouched blocks should still be readable");
+    XCTAssertNil([reader readDataInRange:NSMakeRange(kTestBlockSize, 10) error:&error]);
+    XCTAssertEqual(error.code, SFEncryptedBlobErrorAuthenticationFailed);
+}
+
+- (void)testDetectsTruncatedBlob {
+    NSString *filePath = [self writeBlobWithPayload:[SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 3]];
+    NSData *blob = [NSData dataWithContentsOfFile:filePath];
+    [[blob subdataWithRange:NSMakeRange(0, blob.length - 40)] writeToFile:filePath atomically:YES];
+    NSError *error = nil;
+    XCTAssertNil([[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:self.key error:&error]);
+    XCTAssertEqual(error.code, SFEncryptedBlobErrorInvalidFormat);
+}
+
+- (void)testInputStreamSeeks {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 4 + 50];
+    SFEncryptedBlobInputStream *stream = [[SFEncryptedBlobInputStream alloc] initWithFileAtPath:[self writeBlobWithPayload:payload]];
+    [stream setupWithDecryptionKey:self.key];
+    [stream open];
+    XCTAssertEqual(stream.streamStatus, NSStreamStatusOpen);
+    unsigned long long offset = kTestBlockSize * 3 + 7;
+    XCTAssertTrue([stream setProperty:@(offset) forKey:NSStreamFileCurrentOffsetKey]);
+    XCTAssertEqualObjects([self readAllFromStream:stream], [payload subdataWithRange:NSMakeRange((NSUInteger)offset, payload.length - (NSUInteger)offset)]);
+    XCTAssertEqual(stream.streamStatus, NSStreamStatusAtEnd);
+    XCTAssertTrue([stream setProperty:@0 forKey:NSStreamFileCurrentOffsetKey]);
+    XCTAssertEqualObjects([self readAllFromStream:stream], payload);
+    XCTAssertFalse([stream setProperty:@(payload.length + 1) forKey:NSStreamFileCurrentOffsetKey]);
+    [stream close];
+}
+
+- (void)testMigratesLegacyFile {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 20 + 9];
+    NSString *filePath = [self filePath];
+    SFEncryptStream *legacyStream = [[SFEncryptStream alloc] initToFileAtPath:filePath append:NO];
+    [legacyStream setupWithEncryptionKey:self.key];
+    [legacyStream open];
+    [legacyStream write:payload.bytes maxLength:payload.length];
+    [legacyStream close];
+    XCTAssertFalse([SFEncryptedBlobFormat isEncryptedBlobAtPath:filePath]);
+
+    NSInputStream *stream = [SFEncryptedBlobReader inputStreamForFileAtPath:filePath key:self.key legacyKey:nil];
+    XCTAssertFalse([stream isKindOfClass:[SFEncryptedBlobInputStream class]]);
+    [stream open];
+    XCTAssertEqualObjects([self readAllFromStream:stream], payload, @"Legacy file should be readable before migration");
+    [stream close];
+
+    NSError *error = nil;
+    XCTAssertTrue([SFEncryptedBlobReader migrateLegacyFileAtPath:filePath legacyKey:self.key key:self.key error:&error], @"Migration failed: %@", error);
+    XCTAssertTrue([SFEncryptedBlobFormat isEncryptedBlobAtPath:filePath]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[filePath stringByAppendingPathExtension:@"migrating"]]);
+    SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:self.key error:&error];
+    XCTAssertEqualObjects([reader readDataInRange:NSMakeRange(payload.length - 100, 100) error:&error], [payload subdataWithRange:NSMakeRange(payload.length - 100, 100)]);
+
+    stream = [SFEncryptedBlobReader inputStreamForFileAtPath:filePath key:self.key legacyKey:nil];
+    XCTAssertTrue([stream isKindOfClass:[SFEncryptedBlobInputStream class]]);
+    [stream open];
+    XCTAssertEqualObjects([self readAllFromStream:stream], payload);
+    [stream close];
+    XCTAssertTrue([SFEncryptedBlobReader migrateLegacyFileAtPath:filePath legacyKey:self.key key:self.key error:&error], @"Migrating a migrated file is a no-op");
+}
+
+- (void)testMigrationWithWrongLegacyKeyKeepsOriginal {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:kTestBlockSize * 3 + 5];
+    NSString *filePath = [self filePath];
+    SFEncryptStream *legacyStream = [[SFEncryptStream alloc] initToFileAtPath:filePath append:NO];
+    [legacyStream setupWithEncryptionKey:self.key];
+    [legacyStream open];
+    [legacyStream write:payload.bytes maxLength:payload.length];
+    [legacyStream close];
+    NSData *legacyData = [NSData dataWithContentsOfFile:filePath];
+
+    // Garbage ending with valid padding (about 1 key out of 256) can't be told apart from the real thing
+    SFEncryptionKey *wrongKey = nil;
+    do {
+        wrongKey = [SFEncryptionKey createKey];
+    } while ([wrongKey decryptData:legacyData] != nil);
+
+    NSError *error = nil;
+    XCTAssertFalse([SFEncryptedBlobReader migrateLegacyFileAtPath:filePath legacyKey:wrongKey key:self.key error:&error], @"Migration with the wrong key should fail");
+    XCTAssertEqualObjects(error.domain, NSOSStatusErrorDomain, @"Wrong error domain");
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], legacyData, @"Original file should be unchanged");
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[filePath stringByAppendingPathExtension:@"migrating"]]);
+
+    XCTAssertTrue([SFEncryptedBlobReader migrateLegacyFileAtPath:filePath legacyKey:self.key key:self.key error:&error], @"Migration failed: %@", error);
+    SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:self.key error:&error];
+    XCTAssertEqualObjects([reader readDataInRange:NSMakeRange(0, payload.length) error:&error], payload);
+}
+
+- (void)testPerformanceReadLastKilobyte {
+    NSData *payload = [SFCryptoStreamTestUtils defaultTestDataWithSize:16 * 1024 * 1024];
+    NSString *filePath = [self filePath];
+    XCTAssertTrue([SFEncryptedBlobWriter writeData:payload toFileAtPath:filePath key:self.key error:nil]);
+    NSRange lastKilobyte = NSMakeRange(payload.length - 1024, 1024);
+    [self measureBlock:^{
+        SFEncryptedBlobReader *reader = [[SFEncryptedBlobReader alloc] initWithFileAtPath:filePath key:self.key error:nil];
+        XCTAssertEqual([reader readDataInRange:lastKilobyte error:nil].length, lastKilobyte.length);
+    }];
+}
+
+#pragma mark - Helpers
+
+- (NSString *)filePath {
+    NSString *filePath = [SFCryptoStreamTestUtils filePathForFileName:[[NSUUID UUID] UUIDString]];
+    [self.filePaths addObject:filePath];
+    return filePath;
+}
+
+- (NSString *)writeBlobWithPayload:(NSData *)payload {
+    NSString *filePath = [self filePath];
+    SFEncryptedBlobWriter *writer = [[SFEncryptedBlobWriter alloc] initToFileAtPath:filePath append:NO];
+    [writer setupWithEncryptionKey:self.key blockSize:kTestBlockSize];
+    [writer open];
+    // Odd sized writes, so blocks fill across write calls.
+    NSUInteger written = 0;
+    while (written < payload.length) {
+        NSUInteger len = MIN((NSUInteger)1000, payload.length - written);
+        XCTAssertEqual([writer write:&((const uint8_t *)payload.bytes)[written] maxLength:len], (NSInteger)len);
+        written += len;
+    }
+    [writer close];
+    XCTAssertNil(writer.streamError);
+    XCTAssertEqual(writer.payloadLength, payload.length);
+    return filePath;
+}
+
+- (NSData *)readAllFromStream:(NSInputStream *)stream {
+    NSMutableData *data = [NSMutableData data];
+    uint8_t buffer[1500];
+    while ([stream hasBytesAvailable]) {
+        NSInteger count = [stream read:buffer maxLength:sizeof(buffer)];
+        if (count < 0) {
+            break;
+        }
+        [data appendBytes:buffer length:count];
+    }
+    return data;
+}
+
+@end
@@ -0,0 +1,104 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "SFNetwork.h"
+#import "SFSDKTestHTTPServer.h"
+
+static NSUInteger const kSFTestRequestCount = 5;
+
+@interface SFNetworkTests : XCTestCase
+
+@property (nonatomic, strong) SFSDKTestHTTPServer *server;
+
+@end
+
+@implementation SFNetworkTests
+
+- (void)setUp {
+    [super setUp];
+    [SFNetwork setSessionConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    self.server = [[SFSDKTestHTTPServer alloc] init];
+    XCTAssertTrue([self.server start], @"Local server should have started");
+}
+
+- (void)tearDown {
+    [self.server stop];
+    [SFNetwork removeAllSharedInstances];
+    [super tearDown];
+}
+
+- (void)testSharedInstanceReusesConnection {
+    SFNetwork *network = [SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser"];
+    for (NSUInteger i = 0; i < kSFTestRequestCount; i++) {
+        [self sendRequest:[NSString stringWithFormat:@"/shared/%lu", (unsigned long)i] network:[SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser"]];
+    }
+    XCTAssertEqual([SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser"], network, @"Shared instance should be reused");
+    XCTAssertEqual(self.server.requestCount, kSFTestRequestCount, @"Wrong number of requests");
+    XCTAssertEqual(self.server.acceptedConnections, 1, @"Requests should have gone through a single connection");
+}
+
+- (void)testNewInstancesOpenNewConnections {
+    for (NSUInteger i = 0; i < kSFTestRequestCount; i++) {
+        [self sendRequest:[NSString stringWithFormat:@"/unshared/%lu", (unsigned long)i] network:[[SFNetwork alloc] initWithEphemeralSession]];
+    }
+    XCTAssertEqual(self.server.requestCount, kSFTestRequestCount, @"Wrong number of requests");
+    XCTAssertEqual(self.server.acceptedConnections, kSFTestRequestCount, @"Every session should have opened its own connection");
+}
+
+- (void)testRemoveSharedInstance {
+    SFNetwork *userNetwork = [SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser"];
+    SFNetwork *communityNetwork = [SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser-community"];
+    SFNetwork *otherUserNetwork = [SFNetwork sharedEphemeralInstanceWithIdentifier:@"otherUser"];
+    XCTAssertNotEqual(userNetwork, otherUserNetwork, @"Users should not share a network instance");
+    [self sendRequest:@"/beforeLogout" network:userNetwork];
+
+    // Removing a user's instance removes its community instances, and the next request opens a new connection
+    [SFNetwork removeSharedInstanceWithIdentifier:@"testUser"];
+    XCTAssertNotEqual([SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser"], userNetwork, @"User instance should have been removed");
+    XCTAssertNotEqual([SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser-community"], communityNetwork, @"Community instance should have been removed");
+    XCTAssertEqual([SFNetwork sharedEphemeralInstanceWithIdentifier:@"otherUser"], otherUserNetwork, @"Other user instance should have been kept");
+    [self sendRequest:@"/afterLogout" network:[SFNetwork sharedEphemeralInstanceWithIdentifier:@"testUser"]];
+    XCTAssertEqual(self.server.acceptedConnections, 2, @"Invalidated session should not have been reused");
+
+    // Session configuration changes replace shared instances
+    SFNetwork *network = [SFNetwork sharedEphemeralInstance];
+    [SFNetwork setSessionConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    XCTAssertNotEqual([SFNetwork sharedEphemeralInstance], network, @"Shared instance should have been replaced");
+}
+
+#pragma mark - Helper methods
+
+- (void)sendRequest:(NSString *)path network:(SFNetwork *)network {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:path relativeToURL:self.server.baseURL]];
+    XCTestExpectation *expect = [self expectationWithDescription:path];
+    [network sendRequest:request dataResponseBlock:^(NSData *data, NSURLResponse *response, NSError *error) {
+        XCTAssertNil(error, @"Request should have succeeded");
+        XCTAssertEqual(((NSHTTPURLResponse *)response).statusCode, 200, @"Wrong status code");
+        [expect fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+@end
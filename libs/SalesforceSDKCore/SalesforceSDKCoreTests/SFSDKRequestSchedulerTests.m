@@ -0,0 +1,142 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "SFSDKRequestScheduler.h"
+#import "SFRestRequest+Internal.h"
+
+static NSString * const kSFTestHost = @"test.salesforce.com";
+static NSString * const kSFTestOtherHost = @"other.salesforce.com";
+
+@interface SFSDKRequestSchedulerTests : XCTestCase
+
+@property (nonatomic, strong) SFSDKRequestScheduler *scheduler;
+@property (nonatomic, strong) NSMutableArray<NSString *> *dispatched;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, dispatch_block_t> *finishBlocks;
+
+@end
+
+@implementation SFSDKRequestSchedulerTests
+
+- (void)setUp {
+    [super setUp];
+    self.scheduler = [[SFSDKRequestScheduler alloc] init];
+    self.dispatched = [NSMutableArray array];
+    self.finishBlocks = [NSMutableDictionary dictionary];
+}
+
+- (void)testGlobalCap {
+    self.scheduler.maxConcurrentRequests = 2;
+    for (NSUInteger i = 0; i < 5; i++) {
+        [self schedule:[NSString stringWithFormat:@"r%lu", (unsigned long)i] priority:SFRestRequestPriorityNormal host:(i % 2 ? kSFTestHost : kSFTestOtherHost)];
+    }
+    XCTAssertEqualObjects(self.dispatched, (@[@"r0", @"r1"]), @"Only two requests should be running");
+    XCTAssertEqual(self.scheduler.runningCount, 2, @"Wrong running count");
+    XCTAssertEqual(self.scheduler.queuedCount, 3, @"Wrong queued count");
+
+    [self finish:@"r0"];
+    [self finish:@"r0"]; // finishing twice should not free two slots
+    XCTAssertEqualObjects(self.dispatched, (@[@"r0", @"r1", @"r2"]), @"Freed slot should go to the next request");
+    XCTAssertEqual(self.scheduler.runningCount, 2, @"Wrong running count");
+}
+
+- (void)testPerHostCap {
+    self.scheduler.maxConcurrentRequestsPerHost = 1;
+    [self schedule:@"a0" priority:SFRestRequestPriorityNormal host:kSFTestHost];
+    [self schedule:@"a1" priority:SFRestRequestPriorityHigh host:kSFTestHost];
+    [self schedule:@"b0" priority:SFRestRequestPriorityLow host:kSFTestOtherHost];
+    XCTAssertEqualObjects(self.dispatched, (@[@"a0", @"b0"]), @"Saturated host should not block other hosts");
+
+    [self finish:@"a0"];
+    XCTAssertEqualObjects(self.dispatched, (@[@"a0", @"b0", @"a1"]), @"Freed host slot should be used");
+}
+
+- (void)testInteractiveRequestsJumpAheadOfSyncLoad {
+    self.scheduler.maxConcurrentRequests = 1;
+    [self schedule:@"sync0" priority:SFRestRequestPriorityLow host:kSFTestHost];
+    for (NSUInteger i = 1; i < 50; i++) {
+        [self schedule:[NSString stringWithFormat:@"sync%lu", (unsigned long)i] priority:SFRestRequestPriorityLow host:kSFTestHost];
+    }
+    [self schedule:@"interactive" priority:SFRestRequestPriorityHigh host:kSFTestHost];
+    [self finish:@"sync0"];
+    XCTAssertEqualObjects(self.dispatched.lastObject, @"interactive", @"High priority request should be dispatched first");
+    XCTAssertEqual([self.scheduler dispatchedCountForPriority:SFRestRequestPriorityHigh], 1, @"Wrong dispatched count");
+    XCTAssertEqual([self.scheduler dispatchedCountForPriority:SFRestRequestPriorityLow], 1, @"Wrong dispatched count");
+}
+
+- (void)testAgingPreventsStarvation {
+    self.scheduler.maxConcurrentRequests = 1;
+    self.scheduler.agingInterval = 0.05;
+    [self schedule:@"running" priority:SFRestRequestPriorityNormal host:kSFTestHost];
+    [self schedule:@"old" priority:SFRestRequestPriorityLow host:kSFTestHost];
+    [NSThread sleepForTimeInterval:0.25];
+    [self schedule:@"new" priority:SFRestRequestPriorityHigh host:kSFTestHost];
+    [self finish:@"running"];
+    XCTAssertEqualObjects(self.dispatched.lastObject, @"old", @"Request that waited long enough should win over a fresh high priority one");
+    XCTAssertGreaterThanOrEqual([self.scheduler maxWaitTimeForPriority:SFRestRequestPriorityLow], 0.25, @"Wait time should have been recorded");
+    XCTAssertGreaterThan([self.scheduler averageWaitTimeForPriority:SFRestRequestPriorityLow], 0, @"Wait time should have been recorded");
+
+    [self.scheduler resetStatistics];
+    XCTAssertEqual([self.scheduler dispatchedCountForPriority:SFRestRequestPriorityLow], 0, @"Statistics should have been reset");
+    XCTAssertEqual([self.scheduler maxWaitTimeForPriority:SFRestRequestPriorityLow], 0, @"Statistics should have been reset");
+}
+
+- (void)testCancelQueuedRequest {
+    self.scheduler.maxConcurrentRequests = 1;
+    [self schedule:@"running" priority:SFRestRequestPriorityNormal host:kSFTestHost];
+    SFRestRequest *queued = [self schedule:@"queued" priority:SFRestRequestPriorityNormal host:kSFTestHost];
+    __block BOOL cancelled = NO;
+    SFRestRequest *cancelledRequest = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/cancelled" queryParams:nil];
+    [self.scheduler scheduleRequest:cancelledRequest host:kSFTestHost dispatchBlock:^(dispatch_block_t finishBlock) {
+        XCTFail(@"Cancelled request should not be dispatched");
+    } cancelBlock:^{
+        cancelled = YES;
+    }];
+    [cancelledRequest cancel];
+    XCTAssertTrue(cancelled, @"Cancel block should have run");
+    XCTAssertFalse([self.scheduler cancelRequest:cancelledRequest], @"Request should no longer be queued");
+    [self finish:@"running"];
+    XCTAssertEqualObjects(self.dispatched, (@[@"running", @"queued"]), @"Wrong dispatch order");
+    XCTAssertEqual(queued.scheduler, self.scheduler, @"Request should know its scheduler");
+}
+
+#pragma mark - Helper methods
+
+- (SFRestRequest *)schedule:(NSString *)name priority:(SFRestRequestPriority)priority host:(NSString *)host {
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:[@"/" stringByAppendingString:name] queryParams:nil];
+    request.priority = priority;
+    [self.scheduler scheduleRequest:request host:host dispatchBlock:^(dispatch_block_t finishBlock) {
+        [self.dispatched addObject:name];
+        self.finishBlocks[name] = finishBlock;
+    } cancelBlock:nil];
+    return request;
+}
+
+- (void)finish:(NSString *)name {
+    dispatch_block_t finishBlock = self.finishBlocks[name];
+    XCTAssertNotNil(finishBlock, @"Request %@ was not dispatched", name);
+    finishBlock();
+}
+
+@end
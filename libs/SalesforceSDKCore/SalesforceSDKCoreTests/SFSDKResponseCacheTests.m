@@ -0,0 +1,184 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "SFSDKResponseCache.h"
+#import "SFEncryptionKey.h"
+
+static NSString * const kSFTestURL = @"https://test.salesforce.com/services/data/v44.0/sobjects/Account/describe";
+
+@interface SFSDKResponseCacheTests : XCTestCase
+
+@property (nonatomic, copy) NSString *directory;
+@property (nonatomic, strong) SFEncryptionKey *encryptionKey;
+
+@end
+
+@implementation SFSDKResponseCacheTests
+
+- (void)setUp {
+    [super setUp];
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    self.encryptionKey = [SFEncryptionKey createKey];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:nil];
+    [super tearDown];
+}
+
+- (void)testValidatorsAndNotModified {
+    SFSDKResponseCache *cache = [self cacheWithMaxSize:1024 * 1024];
+    NSData *body = [@"{\"name\":\"Account\"}" dataUsingEncoding:NSUTF8StringEncoding];
+
+    // Nothing cached yet
+    NSMutableURLRequest *request = [self requestForURL:kSFTestURL];
+    [cache addValidatorsToRequest:request];
+    XCTAssertNil([request valueForHTTPHeaderField:@"If-None-Match"], @"No validator expected before caching");
+    [cache storeData:body response:[self responseForURL:kSFTestURL headers:@{@"ETag": @"\"v1\"", @"Last-Modified": @"Mon, 01 Oct 2018 10:00:00 GMT"}] forRequest:request];
+    XCTAssertEqual(cache.entryCount, 1, @"Response should have been cached");
+    XCTAssertEqual(cache.missCount, 1, @"Wrong miss count");
+
+    // Validators get added
+    request = [self requestForURL:kSFTestURL];
+    [cache addValidatorsToRequest:request];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"If-None-Match"], @"\"v1\"", @"Wrong If-None-Match");
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"If-Modified-Since"], @"Mon, 01 Oct 2018 10:00:00 GMT", @"Wrong If-Modified-Since");
+
+    // Other Accept header means other entry
+    NSMutableURLRequest *otherRequest = [self requestForURL:kSFTestURL];
+    [otherRequest setValue:@"application/xml" forHTTPHeaderField:@"Accept"];
+    [cache addValidatorsToRequest:otherRequest];
+    XCTAssertNil([otherRequest valueForHTTPHeaderField:@"If-None-Match"], @"Accept header should be part of the key");
+
+    // 304 served from cache
+    NSHTTPURLResponse *cachedResponse = nil;
+    NSData *cachedData = [cache cachedDataForRequest:request response:&cachedResponse];
+    XCTAssertEqualObjects(cachedData, body, @"Wrong cached body");
+    XCTAssertEqual(cachedResponse.statusCode, 200, @"Wrong cached status code");
+    XCTAssertEqualObjects(cachedResponse.allHeaderFields[@"ETag"], @"\"v1\"", @"Wrong cached headers");
+    XCTAssertEqual(cache.hitCount, 1, @"Wrong hit count");
+
+    [cache resetStatistics];
+    XCTAssertEqual(cache.hitCount, 0, @"Statistics should have been reset");
+    XCTAssertEqual(cache.missCount, 0, @"Statistics should have been reset");
+}
+
+- (void)testUncacheableResponses {
+    SFSDKResponseCache *cache = [self cacheWithMaxSize:10];
+    NSMutableURLRequest *request = [self requestForURL:kSFTestURL];
+    NSData *body = [@"{}" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache storeData:body response:[self responseForURL:kSFTestURL headers:@{}] forRequest:request];
+    XCTAssertEqual(cache.entryCount, 0, @"Response without validator should not be cached");
+    [cache storeData:body response:[self responseForURL:kSFTestURL headers:@{@"ETag": @"\"v1\"", @"Cache-Control": @"no-store"}] forRequest:request];
+    XCTAssertEqual(cache.entryCount, 0, @"No-store response should not be cached");
+    [cache storeData:[NSMutableData dataWithLength:11] response:[self responseForURL:kSFTestURL headers:@{@"ETag": @"\"v1\""}] forRequest:request];
+    XCTAssertEqual(cache.entryCount, 0, @"Response bigger than the cache should not be cached");
+}
+
+- (void)testLRUEviction {
+    SFSDKResponseCache *cache = [self cacheWithMaxSize:300];
+    for (NSUInteger i = 0; i < 3; i++) {
+        NSString *url = [NSString stringWithFormat:@"%@/%lu", kSFTestURL, (unsigned long)i];
+        [cache storeData:[NSMutableData dataWithLength:100] response:[self responseForURL:url headers:@{@"ETag": @"\"v1\""}] forRequest:[self requestForURL:url]];
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    XCTAssertEqual(cache.currentSize, 300, @"Wrong cache size");
+
+    // Touch the oldest one, so that the second one is the least recently used
+    XCTAssertNotNil([cache cachedDataForRequest:[self requestForURL:[kSFTestURL stringByAppendingString:@"/0"]] response:nil], @"Entry should be cached");
+    NSString *url = [kSFTestURL stringByAppendingString:@"/3"];
+    [cache storeData:[NSMutableData dataWithLength:100] response:[self responseForURL:url headers:@{@"ETag": @"\"v1\""}] forRequest:[self requestForURL:url]];
+    XCTAssertEqual(cache.currentSize, 300, @"Wrong cache size");
+    XCTAssertEqual(cache.evictionCount, 1, @"Wrong eviction count");
+    XCTAssertNil([cache cachedDataForRequest:[self requestForURL:[kSFTestURL stringByAppendingString:@"/1"]] response:nil], @"Least recently used entry should have been evicted");
+    XCTAssertNotNil([cache cachedDataForRequest:[self requestForURL:[kSFTestURL stringByAppendingString:@"/0"]] response:nil], @"Recently used entry should have been kept");
+}
+
+- (void)testEncryptedAndPersisted {
+    NSData *body = [@"{\"secret\":\"do not store in clear\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableURLRequest *request = [self requestForURL:kSFTestURL];
+    SFSDKResponseCache *savedCache = [self cacheWithMaxSize:1024];
+    [savedCache storeData:body response:[self responseForURL:kSFTestURL headers:@{@"ETag": @"\"v1\""}] forRequest:request];
+    [savedCache flush];
+    for (NSString *file in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directory error:nil]) {
+        NSData *content = [NSData dataWithContentsOfFile:[self.directory stringByAppendingPathComponent:file]];
+        XCTAssertEqual([content rangeOfData:[@"secret" dataUsingEncoding:NSUTF8StringEncoding] options:0 range:NSMakeRange(0, content.length)].location, NSNotFound, @"Cache files should be encrypted");
+        XCTAssertEqual([content rangeOfData:[@"ETag" dataUsingEncoding:NSUTF8StringEncoding] options:0 range:NSMakeRange(0, content.length)].location, NSNotFound, @"Cache index should be encrypted");
+    }
+
+    // A new instance picks up the saved entries
+    SFSDKResponseCache *cache = [self cacheWithMaxSize:1024];
+    XCTAssertEqual(cache.entryCount, 1, @"Entry should have been loaded");
+    XCTAssertEqual(cache.currentSize, body.length, @"Wrong cache size");
+    XCTAssertEqualObjects([cache cachedDataForRequest:request response:nil], body, @"Wrong cached body");
+    [cache removeAllEntries];
+    XCTAssertEqual(cache.entryCount, 0, @"Entries should have been removed");
+    XCTAssertEqual(cache.currentSize, 0, @"Wrong cache size");
+}
+
+- (void)testIndexSavedLazily {
+    NSData *body = [@"{\"name\":\"Account\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableURLRequest *request = [self requestForURL:kSFTestURL];
+    NSString *indexPath = [self.directory stringByAppendingPathComponent:@"index"];
+    SFSDKResponseCache *cache = [self cacheWithMaxSize:1024];
+    [cache storeData:body response:[self responseForURL:kSFTestURL headers:@{@"ETag": @"\"v1\""}] forRequest:request];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:indexPath], @"Index should not be saved on every change");
+    [cache flush];
+    NSData *savedIndex = [NSData dataWithContentsOfFile:indexPath];
+    XCTAssertNotNil(savedIndex, @"Index should have been saved");
+
+    // Hits only touch the index in memory
+    for (NSUInteger i = 0; i < 100; i++) {
+        XCTAssertEqualObjects([cache cachedDataForRequest:request response:nil], body, @"Wrong cached body");
+    }
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:indexPath], savedIndex, @"Index should not be saved on every hit");
+    [cache flush];
+    XCTAssertNotEqualObjects([NSData dataWithContentsOfFile:indexPath], savedIndex, @"Index should have been saved");
+
+    // Bodies missing from the saved index get removed
+    NSString *orphanPath = [self.directory stringByAppendingPathComponent:@"orphan"];
+    [body writeToFile:orphanPath atomically:YES];
+    cache = [self cacheWithMaxSize:1024];
+    XCTAssertEqual(cache.entryCount, 1, @"Entry should have been loaded");
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:orphanPath], @"Unknown body should have been removed");
+}
+
+#pragma mark - Helper methods
+
+- (SFSDKResponseCache *)cacheWithMaxSize:(NSUInteger)maxSize {
+    return [[SFSDKResponseCache alloc] initWithDirectory:self.directory encryptionKey:self.encryptionKey maxSize:maxSize];
+}
+
+- (NSMutableURLRequest *)requestForURL:(NSString *)url {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:url]];
+    request.HTTPMethod = @"GET";
+    return request;
+}
+
+- (NSHTTPURLResponse *)responseForURL:(NSString *)url headers:(NSDictionary<NSString *, NSString *> *)headers {
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:url] statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:headers];
+}
+
+@end
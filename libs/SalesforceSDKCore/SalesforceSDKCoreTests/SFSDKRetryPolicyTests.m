@@ -0,0 +1,148 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "SFSDKRetryPolicy.h"
+#import "SFSDKCircuitBreaker.h"
+
+static NSString * const kSFTestURL = @"https://test.salesforce.com/services/data/v44.0/sobjects/Account";
+
+@interface SFSDKRetryPolicyTests : XCTestCase
+
+@end
+
+@implementation SFSDKRetryPolicyTests
+
+- (void)testTransientFailures {
+    SFSDKRetryPolicy *policy = [[SFSDKRetryPolicy alloc] init];
+    for (NSNumber *statusCode in @[@429, @500, @502, @503, @504]) {
+        XCTAssertTrue([policy isTransientFailure:[self responseWithStatusCode:statusCode.integerValue headers:nil] error:nil], @"%@ should be transient", statusCode);
+    }
+    for (NSNumber *statusCode in @[@200, @304, @400, @401, @404]) {
+        XCTAssertFalse([policy isTransientFailure:[self responseWithStatusCode:statusCode.integerValue headers:nil] error:nil], @"%@ should not be transient", statusCode);
+    }
+    XCTAssertTrue([policy isTransientFailure:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]], @"Timeout should be transient");
+    XCTAssertTrue([policy isTransientFailure:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNetworkConnectionLost userInfo:nil]], @"Dropped connection should be transient");
+    XCTAssertFalse([policy isTransientFailure:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil]], @"Being offline should not be transient");
+}
+
+- (void)testExponentialBackoff {
+    SFSDKRetryPolicy *policy = [[SFSDKRetryPolicy alloc] init];
+    policy.jitter = NO;
+    policy.baseDelay = 1;
+    policy.maxDelay = 3;
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/v44.0/sobjects" queryParams:nil];
+    NSHTTPURLResponse *response = [self responseWithStatusCode:503 headers:nil];
+    XCTAssertEqual([policy retryDelayForRequest:request response:response error:nil retryCount:0], 1, @"Wrong first delay");
+    XCTAssertEqual([policy retryDelayForRequest:request response:response error:nil retryCount:1], 2, @"Wrong second delay");
+    XCTAssertEqual([policy retryDelayForRequest:request response:response error:nil retryCount:2], 3, @"Delay should be capped");
+    XCTAssertLessThan([policy retryDelayForRequest:request response:response error:nil retryCount:3], 0, @"Should not retry beyond max retries");
+    XCTAssertLessThan([policy retryDelayForRequest:request response:[self responseWithStatusCode:400 headers:nil] error:nil retryCount:0], 0, @"Should not retry non transient failures");
+    XCTAssertLessThan([[SFSDKRetryPolicy noRetryPolicy] retryDelayForRequest:request response:response error:nil retryCount:0], 0, @"No retry policy should not retry");
+
+    policy.jitter = YES;
+    for (NSUInteger i = 0; i < 20; i++) {
+        NSTimeInterval delay = [policy retryDelayForRequest:request response:response error:nil retryCount:1];
+        XCTAssertTrue(delay >= 0 && delay <= 2, @"Jittered delay out of range: %f", delay);
+    }
+}
+
+- (void)testNonIdempotentRequests {
+    SFSDKRetryPolicy *policy = [[SFSDKRetryPolicy alloc] init];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:@"/v44.0/sobjects/Account" queryParams:nil];
+    XCTAssertGreaterThanOrEqual([policy retryDelayForRequest:request response:[self responseWithStatusCode:429 headers:nil] error:nil retryCount:0], 0, @"Rejected POST should be retried");
+    XCTAssertGreaterThanOrEqual([policy retryDelayForRequest:request response:[self responseWithStatusCode:503 headers:nil] error:nil retryCount:0], 0, @"Rejected POST should be retried");
+    XCTAssertLessThan([policy retryDelayForRequest:request response:[self responseWithStatusCode:500 headers:nil] error:nil retryCount:0], 0, @"POST that may have been processed should not be retried");
+    XCTAssertLessThan([policy retryDelayForRequest:request response:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil] retryCount:0], 0, @"POST that may have been processed should not be retried");
+}
+
+- (void)testDefaultPolicy {
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/v44.0/sobjects" queryParams:nil];
+    XCTAssertNotNil(request.retryPolicy, @"Requests should be retried by default");
+    XCTAssertEqual(request.retryPolicy.maxRetries, 3, @"Wrong default max retries");
+
+    SFSDKRetryPolicy *defaultPolicy = SFSDKRetryPolicy.defaultPolicy;
+    SFSDKRetryPolicy.defaultPolicy = nil;
+    request = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/v44.0/sobjects" queryParams:nil];
+    XCTAssertNil(request.retryPolicy, @"Requests should not be retried without a default policy");
+    SFSDKRetryPolicy.defaultPolicy = defaultPolicy;
+}
+
+- (void)testRetryAfter {
+    XCTAssertEqual([SFSDKRetryPolicy delayFromRetryAfter:@"7"], 7, @"Wrong delay");
+    XCTAssertLessThan([SFSDKRetryPolicy delayFromRetryAfter:@"soon"], 0, @"Invalid header should be ignored");
+    XCTAssertLessThan([SFSDKRetryPolicy delayFromRetryAfter:nil], 0, @"Missing header should be ignored");
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"GMT"];
+    formatter.dateFormat = @"EEE',' dd MMM yyyy HH':'mm':'ss 'GMT'";
+    NSTimeInterval delay = [SFSDKRetryPolicy delayFromRetryAfter:[formatter stringFromDate:[NSDate dateWithTimeIntervalSinceNow:60]]];
+    XCTAssertTrue(delay > 55 && delay <= 60, @"Wrong delay for HTTP date: %f", delay);
+
+    SFSDKRetryPolicy *policy = [[SFSDKRetryPolicy alloc] init];
+    SFRestRequest *request = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/v44.0/sobjects" queryParams:nil];
+    XCTAssertEqual([policy retryDelayForRequest:request response:[self responseWithStatusCode:429 headers:@{@"Retry-After": @"5"}] error:nil retryCount:0], 5, @"Retry-After should be honored");
+    XCTAssertLessThan([policy retryDelayForRequest:request response:[self responseWithStatusCode:429 headers:@{@"Retry-After": @"3600"}] error:nil retryCount:0], 0, @"Too long Retry-After should not be retried");
+}
+
+- (void)testCircuitBreaker {
+    SFSDKCircuitBreaker *circuitBreaker = [[SFSDKCircuitBreaker alloc] initWithHost:@"test.salesforce.com"];
+    circuitBreaker.failureThreshold = 3;
+    circuitBreaker.openInterval = 0.2;
+    [circuitBreaker recordFailure];
+    [circuitBreaker recordFailure];
+    [circuitBreaker recordSuccess];
+    [circuitBreaker recordFailure];
+    [circuitBreaker recordFailure];
+    XCTAssertFalse(circuitBreaker.isOpen, @"Success should have reset the failure count");
+    [circuitBreaker recordFailure];
+    XCTAssertTrue(circuitBreaker.isOpen, @"Circuit should be open");
+    XCTAssertFalse([circuitBreaker allowRequest], @"Requests should be shed");
+
+    // Failed probe
+    [NSThread sleepForTimeInterval:0.25];
+    XCTAssertTrue([circuitBreaker allowRequest], @"Probe should be let through");
+    XCTAssertFalse([circuitBreaker allowRequest], @"Only one probe should be let through");
+    [circuitBreaker recordFailure];
+    XCTAssertFalse([circuitBreaker allowRequest], @"Circuit should be open again");
+
+    // Successful probe
+    [NSThread sleepForTimeInterval:0.25];
+    XCTAssertTrue([circuitBreaker allowRequest], @"Probe should be let through");
+    [circuitBreaker recordSuccess];
+    XCTAssertFalse(circuitBreaker.isOpen, @"Circuit should be closed");
+    XCTAssertTrue([circuitBreaker allowRequest], @"Requests should go through");
+
+    XCTAssertEqual([SFSDKCircuitBreaker circuitBreakerForHost:@"a.salesforce.com"], [SFSDKCircuitBreaker circuitBreakerForHost:@"a.salesforce.com"], @"Circuit breakers should be shared per host");
+    XCTAssertNotEqual([SFSDKCircuitBreaker circuitBreakerForHost:@"a.salesforce.com"], [SFSDKCircuitBreaker circuitBreakerForHost:@"b.salesforce.com"], @"Circuit breakers should be per host");
+    [SFSDKCircuitBreaker removeAllCircuitBreakers];
+}
+
+#pragma mark - Helper methods
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode headers:(NSDictionary<NSString *, NSString *> *)headers {
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:kSFTestURL] statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:headers];
+}
+
+@end
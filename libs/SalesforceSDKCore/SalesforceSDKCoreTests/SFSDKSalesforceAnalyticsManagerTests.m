@@ -24,6 +24,53 @@
 
 #import <XCTest/XCTest.h>
 #import "SFSDKSalesforceAnalyticsManager+Internal.h"
+#import "SFSDKAILTNPublisher.h"
+#import <SalesforceAnalytics/SFSDKInstrumentationEventBuilder.h>
+
+@interface SFSDKAILTNPublisher (Testing)
+
++ (NSData *) buildRequestBody:(NSArray *) events;
+
+@end
+
+@interface SFSDKTestIdentityTransform : NSObject <SFSDKTransform>
+
+@end
+
+@implementation SFSDKTestIdentityTransform
+
+- (id) transform:(SFSDKInstrumentationEvent *) event {
+    return event;
+}
+
+@end
+
+@interface SFSDKTestRecordingPublisher : NSObject <SFSDKAnalyticsPublisher>
+
+@property (nonatomic, assign) BOOL succeeds;
+@property (nonatomic, strong) NSMutableArray<NSArray *> *publishedChunks;
+
+@end
+
+@implementation SFSDKTestRecordingPublisher
+
+- (instancetype) init {
+    self = [super init];
+    if (self) {
+        _succeeds = YES;
+        _publishedChunks = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void) publish:(NSArray *) events publishCompleteBlock:(PublishCompleteBlock) publishCompleteBlock {
+    [self.publishedChunks addObject:events];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        publishCompleteBlock(self.succeeds, nil);
+    });
+}
+
+@end
 
 @interface SFSDKSalesforceAnalyticsManagerTests : XCTestCase
 
@@ -41,4 +88,90 @@
     XCTAssertEqual(unauthMgr.remotes.count, 0, @"Should be no transforms or publishers for the unauthenticated manager, by default.");
 }
 
+- (void)testPublishAllEventsInChunks {
+    SFSDKSalesforceAnalyticsManager *unauthMgr = [SFSDKSalesforceAnalyticsManager sharedUnauthenticatedInstance];
+    SFSDKTestRecordingPublisher *publisher = [[SFSDKTestRecordingPublisher alloc] init];
+    [unauthMgr addRemotePublisher:[[SFSDKTestIdentityTransform alloc] init] publisher:publisher];
+    [unauthMgr.eventStoreManager deleteAllEvents];
+    [self storeTestEvents:25 manager:unauthMgr];
+    unauthMgr.publishBatchMaxEvents = 10;
+    [self publishAllEvents:unauthMgr expectedSuccess:YES];
+    XCTAssertEqual(publisher.publishedChunks.count, 3, @"Events should have been published in 3 chunks");
+    XCTAssertEqual(publisher.publishedChunks[0].count, 10, @"Chunk should hold at most 10 events");
+    XCTAssertEqual(publisher.publishedChunks[2].count, 5, @"Last chunk should hold the remaining events");
+    XCTAssertEqual(unauthMgr.eventStoreManager.numStoredEvents, 0, @"Published events should have been deleted");
+
+    // Publishing stops at the first chunk that fails, leaving the events in the store
+    publisher.succeeds = NO;
+    [publisher.publishedChunks removeAllObjects];
+    [self storeTestEvents:25 manager:unauthMgr];
+    [self publishAllEvents:unauthMgr expectedSuccess:NO];
+    XCTAssertEqual(publisher.publishedChunks.count, 1, @"Publishing should have stopped after the first chunk");
+    XCTAssertEqual(unauthMgr.eventStoreManager.numStoredEvents, 25, @"Events should still be stored");
+
+    [unauthMgr.eventStoreManager deleteAllEvents];
+    [unauthMgr.remotes removeAllObjects];
+    unauthMgr.publishBatchMaxEvents = 500;
+}
+
+- (void)testPublishToSeveralPublishers {
+    SFSDKSalesforceAnalyticsManager *unauthMgr = [SFSDKSalesforceAnalyticsManager sharedUnauthenticatedInstance];
+    SFSDKTestRecordingPublisher *publisher = [[SFSDKTestRecordingPublisher alloc] init];
+    SFSDKTestRecordingPublisher *failingPublisher = [[SFSDKTestRecordingPublisher alloc] init];
+    failingPublisher.succeeds = NO;
+    [unauthMgr addRemotePublisher:[[SFSDKTestIdentityTransform alloc] init] publisher:publisher];
+    [unauthMgr addRemotePublisher:[[SFSDKTestIdentityTransform alloc] init] publisher:failingPublisher];
+    [unauthMgr.eventStoreManager deleteAllEvents];
+    [self storeTestEvents:5 manager:unauthMgr];
+    [self publishAllEvents:unauthMgr expectedSuccess:NO];
+    XCTAssertEqual(publisher.publishedChunks.count, 1, @"Events should have been published");
+    XCTAssertEqual(failingPublisher.publishedChunks.count, 1, @"Events should have been published");
+    XCTAssertEqual(unauthMgr.eventStoreManager.numStoredEvents, 5, @"Events should be kept until every publisher acknowledged them");
+
+    // Only the publisher that failed gets the events again
+    failingPublisher.succeeds = YES;
+    [self publishAllEvents:unauthMgr expectedSuccess:YES];
+    XCTAssertEqual(publisher.publishedChunks.count, 1, @"Acknowledged events should not have been published again");
+    XCTAssertEqual(failingPublisher.publishedChunks.count, 2, @"Events should have been published again");
+    XCTAssertEqual(unauthMgr.eventStoreManager.numStoredEvents, 0, @"Published events should have been deleted");
+    [unauthMgr.remotes removeAllObjects];
+}
+
+- (void)testAILTNRequestBody {
+    NSArray *events = @[[@{ @"schemaType": @"LightningInteraction", @"id": @"a\"b/c", @"attributes": @{ @"path": @"x\\y" } } mutableCopy]];
+    NSData *body = [SFSDKAILTNPublisher buildRequestBody:events];
+    NSDictionary *bodyDict = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil];
+    XCTAssertNotNil(bodyDict, @"Body should be valid JSON");
+    NSDictionary *logLine = bodyDict[@"logLines"][0];
+    XCTAssertEqualObjects(logLine[@"code"], @"ailtn", @"Wrong code");
+    XCTAssertEqualObjects(logLine[@"data"][@"schemaType"], @"LightningInteraction", @"Wrong schema type");
+    NSData *payloadData = [logLine[@"data"][@"payload"] dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *payload = [NSJSONSerialization JSONObjectWithData:payloadData options:0 error:nil];
+    NSDictionary *expectedPayload = @{ @"id": @"a\"b/c", @"attributes": @{ @"path": @"x\\y" } };
+    XCTAssertEqualObjects(payload, expectedPayload, @"Payload should be the event without its schema type");
+}
+
+- (void)storeTestEvents:(NSUInteger)numEvents manager:(SFSDKSalesforceAnalyticsManager *)manager {
+    for (NSUInteger i = 0; i < numEvents; i++) {
+        SFSDKInstrumentationEvent *event = [SFSDKInstrumentationEventBuilder buildEventWithBuilderBlock:^(SFSDKInstrumentationEventBuilder *builder) {
+            builder.startTime = 1000 * [[NSDate date] timeIntervalSince1970];
+            builder.name = [NSString stringWithFormat:@"TEST_EVENT_%lu", (unsigned long)i];
+            builder.page = @{};
+            builder.schemaType = SchemaTypeError;
+            builder.eventType = EventTypeSystem;
+            builder.errorType = ErrorTypeWarn;
+        } analyticsManager:manager.analyticsManager];
+        [manager.eventStoreManager storeEvent:event];
+    }
+}
+
+- (void)publishAllEvents:(SFSDKSalesforceAnalyticsManager *)manager expectedSuccess:(BOOL)expectedSuccess {
+    XCTestExpectation *published = [self expectationWithDescription:@"published"];
+    [manager publishAllEventsWithCompletion:^(BOOL success) {
+        XCTAssertEqual(success, expectedSuccess, @"Unexpected publishing outcome");
+        [published fulfill];
+    }];
+    [self waitForExpectations:@[published] timeout:10];
+}
+
 @end
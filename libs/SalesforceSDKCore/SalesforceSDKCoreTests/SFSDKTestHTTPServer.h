@@ -0,0 +1,60 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Block producing the body of the response to a request (given its request line, e.g. "GET /path HTTP/1.1").
+ */
+typedef NSData * _Nonnull (^SFSDKTestHTTPServerResponder)(NSString *requestLine);
+
+/**
+ * Minimal HTTP/1.1 server listening on the loopback interface, used by tests that need real TCP connections.
+ * Connections are kept alive, and the number of connections accepted is recorded.
+ */
+@interface SFSDKTestHTTPServer : NSObject
+
+/// Port the server listens on, once started
+@property (nonatomic, readonly) uint16_t port;
+
+/// Base URL of the server (http://127.0.0.1:port), once started
+@property (nonatomic, readonly, nullable) NSURL *baseURL;
+
+/// Number of TCP connections accepted since the server was started
+@property (nonatomic, readonly) NSUInteger acceptedConnections;
+
+/// Number of requests answered since the server was started
+@property (nonatomic, readonly) NSUInteger requestCount;
+
+/// Optional responder, the server answers with an empty JSON object otherwise
+@property (nonatomic, copy, nullable) SFSDKTestHTTPServerResponder responder;
+
+- (BOOL)start;
+- (void)stop;
+
+@end
+
+NS_ASSUME_NONNULL_END
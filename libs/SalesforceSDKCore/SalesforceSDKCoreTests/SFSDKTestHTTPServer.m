@@ -0,0 +1,173 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKTestHTTPServer.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+static NSString * const kHeadersEnd = @"\r\n\r\n";
+
+@interface SFSDKTestHTTPServer ()
+
+@property (nonatomic, readwrite) uint16_t port;
+@property (nonatomic, readwrite) NSUInteger acceptedConnections;
+@property (nonatomic, readwrite) NSUInteger requestCount;
+@property (nonatomic, assign) int listenSocket;
+@property (nonatomic, strong) NSMutableSet<NSNumber *> *connectionSockets;
+@property (nonatomic, strong) dispatch_queue_t acceptQueue;
+
+@end
+
+@implementation SFSDKTestHTTPServer
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _listenSocket = -1;
+        _connectionSockets = [NSMutableSet new];
+        _acceptQueue = dispatch_queue_create("com.salesforce.test.httpserver.accept", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+- (NSURL *)baseURL {
+    return self.port > 0 ? [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%u", self.port]] : nil;
+}
+
+- (BOOL)start {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return NO;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_len = sizeof(addr);
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0
+        || listen(fd, 16) != 0
+        || getsockname(fd, (struct sockaddr *)&addr, &addrLen) != 0) {
+        close(fd);
+        return NO;
+    }
+    self.listenSocket = fd;
+    self.port = ntohs(addr.sin_port);
+
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(self.acceptQueue, ^{
+        while (YES) {
+            int connection = accept(fd, NULL, NULL);
+            if (connection < 0) {
+                return; // listening socket closed
+            }
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) {
+                close(connection);
+                return;
+            }
+            @synchronized (strongSelf) {
+                strongSelf.acceptedConnections++;
+                [strongSelf.connectionSockets addObject:@(connection)];
+            }
+            dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                [weakSelf serveConnection:connection];
+            });
+        }
+    });
+    return YES;
+}
+
+- (void)stop {
+    if (self.listenSocket >= 0) {
+        shutdown(self.listenSocket, SHUT_RDWR);
+        close(self.listenSocket);
+        self.listenSocket = -1;
+    }
+    @synchronized (self) {
+        for (NSNumber *connection in self.connectionSockets) {
+            shutdown(connection.intValue, SHUT_RDWR);
+        }
+        [self.connectionSockets removeAllObjects];
+    }
+}
+
+#pragma mark - Private methods
+
+- (void)serveConnection:(int)connection {
+    NSMutableData *buffer = [NSMutableData new];
+    uint8_t chunk[4096];
+    while (YES) {
+        // Waiting for a complete request (headers and body)
+        NSRange headersEnd;
+        NSUInteger contentLength = 0;
+        while (YES) {
+            headersEnd = [buffer rangeOfData:[kHeadersEnd dataUsingEncoding:NSUTF8StringEncoding] options:0 range:NSMakeRange(0, buffer.length)];
+            if (headersEnd.location != NSNotFound) {
+                NSString *headers = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, headersEnd.location)] encoding:NSUTF8StringEncoding];
+                for (NSString *line in [headers componentsSeparatedByString:@"\r\n"]) {
+                    if ([line.lowercaseString hasPrefix:@"content-length:"]) {
+                        contentLength = (NSUInteger)[[line substringFromIndex:15] integerValue];
+                    }
+                }
+                if (buffer.length >= NSMaxRange(headersEnd) + contentLength) {
+                    break;
+                }
+            }
+            ssize_t count = recv(connection, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                close(connection);
+                @synchronized (self) {
+                    [self.connectionSockets removeObject:@(connection)];
+                }
+                return;
+            }
+            [buffer appendBytes:chunk length:(NSUInteger)count];
+        }
+
+        NSString *headers = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, headersEnd.location)] encoding:NSUTF8StringEncoding];
+        NSString *requestLine = [headers componentsSeparatedByString:@"\r\n"].firstObject;
+        [buffer replaceBytesInRange:NSMakeRange(0, NSMaxRange(headersEnd) + contentLength) withBytes:NULL length:0];
+
+        NSData *body = self.responder ? self.responder(requestLine) : [@"{}" dataUsingEncoding:NSUTF8StringEncoding];
+        NSString *responseHeaders = [NSString stringWithFormat:@"HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %lu\r\nConnection: keep-alive\r\n\r\n", (unsigned long)body.length];
+        NSMutableData *response = [[responseHeaders dataUsingEncoding:NSUTF8StringEncoding] mutableCopy];
+        [response appendData:body];
+        @synchronized (self) {
+            self.requestCount++;
+        }
+        send(connection, response.bytes, response.length, 0);
+    }
+}
+
+@end
@@ -26,7 +26,10 @@
 #import <SalesforceSDKCore/SalesforceSDKCore.h>
 #import "SFRestAPI+Internal.h"
 #import "SFRestRequest+Internal.h"
+#import "SFSDKRequestBatcher.h"
+#import "SFSDKRequestCoalescer.h"
 #import "SFNativeRestRequestListener.h"
+#import <SalesforceSDKCommon/SFJsonUtils.h>
 #import "SFUserAccount+Internal.h"
 #import "SFOAuthCredentials+Internal.h"
 #import "SFUserAccountManager+Internal.h"
@@ -129,6 +132,9 @@ static NSException *authException = nil;
 - (void)tearDown
 {
     // Tear-down code here.
+    [SFSDKTestStandInServer stop];
+    [SFRestAPI sharedInstance].autoBatchingEnabled = NO;
+    [SFSDKCircuitBreaker removeAllCircuitBreakers];
     if (self.dataCleanupRequired) {
         [self cleanup];
     }
@@ -809,6 +815,681 @@ static NSException *authException = nil;
      XCTAssertEqualObjects(contactId, queryRecords[0][ID], "Contact id not returned by query");
  }
 
+ // Test for auto batching
+ // Send (with auto batching enabled) requests that:
+ // - create an account,
+ // - query for an account that does not exist,
+ // - delete an account that does not exist
+ // Then make sure each delegate got its own response
+ - (void) testAutoBatchedRequests {
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     restApi.autoBatchingEnabled = YES;
+     NSString *accountName = [self generateRecordName];
+     SFRestRequest *createRequest = [restApi requestForCreateWithObjectType:ACCOUNT fields:@{NAME: accountName}];
+     SFRestRequest *queryRequest = [restApi requestForQuery:[NSString stringWithFormat:@"select Id from Account where Name = '%@_missing'", accountName]];
+     SFRestRequest *deleteRequest = [restApi requestForDeleteWithObjectType:ACCOUNT objectId:@"001000000000000AAA"];
+     SFNativeRestRequestListener *createListener = [[SFNativeRestRequestListener alloc] initWithRequest:createRequest];
+     SFNativeRestRequestListener *queryListener = [[SFNativeRestRequestListener alloc] initWithRequest:queryRequest];
+     SFNativeRestRequestListener *deleteListener = [[SFNativeRestRequestListener alloc] initWithRequest:deleteRequest];
+     [restApi send:createRequest delegate:createListener];
+     [restApi send:queryRequest delegate:queryListener];
+     [restApi send:deleteRequest delegate:deleteListener];
+     restApi.autoBatchingEnabled = NO;
+
+     XCTAssertEqualObjects([createListener waitForCompletion], kTestRequestStatusDidLoad, @"Create request failed");
+     XCTAssertNotNil(createListener.dataResponse[LID], @"Id of created account missing");
+     XCTAssertEqualObjects([queryListener waitForCompletion], kTestRequestStatusDidLoad, @"Query request failed");
+     XCTAssertEqual(0, [queryListener.dataResponse[RECORDS] count], @"Query should not have returned records");
+     XCTAssertEqualObjects([deleteListener waitForCompletion], kTestRequestStatusDidFail, @"Delete request should have failed");
+     XCTAssertEqual(404, deleteListener.lastError.code, @"Wrong error code for delete request");
+ }
+
+ // Test for auto batching against the stand-in server
+ // Send (with auto batching enabled) three requests, a custom endpoint request and a single batched request
+ // Then make sure only the batchable requests went through a single composite request
+ - (void) testAutoBatchingWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         if (![request.URL.path hasSuffix:@"/composite"]) {
+             return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"custom": @YES}];
+         }
+         NSMutableArray *subresponses = [NSMutableArray array];
+         for (NSDictionary *subrequest in [SFJsonUtils objectFromJSONData:body][@"compositeRequest"]) {
+             BOOL missing = [subrequest[@"url"] containsString:@"missing"];
+             [subresponses addObject:@{@"referenceId": subrequest[@"referenceId"],
+                                       HTTP_STATUS_CODE: missing ? @404 : @200,
+                                       @"httpHeaders": @{},
+                                       BODY: missing ? @[@{@"errorCode": @"NOT_FOUND"}] : @{@"url": subrequest[@"url"]}}];
+         }
+         return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{COMPOSITE_RESPONSE: subresponses}];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     restApi.autoBatchingEnabled = YES;
+     restApi.autoBatchingWindow = 0.2;
+     NSArray<SFRestRequest *> *requests = @[[restApi requestForQuery:@"select Id from Account"],
+                                            [restApi requestForDeleteWithObjectType:ACCOUNT objectId:@"001missing"],
+                                            [restApi requestForQueryAll:@"select Id from Account"],
+                                            [SFRestRequest customEndPointRequestWithMethod:SFRestMethodGET endPoint:@"/services/apexrest" path:@"/custom" queryParams:nil]];
+     NSMutableArray<SFNativeRestRequestListener *> *listeners = [NSMutableArray array];
+     for (SFRestRequest *request in requests) {
+         SFNativeRestRequestListener *listener = [[SFNativeRestRequestListener alloc] initWithRequest:request];
+         [listeners addObject:listener];
+         [restApi send:request delegate:listener];
+     }
+     for (SFNativeRestRequestListener *listener in listeners) {
+         [listener waitForCompletion];
+     }
+     XCTAssertEqualObjects(listeners[0].returnStatus, kTestRequestStatusDidLoad, @"Query request failed");
+     XCTAssertTrue([listeners[0].dataResponse[@"url"] containsString:@"/query"], @"Query request got the wrong response");
+     XCTAssertEqualObjects(listeners[1].returnStatus, kTestRequestStatusDidFail, @"Delete request should have failed");
+     XCTAssertEqual(404, listeners[1].lastError.code, @"Wrong error code for delete request");
+     XCTAssertEqualObjects(listeners[1].lastError.userInfo[@"error"][0][@"errorCode"], @"NOT_FOUND", @"Wrong error for delete request");
+     XCTAssertEqualObjects(listeners[2].returnStatus, kTestRequestStatusDidLoad, @"QueryAll request failed");
+     XCTAssertTrue([listeners[2].dataResponse[@"url"] containsString:@"/queryAll"], @"QueryAll request got the wrong response");
+     XCTAssertEqualObjects(listeners[3].returnStatus, kTestRequestStatusDidLoad, @"Custom endpoint request failed");
+     XCTAssertEqualObjects(listeners[3].dataResponse[@"custom"], @YES, @"Custom endpoint request got the wrong response");
+     XCTAssertEqual(2, [SFSDKTestStandInServer receivedRequests].count, @"Batchable requests should have gone in a single composite request");
+
+     // A lone request is sent as is
+     SFRestRequest *loneRequest = [restApi requestForQuery:@"select Id from Contact"];
+     SFNativeRestRequestListener *loneListener = [[SFNativeRestRequestListener alloc] initWithRequest:loneRequest];
+     [restApi send:loneRequest delegate:loneListener];
+     XCTAssertEqualObjects([loneListener waitForCompletion], kTestRequestStatusDidLoad, @"Lone request failed");
+     XCTAssertTrue([[SFSDKTestStandInServer receivedRequests].lastObject.URL.path hasSuffix:@"/query"], @"Lone request should not have been batched");
+     restApi.autoBatchingEnabled = NO;
+     [SFSDKTestStandInServer stop];
+ }
+
+ // Test for the query limit of auto batching against the stand-in server
+ // Send (with auto batching enabled) seven queries
+ // Then make sure no composite request carried more than five of them
+ - (void) testAutoBatchingQueryLimitWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         NSMutableArray *subresponses = [NSMutableArray array];
+         for (NSDictionary *subrequest in [SFJsonUtils objectFromJSONData:body][@"compositeRequest"]) {
+             [subresponses addObject:@{@"referenceId": subrequest[@"referenceId"],
+                                       HTTP_STATUS_CODE: @200,
+                                       @"httpHeaders": @{},
+                                       BODY: @{@"url": subrequest[@"url"]}}];
+         }
+         return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{COMPOSITE_RESPONSE: subresponses}];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     restApi.autoBatchingEnabled = YES;
+     restApi.autoBatchingWindow = 0.2;
+     NSMutableArray<SFNativeRestRequestListener *> *listeners = [NSMutableArray array];
+     for (NSUInteger i = 0; i < 7; i++) {
+         SFRestRequest *request = [restApi requestForQuery:[NSString stringWithFormat:@"select Id from Account limit %lu", (unsigned long)i + 1]];
+         SFNativeRestRequestListener *listener = [[SFNativeRestRequestListener alloc] initWithRequest:request];
+         [listeners addObject:listener];
+         [restApi send:request delegate:listener];
+     }
+     for (SFNativeRestRequestListener *listener in listeners) {
+         XCTAssertEqualObjects([listener waitForCompletion], kTestRequestStatusDidLoad, @"Query request failed");
+     }
+     XCTAssertEqual(2, [SFSDKTestStandInServer receivedRequests].count, @"Queries should have gone in two composite requests");
+     NSArray *firstSubrequests = [SFJsonUtils objectFromJSONData:[SFSDKTestStandInServer receivedBodies].firstObject][@"compositeRequest"];
+     XCTAssertEqual(5, firstSubrequests.count, @"A composite request should carry at most five queries");
+     restApi.autoBatchingEnabled = NO;
+     [SFSDKTestStandInServer stop];
+ }
+
+ // Test for the cancellation of batched requests against the stand-in server
+ // Cancel a request waiting for its batch to go out, then one whose composite request is in flight
+ // Then make sure only their delegates got notified of the cancellation and the others got their response
+ - (void) testCancelBatchedRequestsWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         NSMutableArray *subresponses = [NSMutableArray array];
+         for (NSDictionary *subrequest in [SFJsonUtils objectFromJSONData:body][@"compositeRequest"]) {
+             [subresponses addObject:@{@"referenceId": subrequest[@"referenceId"],
+                                       HTTP_STATUS_CODE: @200,
+                                       @"httpHeaders": @{},
+                                       BODY: @{@"url": subrequest[@"url"]}}];
+         }
+         SFSDKStandInResponse *response = [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{COMPOSITE_RESPONSE: subresponses}];
+         response.delay = 0.5;
+         return response;
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     restApi.autoBatchingEnabled = YES;
+     restApi.autoBatchingWindow = 0.2;
+
+     // Still pending
+     NSArray<SFRestRequest *> *requests = @[[restApi requestForQuery:@"select Id from Account"],
+                                            [restApi requestForQuery:@"select Id from Contact"],
+                                            [restApi requestForQuery:@"select Id from Lead"]];
+     NSMutableArray<SFNativeRestRequestListener *> *listeners = [NSMutableArray array];
+     for (SFRestRequest *request in requests) {
+         SFNativeRestRequestListener *listener = [[SFNativeRestRequestListener alloc] initWithRequest:request];
+         [listeners addObject:listener];
+         [restApi send:request delegate:listener];
+     }
+     [requests[1] cancel];
+     XCTAssertEqualObjects([listeners[1] waitForCompletion], kTestRequestStatusDidCancel, @"Request should have been cancelled");
+     XCTAssertEqualObjects([listeners[0] waitForCompletion], kTestRequestStatusDidLoad, @"Request failed");
+     XCTAssertEqualObjects([listeners[2] waitForCompletion], kTestRequestStatusDidLoad, @"Request failed");
+     XCTAssertEqual(1, [SFSDKTestStandInServer receivedRequests].count, @"Requests should have gone in a single composite request");
+     NSArray *subrequests = [SFJsonUtils objectFromJSONData:[SFSDKTestStandInServer receivedBodies].lastObject][@"compositeRequest"];
+     XCTAssertEqual(2, subrequests.count, @"Cancelled request should not have been sent");
+
+     // In flight
+     requests = @[[restApi requestForQuery:@"select Id from Case"],
+                  [restApi requestForQuery:@"select Id from Task"]];
+     [listeners removeAllObjects];
+     for (SFRestRequest *request in requests) {
+         SFNativeRestRequestListener *listener = [[SFNativeRestRequestListener alloc] initWithRequest:request];
+         [listeners addObject:listener];
+         [restApi send:request delegate:listener];
+     }
+     [restApi.requestBatcher flush];
+     [requests[0] cancel];
+     XCTAssertEqualObjects([listeners[0] waitForCompletion], kTestRequestStatusDidCancel, @"Request should have been cancelled");
+     XCTAssertEqualObjects([listeners[1] waitForCompletion], kTestRequestStatusDidLoad, @"Request failed");
+     XCTAssertTrue([listeners[1].dataResponse[@"url"] containsString:@"Task"], @"Request got the wrong response");
+     XCTAssertEqualObjects(listeners[0].returnStatus, kTestRequestStatusDidCancel, @"Cancelled request should not have been delivered");
+     restApi.autoBatchingEnabled = NO;
+     [SFSDKTestStandInServer stop];
+ }
+
+ // Test for conditional GET cache against the stand-in server
+ // Send the same describe request three times, the server returning 304 when the ETag matches
+ // Then make sure the cached body got served and the hit/miss stats are right
+ - (void) testConditionalCacheWithStandInServer {
+     self.dataCleanupRequired = NO;
+     __block NSString *currentETag = @"\"v1\"";
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         if ([[request valueForHTTPHeaderField:@"If-None-Match"] isEqualToString:currentETag]) {
+             return [SFSDKStandInResponse responseWithStatusCode:304 headers:@{@"ETag": currentETag} data:nil];
+         }
+         NSData *data = [SFJsonUtils JSONDataRepresentation:@{NAME: ACCOUNT, @"version": currentETag}];
+         return [SFSDKStandInResponse responseWithStatusCode:200 headers:@{@"ETag": currentETag, @"Content-Type": @"application/json"} data:data];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     [restApi.responseCache removeAllEntries];
+     [restApi.responseCache resetStatistics];
+
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:[restApi requestForDescribeWithObjectType:ACCOUNT]];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"First request failed");
+     XCTAssertNil([[SFSDKTestStandInServer receivedRequests].lastObject valueForHTTPHeaderField:@"If-None-Match"], @"First request should not be conditional");
+
+     listener = [self sendSyncRequest:[restApi requestForDescribeWithObjectType:ACCOUNT]];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Second request failed");
+     XCTAssertEqualObjects([[SFSDKTestStandInServer receivedRequests].lastObject valueForHTTPHeaderField:@"If-None-Match"], @"\"v1\"", @"Second request should be conditional");
+     XCTAssertEqualObjects(listener.dataResponse[NAME], ACCOUNT, @"Cached body should have been served");
+     XCTAssertEqualObjects(listener.dataResponse[@"version"], @"\"v1\"", @"Cached body should have been served");
+     XCTAssertEqual(restApi.responseCache.hitCount, 1, @"Wrong hit count");
+
+     // Changed on the server
+     currentETag = @"\"v2\"";
+     listener = [self sendSyncRequest:[restApi requestForDescribeWithObjectType:ACCOUNT]];
+     XCTAssertEqualObjects(listener.dataResponse[@"version"], @"\"v2\"", @"New body should have been served");
+     XCTAssertEqual(restApi.responseCache.hitCount, 1, @"Wrong hit count");
+     XCTAssertEqual(restApi.responseCache.missCount, 2, @"Wrong miss count");
+     XCTAssertEqual(restApi.responseCache.entryCount, 1, @"New body should have replaced the cached one");
+
+     // Cached body gone, the request goes again without validators
+     [restApi.responseCache removeAllEntries];
+     SFRestRequest *request = [restApi requestForDescribeWithObjectType:ACCOUNT];
+     [request setHeaderValue:currentETag forHeaderName:@"If-None-Match"];
+     NSUInteger requestCount = [SFSDKTestStandInServer receivedRequests].count;
+     listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Request should have been sent again");
+     XCTAssertEqualObjects(listener.dataResponse[@"version"], @"\"v2\"", @"Full body should have been served");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, requestCount + 2, @"Request should have been sent twice");
+     XCTAssertNil([[SFSDKTestStandInServer receivedRequests].lastObject valueForHTTPHeaderField:@"If-None-Match"], @"Second request should not be conditional");
+     [restApi.responseCache removeAllEntries];
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testRetryOnTransientFailuresWithStandInServer {
+     self.dataCleanupRequired = NO;
+     __block NSUInteger requestCount = 0;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         requestCount++;
+         switch (requestCount) {
+             case 1: return [SFSDKStandInResponse responseWithStatusCode:503 jsonObject:@[@{@"errorCode": @"SERVER_UNAVAILABLE"}]];
+             case 2: return [SFSDKStandInResponse responseWithStatusCode:429 headers:@{@"Retry-After": @"1"} data:nil];
+             case 3: return [SFSDKStandInResponse responseWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNetworkConnectionLost userInfo:nil]];
+             default: return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{NAME: ACCOUNT}];
+         }
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     SFRestRequest *request = [restApi requestForDescribeWithObjectType:ACCOUNT];
+     request.retryPolicy.baseDelay = 0.05;
+     request.retryPolicy.maxRetries = 3;
+     NSDate *start = [NSDate date];
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Request should have succeeded after retries");
+     XCTAssertEqualObjects(listener.dataResponse[NAME], ACCOUNT, @"Wrong response");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 4, @"Request should have been sent four times");
+     XCTAssertGreaterThanOrEqual([[NSDate date] timeIntervalSinceDate:start], 1.0, @"Retry-After should have been honored");
+     [SFSDKTestStandInServer stop];
+
+     // Retries exhausted
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:502 jsonObject:@[@{@"errorCode": @"BAD_GATEWAY"}]];
+     }];
+     request = [restApi requestForDescribeWithObjectType:ACCOUNT];
+     request.retryPolicy.baseDelay = 0.05;
+     request.retryPolicy.maxRetries = 2;
+     listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidFail, @"Request should have failed");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 3, @"Request should have been sent three times");
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testNoRetryOfNonIdempotentRequestWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:500 jsonObject:@[@{@"errorCode": @"UNKNOWN_EXCEPTION"}]];
+     }];
+     SFRestRequest *request = [[SFRestAPI sharedInstance] requestForCreateWithObjectType:ACCOUNT fields:@{NAME: [self generateRecordName]}];
+     request.retryPolicy.baseDelay = 0.05;
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidFail, @"Request should have failed");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 1, @"POST should not have been retried");
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testCircuitBreakerWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:503 jsonObject:@[@{@"errorCode": @"SERVER_UNAVAILABLE"}]];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     SFSDKCircuitBreaker *circuitBreaker = [SFSDKCircuitBreaker circuitBreakerForHost:restApi.user.credentials.instanceUrl.host];
+     circuitBreaker.failureThreshold = 2;
+     circuitBreaker.openInterval = 60;
+     for (NSUInteger i = 0; i < 2; i++) {
+         SFRestRequest *request = [restApi requestForDescribeWithObjectType:ACCOUNT];
+         request.retryPolicy = [SFSDKRetryPolicy noRetryPolicy];
+         SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+         XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidFail, @"Request should have failed");
+     }
+     XCTAssertTrue(circuitBreaker.isOpen, @"Circuit should be open");
+
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:[restApi requestForDescribeWithObjectType:ACCOUNT]];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidFail, @"Request should have failed fast");
+     XCTAssertEqualObjects(listener.lastError.domain, kSFRestErrorDomain, @"Wrong error domain");
+     XCTAssertEqual(listener.lastError.code, kSFRestCircuitOpenErrorCode, @"Wrong error code");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 2, @"Request should not have reached the server");
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testDownloadToFileWithStandInServer {
+     self.dataCleanupRequired = NO;
+     NSMutableData *content = [NSMutableData dataWithLength:1024 * 1024];
+     for (NSUInteger i = 0; i < content.length; i++) {
+         ((uint8_t *)content.mutableBytes)[i] = (uint8_t)(i % 251);
+     }
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         if ([request.URL.path hasSuffix:@"/missing/content"]) {
+             return [SFSDKStandInResponse responseWithStatusCode:404 jsonObject:@[@{@"errorCode": @"NOT_FOUND"}]];
+         }
+         return [SFSDKStandInResponse responseWithStatusCode:200 headers:@{@"Content-Type": @"application/octet-stream", @"Content-Length": [NSString stringWithFormat:@"%lu", (unsigned long)content.length]} data:content];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     NSURL *destinationURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+
+     // Plain download
+     __block int64_t lastTransferred = 0;
+     __block int64_t lastExpected = 0;
+     SFRestRequest *request = [restApi requestForFileContents:@"someid" version:nil destinationURL:destinationURL];
+     request.progressBlock = ^(int64_t bytesTransferred, int64_t totalBytesExpected) {
+         lastTransferred = bytesTransferred;
+         lastExpected = totalBytesExpected;
+     };
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Download failed");
+     XCTAssertEqualObjects(listener.dataResponse, destinationURL, @"Delegate should have received the destination URL");
+     XCTAssertEqualObjects([NSData dataWithContentsOfURL:destinationURL], content, @"Wrong file contents");
+     XCTAssertEqual(lastTransferred, (int64_t)content.length, @"Progress should have been reported");
+     XCTAssertEqual(lastExpected, (int64_t)content.length, @"Progress should have been reported");
+
+     // Encrypted download
+     SFEncryptionKey *encryptionKey = [[SFEncryptionKey alloc] initWithData:[SFSDKCryptoUtils randomByteDataWithLength:SFCryptChunksCipherKeySize] initializationVector:[SFSDKCryptoUtils randomByteDataWithLength:SFCryptChunksCipherBlockSize]];
+     request = [restApi requestForBlobWithObjectType:@"ContentVersion" objectId:@"someid" fieldName:@"VersionData" destinationURL:destinationURL];
+     request.downloadEncryptionKey = encryptionKey;
+     listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Download failed");
+     XCTAssertNotEqualObjects([NSData dataWithContentsOfURL:destinationURL], content, @"File should be encrypted");
+     SFDecryptStream *decryptStream = [[SFDecryptStream alloc] initWithFileAtPath:destinationURL.path];
+     [decryptStream setupWithDecryptionKey:encryptionKey];
+     [decryptStream open];
+     NSMutableData *decrypted = [NSMutableData data];
+     uint8_t buffer[4096];
+     NSInteger bytesRead = 0;
+     while ((bytesRead = [decryptStream read:buffer maxLength:sizeof(buffer)]) > 0) {
+         [decrypted appendBytes:buffer length:bytesRead];
+     }
+     [decryptStream close];
+     XCTAssertEqualObjects(decrypted, content, @"Wrong decrypted contents");
+
+     // Failed download
+     request = [restApi requestForFileContents:@"missing" version:nil destinationURL:destinationURL];
+     listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidFail, @"Download should have failed");
+     XCTAssertEqual(listener.lastError.code, 404, @"Wrong error code");
+     [[NSFileManager defaultManager] removeItemAtURL:destinationURL error:nil];
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testStreamedUploadWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:201 jsonObject:@{LID: @"someid"}];
+     }];
+     NSMutableData *content = [NSMutableData dataWithLength:512 * 1024];
+     for (NSUInteger i = 0; i < content.length; i++) {
+         ((uint8_t *)content.mutableBytes)[i] = (uint8_t)(i % 241);
+     }
+     NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+     NSURL *fileURL = [NSURL fileURLWithPath:path];
+     [content writeToURL:fileURL atomically:YES];
+
+     // Plain file
+     SFRestRequest *request = [[SFRestAPI sharedInstance] requestForUploadFileAtURL:fileURL name:@"file.bin" description:@"streamed" mimeType:nil decryptionKey:nil];
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Upload failed");
+     NSData *body = [SFSDKTestStandInServer receivedBodies].lastObject;
+     NSURLRequest *receivedRequest = [SFSDKTestStandInServer receivedRequests].lastObject;
+     XCTAssertTrue([[receivedRequest valueForHTTPHeaderField:@"Content-Type"] hasPrefix:@"multipart/form-data; boundary="], @"Wrong content type");
+     XCTAssertEqual([[receivedRequest valueForHTTPHeaderField:@"Content-Length"] integerValue], (NSInteger)body.length, @"Wrong content length");
+     XCTAssertNotEqual([body rangeOfData:content options:0 range:NSMakeRange(0, body.length)].location, NSNotFound, @"File should have been sent");
+     NSString *boundary = [[receivedRequest valueForHTTPHeaderField:@"Content-Type"] componentsSeparatedByString:@"boundary="].lastObject;
+     NSData *trailer = [[NSString stringWithFormat:@"\r\n--%@--\r\n", boundary] dataUsingEncoding:NSUTF8StringEncoding];
+     XCTAssertEqualObjects([body subdataWithRange:NSMakeRange(body.length - trailer.length, trailer.length)], trailer, @"Body should end with the closing boundary");
+
+     // Encrypted file
+     SFEncryptionKey *encryptionKey = [[SFEncryptionKey alloc] initWithData:[SFSDKCryptoUtils randomByteDataWithLength:SFCryptChunksCipherKeySize] initializationVector:[SFSDKCryptoUtils randomByteDataWithLength:SFCryptChunksCipherBlockSize]];
+     SFEncryptStream *encryptStream = [[SFEncryptStream alloc] initToFileAtPath:path append:NO];
+     [encryptStream setupWithEncryptionKey:encryptionKey];
+     [encryptStream open];
+     [encryptStream write:content.bytes maxLength:content.length];
+     [encryptStream close];
+     request = [[SFRestAPI sharedInstance] requestForUploadFileAtURL:fileURL name:@"file.bin" description:@"streamed" mimeType:nil decryptionKey:encryptionKey];
+     listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Upload failed");
+     body = [SFSDKTestStandInServer receivedBodies].lastObject;
+     XCTAssertNotEqual([body rangeOfData:content options:0 range:NSMakeRange(0, body.length)].location, NSNotFound, @"Decrypted file should have been sent");
+     [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testDeliveryQueueAndLazyParsingWithStandInServer {
+     self.dataCleanupRequired = NO;
+     NSMutableArray *records = [NSMutableArray array];
+     for (NSUInteger i = 0; i < 50000; i++) {
+         [records addObject:@{ID: [NSString stringWithFormat:@"001%015lu", (unsigned long)i], NAME: [NSString stringWithFormat:@"Account %lu", (unsigned long)i]}];
+     }
+     NSDictionary *queryResponse = @{@"totalSize": @(records.count), @"done": @YES, @"records": records};
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:queryResponse];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+
+     // Delivered on the main queue, parsed elsewhere
+     SFRestRequest *request = [restApi requestForQuery:@"SELECT Id, Name FROM Account"];
+     request.deliveryQueue = dispatch_get_main_queue();
+     XCTestExpectation *mainQueueDelivery = [self expectationWithDescription:@"mainQueueDelivery"];
+     [restApi sendRESTRequest:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+         XCTFail(@"Request failed: %@", e);
+         [mainQueueDelivery fulfill];
+     } completeBlock:^(id response, NSURLResponse *rawResponse) {
+         XCTAssertTrue([NSThread isMainThread], @"Response should have been delivered on the main queue");
+         XCTAssertEqual([response[@"records"] count], records.count, @"Wrong number of records");
+         [mainQueueDelivery fulfill];
+     }];
+     [self waitForExpectationsWithTimeout:30 handler:nil];
+
+     // Delivered on a custom queue
+     static void *kDeliveryQueueKey = &kDeliveryQueueKey;
+     dispatch_queue_t deliveryQueue = dispatch_queue_create("com.salesforce.test.delivery", DISPATCH_QUEUE_SERIAL);
+     dispatch_queue_set_specific(deliveryQueue, kDeliveryQueueKey, kDeliveryQueueKey, NULL);
+     request = [restApi requestForQuery:@"SELECT Id, Name FROM Account"];
+     request.deliveryQueue = deliveryQueue;
+     XCTestExpectation *customQueueDelivery = [self expectationWithDescription:@"customQueueDelivery"];
+     [restApi sendRESTRequest:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+         XCTFail(@"Request failed: %@", e);
+         [customQueueDelivery fulfill];
+     } completeBlock:^(id response, NSURLResponse *rawResponse) {
+         XCTAssertTrue(dispatch_get_specific(kDeliveryQueueKey) == kDeliveryQueueKey, @"Response should have been delivered on the delivery queue");
+         [customQueueDelivery fulfill];
+     }];
+     [self waitForExpectationsWithTimeout:30 handler:nil];
+
+     // Delivered off the parse queue by default, one at a time
+     NSUInteger defaultCount = 3;
+     __block NSInteger runningDelegates = 0;
+     __block NSInteger maxRunningDelegates = 0;
+     XCTestExpectation *defaultDelivery = [self expectationWithDescription:@"defaultDelivery"];
+     defaultDelivery.expectedFulfillmentCount = defaultCount;
+     for (NSUInteger i = 0; i < defaultCount; i++) {
+         request = [restApi requestForQuery:[NSString stringWithFormat:@"SELECT Id, Name FROM Account LIMIT %lu", (unsigned long)(i + 1)]];
+         [restApi sendRESTRequest:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+             XCTFail(@"Request failed: %@", e);
+             [defaultDelivery fulfill];
+         } completeBlock:^(id response, NSURLResponse *rawResponse) {
+             XCTAssertNotEqual([NSOperationQueue currentQueue], [SFRestAPI responseParsingQueue], @"Response should not have been delivered on the parse queue");
+             @synchronized (records) {
+                 maxRunningDelegates = MAX(maxRunningDelegates, ++runningDelegates);
+             }
+             [NSThread sleepForTimeInterval:0.2];
+             @synchronized (records) {
+                 runningDelegates--;
+             }
+             [defaultDelivery fulfill];
+         }];
+     }
+     [self waitForExpectationsWithTimeout:30 handler:nil];
+     XCTAssertEqual(maxRunningDelegates, 1, @"Delegates should have been notified one at a time");
+
+     // Parsed lazily
+     request = [restApi requestForQuery:@"SELECT Id, Name FROM Account"];
+     request.lazyParseResponse = YES;
+     SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"Request failed");
+     XCTAssertTrue([listener.dataResponse isKindOfClass:[SFSDKLazyJSONResponse class]], @"Response should be lazily parsed");
+     SFSDKLazyJSONResponse *lazyResponse = listener.dataResponse;
+     XCTAssertEqual([lazyResponse.jsonObject[@"records"] count], records.count, @"Wrong number of records");
+     XCTAssertEqual(lazyResponse.jsonObject, lazyResponse.object, @"Response should only be parsed once");
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testCoalescingOfIdenticalRequestsWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         SFSDKStandInResponse *response = [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"url": request.URL.absoluteString}];
+         response.delay = 0.5;
+         return response;
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+
+     // Identical requests share one response
+     NSArray<SFRestRequest *> *requests = @[[restApi requestForQuery:@"select Id from Account"],
+                                            [restApi requestForQuery:@"select Id from Account"],
+                                            [restApi requestForQuery:@"select Id from Account"],
+                                            [restApi requestForQuery:@"select Id from Contact"]];
+     NSMutableArray<SFNativeRestRequestListener *> *listeners = [NSMutableArray array];
+     for (SFRestRequest *request in requests) {
+         SFNativeRestRequestListener *listener = [[SFNativeRestRequestListener alloc] initWithRequest:request];
+         [listeners addObject:listener];
+         [restApi send:request delegate:listener];
+     }
+     XCTAssertEqual(restApi.requestCoalescer.inFlightCount, 2, @"Identical requests should share a request in flight");
+     for (SFRestRequest *request in requests) {
+         XCTAssertNil(request.request.URL, @"Coalesced requests should be left untouched, their carrier is what gets prepared");
+     }
+     for (SFNativeRestRequestListener *listener in listeners) {
+         XCTAssertEqualObjects([listener waitForCompletion], kTestRequestStatusDidLoad, @"Request failed");
+     }
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 2, @"Identical requests should have been sent once");
+     XCTAssertEqual(listeners[0].dataResponse, listeners[1].dataResponse, @"Identical requests should get the same response");
+     XCTAssertEqual(listeners[0].dataResponse, listeners[2].dataResponse, @"Identical requests should get the same response");
+     XCTAssertTrue([listeners[3].dataResponse[@"url"] containsString:@"Contact"], @"Different request got the wrong response");
+     XCTAssertEqual(restApi.requestCoalescer.inFlightCount, 0, @"No request should be in flight");
+
+     // Cancelling one request leaves the others running
+     SFRestRequest *cancelledRequest = [restApi requestForQuery:@"select Id from Lead"];
+     SFRestRequest *otherRequest = [restApi requestForQuery:@"select Id from Lead"];
+     SFNativeRestRequestListener *cancelledListener = [[SFNativeRestRequestListener alloc] initWithRequest:cancelledRequest];
+     SFNativeRestRequestListener *otherListener = [[SFNativeRestRequestListener alloc] initWithRequest:otherRequest];
+     [restApi send:cancelledRequest delegate:cancelledListener];
+     [restApi send:otherRequest delegate:otherListener];
+     [cancelledRequest cancel];
+     XCTAssertEqualObjects([cancelledListener waitForCompletion], kTestRequestStatusDidCancel, @"Request should have been cancelled");
+     XCTAssertEqualObjects([otherListener waitForCompletion], kTestRequestStatusDidLoad, @"Other request should have completed");
+
+     // Cancelling all of them cancels the request in flight
+     cancelledRequest = [restApi requestForQuery:@"select Id from Case"];
+     otherRequest = [restApi requestForQuery:@"select Id from Case"];
+     cancelledListener = [[SFNativeRestRequestListener alloc] initWithRequest:cancelledRequest];
+     otherListener = [[SFNativeRestRequestListener alloc] initWithRequest:otherRequest];
+     [restApi send:cancelledRequest delegate:cancelledListener];
+     [restApi send:otherRequest delegate:otherListener];
+     [cancelledRequest cancel];
+     [otherRequest cancel];
+     XCTAssertEqualObjects([cancelledListener waitForCompletion], kTestRequestStatusDidCancel, @"Request should have been cancelled");
+     XCTAssertEqualObjects([otherListener waitForCompletion], kTestRequestStatusDidCancel, @"Request should have been cancelled");
+     XCTAssertEqual(restApi.requestCoalescer.inFlightCount, 0, @"Request in flight should have been cancelled");
+     [SFSDKTestStandInServer stop];
+ }
+
+ // Test for the replay of requests after a token refresh against the stand-in server
+ // Queue a request behind the concurrency limit, then resend the active requests as done after a refresh
+ // Then make sure the queued request was only sent (and delivered) once
+ - (void) testResendSkipsQueuedRequestsWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{NAME: ACCOUNT}];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     SFSDKRequestScheduler *scheduler = [[SFSDKRequestScheduler alloc] init];
+     scheduler.maxConcurrentRequests = 1;
+     restApi.requestScheduler = scheduler;
+
+     // Holds the only slot
+     __block dispatch_block_t blockerFinishBlock = nil;
+     SFRestRequest *blocker = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/blocker" queryParams:nil];
+     [scheduler scheduleRequest:blocker host:@"" dispatchBlock:^(dispatch_block_t finishBlock) {
+         blockerFinishBlock = finishBlock;
+     } cancelBlock:nil];
+
+     __block NSUInteger deliveryCount = 0;
+     XCTestExpectation *delivered = [self expectationWithDescription:@"delivered"];
+     SFRestRequest *request = [restApi requestForDescribeWithObjectType:ACCOUNT];
+     [restApi sendRESTRequest:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+         XCTFail(@"Request failed: %@", e);
+     } completeBlock:^(id response, NSURLResponse *rawResponse) {
+         if (++deliveryCount == 1) {
+             [delivered fulfill];
+         }
+     }];
+     XCTAssertEqual(scheduler.queuedCount, 1, @"Request should be queued");
+     [restApi resendActiveRequestsRequiringAuthentication];
+     XCTAssertEqual(scheduler.queuedCount, 1, @"Queued request should not have been resent");
+
+     blockerFinishBlock();
+     [self waitForExpectationsWithTimeout:10 handler:nil];
+     [NSThread sleepForTimeInterval:0.5];
+     XCTAssertEqual(deliveryCount, 1, @"Delegate should have been called once");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 1, @"Request should have been sent once");
+     restApi.requestScheduler = [SFSDKRequestScheduler sharedInstance];
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testFailedRefreshSkipsQueuedRequestsWithStandInServer {
+     self.dataCleanupRequired = NO;
+     [SFSDKTestStandInServer start];
+     [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+         return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{NAME: ACCOUNT}];
+     }];
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     SFSDKRequestScheduler *scheduler = [[SFSDKRequestScheduler alloc] init];
+     scheduler.maxConcurrentRequests = 1;
+     restApi.requestScheduler = scheduler;
+
+     // Holds the only slot
+     __block dispatch_block_t blockerFinishBlock = nil;
+     SFRestRequest *blocker = [SFRestRequest requestWithMethod:SFRestMethodGET path:@"/blocker" queryParams:nil];
+     [scheduler scheduleRequest:blocker host:@"" dispatchBlock:^(dispatch_block_t finishBlock) {
+         blockerFinishBlock = finishBlock;
+     } cancelBlock:nil];
+
+     __block NSUInteger callbackCount = 0;
+     XCTestExpectation *delivered = [self expectationWithDescription:@"delivered"];
+     SFRestRequest *request = [restApi requestForDescribeWithObjectType:ACCOUNT];
+     [restApi sendRESTRequest:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+         if (++callbackCount == 1) {
+             [delivered fulfill];
+         }
+     } completeBlock:^(id response, NSURLResponse *rawResponse) {
+         if (++callbackCount == 1) {
+             [delivered fulfill];
+         }
+     }];
+     XCTAssertEqual(scheduler.queuedCount, 1, @"Request should be queued");
+     NSError *refreshError = [NSError errorWithDomain:kSFOAuthErrorDomain code:kSFOAuthErrorUnknown userInfo:nil];
+     [restApi flushPendingRequestQueue:refreshError rawResponse:nil];
+     XCTAssertEqual(scheduler.queuedCount, 1, @"Queued request should still be queued");
+
+     blockerFinishBlock();
+     [self waitForExpectationsWithTimeout:10 handler:nil];
+     [NSThread sleepForTimeInterval:0.5];
+     XCTAssertEqual(callbackCount, 1, @"Delegate should have been called once");
+     XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 1, @"Request should have been sent once");
+     restApi.requestScheduler = [SFSDKRequestScheduler sharedInstance];
+     [SFSDKTestStandInServer stop];
+ }
+
+ - (void) testAccessTokenExpirationDate {
+     self.dataCleanupRequired = NO;
+     SFRestAPI *restApi = [SFRestAPI sharedInstance];
+     SFOAuthCredentials *credentials = restApi.user.credentials;
+     NSDate *originalIssuedAt = credentials.issuedAt;
+     NSTimeInterval originalSessionTimeout = restApi.sessionTimeout;
+     NSDate *issuedAt = [NSDate date];
+     credentials.issuedAt = issuedAt;
+     XCTAssertEqual(restApi.sessionTimeout, 2 * 60 * 60, @"Wrong default session timeout");
+     XCTAssertEqualObjects(restApi.accessTokenExpirationDate, [issuedAt dateByAddingTimeInterval:2 * 60 * 60], @"Wrong expiration date");
+     restApi.sessionTimeout = 15 * 60;
+     XCTAssertEqualObjects(restApi.accessTokenExpirationDate, [issuedAt dateByAddingTimeInterval:15 * 60], @"Expiration date should follow the session timeout");
+
+     // Session timeout of the identity data, then of the token response
+     SFIdentityData *originalIdData = restApi.user.idData;
+     NSDictionary *originalOAuthFields = credentials.additionalOAuthFields;
+     NSMutableDictionary *idDict = [NSMutableDictionary dictionaryWithDictionary:originalIdData.dictRepresentation ?: @{}];
+     idDict[@"custom_attributes"] = @{@"SESSION_TIMEOUT": @"30"};
+     restApi.user.idData = [[SFIdentityData alloc] initWithJsonDict:idDict];
+     XCTAssertEqualObjects(restApi.accessTokenExpirationDate, [issuedAt dateByAddingTimeInterval:30 * 60], @"Expiration date should follow the identity data");
+     credentials.additionalOAuthFields = @{@"expires_in": @"600"};
+     XCTAssertEqualObjects(restApi.accessTokenExpirationDate, [issuedAt dateByAddingTimeInterval:600], @"Expiration date should follow the token response");
+     credentials.additionalOAuthFields = originalOAuthFields;
+     restApi.user.idData = originalIdData;
+
+     restApi.sessionTimeout = 0;
+     XCTAssertNil(restApi.accessTokenExpirationDate, @"No expiration date without a session timeout");
+     restApi.sessionTimeout = originalSessionTimeout;
+     credentials.issuedAt = nil;
+     XCTAssertNil(restApi.accessTokenExpirationDate, @"No expiration date without an issue date");
+     credentials.issuedAt = originalIssuedAt;
+ }
+
  // Test for sobject tree request
  // Run a sobject tree request that:
  // - creates an account,
@@ -1015,6 +1696,14 @@ static NSException *authException = nil;
     XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"request failed");
     XCTAssertEqualObjects(listener.dataResponse, fileAttrs[@"data"], @"wrong content");
 
+    // download content to a file
+    NSURL *destinationURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    request = [[SFRestAPI sharedInstance] requestForFileContents:fileAttrs[LID] version:nil destinationURL:destinationURL];
+    listener = [self sendSyncRequest:request];
+    XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"request failed");
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:destinationURL], fileAttrs[@"data"], @"wrong content");
+    [[NSFileManager defaultManager] removeItemAtURL:destinationURL error:nil];
+
     // download rendition (expect 200/success)
     request = [[SFRestAPI sharedInstance] requestForFileRendition:fileAttrs[LID] version:nil renditionType:@"PDF" page:0];
     listener = [self sendSyncRequest:request];
@@ -1032,6 +1721,39 @@ static NSException *authException = nil;
     XCTAssertEqual(listener.lastError.code, 404, @"invalid code");
 }
 
+// Upload file streamed from disk / download content / delete file
+- (void)testStreamedUploadDownloadDeleteFile {
+    NSString *fileTitle = [NSString stringWithFormat:@"FileName%f.txt", [NSDate timeIntervalSinceReferenceDate]];
+    NSData *fileData = [[NSString stringWithFormat:@"FileData%f", [NSDate timeIntervalSinceReferenceDate]] dataUsingEncoding:NSUTF8StringEncoding];
+    NSURL *fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]]];
+    [fileData writeToURL:fileURL atomically:YES];
+
+    // upload file
+    __block int64_t lastTransferred = 0;
+    SFRestRequest *request = [[SFRestAPI sharedInstance] requestForUploadFileAtURL:fileURL name:fileTitle description:@"FileDescription" mimeType:@"text/plain" decryptionKey:nil];
+    request.progressBlock = ^(int64_t bytesTransferred, int64_t totalBytesExpected) {
+        lastTransferred = bytesTransferred;
+    };
+    SFNativeRestRequestListener *listener = [self sendSyncRequest:request];
+    XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"request failed");
+    XCTAssertEqualObjects(listener.dataResponse[@"title"], fileTitle, @"wrong title");
+    XCTAssertEqual([listener.dataResponse[@"contentSize"] integerValue], (NSInteger)fileData.length, @"wrong content size");
+    XCTAssertGreaterThan(lastTransferred, (int64_t)fileData.length, @"upload progress should have been reported");
+    NSString *fileId = listener.dataResponse[LID];
+
+    // download content
+    request = [[SFRestAPI sharedInstance] requestForFileContents:fileId version:nil];
+    listener = [self sendSyncRequest:request];
+    XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"request failed");
+    XCTAssertEqualObjects(listener.dataResponse, fileData, @"wrong content");
+
+    // delete
+    request = [[SFRestAPI sharedInstance] requestForDeleteWithObjectType:@"ContentDocument" objectId:fileId];
+    listener = [self sendSyncRequest:request];
+    XCTAssertEqualObjects(listener.returnStatus, kTestRequestStatusDidLoad, @"request failed");
+    [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+}
+
 // test url for  testUploadDownloadDeleteFileWithCommunity
 - (void)testUploadDownloadDeleteFileWithCommunity {
     // with nil for userId
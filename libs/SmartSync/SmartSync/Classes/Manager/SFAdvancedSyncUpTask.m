@@ -25,16 +25,38 @@
 #import "SFAdvancedSyncUpTask.h"
 #import "SFAdvancedSyncUpTarget.h"
 
+@interface SFAdvancedSyncUpTask ()
+
+// Only used when the target allows more than one batch in flight
+@property (nonatomic, assign) NSUInteger inFlightBatches;
+@property (nonatomic, assign) NSUInteger completedCount;
+@property (nonatomic, assign) NSUInteger resumeIndex;
+@property (nonatomic, assign) BOOL failed;
+
+@end
+
 @implementation SFAdvancedSyncUpTask
 
 -(instancetype) init:(SFSmartSyncSyncManager*)syncManager sync:(SFSyncState*)sync updateBlock:(SFSyncSyncManagerUpdateBlock)updateBlock {
-    return [super init:syncManager sync:sync updateBlock:updateBlock];
+    self = [super init:syncManager sync:sync updateBlock:updateBlock];
+    if (self) {
+        _resumeIndex = NSNotFound;
+    }
+    return self;
 }
 
 - (void)syncUp:(SFSyncState*)sync recordIds:(NSArray*)recordIds {
     [self syncUpMultipleEntries:sync recordIds:recordIds index:0 batch:[NSMutableArray new]];
 }
 
+- (NSUInteger)maxConcurrentBatches:(SFSyncState*)sync {
+    SFSyncUpTarget<SFAdvancedSyncUpTarget>* advancedTarget = (SFSyncUpTarget<SFAdvancedSyncUpTarget>*) sync.target;
+    if ([advancedTarget respondsToSelector:@selector(maxConcurrentBatches)] && advancedTarget.maxConcurrentBatches > 1) {
+        return advancedTarget.maxConcurrentBatches;
+    }
+    return 1;
+}
+
 - (void)syncUpMultipleEntries:(SFSyncState*)sync
                     recordIds:(NSArray*)recordIds
                         index:(NSUInteger)i
@@ -43,10 +65,21 @@
     SFSyncStateMergeMode mergeMode = sync.mergeMode;
     SFSyncUpTarget *target = (SFSyncUpTarget *)sync.target;
     NSString* soupName = sync.soupName;
+    BOOL concurrent = [self maxConcurrentBatches:sync] > 1;
     sync.totalSize = recordIds.count;
-    [self updateSync:sync countSynched:i];
+
+    // Last record(s) skipped but batch not yet sent
+    if (i == recordIds.count && batch.count > 0) {
+        [self processSyncUpBatch:sync recordIds:recordIds index:i-1 batch:batch];
+        return;
+    }
+
+    // With concurrent batches, progress is reported as batches complete
+    if (!concurrent || i == 0) {
+        [self updateSync:sync countSynched:i];
+    }
     
-    if ([sync isDone] || [self shouldStop]) {
+    if ([sync isDone] || [self shouldStop] || self.failed || i >= recordIds.count) {
         return;
     }
 
@@ -64,6 +97,9 @@
             else {
                 // Server date is newer than the local date.  Skip this update.
                 [SFSDKSmartSyncLogger d:[strongSelf class] format:@"syncUpMultipleEntries: Record not synced since client does not have the latest from server:%@", record];
+                if (concurrent) {
+                    [strongSelf batchCompleted:sync recordCount:1 inFlight:NO];
+                }
                 [strongSelf syncUpMultipleEntries:sync recordIds:recordIds index:i+1 batch:batch];
             }
         }];
@@ -97,6 +133,12 @@
                      index:(NSUInteger)i
                      batch:(NSMutableArray*)batch {
     
+    NSUInteger maxConcurrentBatches = [self maxConcurrentBatches:sync];
+    if (maxConcurrentBatches > 1) {
+        [self processSyncUpBatchConcurrently:sync recordIds:recordIds index:i batch:batch maxConcurrentBatches:maxConcurrentBatches];
+        return;
+    }
+    
     SFSyncUpTarget<SFAdvancedSyncUpTarget>* advancedTarget = (SFSyncUpTarget<SFAdvancedSyncUpTarget>*) sync.target;
     
     
@@ -120,4 +162,85 @@
                         failBlock:failBlock];
 }
 
+#pragma mark - Concurrent batches
+
+- (void)processSyncUpBatchConcurrently:(SFSyncState*)sync
+                             recordIds:(NSArray*)recordIds
+                                 index:(NSUInteger)i
+                                 batch:(NSMutableArray*)batch
+                  maxConcurrentBatches:(NSUInteger)maxConcurrentBatches {
+    
+    SFSyncUpTarget<SFAdvancedSyncUpTarget>* advancedTarget = (SFSyncUpTarget<SFAdvancedSyncUpTarget>*) sync.target;
+    NSArray* records = [batch copy];
+    [batch removeAllObjects];
+    
+    // Reading of further records resumes when a batch completes if the window is full
+    BOOL windowFull;
+    @synchronized (self) {
+        self.inFlightBatches++;
+        windowFull = self.inFlightBatches >= maxConcurrentBatches && i+1 < recordIds.count;
+        if (windowFull) {
+            self.resumeIndex = i+1;
+        }
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    void (^nextBlock)(NSDictionary *)=^(NSDictionary *syncUpResult) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        NSUInteger resumeIndex = [strongSelf batchCompleted:sync recordCount:records.count inFlight:YES];
+        if (resumeIndex != NSNotFound) {
+            [strongSelf syncUpMultipleEntries:sync recordIds:recordIds index:resumeIndex batch:[NSMutableArray new]];
+        }
+    };
+    
+    SFSyncUpTargetErrorBlock failBlock = ^(NSError * err) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        BOOL alreadyFailed;
+        @synchronized (strongSelf) {
+            alreadyFailed = strongSelf.failed;
+            strongSelf.failed = YES;
+        }
+        if (!alreadyFailed) {
+            [strongSelf failSync:sync failureMessage:@"syncUpRecords failed" error:err];
+        }
+    };
+    
+    [advancedTarget syncUpRecords:self.syncManager
+                          records:records
+                        fieldlist:sync.options.fieldlist
+                        mergeMode:sync.options.mergeMode
+                     syncSoupName:sync.soupName
+                  completionBlock:nextBlock
+                        failBlock:failBlock];
+    
+    if (!windowFull) {
+        [self syncUpMultipleEntries:sync recordIds:recordIds index:i+1 batch:batch];
+    }
+}
+
+/**
+ Records completion of records (synced up in a batch or skipped) and reports progress
+ @return index to resume reading records at if reading was waiting on a batch, NSNotFound otherwise
+ */
+- (NSUInteger)batchCompleted:(SFSyncState*)sync recordCount:(NSUInteger)recordCount inFlight:(BOOL)inFlight {
+    NSUInteger completedCount;
+    NSUInteger resumeIndex;
+    @synchronized (self) {
+        if (self.failed) {
+            return NSNotFound;
+        }
+        if (inFlight) {
+            self.inFlightBatches--;
+        }
+        self.completedCount += recordCount;
+        completedCount = self.completedCount;
+        resumeIndex = self.resumeIndex;
+        self.resumeIndex = NSNotFound;
+        
+        // Sync state is saved under the same lock so progress never goes backward
+        [self updateSync:sync countSynched:completedCount];
+    }
+    return resumeIndex;
+}
+
 @end
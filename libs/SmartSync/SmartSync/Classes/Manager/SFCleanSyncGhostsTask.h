@@ -34,6 +34,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 -(instancetype) init:(SFSmartSyncSyncManager*)syncManager sync:(SFSyncState*)sync completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock;
 
+-(instancetype) init:(SFSmartSyncSyncManager*)syncManager sync:(SFSyncState*)sync progressBlock:(nullable SFSyncSyncManagerCleanGhostsProgressBlock)progressBlock completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -28,6 +28,7 @@
 
 @interface SFCleanSyncGhostsTask ()
 
+@property (nonatomic, copy) SFSyncSyncManagerCleanGhostsProgressBlock progressBlock;
 @property (nonatomic, copy) SFSyncSyncManagerCompletionStatusBlock completionStatusBlock;
 
 @end
@@ -35,8 +36,13 @@
 @implementation SFCleanSyncGhostsTask
 
 -(instancetype) init:(SFSmartSyncSyncManager*)syncManager sync:(SFSyncState*)sync completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock {
+    return [self init:syncManager sync:sync progressBlock:nil completionStatusBlock:completionStatusBlock];
+}
+
+-(instancetype) init:(SFSmartSyncSyncManager*)syncManager sync:(SFSyncState*)sync progressBlock:(SFSyncSyncManagerCleanGhostsProgressBlock)progressBlock completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock {
     self = [super init:syncManager sync:sync updateBlock:nil];
     if (self) {
+        self.progressBlock = progressBlock;
         self.completionStatusBlock = completionStatusBlock;
     }
     return self;
@@ -56,18 +62,25 @@
     [target cleanGhosts:self.syncManager
                soupName:soupName
                  syncId:syncId
+          progressBlock:^(NSUInteger numRecordsChecked, NSUInteger numRecordsDeleted) {
+              __strong typeof (weakSelf) strongSelf = weakSelf;
+              [SFSDKSmartSyncLogger d:[strongSelf class] format:@"cleanResyncGhosts:%@ checked:%lu deleted:%lu", syncId, (unsigned long) numRecordsChecked, (unsigned long) numRecordsDeleted];
+              if (strongSelf.progressBlock) {
+                  strongSelf.progressBlock(numRecordsChecked, numRecordsDeleted);
+              }
+          }
              errorBlock:^(NSError *e) {
                  __strong typeof (weakSelf) strongSelf = weakSelf;
                  [SFSDKSmartSyncLogger e:[strongSelf class] format:@"Failed to get list of remote IDs, %@", [e localizedDescription]];
                  [strongSelf createAndStoreEvent:sync numRecords:-1];
-                 [self.syncManager removeFromActiveSyncs:strongSelf];
+                 [strongSelf.syncManager removeFromActiveSyncs:strongSelf];
                  strongSelf.completionStatusBlock(SFSyncStateStatusFailed, 0);
              }
-          completeBlock:^(NSArray *localIds) {
+          completeBlock:^(NSUInteger numRecordsDeleted) {
               __strong typeof (weakSelf) strongSelf = weakSelf;
-              [self createAndStoreEvent:sync numRecords:localIds.count];
-              [self.syncManager removeFromActiveSyncs:strongSelf];
-              strongSelf.completionStatusBlock(SFSyncStateStatusDone, localIds.count);
+              [strongSelf createAndStoreEvent:sync numRecords:numRecordsDeleted];
+              [strongSelf.syncManager removeFromActiveSyncs:strongSelf];
+              strongSelf.completionStatusBlock(SFSyncStateStatusDone, numRecordsDeleted);
           }];
 }
 
@@ -35,6 +35,7 @@ NS_ASSUME_NONNULL_BEGIN
 // block type
 typedef void (^SFSyncSyncManagerUpdateBlock) (SFSyncState* sync) NS_SWIFT_NAME(SyncUpdateBlock);
 typedef void (^SFSyncSyncManagerCompletionStatusBlock) (SFSyncStateStatus syncStatus, NSUInteger numRecords) NS_SWIFT_NAME(SyncCompletionBlock);
+typedef void (^SFSyncSyncManagerCleanGhostsProgressBlock) (NSUInteger numRecordsChecked, NSUInteger numRecordsDeleted) NS_SWIFT_NAME(CleanGhostsProgressBlock);
 
 // Possible value for sync manager state
 typedef NS_ENUM(NSInteger, SFSyncManagerState) {
@@ -391,6 +392,19 @@ NS_SWIFT_NAME(SyncManager)
  */
 - (BOOL) cleanResyncGhostsByName:(NSString*)syncName completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error NS_SWIFT_NAME(cleanResyncGhosts(forName:onComplete:));
 
+/**
+ * Removes local copies of records that have been deleted on the server
+ * or do not match the query results on the server anymore.
+ * Progress is reported as local records get checked against the server.
+ *
+ * @param syncId Sync ID.
+ * @param progressBlock Progress block (optional).
+ * @param completionStatusBlock Completion status block.
+ * @param error Sets error if clean operation could not be started.
+ * @return YES if cleanResyncGhosts started successfully.
+ */
+- (BOOL) cleanResyncGhosts:(NSNumber*)syncId progressBlock:(nullable SFSyncSyncManagerCleanGhostsProgressBlock)progressBlock completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error NS_SWIFT_NAME(cleanResyncGhosts(forId:onProgress:onComplete:));
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -500,9 +500,13 @@ static NSMutableDictionary *syncMgrList = nil;
 }
 
 - (BOOL) cleanResyncGhosts:(NSNumber*)syncId completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error {
+    return [self cleanResyncGhosts:syncId progressBlock:nil completionStatusBlock:completionStatusBlock error:error];
+}
+
+- (BOOL) cleanResyncGhosts:(NSNumber*)syncId progressBlock:(SFSyncSyncManagerCleanGhostsProgressBlock)progressBlock completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error {
     SFSyncState* sync = [self checkExistsById:syncId error:error];
     if (sync) {
-        return [self cleanResyncGhostsWithSync:sync completionStatusBlock:completionStatusBlock error:error];
+        return [self cleanResyncGhostsWithSync:sync progressBlock:progressBlock completionStatusBlock:completionStatusBlock error:error];
     } else {
         return NO;
     }
@@ -511,14 +515,14 @@ static NSMutableDictionary *syncMgrList = nil;
 - (BOOL) cleanResyncGhostsByName:(NSString*)syncName completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error  {
     SFSyncState* sync = [self checkExistsByName:syncName error:error];
     if (sync) {
-        return [self cleanResyncGhostsWithSync:sync completionStatusBlock:completionStatusBlock error:error];
+        return [self cleanResyncGhostsWithSync:sync progressBlock:nil completionStatusBlock:completionStatusBlock error:error];
     } else {
         return NO;
     }
 }
 
 
-- (BOOL) cleanResyncGhostsWithSync:(SFSyncState*)sync completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error {
+- (BOOL) cleanResyncGhostsWithSync:(SFSyncState*)sync progressBlock:(SFSyncSyncManagerCleanGhostsProgressBlock)progressBlock completionStatusBlock:(SFSyncSyncManagerCompletionStatusBlock)completionStatusBlock error:(NSError**)error {
     if (![self checkAcceptingSyncs:error] || ![self checkNotRunning:@(sync.syncId) error:error]) {
         return NO;
     }
@@ -530,7 +534,7 @@ static NSMutableDictionary *syncMgrList = nil;
     [SFSDKSmartSyncLogger d:[self class] format:@"cleanResyncGhosts:%@", sync];
     
     // Run on background thread
-    SFCleanSyncGhostsTask* task = [[SFCleanSyncGhostsTask alloc] init:self sync:sync completionStatusBlock:completionStatusBlock];
+    SFCleanSyncGhostsTask* task = [[SFCleanSyncGhostsTask alloc] init:self sync:sync progressBlock:progressBlock completionStatusBlock:completionStatusBlock];
     
     dispatch_async(self.queue, ^{
         [task run];
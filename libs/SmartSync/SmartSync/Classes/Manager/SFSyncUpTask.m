@@ -35,7 +35,15 @@
 - (void) runSync:(SFSyncState*)sync {
     SFSyncUpTarget* target = (SFSyncUpTarget*) sync.target;
     NSArray* dirtyRecordIds = [target getIdsOfRecordsToSyncUp:self.syncManager soupName:sync.soupName];
-    [self syncUp:sync recordIds:dirtyRecordIds];
+    if (sync.mergeMode == SFSyncStateMergeModeLeaveIfChanged) {
+        // Fetching server modification dates in batches rather than one record at a time
+        __weak typeof(self) weakSelf = self;
+        [target prefetchLastModifiedDates:self.syncManager soupName:sync.soupName storeIds:dirtyRecordIds completionBlock:^{
+            [weakSelf syncUp:sync recordIds:dirtyRecordIds];
+        }];
+    } else {
+        [self syncUp:sync recordIds:dirtyRecordIds];
+    }
 }
 
 - (void)syncUp:(SFSyncState*)sync recordIds:(NSArray*)recordIds {
@@ -57,6 +57,14 @@ NS_SWIFT_NAME(AdvancedSyncUpTarget)
       completionBlock:(SFSyncUpTargetCompleteBlock)completionBlock
             failBlock:(SFSyncUpTargetErrorBlock)failBlock;
 
+@optional
+
+/**
+ max number of batches that can be passed to syncUpRecords without waiting for the previous ones to complete
+ when not implemented (or less than 2), batches are synced up one at a time
+ */
+@property (nonatomic,readonly) NSUInteger maxConcurrentBatches;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -26,19 +26,13 @@
 #import "SmartSync.h"
 #import "SFSyncTarget+Internal.h"
 #import "SFSyncUpTarget+Internal.h"
+#import "SFBatchSyncUpTarget+Internal.h"
 #import "SFCompositeRequestHelper.h"
 
 NSString * const kSFSyncUpTargetMaxBatchSize = @"maxBatchSize";
 
 static NSUInteger const kSFMaxSubRequestsCompositeAPI = 25;
 
-@interface SFBatchSyncUpTarget ()
-
-@property(nonatomic, readwrite) NSUInteger maxBatchSize;
-
-@end
-
-
 @implementation SFBatchSyncUpTarget
 
 #pragma mark - Initialization methods
@@ -121,23 +115,12 @@ static NSUInteger const kSFMaxSubRequestsCompositeAPI = 25;
     SFSendCompositeRequestCompleteBlock sendCompositeRequestCompleteBlock = ^(NSDictionary *refIdToResponses) {
         __strong typeof(weakSelf) strongSelf = weakSelf;
         
-        // Build refId to server id
-        NSDictionary *refIdToServerId = [SFCompositeRequestHelper parseIdsFromResponse:refIdToResponses];
-        
-        // Will a re-run be required?
-        BOOL needReRun = NO;
-        
         // Update local store
-        for (NSMutableDictionary *record in records) {
-            if ([strongSelf isDirty:record]) {
-                needReRun = needReRun || [strongSelf updateRecordInLocalStore:syncManager
-                                                                     soupName:syncSoupName
-                                                                       record:record
-                                                                    mergeMode:mergeMode
-                                                              refIdToServerId:refIdToServerId
-                                                                     response:refIdToResponses[record[strongSelf.idFieldName]]];
-            }
-        }
+        BOOL needReRun = [strongSelf updateRecordsInLocalStore:syncManager
+                                                      soupName:syncSoupName
+                                                       records:records
+                                                     mergeMode:mergeMode
+                                              refIdToResponses:refIdToResponses];
         
         // Re-run if required
         if (needReRun) {
@@ -164,6 +147,29 @@ static NSUInteger const kSFMaxSubRequestsCompositeAPI = 25;
 
 #pragma mark - helper methods
 
+- (BOOL)updateRecordsInLocalStore:(SFSmartSyncSyncManager *)syncManager soupName:(NSString *)soupName records:(NSArray<NSMutableDictionary *> *)records mergeMode:(SFSyncStateMergeMode)mergeMode refIdToResponses:(NSDictionary *)refIdToResponses {
+    
+    // Build refId to server id
+    NSDictionary *refIdToServerId = [SFCompositeRequestHelper parseIdsFromResponse:refIdToResponses];
+    
+    // Will a re-run be required?
+    BOOL needReRun = NO;
+    
+    // Update local store
+    for (NSMutableDictionary *record in records) {
+        if ([self isDirty:record]) {
+            needReRun = [self updateRecordInLocalStore:syncManager
+                                              soupName:soupName
+                                                record:record
+                                             mergeMode:mergeMode
+                                       refIdToServerId:refIdToServerId
+                                              response:refIdToResponses[record[self.idFieldName]]] || needReRun;
+        }
+    }
+    
+    return needReRun;
+}
+
 - (SFRestRequest*) buildRequestForRecord:(nonnull NSDictionary*)record fieldlist:(nonnull NSArray *)fieldlist {
     if (![self isDirty:record]) {
         return nil; // nothing to do
@@ -0,0 +1,67 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSoqlSyncDownTarget.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+extern NSString * const kSFBulkSyncTargetMaxRecordsPerChunk;
+extern NSString * const kSFBulkSyncTargetPollInterval;
+extern NSString * const kSFBulkSyncTargetPollTimeout;
+
+NS_SWIFT_NAME(BulkSyncDownTarget)
+/**
+ * Subclass of SFSoqlSyncDownTarget that runs its query as a Bulk API 2.0 query job
+ * Meant for initial loads of large data sets: the job is polled until complete, then its CSV results
+ * are downloaded and saved one chunk at a time, so only one chunk is held in memory
+ * CSV values are converted to the types the REST API returns (booleans and numbers) using a describe of the object
+ * Values of relationship fields (e.g. Owner.Name) are kept as strings
+ * Bulk queries can't be ordered, so maxTimeStamp only gets updated once all the records have been fetched
+ */
+@interface SFBulkSyncDownTarget : SFSoqlSyncDownTarget
+
+/**
+ max number of records downloaded per results chunk
+ */
+@property (nonatomic, readonly) NSUInteger maxRecordsPerChunk;
+
+/**
+ seconds between two checks of the job state
+ */
+@property (nonatomic, readonly) NSTimeInterval pollInterval;
+
+/**
+ seconds after which a job that is still not complete gets aborted and the sync fails
+ */
+@property (nonatomic, readonly) NSTimeInterval pollTimeout;
+
+/** Factory methods
+ */
++ (SFBulkSyncDownTarget*) newSyncTarget:(NSString*)query;
++ (SFBulkSyncDownTarget*) newSyncTarget:(NSString*)query maxRecordsPerChunk:(NSUInteger)maxRecordsPerChunk pollInterval:(NSTimeInterval)pollInterval;
++ (SFBulkSyncDownTarget*) newSyncTarget:(NSString*)query maxRecordsPerChunk:(NSUInteger)maxRecordsPerChunk pollInterval:(NSTimeInterval)pollInterval pollTimeout:(NSTimeInterval)pollTimeout;
+
+@end
+
+NS_ASSUME_NONNULL_END
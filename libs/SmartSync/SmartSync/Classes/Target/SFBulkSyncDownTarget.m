@@ -0,0 +1,382 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFBulkSyncDownTarget.h"
+#import "SFSoqlSyncDownTarget+Internal.h"
+#import "SFSyncDownTarget+Internal.h"
+#import "SFSmartSyncSyncManager.h"
+#import "SFSmartSyncConstants.h"
+#import "SFSmartSyncNetworkUtils.h"
+#import "SFSDKSmartSyncLogger.h"
+#import "SFSDKSoqlMutator.h"
+#import "SFSDKCsvParser.h"
+
+NSString * const kSFBulkSyncTargetMaxRecordsPerChunk = @"maxRecordsPerChunk";
+NSString * const kSFBulkSyncTargetPollInterval = @"pollInterval";
+NSString * const kSFBulkSyncTargetPollTimeout = @"pollTimeout";
+
+static NSUInteger const kSFBulkDefaultMaxRecordsPerChunk = 10000;
+static NSTimeInterval const kSFBulkDefaultPollInterval = 2.0;
+static NSTimeInterval const kSFBulkDefaultPollTimeout = 3600.0;
+
+// Bulk API 2.0 requests and responses
+static NSString * const kSFBulkQueryJobsPath = @"jobs/query";
+static NSString * const kSFBulkOperation = @"operation";
+static NSString * const kSFBulkOperationQuery = @"query";
+static NSString * const kSFBulkQuery = @"query";
+static NSString * const kSFBulkJobId = @"id";
+static NSString * const kSFBulkJobState = @"state";
+static NSString * const kSFBulkJobStateComplete = @"JobComplete";
+static NSString * const kSFBulkJobStateFailed = @"Failed";
+static NSString * const kSFBulkJobStateAborted = @"Aborted";
+static NSString * const kSFBulkJobErrorMessage = @"errorMessage";
+static NSString * const kSFBulkJobNumberRecordsProcessed = @"numberRecordsProcessed";
+static NSString * const kSFBulkMaxRecords = @"maxRecords";
+static NSString * const kSFBulkLocator = @"locator";
+static NSString * const kSFBulkLocatorHeader = @"Sforce-Locator";
+static NSString * const kSFBulkLocatorNull = @"null";
+static NSString * const kSFBulkAttributeType = @"type";
+
+// Describe response
+static NSString * const kSFBulkDescribeFields = @"fields";
+static NSString * const kSFBulkDescribeFieldName = @"name";
+static NSString * const kSFBulkDescribeFieldType = @"type";
+
+static NSString * const kSFBulkJobError = @"Bulk query job error";
+static NSInteger const kSFBulkJobFailedErrorCode = 911;
+static NSInteger const kSFBulkJobTimedOutErrorCode = 912;
+
+@interface SFBulkSyncDownTarget ()
+
+@property (nonatomic, readwrite) NSUInteger maxRecordsPerChunk;
+@property (nonatomic, readwrite) NSTimeInterval pollInterval;
+@property (nonatomic, readwrite) NSTimeInterval pollTimeout;
+
+// Set during a bulk fetch
+@property (nonatomic, copy, nullable) NSString* jobId;
+@property (nonatomic, copy, nullable) NSString* locator;
+@property (nonatomic, copy, nullable) NSString* objectType;
+@property (nonatomic, strong, nullable) NSDate* pollDeadline;
+
+// Field name to describe type, for the object type of the last fetch
+@property (nonatomic, copy, nullable) NSDictionary<NSString*, NSString*>* fieldTypes;
+@property (nonatomic, copy, nullable) NSString* fieldTypesObjectType;
+
+@end
+
+@implementation SFBulkSyncDownTarget
+
+- (instancetype)initWithDict:(NSDictionary *)dict {
+    self = [super initWithDict:dict];
+    if (self) {
+        NSNumber* maxRecordsPerChunk = dict[kSFBulkSyncTargetMaxRecordsPerChunk];
+        NSNumber* pollInterval = dict[kSFBulkSyncTargetPollInterval];
+        NSNumber* pollTimeout = dict[kSFBulkSyncTargetPollTimeout];
+        self.maxRecordsPerChunk = maxRecordsPerChunk.unsignedIntegerValue > 0 ? maxRecordsPerChunk.unsignedIntegerValue : kSFBulkDefaultMaxRecordsPerChunk;
+        self.pollInterval = pollInterval.doubleValue > 0 ? pollInterval.doubleValue : kSFBulkDefaultPollInterval;
+        self.pollTimeout = pollTimeout.doubleValue > 0 ? pollTimeout.doubleValue : kSFBulkDefaultPollTimeout;
+    }
+    return self;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.maxRecordsPerChunk = kSFBulkDefaultMaxRecordsPerChunk;
+        self.pollInterval = kSFBulkDefaultPollInterval;
+        self.pollTimeout = kSFBulkDefaultPollTimeout;
+    }
+    return self;
+}
+
+#pragma mark - Factory methods
+
++ (SFBulkSyncDownTarget*) newSyncTarget:(NSString*)query {
+    return [self newSyncTarget:query maxRecordsPerChunk:kSFBulkDefaultMaxRecordsPerChunk pollInterval:kSFBulkDefaultPollInterval];
+}
+
++ (SFBulkSyncDownTarget*) newSyncTarget:(NSString*)query maxRecordsPerChunk:(NSUInteger)maxRecordsPerChunk pollInterval:(NSTimeInterval)pollInterval {
+    return [self newSyncTarget:query maxRecordsPerChunk:maxRecordsPerChunk pollInterval:pollInterval pollTimeout:kSFBulkDefaultPollTimeout];
+}
+
++ (SFBulkSyncDownTarget*) newSyncTarget:(NSString*)query maxRecordsPerChunk:(NSUInteger)maxRecordsPerChunk pollInterval:(NSTimeInterval)pollInterval pollTimeout:(NSTimeInterval)pollTimeout {
+    return [[SFBulkSyncDownTarget alloc] initWithDict:@{
+        kSFSyncTargetTypeKey: [SFSyncDownTarget queryTypeToString:SFSyncDownTargetQueryTypeSoql],
+        @"query": query,
+        kSFBulkSyncTargetMaxRecordsPerChunk: @(maxRecordsPerChunk),
+        kSFBulkSyncTargetPollInterval: @(pollInterval),
+        kSFBulkSyncTargetPollTimeout: @(pollTimeout)
+    }];
+}
+
+#pragma mark - From/to dictionary
+
+- (NSMutableDictionary*) asDict {
+    NSMutableDictionary *dict = [super asDict];
+    dict[kSFBulkSyncTargetMaxRecordsPerChunk] = @(self.maxRecordsPerChunk);
+    dict[kSFBulkSyncTargetPollInterval] = @(self.pollInterval);
+    dict[kSFBulkSyncTargetPollTimeout] = @(self.pollTimeout);
+    return dict;
+}
+
+# pragma mark - Data fetching
+
+- (void) startFetch:(SFSmartSyncSyncManager*)syncManager
+       maxTimeStamp:(long long)maxTimeStamp
+         errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+      completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock
+{
+    // Bulk queries don't support ORDER BY
+    NSString* queryToRun = [[[[SFSDKSoqlMutator withSoql:[self getQueryToRun:maxTimeStamp]] replaceOrderBy:@""] asBuilder] build];
+    self.objectType = [SFBulkSyncDownTarget objectTypeFromQuery:queryToRun];
+    self.jobId = nil;
+    self.locator = nil;
+
+    // Field types are needed to convert the CSV values
+    if (self.objectType && ![self.objectType isEqualToString:self.fieldTypesObjectType]) {
+        __weak typeof(self) weakSelf = self;
+        [self fetchFieldTypes:^(NSError *e) {
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (e) {
+                errorBlock(e);
+            } else {
+                [strongSelf createJob:queryToRun syncManager:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+            }
+        }];
+    }
+    else {
+        [self createJob:queryToRun syncManager:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+    }
+}
+
+- (void) createJob:(NSString*)queryToRun
+       syncManager:(SFSmartSyncSyncManager*)syncManager
+        errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+     completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    __weak typeof(self) weakSelf = self;
+    SFRestRequest* request = [SFRestRequest requestWithMethod:SFRestMethodPOST path:[self jobsPath] queryParams:nil];
+    [request setCustomRequestBodyDictionary:@{kSFBulkOperation: kSFBulkOperationQuery, kSFBulkQuery: queryToRun} contentType:@"application/json"];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+        errorBlock(e);
+    } completeBlock:^(NSDictionary *responseJson, NSURLResponse *rawResponse) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        strongSelf.jobId = responseJson[kSFBulkJobId];
+        strongSelf.pollDeadline = [NSDate dateWithTimeIntervalSinceNow:strongSelf.pollTimeout];
+        [SFSDKSmartSyncLogger d:[strongSelf class] format:@"Bulk query job %@ created for query: %@", strongSelf.jobId, queryToRun];
+        [strongSelf pollJob:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+    }];
+}
+
+- (void) continueFetch:(SFSmartSyncSyncManager *)syncManager
+            errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+         completeBlock:(nullable SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    // Not in a bulk fetch (e.g. fetching remote ids during ghost cleaning): regular query
+    if (self.jobId == nil) {
+        [super continueFetch:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+    }
+    else if (self.locator) {
+        [self fetchResults:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+    }
+    else {
+        [self deleteJob];
+        completeBlock(nil);
+    }
+}
+
+-(BOOL) isSyncDownSortedByLatestModification {
+    return NO;
+}
+
+#pragma mark - Helper methods
+
+- (void) pollJob:(SFSmartSyncSyncManager*)syncManager
+      errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+   completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    NSError* error = nil;
+    if (![syncManager checkAcceptingSyncs:&error]) {
+        [self abortJob];
+        errorBlock(error);
+        return;
+    }
+    if ([self.pollDeadline timeIntervalSinceNow] < 0) {
+        NSString* description = [NSString stringWithFormat:@"Bulk query job %@ not complete after %.0f seconds", self.jobId, self.pollTimeout];
+        [self abortJob];
+        errorBlock([NSError errorWithDomain:kSFSmartSyncErrorDomain
+                                       code:kSFBulkJobTimedOutErrorCode
+                                   userInfo:@{@"error": kSFBulkJobError, @"description": description}]);
+        return;
+    }
+
+    __weak typeof(self) weakSelf = self;
+    NSString* path = [[self jobsPath] stringByAppendingFormat:@"/%@", self.jobId];
+    SFRestRequest* request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:nil];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+        [weakSelf abortJob];
+        errorBlock(e);
+    } completeBlock:^(NSDictionary *responseJson, NSURLResponse *rawResponse) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        NSString* state = responseJson[kSFBulkJobState];
+        if ([state isEqualToString:kSFBulkJobStateComplete]) {
+            strongSelf.totalSize = [responseJson[kSFBulkJobNumberRecordsProcessed] unsignedIntegerValue];
+            [strongSelf fetchResults:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+        }
+        else if ([state isEqualToString:kSFBulkJobStateFailed] || [state isEqualToString:kSFBulkJobStateAborted]) {
+            NSString* description = [NSString stringWithFormat:@"Bulk query job %@ %@: %@", strongSelf.jobId, state, responseJson[kSFBulkJobErrorMessage]];
+            [strongSelf deleteJob];
+            errorBlock([NSError errorWithDomain:kSFSmartSyncErrorDomain
+                                           code:kSFBulkJobFailedErrorCode
+                                       userInfo:@{@"error": kSFBulkJobError, @"description": description}]);
+        }
+        else {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(strongSelf.pollInterval * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                [weakSelf pollJob:syncManager errorBlock:errorBlock completeBlock:completeBlock];
+            });
+        }
+    }];
+}
+
+// Stops a job that is still running, so it doesn't keep using the org's bulk limits
+- (void) abortJob {
+    NSString* jobId = self.jobId;
+    self.jobId = nil;
+    if (jobId == nil) {
+        return;
+    }
+    NSString* path = [[self jobsPath] stringByAppendingFormat:@"/%@", jobId];
+    SFRestRequest* request = [SFRestRequest requestWithMethod:SFRestMethodPATCH path:path queryParams:nil];
+    [request setCustomRequestBodyDictionary:@{kSFBulkJobState: kSFBulkJobStateAborted} contentType:@"application/json"];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+        [SFSDKSmartSyncLogger w:[SFBulkSyncDownTarget class] format:@"Failed to abort bulk query job %@: %@", jobId, e];
+    } completeBlock:^(id response, NSURLResponse *rawResponse) {
+        [SFSDKSmartSyncLogger d:[SFBulkSyncDownTarget class] format:@"Bulk query job %@ aborted", jobId];
+    }];
+}
+
+// Deletes a job that is done (failed, aborted or whose results are no longer needed)
+- (void) deleteJob {
+    NSString* jobId = self.jobId;
+    self.jobId = nil;
+    if (jobId == nil) {
+        return;
+    }
+    NSString* path = [[self jobsPath] stringByAppendingFormat:@"/%@", jobId];
+    SFRestRequest* request = [SFRestRequest requestWithMethod:SFRestMethodDELETE path:path queryParams:nil];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+        [SFSDKSmartSyncLogger w:[SFBulkSyncDownTarget class] format:@"Failed to delete bulk query job %@: %@", jobId, e];
+    } completeBlock:^(id response, NSURLResponse *rawResponse) {
+        [SFSDKSmartSyncLogger d:[SFBulkSyncDownTarget class] format:@"Bulk query job %@ deleted", jobId];
+    }];
+}
+
+- (void) fetchFieldTypes:(void (^)(NSError* _Nullable e))completion {
+    __weak typeof(self) weakSelf = self;
+    NSString* objectType = self.objectType;
+    SFRestRequest* request = [[SFRestAPI sharedInstance] requestForDescribeWithObjectType:objectType];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+        completion(e);
+    } completeBlock:^(NSDictionary *responseJson, NSURLResponse *rawResponse) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        NSMutableDictionary<NSString*, NSString*>* fieldTypes = [NSMutableDictionary new];
+        NSArray* fields = [responseJson isKindOfClass:[NSDictionary class]] ? responseJson[kSFBulkDescribeFields] : nil;
+        for (NSDictionary* field in fields) {
+            NSString* name = field[kSFBulkDescribeFieldName];
+            NSString* type = field[kSFBulkDescribeFieldType];
+            if (name && type) {
+                fieldTypes[name] = type;
+            }
+        }
+        strongSelf.fieldTypes = fieldTypes;
+        strongSelf.fieldTypesObjectType = objectType;
+        completion(nil);
+    }];
+}
+
+- (void) fetchResults:(SFSmartSyncSyncManager*)syncManager
+           errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+        completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    __weak typeof(self) weakSelf = self;
+    NSString* path = [[self jobsPath] stringByAppendingFormat:@"/%@/results", self.jobId];
+    NSMutableDictionary* queryParams = [@{kSFBulkMaxRecords: [@(self.maxRecordsPerChunk) stringValue]} mutableCopy];
+    if (self.locator) {
+        queryParams[kSFBulkLocator] = self.locator;
+    }
+    SFRestRequest* request = [SFRestRequest requestWithMethod:SFRestMethodGET path:path queryParams:queryParams];
+    request.parseResponse = NO;
+    request.customHeaders = [@{@"Accept": @"text/csv"} mutableCopy];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+        [weakSelf deleteJob];
+        errorBlock(e);
+    } completeBlock:^(NSData *csvData, NSURLResponse *rawResponse) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        NSString* locator = [rawResponse isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse*) rawResponse).allHeaderFields[kSFBulkLocatorHeader] : nil;
+        strongSelf.locator = (locator.length > 0 && ![locator isEqualToString:kSFBulkLocatorNull]) ? locator : nil;
+        completeBlock([strongSelf recordsFromCsv:csvData]);
+    }];
+}
+
+- (NSArray<NSDictionary*>*) recordsFromCsv:(NSData*)csvData {
+    SFSDKCsvParser* parser = [SFSDKCsvParser new];
+    NSMutableArray<NSDictionary*>* records = [NSMutableArray new];
+    [records addObjectsFromArray:[parser parseData:csvData]];
+    [records addObjectsFromArray:[parser finish]];
+    if (self.objectType) {
+        // Same attributes and value types as records returned by the REST API
+        NSDictionary* attributes = @{kSFBulkAttributeType: self.objectType};
+        for (NSMutableDictionary* record in records) {
+            record[kAttributes] = attributes;
+            for (NSString* field in parser.columns) {
+                id value = record[field];
+                if ([value isKindOfClass:[NSString class]]) {
+                    record[field] = [SFBulkSyncDownTarget typedValue:value fieldType:self.fieldTypes[field]];
+                }
+            }
+        }
+    }
+    return records;
+}
+
++ (id) typedValue:(NSString*)value fieldType:(nullable NSString*)fieldType {
+    if ([fieldType isEqualToString:@"boolean"]) {
+        return @([value caseInsensitiveCompare:@"true"] == NSOrderedSame);
+    }
+    if ([fieldType isEqualToString:@"int"] || [fieldType isEqualToString:@"long"]) {
+        return @([value longLongValue]);
+    }
+    if ([fieldType isEqualToString:@"double"] || [fieldType isEqualToString:@"currency"] || [fieldType isEqualToString:@"percent"]) {
+        return @([value doubleValue]);
+    }
+    return value;
+}
+
+- (NSString*) jobsPath {
+    return [NSString stringWithFormat:@"/%@/%@", [SFRestAPI sharedInstance].apiVersion, kSFBulkQueryJobsPath];
+}
+
++ (nullable NSString*) objectTypeFromQuery:(NSString*)query {
+    NSRegularExpression* regexp = [NSRegularExpression regularExpressionWithPattern:@"\\sfrom\\s+(\\w+)" options:NSRegularExpressionCaseInsensitive error:nil];
+    NSTextCheckingResult* match = [regexp firstMatchInString:query options:0 range:NSMakeRange(0, query.length)];
+    return match ? [query substringWithRange:[match rangeAtIndex:1]] : nil;
+}
+
+@end
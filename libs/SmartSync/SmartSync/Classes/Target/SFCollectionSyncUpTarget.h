@@ -0,0 +1,56 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFBatchSyncUpTarget.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+extern NSString * const kSFSyncUpTargetMaxConcurrentBatches;
+
+NS_SWIFT_NAME(CollectionSyncUpTarget)
+/**
+ * Subclass of SFBatchSyncUpTarget that batches create/update/delete operations by using sobject collection apis
+ * Up to 200 records are sent per call, and several batches can be in flight at once
+ */
+@interface SFCollectionSyncUpTarget : SFBatchSyncUpTarget
+
+/**
+ max number of batches being synced up at the same time
+ */
+@property (nonatomic, readonly) NSUInteger maxConcurrentBatches;
+
+/** Constructor
+ */
+- (instancetype)initWithCreateFieldlist:(nullable NSArray<NSString*> *)createFieldlist
+                        updateFieldlist:(nullable NSArray<NSString*> *)updateFieldlist
+                           maxBatchSize:(nullable NSNumber *)maxBatchSize
+                   maxConcurrentBatches:(nullable NSNumber *)maxConcurrentBatches;
+
+/** Factory method
+ */
++ (instancetype)newFromDict:(nullable NSDictionary *)dict;
+
+@end
+
+NS_ASSUME_NONNULL_END
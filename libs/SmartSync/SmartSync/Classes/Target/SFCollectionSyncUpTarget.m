@@ -0,0 +1,281 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <SalesforceSDKCommon/SFJsonUtils.h>
+#import "SmartSync.h"
+#import "SFCollectionSyncUpTarget.h"
+#import "SFSyncTarget+Internal.h"
+#import "SFSyncUpTarget+Internal.h"
+#import "SFBatchSyncUpTarget+Internal.h"
+
+NSString * const kSFSyncUpTargetMaxConcurrentBatches = @"maxConcurrentBatches";
+
+static NSUInteger const kSFMaxRecordsCollectionAPI = 200;
+static NSUInteger const kSFDefaultMaxConcurrentBatches = 3;
+static NSUInteger const kSFMaxConcurrentBatchesLimit = 8;
+
+// Keys and values found in collection responses
+static NSString * const kSFCollectionSuccess = @"success";
+static NSString * const kSFCollectionErrors = @"errors";
+static NSString * const kSFCollectionStatusCode = @"statusCode";
+static NSString * const kSFCollectionEntityIsDeleted = @"ENTITY_IS_DELETED";
+static NSString * const kSFCollectionNotFound = @"NOT_FOUND";
+
+typedef void (^SFCollectionResultsBlock)(NSArray<NSDictionary *> *results);
+
+@interface SFCollectionSyncUpTarget ()
+
+@property (nonatomic, readwrite) NSUInteger maxConcurrentBatches;
+
+@end
+
+@implementation SFCollectionSyncUpTarget
+
+#pragma mark - Initialization methods
+
+- (instancetype)initWithDict:(NSDictionary *)dict {
+    return [self initWithCreateFieldlist:dict[kSFSyncUpTargetCreateFieldlist]
+                         updateFieldlist:dict[kSFSyncUpTargetUpdateFieldlist]
+                            maxBatchSize:dict[kSFSyncUpTargetMaxBatchSize]
+                    maxConcurrentBatches:dict[kSFSyncUpTargetMaxConcurrentBatches]
+            ];
+}
+
+- (instancetype)initWithCreateFieldlist:(NSArray<NSString*> *)createFieldlist
+                        updateFieldlist:(NSArray<NSString*> *)updateFieldlist
+                           maxBatchSize:(NSNumber *)maxBatchSize {
+    return [self initWithCreateFieldlist:createFieldlist updateFieldlist:updateFieldlist maxBatchSize:maxBatchSize maxConcurrentBatches:nil];
+}
+
+- (instancetype)initWithCreateFieldlist:(NSArray<NSString*> *)createFieldlist
+                        updateFieldlist:(NSArray<NSString*> *)updateFieldlist
+                           maxBatchSize:(NSNumber *)maxBatchSize
+                   maxConcurrentBatches:(NSNumber *)maxConcurrentBatches
+{
+    self = [super initWithCreateFieldlist:createFieldlist updateFieldlist:updateFieldlist maxBatchSize:nil];
+    if (self) {
+        self.maxBatchSize = (maxBatchSize == nil || [maxBatchSize unsignedIntegerValue] > kSFMaxRecordsCollectionAPI)
+                             ? kSFMaxRecordsCollectionAPI
+                             : [maxBatchSize unsignedIntegerValue];
+        self.maxConcurrentBatches = (maxConcurrentBatches == nil || [maxConcurrentBatches unsignedIntegerValue] == 0)
+                             ? kSFDefaultMaxConcurrentBatches
+                             : MIN([maxConcurrentBatches unsignedIntegerValue], kSFMaxConcurrentBatchesLimit);
+    }
+    return self;
+}
+
+#pragma mark - Factory method
+
++ (instancetype)newFromDict:(NSDictionary *)dict {
+    return [[SFCollectionSyncUpTarget alloc] initWithDict:dict];
+}
+
+#pragma mark - To dictionary
+
+- (NSMutableDictionary *)asDict {
+    NSMutableDictionary *dict = [super asDict];
+    dict[kSFSyncUpTargetMaxConcurrentBatches] = [NSNumber numberWithUnsignedInteger:self.maxConcurrentBatches];
+    return dict;
+}
+
+#pragma mark - SFAdvancedSyncUpTarget methods
+
+- (void)syncUpRecords:(nonnull SFSmartSyncSyncManager *)syncManager records:(nonnull NSArray<NSMutableDictionary *> *)records fieldlist:(nonnull NSArray *)fieldlist mergeMode:(SFSyncStateMergeMode)mergeMode syncSoupName:(nonnull NSString *)syncSoupName completionBlock:(nonnull SFSyncUpTargetCompleteBlock)completionBlock failBlock:(nonnull SFSyncUpTargetErrorBlock)failBlock {
+    
+    if (records.count == 0) {
+        completionBlock(nil);
+        return;
+    }
+    
+    NSMutableArray<NSString *> *createRefIds = [NSMutableArray new];
+    NSMutableArray<NSDictionary *> *recordsToCreate = [NSMutableArray new];
+    NSMutableArray<NSString *> *updateRefIds = [NSMutableArray new];
+    NSMutableArray<NSDictionary *> *recordsToUpdate = [NSMutableArray new];
+    NSMutableArray<NSString *> *idsToDelete = [NSMutableArray new];
+    
+    // Preparing requests
+    for (NSMutableDictionary* record in records) {
+        if (![self isDirty:record]) {
+            continue; // nothing to do
+        }
+        
+        if (record[self.idFieldName] == nil || [record[self.idFieldName] isEqual:[NSNull null]]) {
+            // create local id - needed to match responses with records
+            record[self.idFieldName] = [NSString stringWithFormat:@"local_%@", record[SOUP_ENTRY_ID]];
+        }
+        NSString *refId = record[self.idFieldName];
+        NSString *objectType = [SFJsonUtils projectIntoJson:record path:kObjectTypeField];
+        BOOL isCreate = [self isLocallyCreated:record];
+        BOOL isDelete = [self isLocallyDeleted:record];
+        
+        if (isDelete) {
+            if (!isCreate) {
+                [idsToDelete addObject:refId];
+            }
+            // else no need to go to server
+        }
+        else if (isCreate) {
+            NSMutableDictionary *fields = [self buildFieldsMap:record
+                                                     fieldlist:self.createFieldlist ? self.createFieldlist : fieldlist
+                                                   idFieldName:self.idFieldName
+                                     modificationDateFieldName:self.modificationDateFieldName];
+            fields[kAttributes] = @{@"type": objectType};
+            [createRefIds addObject:refId];
+            [recordsToCreate addObject:fields];
+        }
+        else {
+            NSMutableDictionary *fields = [self buildFieldsMap:record
+                                                     fieldlist:self.updateFieldlist ? self.updateFieldlist : fieldlist
+                                                   idFieldName:self.idFieldName
+                                     modificationDateFieldName:self.modificationDateFieldName];
+            fields[kAttributes] = @{@"type": objectType};
+            fields[kCreatedId] = refId;
+            [updateRefIds addObject:refId];
+            [recordsToUpdate addObject:fields];
+        }
+    }
+    
+    // Sending create, update and delete requests in parallel
+    NSMutableDictionary *refIdToResponses = [NSMutableDictionary new];
+    __block NSError *failure = nil;
+    dispatch_group_t group = dispatch_group_create();
+    
+    void (^sendCollectionRequest)(SFRestRequest *, NSArray<NSString *> *, NSUInteger) = ^(SFRestRequest *request, NSArray<NSString *> *refIds, NSUInteger successStatusCode) {
+        dispatch_group_enter(group);
+        [SFCollectionSyncUpTarget sendCollectionRequest:request
+                                        completionBlock:^(NSArray<NSDictionary *> *results) {
+                                            @synchronized (refIdToResponses) {
+                                                [refIdToResponses addEntriesFromDictionary:[SFCollectionSyncUpTarget parseResults:results refIds:refIds successStatusCode:successStatusCode]];
+                                            }
+                                            dispatch_group_leave(group);
+                                        }
+                                              failBlock:^(NSError *error) {
+                                                  @synchronized (refIdToResponses) {
+                                                      failure = error;
+                                                  }
+                                                  dispatch_group_leave(group);
+                                              }];
+    };
+    
+    SFRestAPI *restApi = [SFRestAPI sharedInstance];
+    if (recordsToCreate.count > 0) {
+        sendCollectionRequest([restApi requestForCollectionCreate:NO records:recordsToCreate], createRefIds, 201);
+    }
+    if (recordsToUpdate.count > 0) {
+        sendCollectionRequest([restApi requestForCollectionUpdate:NO records:recordsToUpdate], updateRefIds, 204);
+    }
+    if (idsToDelete.count > 0) {
+        sendCollectionRequest([restApi requestForCollectionDelete:NO objectIds:idsToDelete], idsToDelete, 204);
+    }
+    
+    __weak typeof(self) weakSelf = self;
+    dispatch_group_notify(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (failure) {
+            // Records the other requests got through must not be sent again on the next sync up
+            NSMutableArray<NSMutableDictionary *> *recordsWithResponses = [NSMutableArray new];
+            for (NSMutableDictionary *record in records) {
+                if (refIdToResponses[record[strongSelf.idFieldName]]) {
+                    [recordsWithResponses addObject:record];
+                }
+            }
+            [strongSelf updateRecordsInLocalStore:syncManager
+                                         soupName:syncSoupName
+                                          records:recordsWithResponses
+                                        mergeMode:mergeMode
+                                 refIdToResponses:refIdToResponses];
+            failBlock(failure);
+            return;
+        }
+        
+        // Update local store
+        BOOL needReRun = [strongSelf updateRecordsInLocalStore:syncManager
+                                                      soupName:syncSoupName
+                                                       records:records
+                                                     mergeMode:mergeMode
+                                              refIdToResponses:refIdToResponses];
+        
+        // Re-run if required
+        if (needReRun) {
+            [strongSelf syncUpRecords:syncManager
+                              records:records
+                            fieldlist:fieldlist
+                            mergeMode:mergeMode
+                         syncSoupName:syncSoupName
+                      completionBlock:completionBlock
+                            failBlock:failBlock];
+        } else {
+            // Done
+            completionBlock(nil);
+        }
+    });
+}
+
+#pragma mark - helper methods
+
++ (void)sendCollectionRequest:(SFRestRequest *)request
+              completionBlock:(SFCollectionResultsBlock)completionBlock
+                    failBlock:(SFSyncUpTargetErrorBlock)failBlock {
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request
+                                                     failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+                                                         failBlock(e);
+                                                     }
+                                                 completeBlock:^(id response, NSURLResponse *rawResponse) {
+                                                     completionBlock([response isKindOfClass:[NSArray class]] ? response : @[]);
+                                                 }];
+}
+
+/**
+ Turns collection results (which come back in the same order as the records sent)
+ into composite-like responses keyed by ref id, so that they can be reconciled
+ with the local store the same way SFBatchSyncUpTarget does it
+ */
++ (NSDictionary *)parseResults:(NSArray<NSDictionary *> *)results refIds:(NSArray<NSString *> *)refIds successStatusCode:(NSUInteger)successStatusCode {
+    NSMutableDictionary *refIdToResponses = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < results.count && i < refIds.count; i++) {
+        NSDictionary *result = results[i];
+        NSMutableDictionary *response = [NSMutableDictionary new];
+        if ([result[kSFCollectionSuccess] boolValue]) {
+            response[kHttpStatusCode] = @(successStatusCode);
+            if (result[kCreatedId]) {
+                response[kBody] = @{kCreatedId: result[kCreatedId]};
+            }
+        } else {
+            NSArray *errors = result[kSFCollectionErrors];
+            BOOL notFound = NO;
+            for (NSDictionary *error in errors) {
+                NSString *statusCode = error[kSFCollectionStatusCode];
+                if ([statusCode isEqualToString:kSFCollectionEntityIsDeleted] || [statusCode isEqualToString:kSFCollectionNotFound]) {
+                    notFound = YES;
+                }
+            }
+            response[kHttpStatusCode] = notFound ? @404 : @400;
+            response[kBody] = errors ? errors : @[];
+        }
+        refIdToResponses[refIds[i]] = response;
+    }
+    return refIdToResponses;
+}
+
+@end
@@ -28,6 +28,9 @@
 #import "SFSyncUpTarget+Internal.h"
 #import "SFCompositeRequestHelper.h"
 
+// max number of parent ids in the IN clause of modification date queries
+static NSUInteger const kSFMaxParentIdsPerModDateQuery = 50;
+
 typedef void (^SFFetchLastModifiedDatesCompleteBlock)(NSDictionary<NSString *, NSString *> * idToLastModifiedDates);
 
 @interface SFParentChildrenSyncUpTarget ()
@@ -37,6 +40,7 @@ typedef void (^SFFetchLastModifiedDatesCompleteBlock)(NSDictionary<NSString *, N
 @property(nonatomic) NSArray<NSString *> *childrenCreateFieldlist;
 @property(nonatomic) NSArray<NSString *> *childrenUpdateFieldlist;
 @property(nonatomic) SFParentChildrenRelationshipType relationshipType;
+@property(nonatomic, strong) NSMutableDictionary<NSString *, id> *parentIdToRemoteTimestamps;
 
 @end
 
@@ -246,29 +250,94 @@ typedef void (^SFFetchLastModifiedDatesCompleteBlock)(NSDictionary<NSString *, N
     }
 
     NSString* parentId = record[self.idFieldName];
+
+    // Answering from the dates fetched by prefetchLastModifiedDates if possible
+    id cachedRemoteTimestamps;
+    @synchronized (self) {
+        cachedRemoteTimestamps = self.parentIdToRemoteTimestamps[parentId];
+    }
+    if (cachedRemoteTimestamps) {
+        completionBlock(cachedRemoteTimestamps == [NSNull null] ? nil : cachedRemoteTimestamps);
+        return;
+    }
+
     SFRestRequest* lastModRequest = [self getRequestForTimestamps:parentId];
     [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:lastModRequest
                                                      failBlock:^(NSError *error, NSURLResponse *rawResponse) {
                                                          completionBlock(nil);
                                                      }
                                                  completeBlock:^(id lastModResponse, NSURLResponse *rawResponse) {
-                                                     NSMutableDictionary<NSString *, NSString *> * idToRemoteTimestamps = nil;
-                                                     id rows = lastModResponse[kResponseRecords];
-                                                     if (rows && rows != [NSNull null] && [rows count] > 0) {
-                                                         idToRemoteTimestamps = [NSMutableDictionary new];
-                                                         NSDictionary * row = rows[0];
-                                                         idToRemoteTimestamps[row[self.idFieldName]] = row[self.modificationDateFieldName];
-                                                         id childrenRows = row[self.childrenInfo.sobjectTypePlural];
-                                                         if (childrenRows && childrenRows != [NSNull null]) {
-                                                             for (NSDictionary * childRow in childrenRows[kResponseRecords]) {
-                                                                 idToRemoteTimestamps[childRow[self.childrenInfo.idFieldName]] = childRow[self.childrenInfo.modificationDateFieldName];
-                                                             }
+                                                     NSDictionary<NSString *, NSDictionary<NSString *, NSString *> *> *parentIdToRemoteTimestamps = [self parseTimestampsResponse:lastModResponse];
+                                                     completionBlock(parentIdToRemoteTimestamps[parentId]);
+                                                 }];
+}
+
+- (NSUInteger)maxIdsPerModDateQuery {
+    // Smaller batches since children rows are returned as well
+    return kSFMaxParentIdsPerModDateQuery;
+}
+
+- (void)fetchLastModifiedDates:(SFSmartSyncSyncManager *)syncManager
+                       records:(NSArray<NSDictionary *> *)records
+               completionBlock:(void (^)(void))completionBlock {
+    NSMutableArray<NSString *> *parentIds = [NSMutableArray new];
+    for (NSDictionary *record in records) {
+        if (![self isLocallyCreated:record] && record[self.idFieldName] != nil) {
+            [parentIds addObject:record[self.idFieldName]];
+        }
+    }
+    if (parentIds.count == 0) {
+        completionBlock();
+        return;
+    }
+
+    SFRestRequest* lastModRequest = [self getRequestForTimestampsWithParentIds:parentIds];
+    [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:lastModRequest
+                                                     failBlock:^(NSError *error, NSURLResponse *rawResponse) {
+                                                         // Records will be checked individually
+                                                         completionBlock();
+                                                     }
+                                                 completeBlock:^(id lastModResponse, NSURLResponse *rawResponse) {
+                                                     NSDictionary<NSString *, NSDictionary<NSString *, NSString *> *> *parentIdToRemoteTimestamps = [self parseTimestampsResponse:lastModResponse];
+                                                     @synchronized (self) {
+                                                         for (NSString *parentId in parentIds) {
+                                                             // if it wasn't returned by the query, then the parent must have been deleted
+                                                             self.parentIdToRemoteTimestamps[parentId] = parentIdToRemoteTimestamps[parentId] ?: [NSNull null];
                                                          }
                                                      }
-                                                     completionBlock(idToRemoteTimestamps);
+                                                     completionBlock();
                                                  }];
 }
 
+- (void)clearLastModifiedDatesCache {
+    [super clearLastModifiedDatesCache];
+    @synchronized (self) {
+        self.parentIdToRemoteTimestamps = [NSMutableDictionary new];
+    }
+}
+
+/**
+ Return map of parent id to map of id to last modified date for parent and its children
+ */
+- (NSDictionary<NSString *, NSDictionary<NSString *, NSString *> *> *)parseTimestampsResponse:(id)lastModResponse {
+    NSMutableDictionary<NSString *, NSDictionary<NSString *, NSString *> *> *parentIdToRemoteTimestamps = [NSMutableDictionary new];
+    id rows = lastModResponse[kResponseRecords];
+    if (rows && rows != [NSNull null]) {
+        for (NSDictionary * row in rows) {
+            NSMutableDictionary<NSString *, NSString *> * idToRemoteTimestamps = [NSMutableDictionary new];
+            idToRemoteTimestamps[row[self.idFieldName]] = row[self.modificationDateFieldName];
+            id childrenRows = row[self.childrenInfo.sobjectTypePlural];
+            if (childrenRows && childrenRows != [NSNull null]) {
+                for (NSDictionary * childRow in childrenRows[kResponseRecords]) {
+                    idToRemoteTimestamps[childRow[self.childrenInfo.idFieldName]] = childRow[self.childrenInfo.modificationDateFieldName];
+                }
+            }
+            parentIdToRemoteTimestamps[row[self.idFieldName]] = idToRemoteTimestamps;
+        }
+    }
+    return parentIdToRemoteTimestamps;
+}
+
 - (void)syncUpRecord:(SFSmartSyncSyncManager *)syncManager
               record:(NSMutableDictionary *)record
             children:(NSArray<NSMutableDictionary *> *)children
@@ -580,12 +649,16 @@ typedef void (^SFFetchLastModifiedDatesCompleteBlock)(NSDictionary<NSString *, N
 
 
 - (SFRestRequest*) getRequestForTimestamps:(NSString*) parentId {
+    return [self getRequestForTimestampsWithParentIds:@[parentId]];
+}
+
+- (SFRestRequest*) getRequestForTimestampsWithParentIds:(NSArray<NSString*>*) parentIds {
     SFSDKSoqlBuilder * builderNested = [SFSDKSoqlBuilder withFieldsArray:@[self.childrenInfo.idFieldName, self.childrenInfo.modificationDateFieldName]];
     [builderNested from:self.childrenInfo.sobjectTypePlural];
 
     SFSDKSoqlBuilder * builder = [SFSDKSoqlBuilder withFieldsArray:@[self.idFieldName, self.modificationDateFieldName, [NSString stringWithFormat:@"(%@)", [builderNested build]]]];
     [builder from:self.parentInfo.sobjectType];
-    [builder whereClause:[NSString stringWithFormat:@"%@ = '%@'", self.idFieldName, parentId]];
+    [builder whereClause:[NSString stringWithFormat:@"%@ IN ('%@')", self.idFieldName, [parentIds componentsJoinedByString:@"', '"]]];
 
     SFRestRequest * request = [[SFRestAPI sharedInstance] requestForQuery:[builder build]];
     return request;
@@ -36,7 +36,9 @@ static NSString * const kSFSyncTargetRefreshSoupName = @"soupName";
 static NSString * const kSFSyncTargetRefreshObjectType = @"sobjectType";
 static NSString * const kSFSyncTargetRefreshFieldlist = @"fieldlist";
 static NSString * const kSFSyncTargetRefreshCountIdsPerSoql = @"coundIdsPerSoql";
+static NSString * const kSFSyncTargetRefreshMaxConcurrentFetches = @"maxConcurrentFetches";
 static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
+static NSUInteger const kSFSyncTargetRefreshDefaultMaxConcurrentFetches = 4;
 
 
 @interface SFRefreshSyncDownTarget ()
@@ -45,12 +47,16 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
 @property (nonatomic, strong, readwrite) NSString* objectType;
 @property (nonatomic, strong, readwrite) NSArray*  fieldlist;
 @property (nonatomic, assign, readwrite) NSUInteger countIdsPerSoql;
+@property (nonatomic, assign, readwrite) NSUInteger maxConcurrentFetches;
 
 // NB: For each sync run - a fresh sync down target is created (by deserializing it from smartstore)
 // The following members are specific to a run
-// page will change during a run as we call start/continueFetch
+// lastIdRead will change during a run as we call start/continueFetch
+// fetchedChunks holds the records of the chunks fetched from the server but not yet handed out
 @property (nonatomic, assign, readwrite) BOOL isResync;
-@property (nonatomic, assign, readwrite) NSUInteger page;
+@property (nonatomic, copy, readwrite, nullable) NSString* lastIdRead;
+@property (nonatomic, assign, readwrite) BOOL moreIdsInSmartStore;
+@property (nonatomic, strong, readwrite) NSMutableArray<NSArray*>* fetchedChunks;
 
 @end
 
@@ -65,6 +71,9 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
         self.fieldlist = dict[kSFSyncTargetRefreshFieldlist];
         NSNumber* idsPerSoqlInDict = dict[kSFSyncTargetRefreshCountIdsPerSoql];
         self.countIdsPerSoql = idsPerSoqlInDict == nil ? kSFSyncTargetRefreshDefaultCountIdsPerSoql : [idsPerSoqlInDict unsignedIntegerValue];
+        NSNumber* maxConcurrentFetchesInDict = dict[kSFSyncTargetRefreshMaxConcurrentFetches];
+        self.maxConcurrentFetches = [maxConcurrentFetchesInDict unsignedIntegerValue] > 0 ? [maxConcurrentFetchesInDict unsignedIntegerValue] : kSFSyncTargetRefreshDefaultMaxConcurrentFetches;
+        self.fetchedChunks = [NSMutableArray new];
     }
     return self;
 }
@@ -73,6 +82,8 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
     self = [super init];
     if (self) {
         self.queryType = SFSyncDownTargetQueryTypeRefresh;
+        self.maxConcurrentFetches = kSFSyncTargetRefreshDefaultMaxConcurrentFetches;
+        self.fetchedChunks = [NSMutableArray new];
     }
     return self;
 }
@@ -97,6 +108,7 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
     dict[kSFSyncTargetRefreshObjectType] = self.objectType;
     dict[kSFSyncTargetRefreshFieldlist] = self.fieldlist;
     dict[kSFSyncTargetRefreshCountIdsPerSoql] = [NSNumber numberWithUnsignedInteger:self.countIdsPerSoql];
+    dict[kSFSyncTargetRefreshMaxConcurrentFetches] = [NSNumber numberWithUnsignedInteger:self.maxConcurrentFetches];
     return dict;
 }
 
@@ -111,6 +123,21 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
     // since we expect records to have been fetched from the server and written to the soup directly outside a sync down operation
     // Instead during a reSync, we compute maxTimeStamp from the records in the soup
     self.isResync = maxTimeStamp > 0;
+    self.lastIdRead = nil;
+    self.moreIdsInSmartStore = YES;
+    [self.fetchedChunks removeAllObjects];
+
+    // Figuring out totalSize
+    // NB: it might not be the correct value during resync
+    //     since not all records will have changed
+    NSError* error = nil;
+    SFQuerySpec* countQuerySpec = [SFQuerySpec newAllQuerySpec:self.soupName withOrderPath:self.idFieldName withOrder:kSFSoupQuerySortOrderAscending withPageSize:1];
+    self.totalSize = [[syncManager.store countWithQuerySpec:countQuerySpec error:&error] unsignedIntegerValue];
+    if (error != nil) {
+        errorBlock(error);
+        return;
+    }
+
     [self getIdsFromSmartStoreAndFetchFromServer:syncManager
                                       errorBlock:errorBlock
                                    completeBlock:completeBlock];
@@ -119,7 +146,10 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
 - (void) continueFetch:(SFSmartSyncSyncManager*)syncManager
             errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
          completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
-    if (self.page > 0) {
+    if (self.fetchedChunks.count > 0) {
+        [self deliverNextFetchedChunk:completeBlock];
+    }
+    else if (self.moreIdsInSmartStore) {
         [self getIdsFromSmartStoreAndFetchFromServer:syncManager
                                           errorBlock:errorBlock
                                        completeBlock:completeBlock];
@@ -137,122 +167,157 @@ static NSUInteger const kSFSyncTargetRefreshDefaultCountIdsPerSoql = 500;
         completeBlock(nil);
         return;
     }
-    
-    __block NSMutableArray* remoteIds = [NSMutableArray new];
-    NSUInteger sliceSize = self.countIdsPerSoql;
-    NSUInteger countSlices = ceil((float)localIds.count / sliceSize);
-    __block NSUInteger slice = 0;
-    NSString* idFieldName = self.idFieldName;
-    __block SFSyncDownTargetFetchCompleteBlock fetchBlockRecurse = ^(NSArray *records) {};
-    
-    SFSyncDownTargetFetchErrorBlock fetchErrorBlock = ^(NSError *error) {
-        fetchBlockRecurse = nil;
-        errorBlock(error);
-    };
-    
-    SFSyncDownTargetFetchCompleteBlock fetchBlock = ^(NSArray* records) {
-        NSError* error = nil;
-        if (![syncManager checkAcceptingSyncs:&error]) {
-            errorBlock(error);
-            return;
-        }
+    [self getRemoteIds:syncManager localIds:localIds fromIndex:0 remoteIds:[NSMutableArray new] errorBlock:errorBlock completeBlock:completeBlock];
+}
 
-        // NB with the recursive block, using weakSelf doesn't work (it goes to nil)
-        //    are we leaking memory?
+- (void) getRemoteIds:(SFSmartSyncSyncManager*)syncManager
+             localIds:(NSArray*)localIds
+            fromIndex:(NSUInteger)fromIndex
+            remoteIds:(NSMutableArray*)remoteIds
+           errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+        completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    NSError* error = nil;
+    if (![syncManager checkAcceptingSyncs:&error]) {
+        errorBlock(error);
+        return;
+    }
 
-        for (NSDictionary * record in records) {
-            [remoteIds addObject:record[idFieldName]];
-        }
+    if (fromIndex >= localIds.count) {
+        completeBlock(remoteIds);
+        return;
+    }
 
-        if (slice < countSlices) {
-            NSArray* idsToFetch = [localIds subarrayWithRange:NSMakeRange(slice*sliceSize, MIN(localIds.count, (slice+1)*sliceSize))];
-            slice++;
-            [self fetchFromServer:idsToFetch
-                        fieldlist:@[idFieldName]
-                     maxTimeStamp:0 /*all*/
-                       errorBlock:fetchErrorBlock
-                    completeBlock:fetchBlockRecurse];
-        } else {
-            fetchBlockRecurse = nil;
-            completeBlock(remoteIds);
+    // Up to maxConcurrentFetches slices of ids checked at once
+    NSUInteger toIndex = MIN(localIds.count, fromIndex + self.countIdsPerSoql * self.maxConcurrentFetches);
+    NSArray* idChunks = [self splitIds:[localIds subarrayWithRange:NSMakeRange(fromIndex, toIndex - fromIndex)]];
+    NSString* idFieldName = self.idFieldName;
+    __weak typeof(self) weakSelf = self;
+    [self fetchChunksFromServer:idChunks fieldlist:@[idFieldName] maxTimeStamps:nil errorBlock:errorBlock completeBlock:^(NSArray<NSArray *> *recordsPerChunk) {
+        for (NSArray* records in recordsPerChunk) {
+            for (NSDictionary* record in records) {
+                [remoteIds addObject:record[idFieldName]];
+            }
         }
-    };
-    fetchBlockRecurse = fetchBlock;
-    // Let's get going
-    fetchBlock([NSArray new]);
+        [weakSelf getRemoteIds:syncManager localIds:localIds fromIndex:toIndex remoteIds:remoteIds errorBlock:errorBlock completeBlock:completeBlock];
+    }];
 }
 
 - (void) getIdsFromSmartStoreAndFetchFromServer:(SFSmartSyncSyncManager*)syncManager
                                      errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
                                   completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
 
-    // Read from smartstore
-    SFQuerySpec* querySpec;
+    // Read next ids from smartstore (seeking past the last id read rather than using an offset)
+    NSUInteger countIdsToRead = self.countIdsPerSoql * self.maxConcurrentFetches;
+    NSString* afterLastIdClause = self.lastIdRead
+        ? [NSString stringWithFormat:@" WHERE {%@:%@} > '%@'", self.soupName, self.idFieldName, [self.lastIdRead stringByReplacingOccurrencesOfString:@"'" withString:@"''"]]
+        : @"";
     NSMutableArray* idsInSmartStore = [NSMutableArray new];
-    long long maxTimeStamp;
-    
+    NSMutableArray<NSNumber*>* maxTimeStamps = nil;
+
     if (self.isResync) {
-        // Getting full records from SmartStore to compute maxTimeStamp
+        // Getting full records from SmartStore to compute maxTimeStamp of each chunk
         // So doing more db work in the hope of doing less server work
-        querySpec = [SFQuerySpec newAllQuerySpec:self.soupName withOrderPath:self.idFieldName withOrder:kSFSoupQuerySortOrderAscending withPageSize:self.countIdsPerSoql];
+        SFQuerySpec* querySpec = [SFQuerySpec newSmartQuerySpec:[NSString stringWithFormat:@"SELECT {%1$@:_soup} FROM {%1$@}%3$@ ORDER BY {%1$@:%2$@} ASC", self.soupName, self.idFieldName, afterLastIdClause] withPageSize:countIdsToRead];
         NSError* error = nil;
-        NSArray* recordsFromSmartStore = [syncManager.store queryWithQuerySpec:querySpec pageIndex:self.page error:&error];
+        NSArray* rows = [syncManager.store queryWithQuerySpec:querySpec pageIndex:0 error:&error];
         if (error != nil) {
             errorBlock(error);
             return;
         }
-        
-        // Compute max time stamp
-        maxTimeStamp = [self getLatestModificationTimeStamp:recordsFromSmartStore];
-        
-        // Get ids
-        for (NSUInteger i = 0; i<recordsFromSmartStore.count; i++) {
-            [idsInSmartStore addObject:((NSDictionary*)recordsFromSmartStore[i])[self.idFieldName]];
+        NSMutableArray* recordsFromSmartStore = [NSMutableArray new];
+        for (NSArray* row in rows) {
+            [recordsFromSmartStore addObject:row[0]];
+            [idsInSmartStore addObject:((NSDictionary*)row[0])[self.idFieldName]];
+        }
+
+        // Compute max time stamp of each chunk
+        maxTimeStamps = [NSMutableArray new];
+        for (NSArray* recordsChunk in [self splitIds:recordsFromSmartStore]) {
+            [maxTimeStamps addObject:@([self getLatestModificationTimeStamp:recordsChunk])];
         }
     }
     else {
-        querySpec = [SFQuerySpec newSmartQuerySpec:[NSString stringWithFormat:@"SELECT {%1$@:%2$@} FROM {%1$@} ORDER BY {%1$@:%2$@} ASC", self.soupName, self.idFieldName] withPageSize:self.countIdsPerSoql];
-        
+        SFQuerySpec* querySpec = [SFQuerySpec newSmartQuerySpec:[NSString stringWithFormat:@"SELECT {%1$@:%2$@} FROM {%1$@}%3$@ ORDER BY {%1$@:%2$@} ASC", self.soupName, self.idFieldName, afterLastIdClause] withPageSize:countIdsToRead];
         NSError* error = nil;
-        NSArray* result = [syncManager.store queryWithQuerySpec:querySpec pageIndex:self.page error:&error];
+        NSArray* result = [syncManager.store queryWithQuerySpec:querySpec pageIndex:0 error:&error];
         if (error != nil) {
             errorBlock(error);
             return;
         }
-        
-        // Not a resync
-        maxTimeStamp = 0;
-        
+
         // Get ids
         for (NSUInteger i = 0; i<result.count; i++) {
             [idsInSmartStore addObject:((NSArray*)result[i])[0]];
         }
-        
     }
-  
-    // If fetch is starting, figuring out totalSize
-    // NB: it might not be the correct value during resync
-    //     since not all records will have changed
-    if (self.page == 0) {
-        NSError* error = nil;
-        self.totalSize = [[syncManager.store countWithQuerySpec:querySpec error:&error] unsignedIntegerValue];
-        if (error != nil) {
-            errorBlock(error);
-            return;
-        }
+
+    if (idsInSmartStore.count == 0) {
+        self.moreIdsInSmartStore = NO;
+        completeBlock(nil);
+        return;
     }
-    // Get records from server that have changed after maxTimeStamp
-    if (idsInSmartStore.count > 0) {
-        [self fetchFromServer:idsInSmartStore fieldlist:self.fieldlist maxTimeStamp:maxTimeStamp errorBlock:errorBlock completeBlock:^(NSArray *records) {
-            // Increment page if there is more to fetch
-            BOOL done = self.countIdsPerSoql * (self.page + 1) >= self.totalSize;
-            self.page = (done ? 0 : self.page+1);
-            completeBlock(records);
-        }];
+    self.moreIdsInSmartStore = idsInSmartStore.count == countIdsToRead;
+    self.lastIdRead = idsInSmartStore.lastObject;
+    NSArray* idChunks = [self splitIds:idsInSmartStore];
+
+    // Get records from server that have changed after maxTimeStamp - chunks are fetched concurrently but handed out one at a time
+    __weak typeof(self) weakSelf = self;
+    [self fetchChunksFromServer:idChunks fieldlist:self.fieldlist maxTimeStamps:maxTimeStamps errorBlock:errorBlock completeBlock:^(NSArray<NSArray *> *recordsPerChunk) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        [strongSelf.fetchedChunks addObjectsFromArray:recordsPerChunk];
+        [strongSelf deliverNextFetchedChunk:completeBlock];
+    }];
+}
+
+- (void) deliverNextFetchedChunk:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    NSArray* records = self.fetchedChunks.firstObject;
+    [self.fetchedChunks removeObjectAtIndex:0];
+    completeBlock(records);
+}
+
+- (NSArray<NSArray*>*) splitIds:(NSArray*)ids {
+    NSMutableArray<NSArray*>* chunks = [NSMutableArray new];
+    for (NSUInteger i = 0; i < ids.count; i += self.countIdsPerSoql) {
+        [chunks addObject:[ids subarrayWithRange:NSMakeRange(i, MIN(self.countIdsPerSoql, ids.count - i))]];
     }
-    else {
-        completeBlock(nil);
+    return chunks;
+}
+
+- (void) fetchChunksFromServer:(NSArray<NSArray*>*)idChunks
+                     fieldlist:(NSArray*)fieldlist
+                 maxTimeStamps:(nullable NSArray<NSNumber*>*)maxTimeStamps
+                    errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+                 completeBlock:(void (^)(NSArray<NSArray*>* recordsPerChunk))completeBlock {
+    NSMutableArray* recordsPerChunk = [NSMutableArray new];
+    for (NSUInteger i = 0; i < idChunks.count; i++) {
+        [recordsPerChunk addObject:@[]];
     }
+    __block NSError* firstError = nil;
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < idChunks.count; i++) {
+        dispatch_group_enter(group);
+        long long maxTimeStamp = maxTimeStamps ? [maxTimeStamps[i] longLongValue] : 0 /*all*/;
+        [self fetchFromServer:idChunks[i] fieldlist:fieldlist maxTimeStamp:maxTimeStamp errorBlock:^(NSError *e) {
+            @synchronized (recordsPerChunk) {
+                if (firstError == nil) {
+                    firstError = e;
+                }
+            }
+            dispatch_group_leave(group);
+        } completeBlock:^(NSArray *records) {
+            @synchronized (recordsPerChunk) {
+                recordsPerChunk[i] = records ?: @[];
+            }
+            dispatch_group_leave(group);
+        }];
+    }
+    dispatch_group_notify(group, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        if (firstError) {
+            errorBlock(firstError);
+        } else {
+            completeBlock(recordsPerChunk);
+        }
+    });
 }
 
 - (void) fetchFromServer:(NSArray*)ids fieldlist:(NSArray*)fieldlist
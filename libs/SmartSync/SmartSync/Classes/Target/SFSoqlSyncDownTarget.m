@@ -23,6 +23,7 @@
  */
 
 #import "SFSoqlSyncDownTarget.h"
+#import "SFSyncDownTarget+Internal.h"
 #import "SFSmartSyncSyncManager.h"
 #import "SFSmartSyncConstants.h"
 #import "SFSmartSyncObjectUtils.h"
@@ -196,6 +197,20 @@ static NSString * const kSFSoqlSyncTargetQuery = @"query";
     [self startFetch:syncManager queryToRun:soql errorBlock:errorBlock completeBlock:fetchBlock];
 }
 
+- (BOOL)canFetchRemoteIdsSortedById {
+    // Not if sorting by id changes which records are returned, or if cleanGhosts has been customized by a subclass
+    SEL cleanGhostsSelector = @selector(cleanGhosts:soupName:syncId:errorBlock:completeBlock:);
+    return ![[SFSDKSoqlMutator withSoql:self.query] hasLimitOrOffset]
+        && [self methodForSelector:cleanGhostsSelector] == [SFSyncDownTarget instanceMethodForSelector:cleanGhostsSelector];
+}
+
+- (void)startFetchRemoteIdsSortedById:(SFSmartSyncSyncManager *)syncManager
+                           errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+                        completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    NSString* soql = [[[[[SFSDKSoqlMutator withSoql:self.query] replaceSelectFields:self.idFieldName] replaceOrderBy:self.idFieldName] asBuilder] build];
+    [self startFetch:syncManager queryToRun:soql errorBlock:errorBlock completeBlock:completeBlock];
+}
+
 -(BOOL) isSyncDownSortedByLatestModification {
     return [[SFSDKSoqlMutator withSoql:self.query] isOrderingBy:self.modificationDateFieldName];
 }
@@ -32,4 +32,17 @@
 
 - (NSOrderedSet *)getNonDirtyRecordIds:(SFSmartSyncSyncManager *)syncManager soupName:(NSString *)soupName idField:(NSString *)idField additionalPredicate:(NSString *)additionalPredicate;
 
+/**
+ * YES if remote ids can be fetched sorted by id (required to clean ghosts by streaming)
+ */
+- (BOOL)canFetchRemoteIdsSortedById;
+
+/**
+ * Start fetching ids of records conforming to target sorted by id
+ * completeBlock gets records with only the id field, use continueFetch to get the next pages
+ */
+- (void)startFetchRemoteIdsSortedById:(SFSmartSyncSyncManager *)syncManager
+                           errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+                        completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock;
+
 @end
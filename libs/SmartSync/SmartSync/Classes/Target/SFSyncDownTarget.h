@@ -31,6 +31,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 typedef void (^SFSyncDownTargetFetchCompleteBlock) (NSArray* _Nullable records) NS_SWIFT_NAME(SyncDownCompletionBlock);
 typedef void (^SFSyncDownTargetFetchErrorBlock) (NSError * _Nullable e) NS_SWIFT_NAME(SyncDownErrorBlock);
+typedef void (^SFSyncDownTargetCleanGhostsProgressBlock) (NSUInteger numRecordsChecked, NSUInteger numRecordsDeleted) NS_SWIFT_NAME(CleanGhostsProgressBlock);
+typedef void (^SFSyncDownTargetCleanGhostsCompleteBlock) (NSUInteger numRecordsDeleted) NS_SWIFT_NAME(CleanGhostsCompletionBlock);
 
 typedef NS_ENUM(NSInteger, SFSyncDownTargetQueryType) {
   SFSyncDownTargetQueryTypeMru,
@@ -104,6 +106,26 @@ NS_SWIFT_NAME(SyncDownTarget)
          errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
       completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock NS_SWIFT_NAME(cleanGhosts(syncManager:soupName:syncId:onFail:onComplete:));
 
+/**
+ * Delete from local store records that a full sync down would no longer download
+ * When the target can fetch remote ids sorted by id, local and remote ids are merged one page at a time
+ * and ghosts are deleted in bounded batches, so memory use does not grow with the size of the soup
+ * Otherwise falls back to cleanGhosts:soupName:syncId:errorBlock:completeBlock:
+ *
+ * @param syncManager The sync manager
+ * @param soupName The soup to clean
+ * @param syncId The sync id
+ * @param progressBlock Block to execute as records get checked (optional)
+ * @param errorBlock Block to execute in case of error
+ * @param completeBlock Block to execute upon completion with the number of records deleted
+ */
+- (void)cleanGhosts:(SFSmartSyncSyncManager *)syncManager
+           soupName:(NSString *)soupName
+             syncId:(NSNumber *)syncId
+      progressBlock:(nullable SFSyncDownTargetCleanGhostsProgressBlock)progressBlock
+         errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+      completeBlock:(SFSyncDownTargetCleanGhostsCompleteBlock)completeBlock NS_SWIFT_NAME(cleanGhosts(syncManager:soupName:syncId:onProgress:onFail:onComplete:));
+
 /**
  * Get ids of records that should not be written over
  * during a sync down with merge mode leave-if-changed
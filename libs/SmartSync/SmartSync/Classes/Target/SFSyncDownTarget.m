@@ -25,6 +25,8 @@
 #import <SmartStore/SFSmartStore.h>
 #import <SmartStore/SFSoupIndex.h>
 #import "SFSyncTarget+Internal.h"
+#import "SFSyncDownTarget+Internal.h"
+#import "SFSmartSyncSyncManager.h"
 #import "SFMruSyncDownTarget.h"
 #import "SFRefreshSyncDownTarget.h"
 #import "SFSoqlSyncDownTarget.h"
@@ -45,6 +47,44 @@ NSString * const kSFSyncTargetQueryTypeCustom = @"custom";
 NSString * const kSFSyncTargetQueryTypeMetadata = @"metadata";
 NSString * const kSFSyncTargetQueryTypeLayout = @"layout";
 
+// streaming ghost cleaning
+static NSUInteger const kSFGhostCleaningLocalPageSize = 2000;
+static NSUInteger const kSFMaxIdsPerGhostDelete = 500;
+static NSString * const kSFGhostCleaningError = @"Ghost cleaning error";
+static NSInteger const kSFGhostCleaningUnsortedIdsErrorCode = 910;
+
+/**
+ * State of a streaming ghost cleaning: one page of local ids and one page of remote ids at a time
+ */
+@interface SFGhostCleaningState : NSObject
+
+@property (nonatomic, strong) NSArray<NSString *> *localIds;
+@property (nonatomic, assign) NSUInteger localIndex;
+@property (nonatomic, copy) NSString *lastLocalId;
+@property (nonatomic, strong) NSArray<NSString *> *remoteIds;
+@property (nonatomic, assign) NSUInteger remoteIndex;
+@property (nonatomic, copy) NSString *lastRemoteId;
+@property (nonatomic, assign) BOOL remoteDone;
+@property (nonatomic, strong) NSMutableArray<NSString *> *ghostIds;
+@property (nonatomic, assign) NSUInteger numRecordsChecked;
+@property (nonatomic, assign) NSUInteger numRecordsDeleted;
+
+@end
+
+@implementation SFGhostCleaningState
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _localIds = @[];
+        _remoteIds = @[];
+        _ghostIds = [NSMutableArray new];
+    }
+    return self;
+}
+
+@end
+
 @implementation SFSyncDownTarget
 
 #pragma mark - Initialization and serialization methods
@@ -123,6 +163,10 @@ ABSTRACT_METHOD
 
     // Fetches list of IDs present in local soup that have not been modified locally.
     NSMutableOrderedSet *localIds = [NSMutableOrderedSet orderedSetWithOrderedSet:[self getNonDirtyRecordIds:syncManager soupName:soupName idField:self.idFieldName additionalPredicate:[self buildSyncIdPredicateIfIndexed:syncManager soupName:soupName syncId:syncId]]];
+    [self cleanGhosts:syncManager soupName:soupName localIds:localIds errorBlock:errorBlock completeBlock:completeBlock];
+}
+
+- (void)cleanGhosts:(SFSmartSyncSyncManager *)syncManager soupName:(NSString *)soupName localIds:(NSMutableOrderedSet *)localIds errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
 
     // Fetches list of IDs still present on the server from the list of local IDs
     // and removes the list of IDs that are still present on the server.
@@ -138,6 +182,156 @@ ABSTRACT_METHOD
          }];
 }
 
+- (void)cleanGhosts:(SFSmartSyncSyncManager *)syncManager
+           soupName:(NSString *)soupName
+             syncId:(NSNumber *)syncId
+      progressBlock:(SFSyncDownTargetCleanGhostsProgressBlock)progressBlock
+         errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+      completeBlock:(SFSyncDownTargetCleanGhostsCompleteBlock)completeBlock {
+
+    if (![self canFetchRemoteIdsSortedById]) {
+        NSMutableOrderedSet *localIds = [NSMutableOrderedSet orderedSetWithOrderedSet:[self getNonDirtyRecordIds:syncManager soupName:soupName idField:self.idFieldName additionalPredicate:[self buildSyncIdPredicateIfIndexed:syncManager soupName:soupName syncId:syncId]]];
+        NSUInteger numRecordsChecked = localIds.count;
+        [self cleanGhosts:syncManager soupName:soupName localIds:localIds errorBlock:errorBlock completeBlock:^(NSArray *deletedIds) {
+            if (progressBlock) {
+                progressBlock(numRecordsChecked, deletedIds.count);
+            }
+            completeBlock(deletedIds.count);
+        }];
+        return;
+    }
+
+    SFGhostCleaningState *state = [SFGhostCleaningState new];
+    __weak typeof(self) weakSelf = self;
+    [self startFetchRemoteIdsSortedById:syncManager errorBlock:errorBlock completeBlock:^(NSArray *records) {
+        [weakSelf mergeGhosts:syncManager soupName:soupName syncId:syncId state:state remoteRecords:records progressBlock:progressBlock errorBlock:errorBlock completeBlock:completeBlock];
+    }];
+}
+
+- (BOOL)canFetchRemoteIdsSortedById {
+    return NO;
+}
+
+- (void)startFetchRemoteIdsSortedById:(SFSmartSyncSyncManager *)syncManager
+                           errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+                        completeBlock:(SFSyncDownTargetFetchCompleteBlock)completeBlock {
+    completeBlock(nil);
+}
+
+/**
+ * Walks local ids (in id order) against a newly fetched page of remote ids (also in id order)
+ * A local id is a ghost if the remote ids went past it without matching it
+ * Stops when it needs the next page of remote ids and resumes once it gets fetched
+ * Ghosts only get deleted once all the remote ids were seen in order, an unsorted page further down must not leave
+ * records wrongly deleted behind it
+ */
+- (void)mergeGhosts:(SFSmartSyncSyncManager *)syncManager
+           soupName:(NSString *)soupName
+             syncId:(NSNumber *)syncId
+              state:(SFGhostCleaningState *)state
+      remoteRecords:(NSArray *)remoteRecords
+      progressBlock:(SFSyncDownTargetCleanGhostsProgressBlock)progressBlock
+         errorBlock:(SFSyncDownTargetFetchErrorBlock)errorBlock
+      completeBlock:(SFSyncDownTargetCleanGhostsCompleteBlock)completeBlock {
+
+    NSError *error = nil;
+    if (![syncManager checkAcceptingSyncs:&error]) {
+        errorBlock(error);
+        return;
+    }
+
+    // New page of remote ids
+    if (remoteRecords == nil) {
+        state.remoteDone = YES;
+        state.remoteIds = @[];
+    } else {
+        NSMutableArray<NSString *> *remoteIds = [NSMutableArray arrayWithCapacity:remoteRecords.count];
+        for (NSDictionary *record in remoteRecords) {
+            NSString *remoteId = record[self.idFieldName];
+            // Merging is only correct if the server returns ids in the same order as the local store
+            if (state.lastRemoteId && [state.lastRemoteId compare:remoteId options:NSLiteralSearch] != NSOrderedAscending) {
+                errorBlock([NSError errorWithDomain:kSFSmartSyncErrorDomain
+                                               code:kSFGhostCleaningUnsortedIdsErrorCode
+                                           userInfo:@{@"error": kSFGhostCleaningError,
+                                                      @"description": @"Remote ids are not sorted by id"}]);
+                return;
+            }
+            state.lastRemoteId = remoteId;
+            [remoteIds addObject:remoteId];
+        }
+        state.remoteIds = remoteIds;
+    }
+    state.remoteIndex = 0;
+
+    while (YES) {
+        // Next page of local ids
+        if (state.localIndex >= state.localIds.count) {
+            if (progressBlock && state.localIds.count > 0) {
+                progressBlock(state.numRecordsChecked, state.numRecordsDeleted);
+            }
+            state.localIds = [self getNonDirtyRecordIdsPage:syncManager soupName:soupName syncId:syncId afterId:state.lastLocalId];
+            state.localIndex = 0;
+            if (state.localIds.count == 0) {
+                [self flushGhosts:syncManager soupName:soupName state:state];
+                if (progressBlock && state.numRecordsDeleted > 0) {
+                    progressBlock(state.numRecordsChecked, state.numRecordsDeleted);
+                }
+                completeBlock(state.numRecordsDeleted);
+                return;
+            }
+        }
+
+        NSString *localId = state.localIds[state.localIndex];
+
+        // Skipping remote ids that are before the local id
+        while (state.remoteIndex < state.remoteIds.count
+               && [state.remoteIds[state.remoteIndex] compare:localId options:NSLiteralSearch] == NSOrderedAscending) {
+            state.remoteIndex++;
+        }
+
+        // Need the next page of remote ids to decide
+        if (state.remoteIndex == state.remoteIds.count && !state.remoteDone) {
+            __weak typeof(self) weakSelf = self;
+            [self continueFetch:syncManager errorBlock:errorBlock completeBlock:^(NSArray *records) {
+                [weakSelf mergeGhosts:syncManager soupName:soupName syncId:syncId state:state remoteRecords:records progressBlock:progressBlock errorBlock:errorBlock completeBlock:completeBlock];
+            }];
+            return;
+        }
+
+        if (state.remoteIndex == state.remoteIds.count || ![state.remoteIds[state.remoteIndex] isEqualToString:localId]) {
+            [state.ghostIds addObject:localId];
+        }
+        state.lastLocalId = localId;
+        state.localIndex++;
+        state.numRecordsChecked++;
+    }
+}
+
+- (void)flushGhosts:(SFSmartSyncSyncManager *)syncManager soupName:(NSString *)soupName state:(SFGhostCleaningState *)state {
+    for (NSUInteger offset = 0; offset < state.ghostIds.count; offset += kSFMaxIdsPerGhostDelete) {
+        NSArray<NSString *> *ghostIds = [state.ghostIds subarrayWithRange:NSMakeRange(offset, MIN(kSFMaxIdsPerGhostDelete, state.ghostIds.count - offset))];
+        [self deleteRecordsFromLocalStore:syncManager soupName:soupName ids:ghostIds idField:self.idFieldName];
+        state.numRecordsDeleted += ghostIds.count;
+    }
+    [state.ghostIds removeAllObjects];
+}
+
+/**
+ * Returns next page of non-dirty local ids in id order
+ * Paging is done on the id (not with an offset) since ghosts get deleted along the way
+ */
+- (NSArray<NSString *> *)getNonDirtyRecordIdsPage:(SFSmartSyncSyncManager *)syncManager soupName:(NSString *)soupName syncId:(NSNumber *)syncId afterId:(NSString *)afterId {
+    NSString *predicate = [self buildSyncIdPredicateIfIndexed:syncManager soupName:soupName syncId:syncId];
+    if (afterId) {
+        predicate = [NSString stringWithFormat:@"%@ AND {%@:%@} > '%@'", predicate, soupName, self.idFieldName,
+                     [afterId stringByReplacingOccurrencesOfString:@"'" withString:@"''"]];
+    }
+    NSString *smartSql = [self getNonDirtyRecordIdsSql:soupName idField:self.idFieldName additionalPredicate:predicate];
+    SFQuerySpec *querySpec = [SFQuerySpec newSmartQuerySpec:smartSql withPageSize:kSFGhostCleaningLocalPageSize];
+    NSArray *results = [syncManager.store queryWithQuerySpec:querySpec pageIndex:0 error:nil];
+    return [self flatten:results];
+}
+
 - (NSString*) buildSyncIdPredicateIfIndexed:(SFSmartSyncSyncManager *)syncManager soupName:(NSString *)soupName syncId:(NSNumber *)syncId {
     NSArray *indexSpecs = [syncManager.store indicesForSoup:soupName];
     for (SFSoupIndex* indexSpec in indexSpecs) {
@@ -37,6 +37,23 @@
 - (BOOL)isNewerThanServer:(SFRecordModDate*)localModDate
             remoteModDate:(SFRecordModDate*)remoteModDate;
 
+/**
+ Max number of ids per query when prefetching modification dates
+ */
+- (NSUInteger)maxIdsPerModDateQuery;
+
+/**
+ Fetch the modification dates on the server of the given records (at most maxIdsPerModDateQuery) and cache them
+ */
+- (void)fetchLastModifiedDates:(SFSmartSyncSyncManager *)syncManager
+                       records:(NSArray<NSDictionary *> *)records
+               completionBlock:(void (^)(void))completionBlock;
+
+/**
+ Clear modification dates cached by prefetchLastModifiedDates
+ */
+- (void)clearLastModifiedDatesCache;
+
 - (void) saveRecordToLocalStoreWithLastError:(SFSmartSyncSyncManager*)syncManager
                                     soupName:(NSString*) soupName
                                       record:(NSDictionary*) record
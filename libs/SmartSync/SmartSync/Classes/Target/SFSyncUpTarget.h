@@ -158,6 +158,20 @@ NS_SWIFT_NAME(SyncUpTarget)
                    record:(NSDictionary*)record
              resultBlock:(SFSyncUpRecordNewerThanServerBlock)resultBlock;
 
+/**
+ Fetch ahead of time the modification dates on the server of the given records, with one query per batch of ids
+ Subsequent calls to isNewerThanServer for these records are answered without going to the server
+ Used by sync up when using merge mode leave-if-changed
+ @param syncManager The sync manager doing the sync
+ @param soupName The soup
+ @param storeIds The soup entry ids of the records about to be synced up
+ @param completionBlock The block to execute once all the dates have been fetched (records whose dates could not be fetched are checked individually later)
+ */
+- (void)prefetchLastModifiedDates:(SFSmartSyncSyncManager *)syncManager
+                         soupName:(NSString *)soupName
+                         storeIds:(NSArray<NSNumber *> *)storeIds
+                  completionBlock:(void (^)(void))completionBlock NS_SWIFT_NAME(prefetchLastModifiedDates(syncManager:soupName:storeIds:onComplete:));
+
 /**
  Save locally created record back to server
  @param syncManager The sync manager doing the sync
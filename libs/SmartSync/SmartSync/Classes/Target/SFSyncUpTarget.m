@@ -30,6 +30,7 @@
 #import "SFSmartSyncObjectUtils.h"
 #import "SFSyncTarget+Internal.h"
 #import <SalesforceSDKCommon/SFJsonUtils.h>
+#import <SalesforceSDKCore/SFSDKSoqlBuilder.h>
 #import <SmartStore/SFSmartStore.h>
 
 //
@@ -40,6 +41,9 @@ NSString * const kSFSyncUpTargetUpdateFieldlist = @"updateFieldlist";
 static NSString *const kSFSyncUpTargetTypeRestStandard = @"rest";
 static NSString *const kSFSyncUpTargetTypeCustom = @"custom";
 
+// max number of ids in the IN clause of modification date queries
+static NSUInteger const kSFMaxIdsPerModDateQuery = 200;
+
 @implementation SFRecordModDate
 - (instancetype)initWithTimestamp:(NSString*)timestamp isDeleted:(BOOL)isDeleted {
     self = [super init];
@@ -56,6 +60,7 @@ typedef void (^SFSyncUpRecordModDateBlock)(SFRecordModDate *remoteModDate);
 
 @interface  SFSyncUpTarget ()
 @property (nonatomic, strong) NSString* lastError;
+@property (nonatomic, strong) NSMutableDictionary<NSString*, SFRecordModDate*>* idToRemoteModDates;
 @end
 
 @implementation SFSyncUpTarget
@@ -131,12 +136,50 @@ typedef void (^SFSyncUpRecordModDateBlock)(SFRecordModDate *remoteModDate);
                 initWithTimestamp:record[self.modificationDateFieldName]
                         isDeleted:[self isLocallyDeleted:record]];
 
+        // Answering from the dates fetched by prefetchLastModifiedDates if possible
+        SFRecordModDate *cachedRemoteModDate;
+        @synchronized (self) {
+            cachedRemoteModDate = self.idToRemoteModDates[record[self.idFieldName]];
+        }
+        if (cachedRemoteModDate) {
+            resultBlock([self isNewerThanServer:localModDate remoteModDate:cachedRemoteModDate]);
+            return;
+        }
+
         [self fetchLastModifiedDate:record completeBlock:^(SFRecordModDate *remoteModDate) {
             resultBlock([self isNewerThanServer:localModDate remoteModDate:remoteModDate]);
         }];
     }
 }
 
+- (void)prefetchLastModifiedDates:(SFSmartSyncSyncManager *)syncManager
+                         soupName:(NSString *)soupName
+                         storeIds:(NSArray<NSNumber *> *)storeIds
+                  completionBlock:(void (^)(void))completionBlock
+{
+    [self clearLastModifiedDatesCache];
+    [self prefetchLastModifiedDates:syncManager soupName:soupName storeIds:storeIds offset:0 completionBlock:completionBlock];
+}
+
+- (void)prefetchLastModifiedDates:(SFSmartSyncSyncManager *)syncManager
+                         soupName:(NSString *)soupName
+                         storeIds:(NSArray<NSNumber *> *)storeIds
+                           offset:(NSUInteger)offset
+                  completionBlock:(void (^)(void))completionBlock
+{
+    if (offset >= storeIds.count) {
+        completionBlock();
+        return;
+    }
+
+    NSRange range = NSMakeRange(offset, MIN([self maxIdsPerModDateQuery], storeIds.count - offset));
+    NSArray *records = [syncManager.store retrieveEntries:[storeIds subarrayWithRange:range] fromSoup:soupName];
+    __weak typeof(self) weakSelf = self;
+    [self fetchLastModifiedDates:syncManager records:records completionBlock:^{
+        [weakSelf prefetchLastModifiedDates:syncManager soupName:soupName storeIds:storeIds offset:NSMaxRange(range) completionBlock:completionBlock];
+    }];
+}
+
 
 - (void)createOnServer:(SFSmartSyncSyncManager *)syncManager
                 record:(NSDictionary*)record
@@ -284,6 +327,69 @@ typedef void (^SFSyncUpRecordModDateBlock)(SFRecordModDate *remoteModDate);
                                 }
     ];
 }
+
+- (NSUInteger)maxIdsPerModDateQuery {
+    return kSFMaxIdsPerModDateQuery;
+}
+
+- (void)fetchLastModifiedDates:(SFSmartSyncSyncManager *)syncManager
+                       records:(NSArray<NSDictionary *> *)records
+               completionBlock:(void (^)(void))completionBlock
+{
+    // Grouping ids by object type (locally created records don't exist on the server)
+    NSMutableDictionary<NSString *, NSMutableArray<NSString *> *> *objectTypeToIds = [NSMutableDictionary new];
+    for (NSDictionary *record in records) {
+        NSString *objectType = [SFJsonUtils projectIntoJson:record path:kObjectTypeField];
+        NSString *objectId = record[self.idFieldName];
+        if ([self isLocallyCreated:record] || objectType == nil || objectId == nil || [objectId isEqual:[NSNull null]]) {
+            continue;
+        }
+        if (objectTypeToIds[objectType] == nil) {
+            objectTypeToIds[objectType] = [NSMutableArray new];
+        }
+        [objectTypeToIds[objectType] addObject:objectId];
+    }
+
+    dispatch_group_t group = dispatch_group_create();
+    for (NSString *objectType in objectTypeToIds) {
+        NSArray<NSString *> *ids = objectTypeToIds[objectType];
+        NSString *soql = [[[[SFSDKSoqlBuilder withFieldsArray:@[self.idFieldName, self.modificationDateFieldName]]
+                            from:objectType]
+                           whereClause:[NSString stringWithFormat:@"%@ IN ('%@')", self.idFieldName, [ids componentsJoinedByString:@"', '"]]]
+                          build];
+        SFRestRequest *request = [[SFRestAPI sharedInstance] requestForQuery:soql];
+        dispatch_group_enter(group);
+        [SFSmartSyncNetworkUtils sendRequestWithSmartSyncUserAgent:request
+                                                         failBlock:^(NSError *e, NSURLResponse *rawResponse) {
+                                                             // Records will be checked individually
+                                                             dispatch_group_leave(group);
+                                                         }
+                                                     completeBlock:^(id response, NSURLResponse *rawResponse) {
+                                                         NSMutableDictionary<NSString *, NSString *> *idToTimestamps = [NSMutableDictionary new];
+                                                         for (NSDictionary *row in response[kResponseRecords]) {
+                                                             idToTimestamps[row[self.idFieldName]] = row[self.modificationDateFieldName];
+                                                         }
+                                                         @synchronized (self) {
+                                                             for (NSString *objectId in ids) {
+                                                                 NSString *timestamp = idToTimestamps[objectId];
+                                                                 // if it wasn't returned by the query, then the record must have been deleted
+                                                                 self.idToRemoteModDates[objectId] = [[SFRecordModDate alloc] initWithTimestamp:timestamp isDeleted:timestamp == nil];
+                                                             }
+                                                         }
+                                                         dispatch_group_leave(group);
+                                                     }];
+    }
+    dispatch_group_notify(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        completionBlock();
+    });
+}
+
+- (void)clearLastModifiedDatesCache {
+    @synchronized (self) {
+        self.idToRemoteModDates = [NSMutableDictionary new];
+    }
+}
+
 /**
  Return true if local mod date is greater than remote mod date
  NB: also return true if both were deleted or if local mod date is missing
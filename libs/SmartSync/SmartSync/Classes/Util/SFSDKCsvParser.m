@@ -0,0 +1,182 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "SFSDKCsvParser.h"
+
+static const uint8_t kSFCsvQuote = '"';
+static const uint8_t kSFCsvComma = ',';
+static const uint8_t kSFCsvLineFeed = '\n';
+static const uint8_t kSFCsvCarriageReturn = '\r';
+
+@interface SFSDKCsvParser ()
+
+@property (nonatomic, strong, readwrite, nullable) NSArray<NSString*>* columns;
+
+// Used during parsing
+@property (nonatomic, strong) NSMutableData* currentField;
+@property (nonatomic, strong) NSMutableArray* currentRow;
+@property (nonatomic) BOOL inQuotes;
+@property (nonatomic) BOOL quoteInQuotes;
+@property (nonatomic) BOOL fieldStarted;
+
+@end
+
+@implementation SFSDKCsvParser
+
+- (instancetype) init {
+    self = [super init];
+
+    if (self) {
+        self.currentField = [NSMutableData new];
+        self.currentRow = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (NSArray<NSDictionary*>*) parseData:(NSData*)data {
+    NSMutableArray<NSDictionary*>* records = [NSMutableArray new];
+    const uint8_t* bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger runStart = 0;
+
+    for (NSUInteger i=0; i<length; i++) {
+        uint8_t ch = bytes[i];
+
+        if (self.inQuotes) {
+            if (self.quoteInQuotes) {
+                self.quoteInQuotes = NO;
+                if (ch == kSFCsvQuote) {
+                    // Escaped quote: keep one
+                    runStart = i;
+                    continue;
+                }
+                // Closing quote
+                self.inQuotes = NO;
+            }
+            else {
+                if (ch == kSFCsvQuote) {
+                    [self.currentField appendBytes:bytes + runStart length:i - runStart];
+                    self.quoteInQuotes = YES;
+                }
+                continue;
+            }
+        }
+
+        if (ch == kSFCsvQuote && !self.fieldStarted) {
+            self.inQuotes = YES;
+            self.fieldStarted = YES;
+            runStart = i + 1;
+        }
+        else if (ch == kSFCsvComma) {
+            [self pushField];
+        }
+        else if (ch == kSFCsvLineFeed) {
+            [self pushRow:records];
+        }
+        else if (ch != kSFCsvCarriageReturn) {
+            self.fieldStarted = YES;
+            [self.currentField appendBytes:&ch length:1];
+        }
+    }
+
+    // Quoted value continuing in next piece
+    if (self.inQuotes && !self.quoteInQuotes && runStart < length) {
+        [self.currentField appendBytes:bytes + runStart length:length - runStart];
+    }
+    return records;
+}
+
+- (NSArray<NSDictionary*>*) finish {
+    NSMutableArray<NSDictionary*>* records = [NSMutableArray new];
+    self.inQuotes = NO;
+    self.quoteInQuotes = NO;
+    if (self.fieldStarted || self.currentRow.count > 0) {
+        [self pushRow:records];
+    }
+    return records;
+}
+
+#pragma mark - Helper methods
+
+- (void) pushField {
+    NSString* value = [[NSString alloc] initWithData:self.currentField encoding:NSUTF8StringEncoding];
+    [self.currentRow addObject:value.length > 0 ? value : [NSNull null]];
+    self.currentField = [NSMutableData new];
+    self.fieldStarted = NO;
+}
+
+- (void) pushRow:(NSMutableArray<NSDictionary*>*)records {
+    [self pushField];
+    NSArray* row = self.currentRow;
+    self.currentRow = [NSMutableArray new];
+
+    // Skipping blank lines
+    if (row.count == 1 && row[0] == [NSNull null]) {
+        return;
+    }
+
+    if (self.columns == nil) {
+        self.columns = row;
+    }
+    else {
+        [records addObject:[self recordFromRow:row]];
+    }
+}
+
+- (NSDictionary*) recordFromRow:(NSArray*)row {
+    NSMutableDictionary* record = [NSMutableDictionary new];
+    for (NSUInteger i=0; i<self.columns.count; i++) {
+        id value = i < row.count ? row[i] : [NSNull null];
+        NSString* column = self.columns[i];
+        if ([column isKindOfClass:[NSString class]] && [column rangeOfString:@"."].location != NSNotFound) {
+            [self setValue:value path:[column componentsSeparatedByString:@"."] record:record];
+        }
+        else if ([column isKindOfClass:[NSString class]]) {
+            record[column] = value;
+        }
+    }
+    return record;
+}
+
+- (void) setValue:(id)value path:(NSArray<NSString*>*)path record:(NSMutableDictionary*)record {
+    NSMutableDictionary* parent = record;
+    for (NSUInteger i=0; i<path.count - 1; i++) {
+        id child = parent[path[i]];
+        if (![child isKindOfClass:[NSMutableDictionary class]]) {
+            if (value == [NSNull null]) {
+                // Null relationship: same as the REST API
+                if (child == nil) {
+                    parent[path[i]] = [NSNull null];
+                }
+                return;
+            }
+            child = [NSMutableDictionary new];
+            parent[path[i]] = child;
+        }
+        parent = child;
+    }
+    parent[path.lastObject] = value;
+}
+
+@end
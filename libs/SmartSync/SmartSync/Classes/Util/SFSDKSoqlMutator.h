@@ -73,6 +73,12 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL) hasOrderBy;
 
+/**
+ * Check if query has limit or offset clause
+ * @return YES if it is the case.
+ */
+- (BOOL) hasLimitOrOffset;
+
 /**
  * Check if query is selecting by given field
  * @param field Field to look for.
@@ -130,6 +130,10 @@ static NSString * const kSFSDKSoqlMutatorOffset = @"offset";
     return self.clauses[kSFSDKSoqlMutatorOrderBy] != nil;
 }
 
+- (BOOL) hasLimitOrOffset {
+    return self.clauses[kSFSDKSoqlMutatorLimit] != nil || self.clauses[kSFSDKSoqlMutatorOffset] != nil;
+}
+
 - (BOOL) isSelectingField:(NSString*) field {
     NSArray* selectedFields = [[self removeWhiteSpaces:self.clausesWithoutSubqueries[kSFSDKSoqlMutatorSelect]] componentsSeparatedByString:@","];
     return [selectedFields containsObject:field];
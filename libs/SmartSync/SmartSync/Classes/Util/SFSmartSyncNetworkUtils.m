@@ -34,6 +34,10 @@ NSString * const kSmartSync = @"SmartSync";
 + (void)sendRequestWithSmartSyncUserAgent:(SFRestRequest *)request failBlock:(SFRestFailBlock)failBlock completeBlock:(SFRestResponseBlock)completeBlock {
     [SFSDKSmartSyncLogger d:[self class] format:@"sendRequestWithSmartSyncUserAgent:request:%@", request];
     [request setHeaderValue:[SFRestAPI userAgentString:kSmartSync] forHeaderName:kUserAgent];
+    // Sync traffic yields to interactive requests, unless the caller asked otherwise
+    if (request.priority == SFRestRequestPriorityNormal) {
+        request.priority = SFRestRequestPriorityLow;
+    }
     [[SFRestAPI sharedInstance] sendRESTRequest:request failBlock:^(NSError *e, NSURLResponse *rawResponse) {
         [SFSDKSmartSyncLogger e:[self class] format:@"sendRequestWithSmartSyncUserAgent:error:%ld:%@", (long) e.code, e.domain];
         failBlock(e, rawResponse);
@@ -36,6 +36,8 @@
 #import <SmartSync/SFMetadataSyncManager.h>
 #import <SmartSync/SFSmartSyncConstants.h>
 #import <SmartSync/SFBatchSyncUpTarget.h>
+#import <SmartSync/SFBulkSyncDownTarget.h>
+#import <SmartSync/SFCollectionSyncUpTarget.h>
 #import <SmartSync/SFSmartSyncPersistableObject.h>
 #import <SmartSync/SFSmartSyncSyncManager+Instrumentation.h>
 #import <SmartSync/SFSoslSyncDownTarget.h>
@@ -0,0 +1,247 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <SalesforceSDKCore/SFSDKTestStandInServer.h>
+#import "SyncManagerTestCase.h"
+#import "SFSDKCsvParser.h"
+
+@interface BulkSyncDownTests : SyncManagerTestCase
+
+@end
+
+@implementation BulkSyncDownTests
+
+#pragma mark - setUp/tearDown
+
+- (void)tearDown {
+    [SFSDKTestStandInServer stop];
+    [self deleteSyncs];
+    [self dropAccountsSoup];
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void) testCsvParserInPieces {
+    NSString* csv = @"\"Id\",\"Name\",\"Owner.Name\",\"LastModifiedDate\"\r\n"
+                     "\"001A\",\"Plain\",\"Jane\",\"2019-10-01T00:00:00.000Z\"\r\n"
+                     "\"001B\",\"Comma, \"\"quote\"\" and\nnew line\",\"\",\"2019-10-02T00:00:00.000Z\"\r\n"
+                     "\"001C\",\"Café\",\"Zoé\",\"2019-10-03T00:00:00.000Z\"";
+    NSData* data = [csv dataUsingEncoding:NSUTF8StringEncoding];
+
+    // Feeding one byte at a time to split rows, quotes and multi-byte characters
+    SFSDKCsvParser* parser = [SFSDKCsvParser new];
+    NSMutableArray* records = [NSMutableArray new];
+    for (NSUInteger i = 0; i < data.length; i++) {
+        [records addObjectsFromArray:[parser parseData:[data subdataWithRange:NSMakeRange(i, 1)]]];
+    }
+    [records addObjectsFromArray:[parser finish]];
+
+    XCTAssertEqualObjects(parser.columns, (@[@"Id", @"Name", @"Owner.Name", @"LastModifiedDate"]), @"Wrong columns");
+    XCTAssertEqual(records.count, 3, @"Wrong number of records");
+    XCTAssertEqualObjects(records[0][@"Owner"], @{@"Name": @"Jane"}, @"Relationship field should be nested");
+    XCTAssertEqualObjects(records[1][NAME], @"Comma, \"quote\" and\nnew line", @"Wrong quoted value");
+    XCTAssertEqual(records[1][@"Owner"], [NSNull null], @"Empty relationship should be null");
+    XCTAssertEqualObjects(records[2][NAME], @"Café", @"Wrong multi-byte value");
+    XCTAssertEqualObjects(records[2][LAST_MODIFIED_DATE], @"2019-10-03T00:00:00.000Z", @"Wrong value for last column");
+}
+
+- (void) testFactoryMethodWithDictAndAsDict {
+    SFBulkSyncDownTarget* target = [SFBulkSyncDownTarget newSyncTarget:@"SELECT Id, Name FROM Account" maxRecordsPerChunk:5000 pollInterval:0.5];
+    NSDictionary* targetDict = [target asDict];
+    XCTAssertEqualObjects(targetDict[kSFSyncTargetiOSImplKey], @"SFBulkSyncDownTarget", @"Wrong ios impl");
+    SFSyncDownTarget* restoredTarget = [SFSyncDownTarget newFromDict:targetDict];
+    XCTAssertEqual([restoredTarget class], [SFBulkSyncDownTarget class], @"Wrong class");
+    SFBulkSyncDownTarget* bulkTarget = (SFBulkSyncDownTarget*) restoredTarget;
+    XCTAssertEqualObjects(bulkTarget.query, target.query, @"Wrong query");
+    XCTAssertEqual(bulkTarget.maxRecordsPerChunk, 5000, @"Wrong max records per chunk");
+    XCTAssertEqual(bulkTarget.pollInterval, 0.5, @"Wrong poll interval");
+}
+
+/**
+ Sync down with a bulk target against the stand-in server
+ Job is in progress at first poll, then results are served two records per chunk
+ Make sure every chunk got saved with typed values, the query sent has no ORDER BY, maxTimeStamp is the latest modification date
+ and the job is deleted once all results are fetched
+ */
+- (void) testSyncDownWithStandInServer {
+    [self createAccountsSoup];
+    NSUInteger numberRecords = 5;
+    NSUInteger maxRecordsPerChunk = 2;
+    NSMutableArray<NSString*>* rows = [NSMutableArray new];
+    for (NSUInteger i = 0; i < numberRecords; i++) {
+        [rows addObject:[NSString stringWithFormat:@"\"001BULK%08lu\",\"Bulk account %lu\",\"%lu\",\"%@\",\"2019-10-0%luT00:00:00.000Z\"\n", (unsigned long) i, (unsigned long) i, (unsigned long) i * 10, i % 2 ? @"true" : @"false", (unsigned long) i + 1]];
+    }
+
+    __block NSUInteger pollCount = 0;
+    __block NSString* jobQuery = nil;
+    __block BOOL jobDeleted = NO;
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        NSString* path = request.URL.path;
+        if ([path hasSuffix:@"/sobjects/Account/describe"]) {
+            return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"fields": @[@{@"name": @"Id", @"type": @"id"},
+                                                                                              @{@"name": @"Name", @"type": @"string"},
+                                                                                              @{@"name": @"NumberOfEmployees", @"type": @"int"},
+                                                                                              @{@"name": @"IsDeleted", @"type": @"boolean"},
+                                                                                              @{@"name": @"LastModifiedDate", @"type": @"datetime"}]}];
+        }
+        if ([request.HTTPMethod isEqualToString:@"DELETE"] && [path hasSuffix:@"/jobs/query/750BULK"]) {
+            jobDeleted = YES;
+            return [SFSDKStandInResponse responseWithStatusCode:204 headers:nil data:nil];
+        }
+        if ([request.HTTPMethod isEqualToString:@"POST"] && [path hasSuffix:@"/jobs/query"]) {
+            jobQuery = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil][@"query"];
+            return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750BULK", @"state": @"UploadComplete"}];
+        }
+        if ([path hasSuffix:@"/jobs/query/750BULK"]) {
+            pollCount++;
+            return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750BULK",
+                                                                                 @"state": pollCount == 1 ? @"InProgress" : @"JobComplete",
+                                                                                 @"numberRecordsProcessed": @(numberRecords)}];
+        }
+        if ([path hasSuffix:@"/jobs/query/750BULK/results"]) {
+            NSURLComponents* components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+            NSUInteger offset = 0;
+            for (NSURLQueryItem* item in components.queryItems) {
+                if ([item.name isEqualToString:@"locator"]) {
+                    offset = (NSUInteger) [item.value integerValue];
+                }
+            }
+            NSUInteger end = MIN(offset + maxRecordsPerChunk, numberRecords);
+            NSString* csv = [@"\"Id\",\"Name\",\"NumberOfEmployees\",\"IsDeleted\",\"LastModifiedDate\"\n" stringByAppendingString:[[rows subarrayWithRange:NSMakeRange(offset, end - offset)] componentsJoinedByString:@""]];
+            NSString* locator = end < numberRecords ? [NSString stringWithFormat:@"%lu", (unsigned long) end] : @"null";
+            return [SFSDKStandInResponse responseWithStatusCode:200 headers:@{@"Content-Type": @"text/csv", @"Sforce-Locator": locator} data:[csv dataUsingEncoding:NSUTF8StringEncoding]];
+        }
+        return nil;
+    }];
+
+    SFBulkSyncDownTarget* target = [SFBulkSyncDownTarget newSyncTarget:@"SELECT Id, Name, NumberOfEmployees, IsDeleted, LastModifiedDate FROM Account" maxRecordsPerChunk:maxRecordsPerChunk pollInterval:0.1];
+    XCTestExpectation* syncDone = [self expectationWithDescription:@"syncDone"];
+    __block SFSyncState* finalSync = nil;
+    __block NSUInteger runningUpdates = 0;
+    [self.syncManager syncDownWithTarget:target options:[SFSyncOptions newSyncOptionsForSyncDown:SFSyncStateMergeModeOverwrite] soupName:ACCOUNTS_SOUP updateBlock:^(SFSyncState *sync) {
+        if ([sync isRunning]) {
+            runningUpdates++;
+        } else {
+            finalSync = sync;
+            [syncDone fulfill];
+        }
+    }];
+    [self waitForExpectationsWithTimeout:30.0 handler:nil];
+
+    XCTAssertEqual(finalSync.status, SFSyncStateStatusDone, @"Sync should have succeeded");
+    XCTAssertEqual(finalSync.totalSize, numberRecords, @"Wrong total size");
+    XCTAssertEqual(pollCount, 2, @"Job should have been polled twice");
+    XCTAssertFalse([jobQuery.lowercaseString containsString:@"order by"], @"Bulk query should not be ordered");
+    XCTAssertGreaterThanOrEqual(runningUpdates, (numberRecords + maxRecordsPerChunk - 1) / maxRecordsPerChunk, @"Progress should be reported for every chunk");
+    XCTAssertEqual(finalSync.maxTimeStamp, [SFSmartSyncObjectUtils getMillisFromIsoString:@"2019-10-05T00:00:00.000Z"], @"Wrong maxTimeStamp");
+
+    NSMutableArray* ids = [NSMutableArray new];
+    for (NSUInteger i = 0; i < numberRecords; i++) {
+        [ids addObject:[NSString stringWithFormat:@"001BULK%08lu", (unsigned long) i]];
+    }
+    [self checkDbExists:ACCOUNTS_SOUP ids:ids idField:ID];
+    NSArray* savedRecords = [self.store queryWithQuerySpec:[SFQuerySpec newAllQuerySpec:ACCOUNTS_SOUP withOrderPath:ID withOrder:kSFSoupQuerySortOrderAscending withPageSize:numberRecords] pageIndex:0 error:nil];
+    XCTAssertEqualObjects(savedRecords[0][ATTRIBUTES][TYPE], ACCOUNT_TYPE, @"Records should have their object type");
+    XCTAssertEqualObjects(savedRecords[4][NAME], @"Bulk account 4", @"Wrong name");
+    XCTAssertEqualObjects(savedRecords[4][@"NumberOfEmployees"], @40, @"Int field should be a number");
+    XCTAssertEqualObjects(savedRecords[3][@"IsDeleted"], @YES, @"Boolean field should be a boolean");
+    XCTAssertEqualObjects(savedRecords[4][@"IsDeleted"], @NO, @"Boolean field should be a boolean");
+    XCTAssertEqualObjects(savedRecords[4][LAST_MODIFIED_DATE], @"2019-10-05T00:00:00.000Z", @"Date field should stay a string");
+    XCTAssertTrue(jobDeleted, @"Job should be deleted once all results are fetched");
+}
+
+/**
+ Sync down with a bulk target against the stand-in server where the job fails
+ Make sure the sync fails
+ */
+- (void) testSyncDownFailedJobWithStandInServer {
+    [self createAccountsSoup];
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if ([request.HTTPMethod isEqualToString:@"POST"]) {
+            return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750FAIL", @"state": @"UploadComplete"}];
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750FAIL", @"state": @"Failed", @"errorMessage": @"INVALID_FIELD"}];
+    }];
+
+    SFBulkSyncDownTarget* target = [SFBulkSyncDownTarget newSyncTarget:@"SELECT Id, Name, LastModifiedDate FROM Account" maxRecordsPerChunk:2 pollInterval:0.1];
+    XCTestExpectation* syncDone = [self expectationWithDescription:@"syncDone"];
+    __block SFSyncState* finalSync = nil;
+    [self.syncManager syncDownWithTarget:target options:[SFSyncOptions newSyncOptionsForSyncDown:SFSyncStateMergeModeOverwrite] soupName:ACCOUNTS_SOUP updateBlock:^(SFSyncState *sync) {
+        if (![sync isRunning]) {
+            finalSync = sync;
+            [syncDone fulfill];
+        }
+    }];
+    [self waitForExpectationsWithTimeout:30.0 handler:nil];
+    XCTAssertEqual(finalSync.status, SFSyncStateStatusFailed, @"Sync should have failed");
+}
+
+/**
+ Sync down with a bulk target against the stand-in server where the job never completes
+ Make sure polling stops after the poll timeout, the job gets aborted and the sync fails
+ */
+- (void) testSyncDownJobTimeoutWithStandInServer {
+    [self createAccountsSoup];
+    __block NSUInteger pollCount = 0;
+    __block NSString* abortState = nil;
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if ([request.HTTPMethod isEqualToString:@"POST"]) {
+            return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750SLOW", @"state": @"UploadComplete"}];
+        }
+        if ([request.HTTPMethod isEqualToString:@"PATCH"]) {
+            abortState = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil][@"state"];
+            return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750SLOW", @"state": @"Aborted"}];
+        }
+        if ([request.URL.path hasSuffix:@"/jobs/query/750SLOW"]) {
+            pollCount++;
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"id": @"750SLOW", @"state": @"InProgress"}];
+    }];
+
+    SFBulkSyncDownTarget* target = [SFBulkSyncDownTarget newSyncTarget:@"SELECT Id, Name, LastModifiedDate FROM Account" maxRecordsPerChunk:2 pollInterval:0.1 pollTimeout:1.0];
+    XCTestExpectation* syncDone = [self expectationWithDescription:@"syncDone"];
+    __block SFSyncState* finalSync = nil;
+    [self.syncManager syncDownWithTarget:target options:[SFSyncOptions newSyncOptionsForSyncDown:SFSyncStateMergeModeOverwrite] soupName:ACCOUNTS_SOUP updateBlock:^(SFSyncState *sync) {
+        if (![sync isRunning]) {
+            finalSync = sync;
+            [syncDone fulfill];
+        }
+    }];
+    [self waitForExpectationsWithTimeout:30.0 handler:nil];
+    XCTAssertEqual(finalSync.status, SFSyncStateStatusFailed, @"Sync should have failed");
+    XCTAssertGreaterThan(pollCount, 1, @"Job should have been polled until the timeout");
+    XCTAssertLessThan(pollCount, 30, @"Polling should have stopped at the timeout");
+    // The abort request is fire and forget
+    NSDate* deadline = [NSDate dateWithTimeIntervalSinceNow:5.0];
+    while (abortState == nil && [deadline timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    }
+    XCTAssertEqualObjects(abortState, @"Aborted", @"Job should have been aborted");
+}
+
+@end
@@ -0,0 +1,220 @@
+/*
+ Copyright (c) 2019-present, salesforce.com, inc. All rights reserved.
+ 
+ Redistribution and use of this software in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice, this list of conditions
+ and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of
+ conditions and the following disclaimer in the documentation and/or other materials provided
+ with the distribution.
+ * Neither the name of salesforce.com, inc. nor the names of its contributors may be used to
+ endorse or promote products derived from this software without specific prior written
+ permission of salesforce.com, inc.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <SalesforceSDKCore/SFSDKTestStandInServer.h>
+#import "SyncManagerTestCase.h"
+#import "SyncUpTargetTests.h"
+
+@interface CollectionSyncUpTests : SyncUpTargetTests
+
+@end
+
+@implementation CollectionSyncUpTests
+
+#pragma mark - setUp/tearDown
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [SFSDKTestStandInServer stop];
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void) testMaxBatchSizeExceeding200 {
+    SFCollectionSyncUpTarget* target = [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:nil updateFieldlist:nil maxBatchSize:@201];
+    XCTAssertEqual(target.maxBatchSize, 200, @"Max batch size should be 200");
+}
+
+- (void) testConstructors {
+    SFCollectionSyncUpTarget* target = [[SFCollectionSyncUpTarget alloc] init];
+    XCTAssertNil(target.createFieldlist, @"Wrong createFieldlist");
+    XCTAssertNil(target.updateFieldlist, @"Wrong updateFieldlist");
+    XCTAssertEqual(target.maxBatchSize, 200, @"Max batch size should be 200");
+    XCTAssertEqual(target.maxConcurrentBatches, 3, @"Max concurrent batches should be 3");
+
+    target = [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:@[@"Name"] updateFieldlist:@[@"Name", @"Description"] maxBatchSize:@50 maxConcurrentBatches:@5];
+    XCTAssertEqual(target.createFieldlist.count, 1, @"Wrong createFieldlist");
+    XCTAssertEqual(target.updateFieldlist.count, 2, @"Wrong updateFieldlist");
+    XCTAssertEqual(target.maxBatchSize, 50, @"Max batch size should be 50");
+    XCTAssertEqual(target.maxConcurrentBatches, 5, @"Max concurrent batches should be 5");
+
+    target = [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:nil updateFieldlist:nil maxBatchSize:nil maxConcurrentBatches:@100];
+    XCTAssertEqual(target.maxConcurrentBatches, 8, @"Max concurrent batches should be 8");
+}
+
+- (void) testFactoryMethodWithDictAndAsDict {
+    NSDictionary* targetDict = @{@"createFieldlist": @[@"Name"],
+                                 @"updateFieldlist": @[@"Name", @"Description"],
+                                 @"maxBatchSize": @12,
+                                 @"maxConcurrentBatches": @4,
+                                 kSFSyncTargetiOSImplKey: @"SFCollectionSyncUpTarget"};
+    SFSyncUpTarget* target = [SFSyncUpTarget newFromDict:targetDict];
+    XCTAssertEqual([target class], [SFCollectionSyncUpTarget class], @"Wrong class");
+    SFCollectionSyncUpTarget* collectionTarget = (SFCollectionSyncUpTarget*) target;
+    XCTAssertEqual(collectionTarget.maxBatchSize, 12, @"Max batch size should be 12");
+    XCTAssertEqual(collectionTarget.maxConcurrentBatches, 4, @"Max concurrent batches should be 4");
+
+    NSDictionary* actualTargetDict = [collectionTarget asDict];
+    XCTAssertEqualObjects(actualTargetDict[kSFSyncTargetiOSImplKey], @"SFCollectionSyncUpTarget", @"Wrong ios impl");
+    XCTAssertEqualObjects(actualTargetDict[@"maxBatchSize"], @12, @"Wrong max batch size");
+    XCTAssertEqualObjects(actualTargetDict[@"maxConcurrentBatches"], @4, @"Wrong max concurrent batches");
+    XCTAssertEqualObjects(actualTargetDict[@"createFieldlist"], @[@"Name"], @"Wrong createFieldlist");
+}
+
+/**
+ Create records locally
+ Sync up against the stand-in server with batches of 2 and up to 3 batches in flight
+ Make sure batches were in flight at the same time and every record got its server id
+ */
+- (void) testSyncUpConcurrentBatchesWithStandInServer {
+    [self createAccountsSoup];
+    NSArray* names = @[[self createAccountName], [self createAccountName], [self createAccountName],
+                       [self createAccountName], [self createAccountName], [self createAccountName]];
+    [self createAccountsLocally:names];
+
+    __block NSUInteger createdCount = 0;
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if (![request.HTTPMethod isEqualToString:@"POST"] || ![request.URL.path hasSuffix:@"/composite/sobjects"]) {
+            return nil;
+        }
+        NSArray* records = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil][@"records"];
+        NSMutableArray* results = [NSMutableArray new];
+        @synchronized (names) {
+            for (NSUInteger i = 0; i < records.count; i++) {
+                [results addObject:@{@"id": [NSString stringWithFormat:@"001STANDIN%08lu", (unsigned long) createdCount++], @"success": @YES, @"errors": @[]}];
+            }
+        }
+        SFSDKStandInResponse* response = [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:results];
+        response.delay = 0.5;
+        return response;
+    }];
+
+    SFCollectionSyncUpTarget* target = [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:nil updateFieldlist:nil maxBatchSize:@2 maxConcurrentBatches:@3];
+    SFSyncOptions* options = [SFSyncOptions newSyncOptionsForSyncUp:@[NAME, DESCRIPTION] mergeMode:SFSyncStateMergeModeOverwrite];
+    [self trySyncUp:names.count actualChanges:names.count target:target options:options completionStatus:SFSyncStateStatusDone];
+
+    XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 3, @"Wrong number of requests");
+    XCTAssertGreaterThan([SFSDKTestStandInServer maxConcurrentRequests], 1, @"Batches should have been in flight concurrently");
+
+    NSDictionary* idToFieldsCreated = [self getIdToFieldsByName:ACCOUNTS_SOUP fieldNames:@[NAME, DESCRIPTION] nameField:NAME names:names];
+    XCTAssertEqual(idToFieldsCreated.count, names.count, @"Wrong number of records");
+    for (NSString* recordId in idToFieldsCreated) {
+        XCTAssertTrue([recordId hasPrefix:@"001STANDIN"], @"Server id expected");
+    }
+    [self checkDbStateFlags:[idToFieldsCreated allKeys] soupName:ACCOUNTS_SOUP expectedLocallyCreated:NO expectedLocallyUpdated:NO expectedLocallyDeleted:NO];
+}
+
+/**
+ Create records locally
+ Sync up against the stand-in server which fails some of the records
+ Make sure only the successful ones are clean and the failed ones have their last error populated
+ */
+- (void) testSyncUpPartialFailureWithStandInServer {
+    [self createAccountsSoup];
+    NSArray* names = @[[self createAccountName], [self createAccountName], [self createAccountName]];
+    [self createAccountsLocally:names];
+
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if (![request.URL.path hasSuffix:@"/composite/sobjects"]) {
+            return nil;
+        }
+        NSArray* records = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil][@"records"];
+        NSMutableArray* results = [NSMutableArray new];
+        for (NSDictionary* record in records) {
+            if ([record[NAME] isEqualToString:names[1]]) {
+                [results addObject:@{@"success": @NO, @"errors": @[@{@"statusCode": @"STRING_TOO_LONG", @"message": @"Name too long"}]}];
+            } else {
+                [results addObject:@{@"id": [NSString stringWithFormat:@"001STANDIN%08lu", (unsigned long) results.count], @"success": @YES, @"errors": @[]}];
+            }
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:results];
+    }];
+
+    SFCollectionSyncUpTarget* target = [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:nil updateFieldlist:nil maxBatchSize:nil maxConcurrentBatches:nil];
+    SFSyncOptions* options = [SFSyncOptions newSyncOptionsForSyncUp:@[NAME, DESCRIPTION] mergeMode:SFSyncStateMergeModeOverwrite];
+    [self trySyncUp:names.count actualChanges:names.count target:target options:options completionStatus:SFSyncStateStatusDone];
+
+    NSDictionary* idToFieldsGood = [self getIdToFieldsByName:ACCOUNTS_SOUP fieldNames:@[NAME] nameField:NAME names:@[names[0], names[2]]];
+    [self checkDbStateFlags:[idToFieldsGood allKeys] soupName:ACCOUNTS_SOUP expectedLocallyCreated:NO expectedLocallyUpdated:NO expectedLocallyDeleted:NO];
+    NSDictionary* idToFieldsBad = [self getIdToFieldsByName:ACCOUNTS_SOUP fieldNames:@[NAME] nameField:NAME names:@[names[1]]];
+    [self checkDbStateFlags:[idToFieldsBad allKeys] soupName:ACCOUNTS_SOUP expectedLocallyCreated:YES expectedLocallyUpdated:NO expectedLocallyDeleted:NO];
+    [self checkDbLastErrorField:[idToFieldsBad allKeys] soupName:ACCOUNTS_SOUP lastErrorSubString:@"Name too long"];
+}
+
+/**
+ Create records locally and delete some others
+ Sync up against the stand-in server which creates the records but fails the delete request
+ Make sure the created records are not left locally created (they would be created again on the next sync up)
+ */
+- (void) testSyncUpFailedRequestKeepsOtherResultsWithStandInServer {
+    [self createAccountsSoup];
+    NSArray* names = @[[self createAccountName], [self createAccountName]];
+    NSArray* namesToDelete = @[[self createAccountName], [self createAccountName]];
+    [self createAccountsLocally:names];
+    NSArray* accountsToDelete = [self createAccountsLocally:namesToDelete];
+    [self deleteRecordsLocally:[accountsToDelete valueForKey:ID] soupName:ACCOUNTS_SOUP];
+
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if (![request.URL.path hasSuffix:@"/composite/sobjects"]) {
+            return nil;
+        }
+        if ([request.HTTPMethod isEqualToString:@"DELETE"]) {
+            return [SFSDKStandInResponse responseWithStatusCode:400 jsonObject:@[@{@"errorCode": @"INVALID_ID_FIELD", @"message": @"Invalid id"}]];
+        }
+        NSArray* records = [NSJSONSerialization JSONObjectWithData:body options:0 error:nil][@"records"];
+        NSMutableArray* results = [NSMutableArray new];
+        for (NSUInteger i = 0; i < records.count; i++) {
+            [results addObject:@{@"id": [NSString stringWithFormat:@"001STANDIN%08lu", (unsigned long) i], @"success": @YES, @"errors": @[]}];
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:results];
+    }];
+
+    SFCollectionSyncUpTarget* target = [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:nil updateFieldlist:nil maxBatchSize:nil maxConcurrentBatches:nil];
+    SFSyncOptions* options = [SFSyncOptions newSyncOptionsForSyncUp:@[NAME, DESCRIPTION] mergeMode:SFSyncStateMergeModeOverwrite];
+    [self trySyncUp:names.count + namesToDelete.count actualChanges:1 target:target options:options completionStatus:SFSyncStateStatusFailed];
+
+    NSDictionary* idToFieldsCreated = [self getIdToFieldsByName:ACCOUNTS_SOUP fieldNames:@[NAME] nameField:NAME names:names];
+    XCTAssertEqual(idToFieldsCreated.count, names.count, @"Wrong number of records");
+    for (NSString* recordId in idToFieldsCreated) {
+        XCTAssertTrue([recordId hasPrefix:@"001STANDIN"], @"Server id expected");
+    }
+    [self checkDbStateFlags:[idToFieldsCreated allKeys] soupName:ACCOUNTS_SOUP expectedLocallyCreated:NO expectedLocallyUpdated:NO expectedLocallyDeleted:NO];
+    NSDictionary* idToFieldsDeleted = [self getIdToFieldsByName:ACCOUNTS_SOUP fieldNames:@[NAME] nameField:NAME names:namesToDelete];
+    [self checkDbStateFlags:[idToFieldsDeleted allKeys] soupName:ACCOUNTS_SOUP expectedLocallyCreated:NO expectedLocallyUpdated:NO expectedLocallyDeleted:YES];
+}
+
+#pragma mark - THE methods responsible for building sync up targets used in all the tests
+
+- (SFSyncUpTarget*) buildSyncUpTargetWithCreateFieldlist:(nullable NSArray*)createFieldlist updateFieldlist:(nullable NSArray*)updateFieldlist {
+    return [[SFCollectionSyncUpTarget alloc] initWithCreateFieldlist:createFieldlist updateFieldlist:updateFieldlist maxBatchSize:@2 maxConcurrentBatches:@2];
+}
+
+@end
@@ -28,6 +28,7 @@
 #import "TestSyncDownTarget.h"
 #import <SalesforceSDKCore/SFSDKSoqlBuilder.h>
 #import <SalesforceSDKCore/SFSDKSoslBuilder.h>
+#import <SalesforceSDKCore/SFSDKTestStandInServer.h>
 
 #define COUNT_TEST_ACCOUNTS 10
 
@@ -46,6 +47,7 @@
 @interface SFRefreshSyncDownTarget ()
 
 @property (nonatomic, assign, readwrite) NSUInteger countIdsPerSoql;
+@property (nonatomic, assign, readwrite) NSUInteger maxConcurrentFetches;
 
 @end
 
@@ -107,6 +109,8 @@
 #pragma mark - setUp/tearDown
 
 - (void)tearDown {
+    [SFSDKTestStandInServer stop];
+
     // Deleting test data
     [self deleteTestData];
     [super tearDown];
@@ -171,6 +175,139 @@
     [self deleteAccountsOnServer:accountIds];
 }
 
+/**
+ * Tests that ghost records are cleaned page by page for a SOQL target against the stand-in server
+ * Local and remote ids span several pages, remote ids are returned sorted by id
+ */
+- (void)testCleanResyncGhostsStreamingWithStandInServer
+{
+    [self createAccountsSoup];
+    SFSoqlSyncDownTarget* target = [SFSoqlSyncDownTarget newSyncTarget:@"SELECT Id, Name FROM Account"];
+    SFSyncOptions* options = [SFSyncOptions newSyncOptionsForSyncDown:SFSyncStateMergeModeOverwrite];
+    SFSyncState* sync = [self.syncManager createSyncDown:target options:options soupName:ACCOUNTS_SOUP syncName:nil];
+    NSNumber* syncId = [NSNumber numberWithInteger:sync.syncId];
+
+    // 5000 clean records locally, every 7th one is gone from the server
+    NSUInteger numberRecords = 5000;
+    NSMutableArray* accounts = [NSMutableArray new];
+    NSMutableArray* remoteIds = [NSMutableArray new];
+    NSMutableArray* ghostIds = [NSMutableArray new];
+    for (NSUInteger i = 0; i < numberRecords; i++) {
+        NSString* accountId = [NSString stringWithFormat:@"001S%014lu", (unsigned long) i];
+        [accounts addObject:@{ID: accountId, NAME: accountId, ATTRIBUTES: @{TYPE: ACCOUNT_TYPE}, kSyncTargetSyncId: syncId,
+                              kSyncTargetLocal: @NO, kSyncTargetLocallyCreated: @NO, kSyncTargetLocallyUpdated: @NO, kSyncTargetLocallyDeleted: @NO}];
+        if (i % 7 == 0) {
+            [ghostIds addObject:accountId];
+        } else {
+            [remoteIds addObject:@{ID: accountId}];
+        }
+    }
+    [self.store upsertEntries:accounts toSoup:ACCOUNTS_SOUP];
+
+    // Serving remote ids 2000 at a time
+    NSUInteger pageSize = 2000;
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        NSRange queryRange = [request.URL.path rangeOfString:@"/query"];
+        if (queryRange.location == NSNotFound) {
+            return nil;
+        }
+        NSString* pageSuffix = [request.URL.path substringFromIndex:NSMaxRange(queryRange)];
+        NSUInteger offset = pageSuffix.length > 0 ? (NSUInteger) [[pageSuffix substringFromIndex:[pageSuffix rangeOfString:@"-"].location + 1] integerValue] : 0;
+        NSUInteger end = MIN(offset + pageSize, remoteIds.count);
+        NSMutableDictionary* response = [@{@"totalSize": @(remoteIds.count), @"done": @(end == remoteIds.count),
+                                           RECORDS: [remoteIds subarrayWithRange:NSMakeRange(offset, end - offset)]} mutableCopy];
+        if (end < remoteIds.count) {
+            response[@"nextRecordsUrl"] = [NSString stringWithFormat:@"%@/01gSTANDIN-%lu", [request.URL.path substringToIndex:NSMaxRange(queryRange)], (unsigned long) end];
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:response];
+    }];
+
+    __block NSUInteger progressCount = 0;
+    __block NSUInteger lastNumRecordsChecked = 0;
+    __block NSUInteger numRecordsDeleted = 0;
+    XCTestExpectation* cleanResyncGhosts = [self expectationWithDescription:@"cleanResyncGhosts"];
+    [self.syncManager cleanResyncGhosts:syncId progressBlock:^(NSUInteger numRecordsChecked, NSUInteger numRecordsDeletedSoFar) {
+        XCTAssertGreaterThanOrEqual(numRecordsChecked, lastNumRecordsChecked, @"Progress should not go backward");
+        lastNumRecordsChecked = numRecordsChecked;
+        progressCount++;
+    } completionStatusBlock:^(SFSyncStateStatus syncStatus, NSUInteger numRecords) {
+        XCTAssertEqual(syncStatus, SFSyncStateStatusDone, @"Clean ghosts should have succeeded");
+        numRecordsDeleted = numRecords;
+        [cleanResyncGhosts fulfill];
+    } error:nil];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+
+    XCTAssertEqual(numRecordsDeleted, ghostIds.count, @"Wrong number of records deleted");
+    XCTAssertEqual(lastNumRecordsChecked, numberRecords, @"All local records should have been checked");
+    XCTAssertGreaterThan(progressCount, 1, @"Progress should be reported for every page of local ids");
+    XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, (remoteIds.count + pageSize - 1) / pageSize, @"Wrong number of requests");
+    NSString* soql = [[SFSDKTestStandInServer receivedRequests][0].URL.query stringByReplacingOccurrencesOfString:@"+" withString:@" "].stringByRemovingPercentEncoding;
+    XCTAssertTrue([soql.lowercaseString containsString:@"order by id"], @"Remote ids should be sorted by id");
+    [self checkDbDeleted:ACCOUNTS_SOUP ids:ghostIds idField:ID];
+    XCTAssertEqual([[self.store countWithQuerySpec:[SFQuerySpec newAllQuerySpec:ACCOUNTS_SOUP withOrderPath:nil withOrder:kSFSoupQuerySortOrderAscending withPageSize:1] error:nil] unsignedIntegerValue], remoteIds.count, @"Only ghosts should have been deleted");
+}
+
+/**
+ * Tests that no ghost record is deleted when a later page of remote ids turns out not to be sorted by id
+ */
+- (void)testCleanResyncGhostsUnsortedRemoteIdsWithStandInServer
+{
+    [self createAccountsSoup];
+    SFSoqlSyncDownTarget* target = [SFSoqlSyncDownTarget newSyncTarget:@"SELECT Id, Name FROM Account"];
+    SFSyncOptions* options = [SFSyncOptions newSyncOptionsForSyncDown:SFSyncStateMergeModeOverwrite];
+    SFSyncState* sync = [self.syncManager createSyncDown:target options:options soupName:ACCOUNTS_SOUP syncName:nil];
+    NSNumber* syncId = [NSNumber numberWithInteger:sync.syncId];
+
+    // 5000 clean records locally, every 7th one is gone from the server, the first remote id comes back last
+    NSUInteger numberRecords = 5000;
+    NSMutableArray* accounts = [NSMutableArray new];
+    NSMutableArray* remoteIds = [NSMutableArray new];
+    for (NSUInteger i = 0; i < numberRecords; i++) {
+        NSString* accountId = [NSString stringWithFormat:@"001S%014lu", (unsigned long) i];
+        [accounts addObject:@{ID: accountId, NAME: accountId, ATTRIBUTES: @{TYPE: ACCOUNT_TYPE}, kSyncTargetSyncId: syncId,
+                              kSyncTargetLocal: @NO, kSyncTargetLocallyCreated: @NO, kSyncTargetLocallyUpdated: @NO, kSyncTargetLocallyDeleted: @NO}];
+        if (i % 7 != 1) {
+            [remoteIds addObject:@{ID: accountId}];
+        }
+    }
+    [self.store upsertEntries:accounts toSoup:ACCOUNTS_SOUP];
+    [remoteIds addObject:remoteIds[0]];
+    [remoteIds removeObjectAtIndex:0];
+
+    NSUInteger pageSize = 2000;
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        NSRange queryRange = [request.URL.path rangeOfString:@"/query"];
+        if (queryRange.location == NSNotFound) {
+            return nil;
+        }
+        NSString* pageSuffix = [request.URL.path substringFromIndex:NSMaxRange(queryRange)];
+        NSUInteger offset = pageSuffix.length > 0 ? (NSUInteger) [[pageSuffix substringFromIndex:[pageSuffix rangeOfString:@"-"].location + 1] integerValue] : 0;
+        NSUInteger end = MIN(offset + pageSize, remoteIds.count);
+        NSMutableDictionary* response = [@{@"totalSize": @(remoteIds.count), @"done": @(end == remoteIds.count),
+                                           RECORDS: [remoteIds subarrayWithRange:NSMakeRange(offset, end - offset)]} mutableCopy];
+        if (end < remoteIds.count) {
+            response[@"nextRecordsUrl"] = [NSString stringWithFormat:@"%@/01gSTANDIN-%lu", [request.URL.path substringToIndex:NSMaxRange(queryRange)], (unsigned long) end];
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:response];
+    }];
+
+    __block SFSyncStateStatus finalStatus = SFSyncStateStatusNew;
+    XCTestExpectation* cleanResyncGhosts = [self expectationWithDescription:@"cleanResyncGhosts"];
+    [self.syncManager cleanResyncGhosts:syncId completionStatusBlock:^(SFSyncStateStatus syncStatus, NSUInteger numRecords) {
+        if (syncStatus == SFSyncStateStatusFailed || syncStatus == SFSyncStateStatusDone) {
+            finalStatus = syncStatus;
+            [cleanResyncGhosts fulfill];
+        }
+    } error:nil];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+
+    XCTAssertEqual(finalStatus, SFSyncStateStatusFailed, @"Clean ghosts should have failed");
+    XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, (remoteIds.count + pageSize - 1) / pageSize, @"Unsorted ids should only show on the last page");
+    XCTAssertEqual([[self.store countWithQuerySpec:[SFQuerySpec newAllQuerySpec:ACCOUNTS_SOUP withOrderPath:nil withOrder:kSFSoupQuerySortOrderAscending withPageSize:1] error:nil] unsignedIntegerValue], numberRecords, @"No record should have been deleted");
+}
+
 /**
  * Tests clean ghosts when soup is populated through more than one sync down
  */
@@ -508,6 +645,49 @@
     [self checkDb:idToFields];
 }
 
+/**
+ * Tests refresh-sync-down against the stand-in server with two ids per soql query and up to three queries in flight
+ * Make sure the queries ran concurrently, records were still handed out one chunk at a time and all got refreshed
+ */
+-(void) testRefreshSyncDownConcurrentFetchesWithStandInServer
+{
+    [self createAccountsSoup];
+    NSUInteger numberRecords = 10;
+    NSMutableDictionary* idToFieldsExpected = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < numberRecords; i++) {
+        NSString* accountId = [NSString stringWithFormat:@"001REFRESH%08lu", (unsigned long) i];
+        idToFieldsExpected[accountId] = @{NAME: [NSString stringWithFormat:@"Refreshed %@", accountId]};
+        [self.store upsertEntries:@[@{ID: accountId}] toSoup:ACCOUNTS_SOUP];
+    }
+
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if (![request.URL.path hasSuffix:@"/query"]) {
+            return nil;
+        }
+        NSString* soql = [request.URL.query stringByReplacingOccurrencesOfString:@"+" withString:@" "].stringByRemovingPercentEncoding;
+        NSMutableArray* records = [NSMutableArray new];
+        NSRegularExpression* idRegexp = [NSRegularExpression regularExpressionWithPattern:@"001REFRESH[0-9]+" options:0 error:nil];
+        for (NSTextCheckingResult* match in [idRegexp matchesInString:soql options:0 range:NSMakeRange(0, soql.length)]) {
+            NSString* accountId = [soql substringWithRange:match.range];
+            [records addObject:@{ID: accountId, NAME: idToFieldsExpected[accountId][NAME], ATTRIBUTES: @{TYPE: ACCOUNT_TYPE}}];
+        }
+        SFSDKStandInResponse* response = [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"totalSize": @(records.count), @"done": @YES, RECORDS: records}];
+        response.delay = 0.3;
+        return response;
+    }];
+
+    SFRefreshSyncDownTarget* target = [SFRefreshSyncDownTarget newSyncTarget:ACCOUNTS_SOUP objectType:ACCOUNT_TYPE fieldlist:@[ID, NAME]];
+    target.countIdsPerSoql = 2;
+    target.maxConcurrentFetches = 3;
+    [self trySyncDown:SFSyncStateMergeModeOverwrite target:target soupName:ACCOUNTS_SOUP totalSize:numberRecords numberFetches:numberRecords/2];
+
+    XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, numberRecords/2, @"Wrong number of requests");
+    XCTAssertGreaterThan([SFSDKTestStandInServer maxConcurrentRequests], 1, @"Queries should have been in flight concurrently");
+    XCTAssertLessThanOrEqual([SFSDKTestStandInServer maxConcurrentRequests], 3, @"No more than maxConcurrentFetches queries should be in flight");
+    [self checkDb:idToFieldsExpected soupName:ACCOUNTS_SOUP];
+}
+
 /**
  * Tests resync for a refresh-sync-down when they are more records in the table than can be enumerated
  * in one soql call to the server
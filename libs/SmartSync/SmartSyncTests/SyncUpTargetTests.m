@@ -22,6 +22,7 @@
  WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#import <SalesforceSDKCore/SFSDKTestStandInServer.h>
 #import "SyncManagerTestCase.h"
 #import "SFSyncUpdateCallbackQueue.h"
 
@@ -43,6 +44,8 @@
 #pragma mark - setUp/tearDown
 
 - (void)tearDown {
+    [SFSDKTestStandInServer stop];
+
     // Deleting test data
     [self deleteTestData];
     [super tearDown];
@@ -296,6 +299,61 @@
     [self checkServer:idToFieldsRemotelyUpdated];
 }
 
+/**
+ * Prefetch modification dates of a few records against the stand-in server
+ * Make sure a single query was sent and isNewerThanServer is answered from the fetched dates
+ */
+- (void)testPrefetchLastModifiedDates
+{
+    [self createAccountsSoup];
+    NSArray* ids = @[@"001000000000001AAA", @"001000000000002AAA", @"001000000000003AAA"];
+    NSMutableArray* accounts = [NSMutableArray new];
+    for (NSString* accountId in ids) {
+        [accounts addObject:@{ID: accountId, NAME: accountId, LAST_MODIFIED_DATE: @"2019-06-01T00:00:00.000Z",
+                              ATTRIBUTES: @{TYPE: ACCOUNT_TYPE},
+                              kSyncTargetLocal: @YES, kSyncTargetLocallyCreated: @NO, kSyncTargetLocallyUpdated: @YES, kSyncTargetLocallyDeleted: @NO}];
+    }
+    NSArray* records = [self.store upsertEntries:accounts toSoup:ACCOUNTS_SOUP];
+    NSMutableArray* storeIds = [NSMutableArray new];
+    for (NSDictionary* record in records) {
+        [storeIds addObject:record[SOUP_ENTRY_ID]];
+    }
+
+    // First record is older on the server, second one is newer and third one is deleted
+    [SFSDKTestStandInServer start];
+    [SFSDKTestStandInServer addHandler:^SFSDKStandInResponse *(NSURLRequest *request, NSData *body) {
+        if (![request.URL.path hasSuffix:@"/query"]) {
+            return nil;
+        }
+        return [SFSDKStandInResponse responseWithStatusCode:200 jsonObject:@{@"totalSize": @2, @"done": @YES, RECORDS: @[
+            @{ID: ids[0], LAST_MODIFIED_DATE: @"2019-01-01T00:00:00.000Z"},
+            @{ID: ids[1], LAST_MODIFIED_DATE: @"2019-12-01T00:00:00.000Z"}]}];
+    }];
+
+    SFSyncUpTarget* target = [self buildSyncUpTarget];
+    XCTestExpectation* prefetched = [self expectationWithDescription:@"prefetched"];
+    [target prefetchLastModifiedDates:self.syncManager soupName:ACCOUNTS_SOUP storeIds:storeIds completionBlock:^{
+        [prefetched fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:30 handler:nil];
+    XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 1, @"Only one query expected");
+    NSString* soql = [SFSDKTestStandInServer receivedRequests][0].URL.query.stringByRemovingPercentEncoding;
+    for (NSString* accountId in ids) {
+        XCTAssertTrue([soql containsString:accountId], @"Id missing from query");
+    }
+
+    NSArray* expectedResults = @[@YES, @NO, @NO];
+    for (NSUInteger i = 0; i < records.count; i++) {
+        XCTestExpectation* checked = [self expectationWithDescription:@"checked"];
+        [target isNewerThanServer:self.syncManager record:records[i] resultBlock:^(BOOL isNewerThanServer) {
+            XCTAssertEqual(isNewerThanServer, [expectedResults[i] boolValue], @"Wrong result for record %lu", (unsigned long) i);
+            [checked fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:30 handler:nil];
+    }
+    XCTAssertEqual([SFSDKTestStandInServer receivedRequests].count, 1, @"No additional request expected");
+}
+
 /**
  * Create accounts locally, sync up with merge mode SFSyncStateMergeModeOverwrite, check smartstore and server afterwards
  */